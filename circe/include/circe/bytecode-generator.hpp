@@ -2,14 +2,13 @@
 
 #include <circe/register.hpp>
 
-#include <sigil/ast/syntax-tree.hpp>
-#include <sigil/ast/visitor.hpp>
+#include <sigil/ast/flat-tree.hpp>
+#include <sigil/ast/interner.hpp>
+#include <sigil/ast/symbol-table.hpp>
 
 #include <mana/literals.hpp>
 #include <hexe/bytecode.hpp>
 
-#include <emhash/emhash8.hpp>
-
 namespace sigil {
 class SemanticAnalyzer;
 }
@@ -18,15 +17,7 @@ namespace circe {
 using namespace mana::literals;
 namespace ast = sigil::ast;
 
-class BytecodeGenerator final : public ast::Visitor {
-    using ScopeID = u8;
-
-    struct Symbol {
-        Register register_index;
-        ScopeID scope;
-    };
-
-
+class BytecodeGenerator final {
     struct JumpInstruction {
         i64 jump_index;
         bool is_conditional;
@@ -38,20 +29,26 @@ class BytecodeGenerator final : public ast::Visitor {
     };
 
     struct Function {
-        std::string_view return_type;
-        i64 address = -1;
+        sigil::NameID return_type = sigil::NO_NAME;
+        i64 address               = -1;
+        u8 param_count            = 0;
+        bool is_native            = false;
         RegisterFrame registers;
     };
 
     struct Call {
-        std::string_view function;
+        sigil::NameID function;
         i64 instruction_index;
     };
 
-    using SymbolTable   = emhash8::HashMap<std::string_view, Symbol>;
-    using FunctionTable = emhash8::HashMap<std::string_view, Function>;
+    // vector builtins compile straight to their opcode
+    struct VectorBuiltin {
+        hexe::Op op;
+        hexe::Value::Data::Type type = hexe::Value::Data::Type::Invalid; // what VecMake builds
+    };
 
-    ScopeID scope;
+    using SymbolTable   = sigil::ScopedSymbolTable<Register>;
+    using FunctionTable = sigil::NameMap<Function>;
 
     SymbolTable symbols;
     FunctionTable functions;
@@ -60,54 +57,64 @@ class BytecodeGenerator final : public ast::Visitor {
     std::vector<Register> register_buffer;
 
     std::vector<LoopContext> loop_stack;
-    std::vector<std::string_view> function_stack;
-    emhash8::HashMap<i64, std::string_view> pending_calls;
+    std::vector<sigil::NameID> function_stack;
+    std::vector<Call> pending_calls;
+
+    sigil::NameID print_name;
+    sigil::NameID printv_name;
+    sigil::NameMap<VectorBuiltin> vector_builtins;
+    sigil::NameMap<hexe::Op> container_builtins;
 
     hexe::ByteCode bytecode;
+    bool emit_line_table;
+
+    // only set for the duration of Generate
+    const ast::FlatTree* tree;
 
 public:
     BytecodeGenerator();
 
     CIRCE_NODISCARD hexe::ByteCode Bytecode() const;
 
+    // attributes each statement's instructions to its source line
+    void EmitLineTable(std::string_view source_name);
+
     void ObtainSemanticAnalysisInfo(const sigil::SemanticAnalyzer& analyzer);
 
-    void Visit(const ast::Artifact& artifact) override;
-    void Visit(const ast::Scope& node) override;
+    void Generate(const ast::FlatTree& flat_tree);
 
-    void Visit(const ast::FunctionDeclaration& node) override;
-    void Visit(const ast::MutableDataDeclaration& node) override;
-    void Visit(const ast::DataDeclaration& node) override;
+private:
+    void Generate(ast::NodeId node);
 
-    void Visit(const ast::Identifier& node) override;
-    void Visit(const ast::Assignment& node) override;
+    void GenerateScope(ast::NodeId node);
+    void GenerateStatements(ast::NodeId node);
+    void GenerateFunctionDeclaration(ast::NodeId node);
 
-    void Visit(const ast::Return& node) override;
-    void Visit(const ast::Invocation& node) override;
+    void GenerateIdentifier(ast::NodeId node);
+    void GenerateAssignment(ast::NodeId node);
+    void GenerateElementAssignment(ast::NodeId node);
 
-    void Visit(const ast::If& node) override;
+    void GenerateReturn(ast::NodeId node);
+    void GenerateInvocation(ast::NodeId node);
+    void GenerateVectorBuiltin(ast::NodeId node, const VectorBuiltin& builtin);
+    void GenerateContainerBuiltin(ast::NodeId node, hexe::Op op);
 
-    void Visit(const ast::Loop& node) override;
-    void Visit(const ast::LoopIf& node) override;
-    void Visit(const ast::LoopIfPost& node) override;
-    void Visit(const ast::LoopFixed& node) override;
-    void Visit(const ast::LoopRange& node) override;
-    void Visit(const ast::LoopRangeMutable& node) override;
+    void GenerateIf(ast::NodeId node);
 
-    void Visit(const ast::Break& node) override;
-    void Visit(const ast::Skip& node) override;
+    void GenerateLoop(ast::NodeId node);
+    void GenerateLoopIf(ast::NodeId node);
+    void GenerateLoopIfPost(ast::NodeId node);
+    void GenerateLoopFixed(ast::NodeId node);
+    void GenerateLoopRange(ast::NodeId node);
+    void GenerateLoopRangeMutable(ast::NodeId node);
+    void GenerateLoopRangeParallel(ast::NodeId node);
 
-    void Visit(const ast::UnaryExpr& node) override;
-    void Visit(const ast::BinaryExpr& node) override;
-    void Visit(const ast::ListExpression& list) override;
-    void Visit(const ast::ListAccess&) override;
+    void GenerateUnary(ast::NodeId node);
+    void GenerateBinary(ast::NodeId node);
 
-    void Visit(const ast::Literal<f64>& float64) override;
-    void Visit(const ast::Literal<i64>& int64) override;
-    void Visit(const ast::Literal<bool>& boolean) override;
-    void Visit(const ast::StringLiteral& string) override;
+    void GenerateList(ast::NodeId node);
+    void GenerateListAccess(ast::NodeId node);
 
-private:
     bool IsConditionalJumpOp(hexe::Op op) const;
     void JumpBackwards(i64 target_index);
     void JumpForward(i64 target_index);
@@ -124,9 +131,12 @@ private:
 
     const Function& CurrentFunction() const;
     Function& CurrentFunction();
-    std::string_view CurrentFunctionName() const;
+    sigil::NameID CurrentFunctionName() const;
+
+    // lets hosts call every function but the entry point by name
+    void ExportFunctions();
 
-    void HandleInvocationArguments(std::span<const ast::NodePtr> args, std::span<const Register> param_regs);
+    void HandleInvocationArguments(std::span<const ast::NodeId> args, std::span<const Register> param_regs);
 
     void ReturnNone();
 
@@ -136,8 +146,7 @@ private:
     void EnterLoop();
     void ExitLoop();
 
-    void AddSymbol(std::string_view name, Register index);
-    void RemoveSymbol(std::string_view name);
+    void AddSymbol(sigil::NameID name, Register index);
 
     LoopContext& CurrentLoop();
 
@@ -145,13 +154,16 @@ private:
         Register end, step, counter;
     };
 
-    RangeLoopRegisters PerformRangeLoopSetup(const ast::LoopRange& node);
+    RangeLoopRegisters PerformRangeLoopSetup(ast::NodeId node);
+
+    // the counter's scope has to have been entered, and is exited once the body is done
+    void GenerateRangeLoopBody(ast::NodeId node, RangeLoopRegisters range);
 
     void HandlePendingSkips();
     void HandlePendingBreaks();
 
-    void HandleLoopControl(bool is_break, const ast::NodePtr& condition);
-    void HandleInitializer(const ast::Initializer& node, bool is_mutable);
+    void HandleLoopControl(bool is_break, ast::NodeId node);
+    void HandleInitializer(ast::NodeId node, bool is_mutable);
 
     template <hexe::ValuePrimitiveType VP>
     void CreateLiteral(const VP literal) {
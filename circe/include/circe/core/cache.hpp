@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mana/literals.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace circe {
+using namespace mana::literals;
+
+// identifies one compilation: what was compiled, by which compiler, and how
+struct CacheKey {
+    u64 fnv;
+    u32 crc;
+
+    CIRCE_NODISCARD std::string FileName() const;
+};
+
+/// Directory of compiled executables, keyed by the hash of their inputs.
+///
+/// Entries are written to a temporary file and renamed into place, so any number of
+/// circe processes may share a directory. A hit refreshes the entry's modification time,
+/// and eviction removes the least recently used entries until the directory fits its budget.
+class CompileCache {
+    std::filesystem::path directory;
+    std::string salt;
+    u64 max_bytes;
+
+    std::atomic<u64> hits   = 0;
+    std::atomic<u64> misses = 0;
+
+public:
+    // the salt should capture everything outside the source that affects the output, such as versions
+    CompileCache(std::filesystem::path directory, std::string salt, u64 max_bytes);
+
+    CIRCE_NODISCARD CacheKey Key(std::string_view source, std::string_view options) const;
+
+    // places the cached executable at 'output', returns false on a miss
+    bool Restore(const CacheKey& key, const std::filesystem::path& output);
+    void Store(const CacheKey& key, std::span<const u8> executable) const;
+
+    // called once compilation is done, as it has to look at every entry
+    void Evict() const;
+
+    CIRCE_NODISCARD u64 Hits() const;
+    CIRCE_NODISCARD u64 Misses() const;
+
+    void LogStatistics() const;
+};
+} // namespace circe
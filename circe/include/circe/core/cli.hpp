@@ -3,28 +3,56 @@
 #include <mana/literals.hpp>
 
 #include <filesystem>
+#include <vector>
 
 
 namespace circe {
 struct CompileSettings {
     friend CompileSettings ParseCommandLineCompileSettings(int argc, char** argv);
 
-    CIRCE_NODISCARD const std::filesystem::path& InputFilePath() const;
+    // the emit options, packed so they can be sent to a compile server
+    CIRCE_NODISCARD mana::literals::u16 Flags() const;
+    CIRCE_NODISCARD static CompileSettings FromFlags(mana::literals::u16 flags,
+                                                     std::filesystem::path natives_path = {});
+
+    // files and directories, as given
+    CIRCE_NODISCARD const std::vector<std::filesystem::path>& InputPaths() const;
     CIRCE_NODISCARD const std::filesystem::path& OutputPath() const;
+    CIRCE_NODISCARD mana::literals::u32 JobCount() const;
+
+    // empty when caching is off
+    CIRCE_NODISCARD const std::filesystem::path& CacheDirectory() const;
+    CIRCE_NODISCARD mana::literals::u64 CacheSizeLimit() const;
+
+    // empty unless compiling on a Salem server
+    CIRCE_NODISCARD const std::filesystem::path& ServerSocket() const;
+
+    // empty unless the host provides native functions, see SemanticAnalyzer::RegisterNatives
+    CIRCE_NODISCARD const std::filesystem::path& NativesPath() const;
     CIRCE_NODISCARD bool EmitVerbose() const;
     CIRCE_NODISCARD bool EmitParseTree() const;
     CIRCE_NODISCARD bool EmitTokens() const;
+    CIRCE_NODISCARD bool EmitLineTable() const;
     CIRCE_NODISCARD bool ShouldExit() const;
 
     CIRCE_NODISCARD int ErrorCode() const;
 
 private:
-    std::filesystem::path input_path;
+    std::vector<std::filesystem::path> input_paths;
     std::filesystem::path output_path;
 
+    mana::literals::u32 job_count {1};
+
+    std::filesystem::path cache_directory;
+    mana::literals::u64 cache_size_mib {512};
+
+    std::filesystem::path server_socket;
+    std::filesystem::path natives_path;
+
     bool emit_detail {false};
     bool emit_ptree {false};
     bool emit_tokens {false};
+    bool emit_line_table {false};
     bool should_exit {false};
 
     int exit_code {mana::literals::SENTINEL};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <circe/core/cache.hpp>
+#include <circe/core/cli.hpp>
+
+#include <mana/literals.hpp>
+#include <mana/logger.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace circe {
+using namespace mana::literals;
+
+struct CompileJob {
+    std::filesystem::path input;
+
+    // a directory if it's empty or ends in a separator
+    std::filesystem::path output;
+};
+
+// a compilation's outcome, with its diagnostics held back rather than written
+struct CompileResult {
+    int exit_code;
+    std::vector<mana::LogRecord> log;
+};
+
+// reduces per-file exit codes to that of the first file which failed
+class CompileTally {
+    std::chrono::high_resolution_clock::time_point start;
+
+    int exit_code = 0;
+    u64 compiled  = 0;
+    u64 total     = 0;
+
+public:
+    CompileTally();
+
+    void Add(int file_exit_code);
+
+    // logs a summary if there was more than one file
+    int Finish() const;
+};
+
+// identifies the compiler in cache keys, as a new compiler may generate different code for the same source
+CIRCE_NODISCARD std::string CompilerFingerprint();
+
+// directories contribute every .mn file beneath them, mirrored under the output directory
+CIRCE_NODISCARD std::vector<CompileJob> CollectJobs(const CompileSettings& settings);
+
+// runs the whole pipeline for one file, the cache may be null
+int CompileFile(const CompileSettings& settings, const CompileJob& job, CompileCache* cache);
+CIRCE_NODISCARD CompileResult CompileCaptured(const CompileSettings& settings, const CompileJob& job, CompileCache* cache);
+
+// every file gets compiled, even after a failure
+int CompileAll(const CompileSettings& settings, std::span<const CompileJob> jobs, CompileCache* cache);
+
+// hands the jobs to a Salem compile server, nullopt if there was none to connect to
+CIRCE_NODISCARD std::optional<int> CompileRemotely(const CompileSettings& settings, std::span<const CompileJob> jobs);
+} // namespace circe
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <circe/core/driver.hpp>
+
+#include <mana/literals.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+/// Wire format between circe and a Salem compile server, over a Unix domain socket.
+///
+/// A client sends one batch of jobs, and gets one result per job back, in the order it sent them.
+/// Every message is prefixed with its size. Both ends share a machine, so integers use native byte order.
+namespace circe::protocol {
+using namespace mana::literals;
+
+constexpr u32 MAGIC   = 0x4d45'4c53; // "SLEM"
+constexpr u16 VERSION = 2;
+
+struct JobRequest {
+    CompileJob job;
+
+    // see CompileSettings::Flags
+    u16 flags;
+
+    // see CompileSettings::NativesPath
+    std::filesystem::path natives;
+};
+
+// sockets are plain descriptors, -1 on failure
+CIRCE_NODISCARD int Connect(const std::filesystem::path& socket_path);
+CIRCE_NODISCARD int Listen(const std::filesystem::path& socket_path);
+
+// -1 if nobody connected within the timeout
+CIRCE_NODISCARD int Accept(int listener, i32 timeout_ms);
+void Close(int socket);
+
+bool SendJobs(int socket, std::span<const CompileJob> jobs, u16 flags, const std::filesystem::path& natives);
+CIRCE_NODISCARD std::optional<std::vector<JobRequest>> ReceiveJobs(int socket);
+
+bool SendResult(int socket, const CompileResult& result);
+CIRCE_NODISCARD std::optional<CompileResult> ReceiveResult(int socket);
+} // namespace circe::protocol
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <mana/literals.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace circe {
+using namespace mana::literals;
+
+/// Fixed set of workers draining a shared FIFO queue.
+/// Destroying the pool finishes whatever was already submitted.
+class ThreadPool {
+    std::vector<std::jthread> workers;
+    std::deque<std::move_only_function<void()>> queue;
+
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+public:
+    explicit ThreadPool(u32 thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename Task>
+    auto Submit(Task&& task) -> std::future<std::invoke_result_t<Task>> {
+        std::packaged_task<std::invoke_result_t<Task>()> packaged(std::forward<Task>(task));
+        auto result = packaged.get_future();
+
+        {
+            std::lock_guard lock(mutex);
+            queue.emplace_back(std::move(packaged));
+        }
+        available.notify_one();
+
+        return result;
+    }
+
+private:
+    void Work();
+};
+} // namespace circe
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mana/literals.hpp>
+
+#include <random>
+#include <string>
+
+namespace circe::tools {
+namespace ml = mana::literals;
+
+/**
+ * @brief Generates synthetic, semantically valid Mana sources of a requested size,
+ * for measuring how the compiler scales.
+ *
+ * Programs are a sequence of functions that cycle through the shapes we care about:
+ * long arithmetic expressions, nested loops, branches, and big literal lists.
+ * The output only depends on the line count and seed, so sizes are comparable across commits.
+ */
+class SourceGenerator {
+    std::mt19937_64 rng;
+
+    std::string out;
+    ml::i64 lines;
+    ml::i64 function_count;
+
+public:
+    explicit SourceGenerator(ml::u64 seed = 1);
+
+    std::string Generate(ml::i64 target_lines);
+
+private:
+    void Line(ml::i64 indent, std::string_view text);
+
+    void ArithmeticFunction();
+    void LoopFunction();
+    void BranchFunction();
+    void ListFunction();
+    void Main();
+
+    std::string Expression(ml::i64 terms);
+    std::string FunctionName(ml::i64 index) const;
+
+    ml::i64 Literal(ml::i64 max);
+};
+} // namespace circe::tools
@@ -9,24 +9,211 @@
 #include <magic_enum/magic_enum.hpp>
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <ranges>
 
 namespace circe {
 using namespace hexe;
 using namespace sigil::ast;
 
+namespace {
+// the arithmetic a compound assignment such as '+=' performs, Err if it isn't one
+Op CompoundOperation(const sigil::TokenType op) {
+    switch (op) {
+        using enum sigil::TokenType;
+
+    case Op_AddAssign:
+        return Op::Add;
+    case Op_SubAssign:
+        return Op::Sub;
+    case Op_MulAssign:
+        return Op::Mul;
+    case Op_DivAssign:
+        return Op::Div;
+    case Op_ModAssign:
+        return Op::Mod;
+    default:
+        return Op::Err;
+    }
+}
+
+bool IsVector(const Value::Data::Type type) {
+    return type >= Value::Data::Type::Vec2 && type <= Value::Data::Type::Vec2i;
+}
+
+// the analyzer only lets '+', '-' and '*' through for vectors, compound or not
+// scaling takes the vector first, wherever it was written
+void WriteVectorOperation(ByteCode& bytecode,
+                          const sigil::TokenType op,
+                          const Register dst,
+                          const Register lhs,
+                          const Register rhs,
+                          const bool lhs_is_vector) {
+    switch (op) {
+        using enum sigil::TokenType;
+
+    case Op_Plus:
+    case Op_AddAssign:
+        bytecode.Write(Op::VecAdd, {dst, lhs, rhs});
+        break;
+    case Op_Minus:
+    case Op_SubAssign:
+        bytecode.Write(Op::VecSub, {dst, lhs, rhs});
+        break;
+    default:
+        bytecode.Write(Op::VecScale, {dst, lhs_is_vector ? lhs : rhs, lhs_is_vector ? rhs : lhs});
+        break;
+    }
+}
+
+// packed lists are read and written at the width of their elements
+Op ListReadOp(const Value::Data::Type element) {
+    switch (element) {
+        using enum Value::Data::Type;
+
+    case Int8:
+        return Op::ListReadI8;
+    case Int16:
+        return Op::ListReadI16;
+    case Int32:
+        return Op::ListReadI32;
+    case Uint8:
+        return Op::ListReadU8;
+    case Uint16:
+        return Op::ListReadU16;
+    case Uint32:
+        return Op::ListReadU32;
+    case Float32:
+        return Op::ListReadF32;
+    case Bits:
+        return Op::ListReadBit;
+    default:
+        return Op::ListRead;
+    }
+}
+
+Op ListStoreOp(const Value::Data::Type element) {
+    switch (element) {
+        using enum Value::Data::Type;
+
+    case Int8:
+    case Uint8:
+        return Op::ListStore8;
+    case Int16:
+    case Uint16:
+        return Op::ListStore16;
+    case Int32:
+    case Uint32:
+        return Op::ListStore32;
+    case Float32:
+        return Op::ListStoreF32;
+    case Bits:
+        return Op::ListStoreBit;
+    default:
+        return Op::ListStore;
+    }
+}
+
+// literals, negated or not, which packed lists can be laid out from ahead of time
+bool IsPackable(const FlatTree& tree, const NodeId node) {
+    switch (tree.Kind(node)) {
+    case NodeKind::LiteralBool:
+    case NodeKind::LiteralInt:
+    case NodeKind::LiteralFloat:
+        return true;
+    case NodeKind::Unary:
+        return tree.Operator(node) == sigil::TokenType::Op_Minus && IsPackable(tree, tree.Child(node, 0));
+    default:
+        return false;
+    }
+}
+
+void PackElement(Value& list, const u16 index, const FlatTree& tree, NodeId element) {
+    i64 sign = 1;
+    while (tree.Kind(element) == NodeKind::Unary) {
+        sign    = -sign;
+        element = tree.Child(element, 0);
+    }
+
+    switch (list.Type()) {
+        using enum Value::Data::Type;
+
+    case Int8:
+    case Uint8:
+        list.SetPacked(index, static_cast<u8>(sign * tree.Int(element)));
+        break;
+    case Int16:
+    case Uint16:
+        list.SetPacked(index, static_cast<u16>(sign * tree.Int(element)));
+        break;
+    case Int32:
+    case Uint32:
+        list.SetPacked(index, static_cast<u32>(sign * tree.Int(element)));
+        break;
+    case Float32:
+        list.SetPacked(index, static_cast<f32>(static_cast<f64>(sign) * tree.Float(element)));
+        break;
+    case Bits:
+        list.SetBit(index, tree.Bool(element));
+        break;
+    default:
+        break;
+    }
+}
+} // namespace
+
 BytecodeGenerator::BytecodeGenerator()
-    : scope {0},
-      bytecode {} {}
+    : print_name {sigil::Names().Intern("Print")},
+      printv_name {sigil::Names().Intern("PrintV")},
+      bytecode {},
+      emit_line_table {false},
+      tree {nullptr} {
+    using enum Value::Data::Type;
+
+    vector_builtins[sigil::Names().Intern("Vec2")]  = {Op::VecMake, Vec2};
+    vector_builtins[sigil::Names().Intern("Vec3")]  = {Op::VecMake, Vec3};
+    vector_builtins[sigil::Names().Intern("Vec4")]  = {Op::VecMake, Vec4};
+    vector_builtins[sigil::Names().Intern("Vec2i")] = {Op::VecMake, Vec2i};
+
+    vector_builtins[sigil::Names().Intern("Dot")]       = {Op::VecDot};
+    vector_builtins[sigil::Names().Intern("Cross")]     = {Op::VecCross};
+    vector_builtins[sigil::Names().Intern("Length")]    = {Op::VecLength};
+    vector_builtins[sigil::Names().Intern("Normalize")] = {Op::VecNormalize};
+
+    container_builtins[sigil::Names().Intern("ListFill")]   = Op::ListFill;
+    container_builtins[sigil::Names().Intern("ListCopy")]   = Op::ListCopy;
+    container_builtins[sigil::Names().Intern("ListSlice")]  = Op::ListSlice;
+    container_builtins[sigil::Names().Intern("ListSum")]    = Op::ListSum;
+    container_builtins[sigil::Names().Intern("ListMin")]    = Op::ListMin;
+    container_builtins[sigil::Names().Intern("ListMax")]    = Op::ListMax;
+    container_builtins[sigil::Names().Intern("ListFind")]   = Op::ListFind;
+    container_builtins[sigil::Names().Intern("ListSort")]   = Op::ListSort;
+    container_builtins[sigil::Names().Intern("ListAdd")]    = Op::ListAdd;
+    container_builtins[sigil::Names().Intern("ListMul")]    = Op::ListMul;
+    container_builtins[sigil::Names().Intern("MapGet")]     = Op::MapGet;
+    container_builtins[sigil::Names().Intern("MapSet")]     = Op::MapSet;
+    container_builtins[sigil::Names().Intern("MapHas")]     = Op::MapHas;
+    container_builtins[sigil::Names().Intern("MapRemove")]  = Op::MapRemove;
+    container_builtins[sigil::Names().Intern("MapCount")]   = Op::MapCount;
+    container_builtins[sigil::Names().Intern("MapKeyAt")]   = Op::MapKeyAt;
+    container_builtins[sigil::Names().Intern("MapValueAt")] = Op::MapValueAt;
+}
 
 ByteCode BytecodeGenerator::Bytecode() const {
     return bytecode;
 }
 
+void BytecodeGenerator::EmitLineTable(const std::string_view source_name) {
+    emit_line_table = true;
+    bytecode.SetSourceName(source_name);
+}
+
 void BytecodeGenerator::ObtainSemanticAnalysisInfo(const sigil::SemanticAnalyzer& analyzer) {
-    for (const auto name : analyzer.Globals() | std::views::keys) {
-        AddSymbol(name, global_registers.Allocate());
-        global_registers.Lock(symbols[name].register_index);
+    for (const auto& global : analyzer.Globals()) {
+        const auto reg = global_registers.Allocate();
+        AddSymbol(global.name, reg);
+        global_registers.Lock(reg);
     }
 
     for (const auto& info : analyzer.Types() | std::views::values) {
@@ -34,25 +221,39 @@ void BytecodeGenerator::ObtainSemanticAnalysisInfo(const sigil::SemanticAnalyzer
             auto& fn = functions[name];
 
             fn.return_type = in_func.return_type;
-            fn.registers.Reserve(in_func.locals.size());
+            fn.registers.Reserve(in_func.param_types.size() + in_func.local_count);
+
+            // natives never get declared, so this is the only place to learn their arity
+            if (in_func.is_native) {
+                fn.is_native   = true;
+                fn.param_count = in_func.param_count;
+            }
         }
     }
 }
 
-void BytecodeGenerator::Visit(const Artifact& artifact) {
-    for (const auto& decl : artifact.GetChildren()) {
-        decl->Accept(*this);
+void BytecodeGenerator::Generate(const FlatTree& flat_tree) {
+    tree = &flat_tree;
+
+    for (const auto decl : tree->Declarations()) {
+        Generate(decl);
     }
 
-    for (const auto& [index, name] : pending_calls) {
+    tree = nullptr;
+
+    for (const auto& [name, index] : pending_calls) {
         if (not functions.contains(name)) {
-            Log->error("Internal Compiler Error: Attempted to call non-existent function '{}'", name);
+            Log->error("Internal Compiler Error: Attempted to call non-existent function '{}'",
+                       sigil::Names().Name(name)
+            );
             continue;
         }
 
         const auto address = functions.at(name).address;
         if (address < 0) {
-            Log->error("Internal Compiler Error: Attempted to call unresolved function '{}'", name);
+            Log->error("Internal Compiler Error: Attempted to call unresolved function '{}'",
+                       sigil::Names().Name(name)
+            );
             continue;
         }
 
@@ -60,42 +261,154 @@ void BytecodeGenerator::Visit(const Artifact& artifact) {
     }
 
     bytecode.SetMainRegisterFrame(global_registers.Total());
+    ExportFunctions();
 }
 
-void BytecodeGenerator::Visit(const Scope& node) {
+void BytecodeGenerator::Generate(const NodeId node) {
+    using enum NodeKind;
+
+    switch (tree->Kind(node)) {
+    case Scope:
+        GenerateScope(node);
+        break;
+    case FunctionDeclaration:
+        GenerateFunctionDeclaration(node);
+        break;
+    case DataDeclaration:
+        HandleInitializer(node, false);
+        break;
+    case MutableDataDeclaration:
+        HandleInitializer(node, true);
+        break;
+    case Identifier:
+        GenerateIdentifier(node);
+        break;
+    case Assignment:
+        GenerateAssignment(node);
+        break;
+    case ElementAssignment:
+        GenerateElementAssignment(node);
+        break;
+    case Return:
+        GenerateReturn(node);
+        break;
+    case Yield:
+        bytecode.Write(Op::Yield);
+        break;
+    case Invocation:
+        GenerateInvocation(node);
+        break;
+    case If:
+        GenerateIf(node);
+        break;
+    case Loop:
+        GenerateLoop(node);
+        break;
+    case LoopIf:
+        GenerateLoopIf(node);
+        break;
+    case LoopIfPost:
+        GenerateLoopIfPost(node);
+        break;
+    case LoopFixed:
+        GenerateLoopFixed(node);
+        break;
+    case LoopRange:
+        GenerateLoopRange(node);
+        break;
+    case LoopRangeMutable:
+        GenerateLoopRangeMutable(node);
+        break;
+    case LoopRangeParallel:
+        GenerateLoopRangeParallel(node);
+        break;
+    case Break:
+        HandleLoopControl(true, node);
+        break;
+    case Skip:
+        HandleLoopControl(false, node);
+        break;
+    case Unary:
+        GenerateUnary(node);
+        break;
+    case Binary:
+        GenerateBinary(node);
+        break;
+    case List:
+        GenerateList(node);
+        break;
+    case Map: {
+        // maps always start out empty
+        const auto reg = Registers().Allocate();
+        bytecode.Write(Op::MapCreate, {static_cast<u16>(tree->ListType(node)), reg});
+        register_buffer.push_back(reg);
+        break;
+    }
+    case ListAccess:
+        GenerateListAccess(node);
+        break;
+    case LiteralBool:
+        CreateLiteral(tree->Bool(node));
+        break;
+    case LiteralInt:
+        CreateLiteral(tree->Int(node));
+        break;
+    case LiteralFloat:
+        CreateLiteral(tree->Float(node));
+        break;
+    case LiteralString:
+        CreateLiteral(tree->String(node));
+        break;
+    }
+}
+
+void BytecodeGenerator::GenerateScope(const NodeId node) {
     EnterScope();
+    GenerateStatements(node);
+    ExitScope();
+}
+
+void BytecodeGenerator::GenerateStatements(const NodeId node) {
+    for (const auto statement : tree->Children(node)) {
+        if (emit_line_table) {
+            const auto location = tree->Location(statement);
+            bytecode.MarkSource(location.line, location.column);
+        }
 
-    for (const auto& statement : node.GetStatements()) {
-        statement->Accept(*this);
+        Generate(statement);
 
         Registers().Free(register_buffer);
         register_buffer.clear();
     }
-
-    ExitScope();
 }
 
-void BytecodeGenerator::Visit(const FunctionDeclaration& node) {
-    const auto& name   = node.GetName();
-    const auto& params = node.GetParameters();
-    const auto& body   = node.GetBody();
+void BytecodeGenerator::GenerateFunctionDeclaration(const NodeId node) {
+    const auto& decl  = tree->Function(node);
+    const auto name   = decl.name;
+    const auto params = tree->Parameters(node);
+    const auto body   = tree->Child(node, 0);
 
     auto& fn = functions[name];
 
-    fn.return_type = node.GetReturnType();
+    fn.return_type = decl.return_type;
     fn.address     = bytecode.CurrentAddress();
+    fn.param_count = static_cast<u8>(params.size());
 
-    ++scope;
+    function_stack.push_back(name);
+
+    // parameters get a scope of their own, around the body's
+    EnterScope();
     {
         const auto param_regs = fn.registers.ViewLocked();
         for (i64 i = 0; i < params.size(); ++i) {
             AddSymbol(params[i].name, param_regs[i]);
         }
     }
-    --scope;
 
-    function_stack.push_back(name);
-    body->Accept(*this);
+    Generate(body);
+
+    // callers find the parameters through the frame's locked registers, so they stay locked
+    symbols.ExitScope();
     function_stack.pop_back();
 
 
@@ -108,76 +421,84 @@ void BytecodeGenerator::Visit(const FunctionDeclaration& node) {
     }
     // functions that return nothing return automatically at the end of their scope
     using enum sigil::PrimitiveType;
-    if (fn.return_type == PrimitiveName(None) && bytecode.LatestOpcode() != Op::Return) {
+    if (fn.return_type == PrimitiveID(None) && bytecode.LatestOpcode() != Op::Return) {
         ReturnNone();
     }
 }
 
-void BytecodeGenerator::Visit(const MutableDataDeclaration& node) {
-    HandleInitializer(node, true);
-}
-
-void BytecodeGenerator::Visit(const DataDeclaration& node) {
-    HandleInitializer(node, false);
-}
-
-void BytecodeGenerator::Visit(const Identifier& node) {
+void BytecodeGenerator::GenerateIdentifier(const NodeId node) {
     // even though input is assumed to be correct
     // we don't wanna fail silently if semantic analysis fails
-    if (const auto it = symbols.find(node.GetName());
-        it != symbols.end()) {
-        register_buffer.push_back(it->second.register_index);
+    if (const auto* reg = symbols.Find(tree->Name(node))) {
+        register_buffer.push_back(*reg);
     }
 }
 
-void BytecodeGenerator::Visit(const Assignment& node) {
-    const auto& symbol = symbols[node.GetIdentifier()];
+void BytecodeGenerator::GenerateAssignment(const NodeId node) {
+    const auto* symbol = symbols.Find(tree->Name(node));
+    if (symbol == nullptr) {
+        Log->error("Internal Compiler Error: Attempted to assign to unknown symbol '{}'",
+                   sigil::Names().Name(tree->Name(node))
+        );
+        return;
+    }
+    const auto lhs = *symbol;
 
-    node.GetValue()->Accept(*this);
+    Generate(tree->Child(node, 0));
 
     const auto rhs = PopRegBuffer();
-    const auto lhs = symbol.register_index;
 
-    const auto op = node.GetOp();
-    if (op == "=") {
+    const auto op = tree->Operator(node);
+    if (op == sigil::TokenType::Op_Assign) {
         bytecode.Write(Op::Move, {lhs, rhs});
+    } else if (IsVector(tree->OperandType(node, 0))) {
+        WriteVectorOperation(bytecode, op, lhs, lhs, rhs, true);
     } else {
-        auto operation = Op::Err;
-        switch (op[0]) {
-        case '+':
-            operation = Op::Add;
-            break;
-        case '-':
-            operation = Op::Sub;
-            break;
-        case '*':
-            operation = Op::Mul;
-            break;
-        case '/':
-            operation = Op::Div;
-            break;
-        case '%':
-            operation = Op::Mod;
-            break;
-        default:
-            break;
-        }
-
-        bytecode.Write(operation, {lhs, lhs, rhs});
+        bytecode.Write(CompoundOperation(op), {lhs, lhs, rhs});
     }
 
     Registers().Free(rhs);
 }
 
-void BytecodeGenerator::Visit(const Return& node) {
+void BytecodeGenerator::GenerateElementAssignment(const NodeId node) {
+    const auto* symbol = symbols.Find(tree->Name(node));
+    if (symbol == nullptr) {
+        Log->error("Internal Compiler Error: Attempted to assign to element of unknown symbol '{}'",
+                   sigil::Names().Name(tree->Name(node))
+        );
+        return;
+    }
+    const auto list = *symbol;
+
+    Generate(tree->Child(node, 0));
+    const auto index = PopRegBuffer();
+
+    Generate(tree->Child(node, 1));
+    const auto rhs = PopRegBuffer();
+
+    const auto op           = tree->Operator(node);
+    const auto element_type = tree->OperandType(node, 0);
+    if (op == sigil::TokenType::Op_Assign) {
+        bytecode.Write(ListStoreOp(element_type), {list, index, rhs});
+    } else {
+        const auto element = Registers().Allocate();
+        bytecode.Write(ListReadOp(element_type), {list, index, element});
+        bytecode.Write(CompoundOperation(op), {element, element, rhs});
+        bytecode.Write(ListStoreOp(element_type), {list, index, element});
+        Registers().Free(element);
+    }
+
+    Registers().Free({index, rhs});
+}
+
+void BytecodeGenerator::GenerateReturn(const NodeId node) {
     if (sigil::IsEntryPoint(CurrentFunctionName())) {
         bytecode.Write(Op::Halt);
         return;
     }
 
-    const auto& return_expr = node.GetExpression();
-    if (return_expr != nullptr) {
-        return_expr->Accept(*this);
+    if (tree->ChildCount(node) != 0) {
+        Generate(tree->Child(node, 0));
         const auto return_value = PopRegBuffer();
 
         bytecode.Write(Op::Return, {return_value});
@@ -188,24 +509,24 @@ void BytecodeGenerator::Visit(const Return& node) {
     }
 }
 
-void BytecodeGenerator::Visit(const Invocation& node) {
-    const auto name  = node.GetIdentifier();
-    const auto& args = node.GetArguments();
-    const auto& fn   = functions[name];
+void BytecodeGenerator::GenerateInvocation(const NodeId node) {
+    const auto name = tree->Name(node);
+    const auto args = tree->Children(node);
+    const auto& fn  = functions[name];
 
     // handle print
-    if (name == "Print") {
-        args[0]->Accept(*this);
+    if (name == print_name) {
+        Generate(args[0]);
         bytecode.Write(Op::Print, {PopRegBuffer()});
 
         register_buffer.push_back(REGISTER_RETURN);
         return;
     }
 
-    if (name == "PrintV") {
-        args[0]->Accept(*this);
+    if (name == printv_name) {
+        Generate(args[0]);
         const auto str_reg = PopRegBuffer();
-        args[1]->Accept(*this);
+        Generate(args[1]);
         const auto val = PopRegBuffer();
 
         bytecode.Write(Op::PrintValue, {str_reg, val});
@@ -214,16 +535,44 @@ void BytecodeGenerator::Visit(const Invocation& node) {
         return;
     }
 
-    HandleInvocationArguments(node.GetArguments(), fn.registers.ViewLocked());
+    if (vector_builtins.contains(name)) {
+        GenerateVectorBuiltin(node, vector_builtins.at(name));
+        return;
+    }
+
+    if (container_builtins.contains(name)) {
+        GenerateContainerBuiltin(node, container_builtins.at(name));
+        return;
+    }
+
+    // a native's arguments are laid out just like a callee's parameters,
+    // so it can read them straight out of the registers past the caller's
+    if (fn.is_native) {
+        std::vector<Register> params(args.size());
+        std::iota(params.begin(), params.end(), Register {0});
+        HandleInvocationArguments(args, params);
+
+        // only natives which are actually called get imported
+        const auto import = bytecode.AddImport(sigil::Names().Name(name), fn.param_count);
+        bytecode.Write(Op::CallNative, {import, Registers().Total()});
+
+        register_buffer.push_back(REGISTER_RETURN);
+        return;
+    }
+
+    HandleInvocationArguments(args, fn.registers.ViewLocked());
 
     if (fn.address == bytecode.CurrentAddress()) {
-        Log->error("Internal Compiler Error: Invocation {} jumps to call site '{}'", name, fn.address);
+        Log->error("Internal Compiler Error: Invocation {} jumps to call site '{}'",
+                   sigil::Names().Name(name),
+                   fn.address
+        );
         return;
     }
 
     if (fn.address < 0) {
-        const auto index     = bytecode.WriteCall(SENTINEL_32, Registers().Total());
-        pending_calls[index] = name;
+        const auto index = bytecode.WriteCall(SENTINEL_32, Registers().Total());
+        pending_calls.emplace_back(name, index);
     } else {
         bytecode.WriteCall(fn.address, Registers().Total());
     }
@@ -231,32 +580,107 @@ void BytecodeGenerator::Visit(const Invocation& node) {
     register_buffer.push_back(REGISTER_RETURN); // functions always return something
 }
 
-void BytecodeGenerator::Visit(const If& node) {
-    node.GetCondition()->Accept(*this);
+void BytecodeGenerator::GenerateVectorBuiltin(const NodeId node, const VectorBuiltin& builtin) {
+    std::vector<Register> args;
+    for (const auto arg : tree->Children(node)) {
+        Generate(arg);
+        args.push_back(PopRegBuffer());
+    }
+
+    const auto dst = Registers().Allocate();
+
+    switch (args.size()) {
+    case 1:
+        bytecode.Write(builtin.op, {dst, args[0]});
+        break;
+    case 2:
+        if (builtin.op != Op::VecMake) {
+            bytecode.Write(builtin.op, {dst, args[0], args[1]});
+            break;
+        }
+        [[fallthrough]];
+    default: {
+        // VecMake always takes four lanes, Hex ignores the ones past the vector's width
+        std::array<Register, 4> lanes;
+        for (u8 i = 0; i < lanes.size(); ++i) {
+            lanes[i] = args[std::min<usize>(i, args.size() - 1)];
+        }
+
+        bytecode.Write(Op::VecMake, {static_cast<u16>(builtin.type), dst, lanes[0], lanes[1], lanes[2], lanes[3]});
+        break;
+    }
+    }
+
+    register_buffer.push_back(dst);
+    Registers().Free(args);
+}
+
+void BytecodeGenerator::GenerateContainerBuiltin(const NodeId node, const Op op) {
+    std::vector<Register> args;
+    for (const auto arg : tree->Children(node)) {
+        Generate(arg);
+        args.push_back(PopRegBuffer());
+    }
+
+    // the in-place ones work on the binding's own register, and return none like Print
+    if (op == Op::ListFill || op == Op::ListCopy || op == Op::ListSort || op == Op::MapSet) {
+        if (op == Op::ListSort) {
+            bytecode.Write(op, {args[0]});
+        } else if (op == Op::MapSet) {
+            bytecode.Write(op, {args[0], args[1], args[2]});
+        } else {
+            bytecode.Write(op, {args[0], args[1]});
+        }
+
+        register_buffer.push_back(REGISTER_RETURN);
+        Registers().Free(args);
+        return;
+    }
+
+    const auto dst = Registers().Allocate();
+
+    switch (args.size()) {
+    case 1:
+        bytecode.Write(op, {dst, args[0]});
+        break;
+    case 2:
+        bytecode.Write(op, {dst, args[0], args[1]});
+        break;
+    default:
+        bytecode.Write(op, {dst, args[0], args[1], args[2]});
+        break;
+    }
+
+    register_buffer.push_back(dst);
+    Registers().Free(args);
+}
+
+void BytecodeGenerator::GenerateIf(const NodeId node) {
+    Generate(tree->Child(node, 0));
     const auto cond_reg = PopRegBuffer();
 
     const i64 jmp_false = bytecode.Write(Op::JumpWhenFalse, {cond_reg, SENTINEL});
     Registers().Free(cond_reg);
 
-    node.GetThenBlock()->Accept(*this);
+    Generate(tree->Child(node, 1));
 
-    if (const auto& else_branch = node.GetElseBranch()) {
+    if (tree->ChildCount(node) == 3) {
         const i64 jmp_end = bytecode.Write(Op::Jump, {SENTINEL});
         PatchJumpForwardConditional(jmp_false);
 
-        else_branch->Accept(*this);
+        Generate(tree->Child(node, 2));
         PatchJumpForward(jmp_end);
     } else {
         PatchJumpForwardConditional(jmp_false);
     }
 }
 
-void BytecodeGenerator::Visit(const Loop& node) {
+void BytecodeGenerator::GenerateLoop(const NodeId node) {
     EnterLoop();
 
     const i64 start_addr = bytecode.CurrentAddress();
 
-    node.GetBody()->Accept(*this);
+    Generate(tree->Child(node, 0));
 
     // calc skips before loop ends so we don't jump over them
     // this also helps resolve end-of-loop logic in other types of loops
@@ -271,19 +695,19 @@ void BytecodeGenerator::Visit(const Loop& node) {
     ExitLoop();
 }
 
-void BytecodeGenerator::Visit(const LoopIf& node) {
+void BytecodeGenerator::GenerateLoopIf(const NodeId node) {
     EnterLoop();
 
     const i64 start_addr = bytecode.CurrentAddress();
 
-    node.GetCondition()->Accept(*this);
+    Generate(tree->Child(node, 0));
     const auto condition = PopRegBuffer();
 
     // the jump out of the loop needs to happen immediately after condition evaluation
     const i64 jmp_end = bytecode.Write(Op::JumpWhenFalse, {condition, SENTINEL});
     Registers().Free(condition);
 
-    node.GetBody()->Accept(*this);
+    Generate(tree->Child(node, 1));
     HandlePendingSkips();
 
     JumpBackwards(start_addr);
@@ -295,17 +719,17 @@ void BytecodeGenerator::Visit(const LoopIf& node) {
 }
 
 // same as LoopIf, except we do the condition evaluation after the body
-void BytecodeGenerator::Visit(const LoopIfPost& node) {
+void BytecodeGenerator::GenerateLoopIfPost(const NodeId node) {
     EnterLoop();
 
     const i64 start_addr = bytecode.CurrentAddress();
 
-    node.GetBody()->Accept(*this);
+    Generate(tree->Child(node, 0));
 
     HandlePendingSkips();
 
     // end of loop
-    node.GetCondition()->Accept(*this);
+    Generate(tree->Child(node, 1));
     const auto condition = PopRegBuffer();
     JumpBackwardsConditional(Op::JumpWhenTrue, condition, start_addr);
 
@@ -316,41 +740,17 @@ void BytecodeGenerator::Visit(const LoopIfPost& node) {
     ExitLoop();
 }
 
-void BytecodeGenerator::Visit(const LoopRange& node) {
+void BytecodeGenerator::GenerateLoopRange(const NodeId node) {
     EnterLoop();
 
-    const auto range = PerformRangeLoopSetup(node);
-
-    // we add or subtract 1 since ranges are inclusive
-    // this lets us compare to "equals" rather than jwf greater/lesser
-    bytecode.Write(Op::Add, {range.end, range.end, range.step});
-
-    const auto cond = Registers().Allocate();
-
-    // loop starts here
-    const i64 start_addr = bytecode.CurrentAddress();
-
-    bytecode.Write(Op::Equals, {cond, range.counter, range.end});
-    const i64 exit = bytecode.Write(Op::JumpWhenTrue, {cond, SENTINEL});
-
-    node.GetBody()->Accept(*this);
-    HandlePendingSkips();
-
-    bytecode.Write(Op::Add, {range.counter, range.counter, range.step});
-    JumpBackwards(start_addr);
-    PatchJumpForwardConditional(exit);
-
-    Registers().Free(cond);
-    Registers().Free(range.counter);
-    Registers().Free(range.step);
-    Registers().Free(range.end);
+    GenerateRangeLoopBody(node, PerformRangeLoopSetup(node));
 
     HandlePendingBreaks();
 
     ExitLoop();
 }
 
-void BytecodeGenerator::Visit(const LoopRangeMutable& node) {
+void BytecodeGenerator::GenerateLoopRangeMutable(const NodeId node) {
     EnterLoop();
 
     const auto range = PerformRangeLoopSetup(node);
@@ -374,7 +774,9 @@ void BytecodeGenerator::Visit(const LoopRangeMutable& node) {
     bytecode.Write(Op::Cmp_GreaterEq, {cond, diff, zero});
     const i64 exit = bytecode.Write(Op::JumpWhenFalse, {cond, SENTINEL});
 
-    node.GetBody()->Accept(*this);
+    // the counter's scope was entered during setup
+    GenerateStatements(tree->Children(node).back());
+    ExitScope();
 
     HandlePendingSkips();
 
@@ -395,7 +797,71 @@ void BytecodeGenerator::Visit(const LoopRangeMutable& node) {
     ExitLoop();
 }
 
-void BytecodeGenerator::Visit(const LoopFixed& node) {
+// the body becomes an ascending loop over the registers 'first' and 'last', ending in a Join
+// Hex either runs it as is, or hands every worker a slice of the range, see Op::ParallelFor
+void BytecodeGenerator::GenerateLoopRangeParallel(const NodeId node) {
+    EnterLoop();
+
+    const auto parts = tree->Children(node);
+
+    Register origin;
+    if (parts.size() < 3) {
+        origin = Registers().Allocate();
+        bytecode.Write(Op::LoadConstant, {origin, bytecode.AddConstant(0)});
+    } else {
+        Generate(parts[0]);
+        origin = PopRegBuffer();
+    }
+
+    Generate(parts[parts.size() - 2]);
+    const auto destination = PopRegBuffer();
+
+    // workers borrow every register below the slice bounds, so the body can't reuse the free ones among them
+    const auto shared = Registers().Total();
+
+    std::vector<Register> held;
+    for (auto reg = Registers().Allocate(); reg < shared; reg = Registers().Allocate()) {
+        held.push_back(reg);
+    }
+    Registers().Free(shared);
+
+    const auto first = Registers().Allocate();
+    const auto last  = Registers().Allocate();
+
+    // either way round, the range is visited in ascending order
+    const auto is_ascending = Registers().Allocate();
+    bytecode.Write(Op::Cmp_LesserEq, {is_ascending, origin, destination});
+    bytecode.Write(Op::Move, {first, origin});
+    bytecode.Write(Op::Move, {last, destination});
+
+    const i64 swap_jmp = bytecode.Write(Op::JumpWhenTrue, {is_ascending, SENTINEL});
+    bytecode.Write(Op::Move, {first, destination});
+    bytecode.Write(Op::Move, {last, origin});
+    PatchJumpForwardConditional(swap_jmp);
+    Registers().Free(is_ascending);
+
+    const i64 fork = bytecode.Write(Op::ParallelFor, {shared, SENTINEL});
+
+    EnterScope();
+    const auto counter = Registers().Allocate();
+    AddSymbol(tree->Name(node), counter);
+    bytecode.Write(Op::Move, {counter, first});
+
+    const auto step = Registers().Allocate();
+    bytecode.Write(Op::LoadConstant, {step, bytecode.AddConstant(1)});
+
+    GenerateRangeLoopBody(node, {last, step, counter});
+
+    bytecode.Write(Op::Join);
+    PatchJumpForwardConditional(fork);
+
+    Registers().Free({first, origin, destination});
+    Registers().Free(held);
+
+    ExitLoop();
+}
+
+void BytecodeGenerator::GenerateLoopFixed(const NodeId node) {
     EnterLoop();
 
     const auto counter = Registers().Allocate();
@@ -404,12 +870,8 @@ void BytecodeGenerator::Visit(const LoopFixed& node) {
     const auto step = Registers().Allocate();
     bytecode.Write(Op::LoadConstant, {step, bytecode.AddConstant(1)});
 
-    // we haven't entered the body yet, but the target belongs to that scope
-    // since the target may be a literal, we need to do it like this
-    ++scope;
-    node.GetCountTarget()->Accept(*this);
+    Generate(tree->Child(node, 0));
     const auto target = PopRegBuffer();
-    --scope;
 
     const i64 start_addr = bytecode.CurrentAddress();
 
@@ -419,7 +881,7 @@ void BytecodeGenerator::Visit(const LoopFixed& node) {
     bytecode.Write(Op::Cmp_Lesser, {cond, counter, target});
     const i64 exit = bytecode.Write(Op::JumpWhenFalse, {cond, SENTINEL});
 
-    node.GetBody()->Accept(*this);
+    Generate(tree->Child(node, 1));
 
     HandlePendingSkips();
 
@@ -439,29 +901,35 @@ void BytecodeGenerator::Visit(const LoopFixed& node) {
     ExitLoop();
 }
 
-void BytecodeGenerator::Visit(const Break& node) {
-    HandleLoopControl(true, node.GetCondition());
-}
-
-void BytecodeGenerator::Visit(const Skip& node) {
-    HandleLoopControl(false, node.GetCondition());
-}
-
-void BytecodeGenerator::Visit(const UnaryExpr& node) {
-    node.GetVal().Accept(*this);
-    const auto op_text = node.GetOp();
+void BytecodeGenerator::GenerateUnary(const NodeId node) {
+    Generate(tree->Child(node, 0));
+    const auto op_token = tree->Operator(node);
 
     auto src = PopRegBuffer();
     auto dst = Registers().Allocate();
 
+    // vectors are negated by scaling them by -1
+    if (const auto type = tree->OperandType(node, 0); IsVector(type)) {
+        if (type == Value::Data::Type::Vec2i) {
+            CreateLiteral(i64 {-1});
+        } else {
+            CreateLiteral(-1.0);
+        }
+
+        const auto factor = PopRegBuffer();
+        bytecode.Write(Op::VecScale, {dst, src, factor});
+
+        register_buffer.push_back(dst);
+        Registers().Free({src, factor});
+        return;
+    }
+
     Op op;
-    switch (op_text[0]) {
-    case '-':
+    switch (op_token) {
+    case sigil::TokenType::Op_Minus:
         op = Op::Negate;
         break;
-    case 'n': // 'not'
-        [[fallthrough]];
-    case '!':
+    case sigil::TokenType::Op_LogicalNot:
         op = Op::Not;
         break;
     default:
@@ -475,12 +943,16 @@ void BytecodeGenerator::Visit(const UnaryExpr& node) {
     Registers().Free(src);
 }
 
-void BytecodeGenerator::Visit(const BinaryExpr& node) {
-    const auto op_text = node.GetOp();
+void BytecodeGenerator::GenerateBinary(const NodeId node) {
+    using enum sigil::TokenType;
+
+    const auto op_token = tree->Operator(node);
+    const auto left     = tree->Child(node, 0);
+    const auto right    = tree->Child(node, 1);
 
     // logical ops need special treatment as they are control flow due to short-circuiting
-    const auto jump = [this, &node](const Op jump_op) {
-        node.GetLeft().Accept(*this);
+    const auto jump = [this, left, right](const Op jump_op) {
+        Generate(left);
 
         const auto lhs = PopRegBuffer();
         const auto dst = Registers().Allocate();
@@ -489,7 +961,7 @@ void BytecodeGenerator::Visit(const BinaryExpr& node) {
         const i64 jwf = bytecode.Write(jump_op, {lhs, SENTINEL});
         Registers().Free(lhs);
 
-        node.GetRight().Accept(*this);
+        Generate(right);
         const auto rhs = PopRegBuffer();
         bytecode.Write(Op::Move, {dst, rhs});
 
@@ -499,66 +971,68 @@ void BytecodeGenerator::Visit(const BinaryExpr& node) {
         Registers().Free(rhs);
     };
 
-    if (op_text == "&&") {
+    if (op_token == Op_LogicalAnd) {
         jump(Op::JumpWhenFalse);
         return;
     }
 
-    if (op_text == "||") {
+    if (op_token == Op_LogicalOr) {
         jump(Op::JumpWhenTrue);
         return;
     }
 
-    node.GetLeft().Accept(*this);
-    node.GetRight().Accept(*this);
+    Generate(left);
+    Generate(right);
 
     auto rhs = PopRegBuffer();
     auto lhs = PopRegBuffer();
     auto dst = Registers().Allocate();
 
+    if (const auto lhs_type = tree->OperandType(node, 0); IsVector(lhs_type) || IsVector(tree->OperandType(node, 1))) {
+        WriteVectorOperation(bytecode, op_token, dst, lhs, rhs, IsVector(lhs_type));
+
+        register_buffer.push_back(dst);
+        Registers().Free({lhs, rhs});
+        return;
+    }
+
     Op op;
-    switch (op_text[0]) {
-    case '+':
+    switch (op_token) {
+    case Op_Plus:
         op = Op::Add;
         break;
-    case '-':
+    case Op_Minus:
         op = Op::Sub;
         break;
-    case '*':
+    case Op_Asterisk:
         op = Op::Mul;
         break;
-    case '/':
+    case Op_FwdSlash:
         op = Op::Div;
         break;
-    case '%':
+    case Op_Modulo:
         op = Op::Mod;
         break;
-    case '>':
-        if (op_text == ">=") {
-            op = Op::Cmp_GreaterEq;
-            break;
-        }
+    case Op_GreaterEqual:
+        op = Op::Cmp_GreaterEq;
+        break;
+    case Op_GreaterThan:
         op = Op::Cmp_Greater;
         break;
-    case '<':
-        if (op_text == "<=") {
-            op = Op::Cmp_LesserEq;
-            break;
-        }
+    case Op_LessEqual:
+        op = Op::Cmp_LesserEq;
+        break;
+    case Op_LessThan:
         op = Op::Cmp_Lesser;
         break;
-    case '=':
-        if (op_text == "==") {
-            op = Op::Equals;
-            break;
-        }
-    case '!':
-        if (op_text == "!=") {
-            op = Op::NotEquals;
-            break;
-        }
+    case Op_Equality:
+        op = Op::Equals;
+        break;
+    case Op_NotEqual:
+        op = Op::NotEquals;
+        break;
     default:
-        Log->error("Internal Compiler Error: Unknown Binary Operator '{}'", node.GetOp());
+        Log->error("Internal Compiler Error: Unknown Binary Operator '{}'", magic_enum::enum_name(op_token));
         return;
     }
 
@@ -568,8 +1042,8 @@ void BytecodeGenerator::Visit(const BinaryExpr& node) {
 }
 
 // we'll add arrays eventually
-void BytecodeGenerator::Visit(const ListExpression& list) {
-    const auto values = list.GetValues();
+void BytecodeGenerator::GenerateList(const NodeId node) {
+    const auto values = tree->Children(node);
 
     if (values.size() >= std::numeric_limits<u16>::max()) {
         Log->critical(
@@ -580,45 +1054,61 @@ void BytecodeGenerator::Visit(const ListExpression& list) {
     }
 
     const auto reg    = Registers().Allocate();
-    const auto length = static_cast<u16>(values.size() * sizeof(Value::Data));
-    bytecode.Write(Op::ListCreate, {static_cast<u16>(list.GetType()), length, reg});
+    const auto type   = tree->ListType(node);
+    const auto length = static_cast<u16>(values.size());
+
+    const bool packed = Value::ElementSize(type) < sizeof(Value::Data);
+
+    // packed lists of literals are laid out ahead of time, and loaded as a single constant
+    if (packed && std::ranges::all_of(values, [this](const NodeId v) { return IsPackable(*tree, v); })) {
+        auto list = Value {static_cast<u8>(type), length};
+        for (u16 i = 0; i < length; ++i) {
+            PackElement(list, i, *tree, values[i]);
+        }
+
+        bytecode.Write(Op::LoadConstant, {reg, bytecode.AddArray(std::move(list))});
+        Registers().Lock(reg);
+        register_buffer.push_back(reg);
+        return;
+    }
+
+    bytecode.Write(Op::ListCreate, {static_cast<u16>(type), length, reg});
 
-    for (u16 i = 0; i < values.size(); ++i) {
-        values[i]->Accept(*this);
+    for (u16 i = 0; i < length; ++i) {
+        Generate(values[i]);
         const auto value = PopRegBuffer();
-        bytecode.Write(Op::ListWrite, {reg, i, value});
+
+        // packed elements can only be written through a register index
+        if (packed) {
+            CreateLiteral(i64 {i});
+            const auto index = PopRegBuffer();
+            bytecode.Write(ListStoreOp(type), {reg, index, value});
+            Registers().Free(index);
+        } else {
+            bytecode.Write(Op::ListWrite, {reg, i, value});
+        }
     }
 
     Registers().Lock(reg);
     register_buffer.push_back(reg);
 }
 
-void BytecodeGenerator::Visit(const ListAccess& access) {
-    access.GetItem()->Accept(*this);
+void BytecodeGenerator::GenerateListAccess(const NodeId node) {
+    Generate(tree->Child(node, 0));
     const auto item = PopRegBuffer();
 
-    access.GetIndex()->Accept(*this);
+    Generate(tree->Child(node, 1));
     const auto index = PopRegBuffer();
     const auto dst   = Registers().Allocate();
-    bytecode.Write(Op::ListRead, {item, index, dst});
-
-    register_buffer.push_back(dst);
-}
-
-void BytecodeGenerator::Visit(const Literal<f64>& float64) {
-    CreateLiteral(float64.Get());
-}
-
-void BytecodeGenerator::Visit(const Literal<i64>& int64) {
-    CreateLiteral(int64.Get());
-}
 
-void BytecodeGenerator::Visit(const Literal<bool>& boolean) {
-    CreateLiteral(boolean.Get());
-}
+    // vectors are indexed by lane
+    if (IsVector(tree->OperandType(node, 0))) {
+        bytecode.Write(Op::VecLane, {dst, item, index});
+    } else {
+        bytecode.Write(ListReadOp(tree->OperandType(node, 0)), {item, index, dst});
+    }
 
-void BytecodeGenerator::Visit(const StringLiteral& string) {
-    CreateLiteral(string.Get());
+    register_buffer.push_back(dst);
 }
 
 bool BytecodeGenerator::IsConditionalJumpOp(const Op op) const {
@@ -709,21 +1199,40 @@ BytecodeGenerator::Function& BytecodeGenerator::CurrentFunction() {
     return functions.at(function_stack.back());
 }
 
-std::string_view BytecodeGenerator::CurrentFunctionName() const {
+sigil::NameID BytecodeGenerator::CurrentFunctionName() const {
     return function_stack.back();
 }
 
-void BytecodeGenerator::HandleInvocationArguments(std::span<const NodePtr> args, std::span<const Register> param_regs) {
+void BytecodeGenerator::ExportFunctions() {
+    std::vector<std::pair<sigil::NameID, const Function*>> exported;
+    for (const auto& [name, fn] : functions) {
+        // builtins never get an address
+        if (fn.address >= 0 && not sigil::IsEntryPoint(name)) {
+            exported.emplace_back(name, &fn);
+        }
+    }
+
+    // listed in code order, like a disassembly would show them
+    std::ranges::sort(exported, {}, [](const auto& entry) {
+        return entry.second->address;
+    });
+
+    for (const auto& [name, fn] : exported) {
+        bytecode.AddExport(sigil::Names().Name(name), fn->address, fn->registers.Total(), fn->param_count);
+    }
+}
+
+void BytecodeGenerator::HandleInvocationArguments(std::span<const NodeId> args, std::span<const Register> param_regs) {
     std::vector<Register> arg_regs;
     arg_regs.reserve(args.size());
 
-    for (const auto& arg : args) {
-        arg->Accept(*this);
+    for (const auto arg : args) {
+        Generate(arg);
         arg_regs.push_back(PopRegBuffer());
     }
 
     for (i64 i = 0; i < arg_regs.size(); ++i) {
-        const u8 dst = param_regs[i] + Registers().Total();
+        const Register dst = param_regs[i] + Registers().Total();
         bytecode.Write(Op::Move, {dst, arg_regs[i]});
     }
 
@@ -735,24 +1244,13 @@ void BytecodeGenerator::ReturnNone() {
 }
 
 void BytecodeGenerator::EnterScope() {
-    ++scope;
+    symbols.EnterScope();
 }
 
 void BytecodeGenerator::ExitScope() {
-    std::vector<std::string_view> deleted_symbols;
-    deleted_symbols.reserve(symbols.size());
-
-    for (const auto& [name, symbol] : symbols) {
-        if (symbol.scope == scope) {
-            deleted_symbols.push_back(name);
-        }
-    }
-
-    for (const auto& name : deleted_symbols) {
-        RemoveSymbol(name);
-    }
-
-    --scope;
+    symbols.ExitScope([this](const SymbolTable::Binding& symbol) {
+        Registers().Unlock(symbol.value);
+    });
 }
 
 void BytecodeGenerator::EnterLoop() {
@@ -763,42 +1261,35 @@ void BytecodeGenerator::ExitLoop() {
     loop_stack.pop_back();
 }
 
-void BytecodeGenerator::AddSymbol(const std::string_view name, const Register index) {
-    // as it stands, duplicate symbol names across different functions get clobbered
-    // but this isn't a big deal because the BCG only operates function-locally anyway
-    symbols[name] = {index, scope};
-}
-
-void BytecodeGenerator::RemoveSymbol(const std::string_view name) {
-    if (not symbols.contains(name)) {
-        Log->warn("Internal Compiler Error: Attempted to remove non-existent symbol '{}'", name);
-        return;
-    }
+void BytecodeGenerator::AddSymbol(const sigil::NameID name, const Register index) {
+    // binding a name again shadows it until the scope is left
+    symbols.Add(name, index);
 
-    // prevent duplicate entries in e.g. 'data x = y'
-    const auto reg = symbols[name].register_index;
-    symbols.erase(name);
-    Registers().Free(reg);
+    // temporaries are freed as soon as they're read, which mustn't recycle the binding's register
+    Registers().Lock(index);
 }
 
 BytecodeGenerator::LoopContext& BytecodeGenerator::CurrentLoop() {
     return loop_stack.back();
 }
 
-BytecodeGenerator::RangeLoopRegisters BytecodeGenerator::PerformRangeLoopSetup(const LoopRange& node) {
-    const auto alloc_origin = [this](const NodePtr& origin) {
-        if (origin == nullptr) {
+BytecodeGenerator::RangeLoopRegisters BytecodeGenerator::PerformRangeLoopSetup(const NodeId node) {
+    // the origin is optional, destination and body are not
+    const auto parts = tree->Children(node);
+
+    const auto alloc_origin = [this, parts] {
+        if (parts.size() < 3) {
             const auto reg = Registers().Allocate();
             bytecode.Write(Op::LoadConstant, {reg, bytecode.AddConstant(0)});
             return reg;
         }
 
-        origin->Accept(*this);
+        Generate(parts[0]);
         return PopRegBuffer();
     };
-    const auto origin = alloc_origin(node.GetOrigin());
+    const auto origin = alloc_origin();
 
-    node.GetDestination()->Accept(*this);
+    Generate(parts[parts.size() - 2]);
     const auto destination = PopRegBuffer();
 
     const auto step = Registers().Allocate();
@@ -814,11 +1305,10 @@ BytecodeGenerator::RangeLoopRegisters BytecodeGenerator::PerformRangeLoopSetup(c
     PatchJumpForwardConditional(neg_jmp);
     Registers().Free(is_ascending);
 
-    // counter's scope technically belongs to the loop, so we manually increment it here
-    ++scope;
+    // the counter lives in the body's scope, so the body is generated without entering another
+    EnterScope();
     const auto counter = Registers().Allocate();
-    AddSymbol(node.GetCounterName(), counter);
-    --scope;
+    AddSymbol(tree->Name(node), counter);
 
     bytecode.Write(Op::Move, {counter, origin});
     Registers().Free(origin);
@@ -826,6 +1316,36 @@ BytecodeGenerator::RangeLoopRegisters BytecodeGenerator::PerformRangeLoopSetup(c
     return {destination, step, counter};
 }
 
+void BytecodeGenerator::GenerateRangeLoopBody(const NodeId node, const RangeLoopRegisters range) {
+    // we add or subtract 1 since ranges are inclusive
+    // this lets us compare to "equals" rather than jwf greater/lesser
+    // the end may well be a binding, so it's moved into a register of its own rather than changed
+    const auto end = Registers().Allocate();
+    bytecode.Write(Op::Add, {end, range.end, range.step});
+
+    const auto cond = Registers().Allocate();
+
+    // loop starts here
+    const i64 start_addr = bytecode.CurrentAddress();
+
+    bytecode.Write(Op::Equals, {cond, range.counter, end});
+    const i64 exit = bytecode.Write(Op::JumpWhenTrue, {cond, SENTINEL});
+
+    GenerateStatements(tree->Children(node).back());
+    ExitScope();
+    HandlePendingSkips();
+
+    bytecode.Write(Op::Add, {range.counter, range.counter, range.step});
+    JumpBackwards(start_addr);
+    PatchJumpForwardConditional(exit);
+
+    Registers().Free(cond);
+    Registers().Free(range.counter);
+    Registers().Free(range.step);
+    Registers().Free(range.end);
+    Registers().Free(end);
+}
+
 void BytecodeGenerator::HandlePendingSkips() {
     for (const auto [skip_target, has_condition] : CurrentLoop().pending_skips) {
         if (has_condition) {
@@ -846,13 +1366,13 @@ void BytecodeGenerator::HandlePendingBreaks() {
     }
 }
 
-void BytecodeGenerator::HandleLoopControl(bool is_break, const NodePtr& condition) {
-    const bool has_condition = condition != nullptr;
+void BytecodeGenerator::HandleLoopControl(bool is_break, const NodeId node) {
+    const bool has_condition = tree->ChildCount(node) != 0;
     i64 jump_index;
 
     if (has_condition) {
         // break/skip if cond
-        condition->Accept(*this);
+        Generate(tree->Child(node, 0));
         const auto cond_reg = PopRegBuffer();
 
         jump_index = bytecode.Write(Op::JumpWhenTrue, {cond_reg, SENTINEL});
@@ -866,13 +1386,13 @@ void BytecodeGenerator::HandleLoopControl(bool is_break, const NodePtr& conditio
     buffer.emplace_back(jump_index, has_condition);
 }
 
-void BytecodeGenerator::HandleInitializer(const Initializer& node, bool is_mutable) {
-    const auto name = node.GetName();
+void BytecodeGenerator::HandleInitializer(const NodeId node, bool is_mutable) {
+    const auto name = tree->Name(node);
 
     Register datum;
 
-    if (const auto& init = node.GetInitializer()) {
-        init->Accept(*this);
+    if (tree->ChildCount(node) != 0) {
+        Generate(tree->Child(node, 0));
 
         // may be an identifier or constant
         const auto src = PopRegBuffer();
@@ -883,6 +1403,15 @@ void BytecodeGenerator::HandleInitializer(const Initializer& node, bool is_mutab
     } else {
         datum = Registers().Allocate();
         bytecode.Write(Op::LoadConstant, {datum, bytecode.AddConstant(0.0)});
+
+        // vectors default to zero in every lane, 0.0 reads as 0 for vec2i as well
+        const auto annotation = tree->Name(node, 1);
+        if (annotation >= sigil::PrimitiveID(sigil::PrimitiveType::Vec2)
+            && annotation <= sigil::PrimitiveID(sigil::PrimitiveType::Vec2i)) {
+            const auto type = static_cast<u16>(Value::Data::Type::Vec2) + annotation
+                              - sigil::PrimitiveID(sigil::PrimitiveType::Vec2);
+            bytecode.Write(Op::VecMake, {static_cast<u16>(type), datum, datum, datum, datum, datum});
+        }
     }
 
     AddSymbol(name, datum);
@@ -0,0 +1,183 @@
+#include <circe/core/cache.hpp>
+#include <circe/core/logger.hpp>
+
+#include <crc/CRC.h>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace circe {
+namespace fs = std::filesystem;
+
+namespace {
+constexpr u64 FNV_OFFSET = 0xcbf29ce484222325;
+constexpr u64 FNV_PRIME  = 0x100000001b3;
+
+constexpr std::string_view ENTRY_EXTENSION = ".hexe";
+
+u64 Fnv1a(const std::string_view bytes, u64 hash) {
+    for (const auto byte : bytes) {
+        hash ^= static_cast<u8>(byte);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+const CRC::Table<u32, 32>& CrcTable() {
+    static const CRC::Table<u32, 32> table(CRC::CRC_32());
+    return table;
+}
+
+// unique across threads and processes sharing the cache
+std::string TemporaryName(const CacheKey& key) {
+    static std::atomic<u32> counter = 0;
+    thread_local std::mt19937 rng(std::random_device {}());
+
+    return fmt::format("{}.{:08x}{:08x}.tmp", key.FileName(), rng(), counter++);
+}
+} // namespace
+
+std::string CacheKey::FileName() const {
+    return fmt::format("{:016x}{:08x}{}", fnv, crc, ENTRY_EXTENSION);
+}
+
+CompileCache::CompileCache(fs::path directory, std::string salt, const u64 max_bytes)
+    : directory(std::move(directory)),
+      salt(std::move(salt)),
+      max_bytes(max_bytes) {
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+    if (ec) {
+        Log->warn("Failed to create cache directory '{}': {}", this->directory.string(), ec.message());
+    }
+}
+
+CacheKey CompileCache::Key(const std::string_view source, const std::string_view options) const {
+    // separators keep e.g. salt "ab" + options "c" apart from salt "a" + options "bc"
+    constexpr std::string_view separator {"\0", 1};
+
+    CacheKey key {FNV_OFFSET, 0};
+    for (const auto part : {std::string_view(salt), separator, options, separator, source}) {
+        key.fnv = Fnv1a(part, key.fnv);
+        key.crc = CRC::Calculate(part.data(), part.size(), CrcTable(), key.crc);
+    }
+
+    return key;
+}
+
+bool CompileCache::Restore(const CacheKey& key, const fs::path& output) {
+    const auto entry = directory / key.FileName();
+
+    std::error_code ec;
+    fs::remove(output, ec);
+
+    // another process may evict the entry at any point, in which case this is just a miss
+    fs::create_hard_link(entry, output, ec);
+    if (ec) {
+        ec.clear();
+        fs::copy_file(entry, output, fs::copy_options::overwrite_existing, ec);
+    }
+
+    if (ec) {
+        ++misses;
+        return false;
+    }
+
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    ++hits;
+    return true;
+}
+
+void CompileCache::Store(const CacheKey& key, const std::span<const u8> executable) const {
+    const auto temporary = directory / TemporaryName(key);
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(executable.data()), static_cast<std::streamsize>(executable.size()));
+
+        if (not out) {
+            Log->warn("Failed to write cache entry '{}'", temporary.string());
+            std::error_code ec;
+            fs::remove(temporary, ec);
+            return;
+        }
+    }
+
+    // whoever renames last wins, which is fine, as both wrote the same bytes
+    std::error_code ec;
+    fs::rename(temporary, directory / key.FileName(), ec);
+    if (ec) {
+        Log->warn("Failed to store cache entry '{}': {}", key.FileName(), ec.message());
+        fs::remove(temporary, ec);
+    }
+}
+
+void CompileCache::Evict() const {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type last_used;
+        u64 size;
+    };
+
+    std::vector<Entry> entries;
+    u64 total = 0;
+
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (file.path().extension() != ENTRY_EXTENSION) {
+            continue;
+        }
+
+        std::error_code entry_ec;
+        Entry entry {file.path(), file.last_write_time(entry_ec), file.file_size(entry_ec)};
+        if (entry_ec) {
+            continue;
+        }
+
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+
+    if (total <= max_bytes) {
+        return;
+    }
+
+    std::ranges::sort(entries, {}, &Entry::last_used);
+
+    u64 evicted = 0;
+    for (const auto& entry : entries) {
+        if (total <= max_bytes) {
+            break;
+        }
+
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+            ++evicted;
+        }
+    }
+
+    Log->debug("Evicted {} cache entr{}", evicted, evicted == 1 ? "y" : "ies");
+}
+
+u64 CompileCache::Hits() const {
+    return hits;
+}
+
+u64 CompileCache::Misses() const {
+    return misses;
+}
+
+void CompileCache::LogStatistics() const {
+    const u64 hit_count = hits;
+    const u64 lookups   = hit_count + misses;
+
+    Log->info("Cache: {} of {} lookups hit ({:.1f}%)",
+              hit_count,
+              lookups,
+              lookups > 0 ? 100.0 * static_cast<double>(hit_count) / static_cast<double>(lookups) : 0.0
+    );
+}
+} // namespace circe
@@ -2,15 +2,64 @@
 
 #include <CLI11/CLI11.hpp>
 
+#include <thread>
+
 namespace circe {
-const std::filesystem::path& CompileSettings::InputFilePath() const {
-    return input_path;
+namespace {
+enum Flag : mana::literals::u16 {
+    Verbose   = 1 << 0,
+    ParseTree = 1 << 1,
+    Tokens    = 1 << 2,
+    LineTable = 1 << 3,
+};
+} // namespace
+
+mana::literals::u16 CompileSettings::Flags() const {
+    return (emit_detail ? Verbose : 0)
+           | (emit_ptree ? ParseTree : 0)
+           | (emit_tokens ? Tokens : 0)
+           | (emit_line_table ? LineTable : 0);
+}
+
+CompileSettings CompileSettings::FromFlags(const mana::literals::u16 flags, std::filesystem::path natives_path) {
+    CompileSettings ret;
+    ret.natives_path    = std::move(natives_path);
+    ret.emit_detail     = flags & Verbose;
+    ret.emit_ptree      = flags & ParseTree;
+    ret.emit_tokens     = flags & Tokens;
+    ret.emit_line_table = flags & LineTable;
+    ret.exit_code       = 0;
+    return ret;
+}
+
+const std::vector<std::filesystem::path>& CompileSettings::InputPaths() const {
+    return input_paths;
 }
 
 const std::filesystem::path& CompileSettings::OutputPath() const {
     return output_path;
 }
 
+mana::literals::u32 CompileSettings::JobCount() const {
+    return job_count;
+}
+
+const std::filesystem::path& CompileSettings::CacheDirectory() const {
+    return cache_directory;
+}
+
+mana::literals::u64 CompileSettings::CacheSizeLimit() const {
+    return cache_size_mib * 1024 * 1024;
+}
+
+const std::filesystem::path& CompileSettings::ServerSocket() const {
+    return server_socket;
+}
+
+const std::filesystem::path& CompileSettings::NativesPath() const {
+    return natives_path;
+}
+
 bool CompileSettings::EmitVerbose() const {
     return emit_detail;
 }
@@ -23,6 +72,10 @@ bool CompileSettings::EmitTokens() const {
     return emit_tokens;
 }
 
+bool CompileSettings::EmitLineTable() const {
+    return emit_line_table;
+}
+
 bool CompileSettings::ShouldExit() const {
     return should_exit;
 }
@@ -36,16 +89,49 @@ CompileSettings ParseCommandLineCompileSettings(int argc, char** argv) {
     CompileSettings ret;
 
     cli->set_version_flag("-v,--version", "Sigil v" SIGIL_VER_STRING "\nCirce v" CIRCE_VER_STRING);
-    cli->add_option("input", ret.input_path, "The Mana file to compile.")->required();
+    cli->add_option("input",
+                    ret.input_paths,
+                    "The Mana files to compile. Directories are searched for .mn files recursively."
+    )->required();
 
-    cli->add_option("-o,--output,output",
+    cli->add_option("-o,--output",
                     ret.output_path,
-                    "Path to output to. If left unspecified, Circe will output to the input folder."
+                    "Path to output to. If left unspecified, Circe will output to the input folder. "
+                    "When compiling more than one file, this is a directory, which mirrors the input directories."
+    );
+
+    cli->add_option("-j,--jobs",
+                    ret.job_count,
+                    "Number of files to compile in parallel. 0 uses every hardware thread."
+    );
+
+    cli->add_option("--cache-dir",
+                    ret.cache_directory,
+                    "Reuse executables compiled from identical sources, kept in this directory."
+    );
+    cli->add_option("--cache-size",
+                    ret.cache_size_mib,
+                    "Size in MiB the cache is trimmed to after compiling, least recently used first."
+    )->capture_default_str();
+
+    cli->add_option("--server",
+                    ret.server_socket,
+                    "Compile on the Salem server listening on this socket, or locally if there is none."
+    );
+
+    cli->add_option("--natives",
+                    ret.natives_path,
+                    "Manifest of the native functions the host provides, one signature per line, "
+                    "e.g. 'fn Sqrt(x: f64) -> f64'."
     );
 
     cli->add_flag("-d,--detailed", ret.emit_detail, "Detailed output.");
     cli->add_flag("-p,--ptree", ret.emit_ptree, "Emit AST after compilation.");
     cli->add_flag("-t,--tokens", ret.emit_tokens, "Emit tokens after compilation.");
+    cli->add_flag("-g,--line-table",
+                  ret.emit_line_table,
+                  "Embed a source line table, so Hex can report 'file.mn:line' locations."
+    );
 
     ret.exit_code = 0;
     try {
@@ -55,6 +141,10 @@ CompileSettings ParseCommandLineCompileSettings(int argc, char** argv) {
         ret.exit_code   = cli->exit(e);
         ret.should_exit = true;
     }
+
+    if (ret.job_count == 0) {
+        ret.job_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
     return ret;
 }
 } // namespace circe
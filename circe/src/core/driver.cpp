@@ -0,0 +1,432 @@
+#include <circe/core/driver.hpp>
+#include <circe/core/logger.hpp>
+#include <circe/core/protocol.hpp>
+#include <circe/core/thread-pool.hpp>
+#include <circe/bytecode-generator.hpp>
+
+#include <sigil/ast/interner.hpp>
+#include <sigil/ast/lexer.hpp>
+#include <sigil/ast/parser.hpp>
+#include <sigil/ast/semantic-analyzer.hpp>
+
+#include <hexe/bytecode.hpp>
+
+#include <mana/exit-codes.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+
+namespace circe {
+namespace fs = std::filesystem;
+
+namespace {
+struct ScopedTimer {
+    using Clock     = std::chrono::high_resolution_clock;
+    using TimePoint = std::chrono::microseconds;
+
+    TimePoint& target;
+    Clock::time_point start;
+
+    explicit ScopedTimer(std::chrono::microseconds& output)
+        : target(output),
+          start(Clock::now()) {}
+
+    ~ScopedTimer() {
+        target = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    }
+};
+
+std::optional<std::string> ReadSource(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        return std::nullopt;
+    }
+
+    std::string source(fs::file_size(path), '\0');
+    file.read(source.data(), static_cast<std::streamsize>(source.size()));
+
+    if (not file) {
+        return std::nullopt;
+    }
+    return source;
+}
+
+// primitives and builtins are registered once per thread, and copied into each analyzer
+// it has to be per thread, as the builtins' names are interned
+struct WarmState {
+    sigil::SemanticAnalyzer analyzer;
+
+    // names past these belong to one file, and are dropped before the next one on the same thread
+    u32 builtin_names = sigil::Names().Count();
+};
+
+const WarmState& Warm() {
+    static thread_local const WarmState warm;
+    return warm;
+}
+} // namespace
+
+CompileTally::CompileTally()
+    : start(std::chrono::high_resolution_clock::now()) {}
+
+void CompileTally::Add(const int file_exit_code) {
+    ++total;
+
+    if (file_exit_code == mana::Exit(mana::ExitCode::Success)) {
+        ++compiled;
+    } else if (exit_code == mana::Exit(mana::ExitCode::Success)) {
+        exit_code = file_exit_code;
+    }
+}
+
+int CompileTally::Finish() const {
+    if (total > 1) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start
+        );
+
+        Log->info("Compiled {} of {} files in {}us", compiled, total, elapsed.count());
+    }
+
+    return exit_code;
+}
+
+std::string CompilerFingerprint() {
+    return fmt::format("circe {} hexe {}", CIRCE_VER_STRING, hexe::Header::Version);
+}
+
+std::vector<CompileJob> CollectJobs(const CompileSettings& settings) {
+    const auto& inputs = settings.InputPaths();
+    const auto& out    = settings.OutputPath();
+
+    // a trailing separator makes the output be treated as a directory
+    const auto out_dir = out.empty() ? out : out / "";
+
+    std::vector<CompileJob> jobs;
+    for (const auto& input : inputs) {
+        if (not fs::is_directory(input)) {
+            jobs.push_back({input, inputs.size() > 1 ? out_dir : out});
+            continue;
+        }
+
+        std::vector<fs::path> found;
+        for (const auto& entry : fs::recursive_directory_iterator(input)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".mn") {
+                found.push_back(entry.path());
+            }
+        }
+
+        if (found.empty()) {
+            Log->warn("No Mana files found in '{}'", input.string());
+            continue;
+        }
+
+        // directory iteration order is unspecified, and we want stable output
+        std::ranges::sort(found);
+        for (auto& path : found) {
+            auto output = out.empty() ? out : (out_dir / path.lexically_relative(input)).remove_filename();
+            jobs.push_back({std::move(path), std::move(output)});
+        }
+    }
+
+    return jobs;
+}
+
+int CompileFile(const CompileSettings& compile_settings, const CompileJob& job, CompileCache* const cache) {
+    namespace chrono = std::chrono;
+    using namespace mana;
+
+    const auto& in_path = job.input;
+    auto out_path       = job.output; // we might have to create our own outpath
+
+    if (not std::filesystem::exists(in_path)) {
+        Log->error("Input file '{}' does not exist", in_path.string());
+        return Exit(ExitCode::FileNotFound);
+    }
+
+    // If no output path is provided, use the input filename with .hexe extension
+    if (out_path.empty()) {
+        out_path = in_path;
+        out_path.replace_extension("hexe");
+    } else if (std::filesystem::is_directory(out_path) || not out_path.has_filename()) {
+        out_path /= in_path.filename().replace_extension(".hexe");
+    }
+
+    // the manifest is read for every file, as it's part of what the cache key covers
+    std::optional<std::string> natives;
+    if (const auto& natives_path = compile_settings.NativesPath();
+        not natives_path.empty()) {
+        natives = ReadSource(natives_path);
+        if (not natives) {
+            Log->error("Failed to read native manifest '{}'", natives_path.string());
+            return Exit(ExitCode::FileNotFound);
+        }
+    }
+
+    // on a hit, lexing is skipped altogether, so we read the source ourselves and hand it to the lexer on a miss
+    std::optional<std::string> source;
+    std::optional<CacheKey> cache_key;
+    if (cache != nullptr) {
+        source = ReadSource(in_path);
+        if (not source) {
+            Log->error("Failed to read file '{}'", in_path.string());
+            return Exit(ExitCode::FileNotFound);
+        }
+
+        // the line table names the source file, and the manifest decides which calls are native
+        auto options = compile_settings.EmitLineTable() ? in_path.filename().string() : std::string {};
+        if (natives) {
+            options.push_back('\0');
+            options += *natives;
+        }
+        cache_key = cache->Key(*source, options);
+
+        // dumps need the front end to actually run
+        const bool needs_front_end = compile_settings.EmitParseTree() || compile_settings.EmitTokens();
+
+        if (out_path.has_parent_path()) {
+            std::filesystem::create_directories(out_path.parent_path());
+        }
+
+        if (not needs_front_end && cache->Restore(*cache_key, out_path)) {
+            Log->info("Compiled '{}' => '{}' (cached)",
+                      in_path.filename().string(),
+                      out_path.filename().string()
+            );
+            Log->info("Output written to '{}'", out_path.string());
+            return Exit(ExitCode::Success);
+        }
+    }
+
+    // a Salem worker compiles file after file, so the names of the last one go before they pile up
+    const auto& warm = Warm();
+    sigil::Names().Truncate(warm.builtin_names);
+
+    std::chrono::microseconds time_lex, time_parse, time_analysis, time_codegen, time_write, time_total;
+    sigil::Lexer lexer;
+    sigil::Parser parser;
+    sigil::SemanticAnalyzer analyzer = warm.analyzer;
+    BytecodeGenerator codegen;
+    u64 output_size;
+
+    {
+        ScopedTimer total_timer(time_total);
+
+        // the manifest goes through the lexer too, so it has to come before the source
+        if (natives && not analyzer.RegisterNatives(*natives, compile_settings.NativesPath().filename().string())) {
+            Log->error("Failed to load native manifest '{}'", compile_settings.NativesPath().string());
+            return Exit(ExitCode::SemanticError);
+        }
+
+        {
+            ScopedTimer lexer_timer(time_lex);
+            const bool tokenized = source ? lexer.TokenizeSource(std::move(*source), in_path.stem().string())
+                                          : lexer.Tokenize(in_path);
+            if (not tokenized) {
+                Log->error("Failed to tokenize file '{}'", in_path.string());
+                return Exit(ExitCode::LexerError);
+            }
+        }
+
+        {
+            ScopedTimer parser_timer(time_parse);
+            parser.AcquireTokens(lexer.Tokens());
+            parser.RetainParseTree(compile_settings.EmitParseTree());
+            if (not parser.Parse()) {
+                Log->error("Failed to parse file '{}'", in_path.string());
+                return Exit(ExitCode::ParserError);
+            }
+        }
+
+        if (const auto issues = parser.IssueCount();
+            issues > 0) {
+            Log->error("Compilation failed with {} issue{}",
+                       issues,
+                       issues > 1 ? "s" : ""
+            );
+            return Exit(ExitCode::SyntaxError);
+        }
+
+        {
+            ScopedTimer analysis_timer(time_analysis);
+            analyzer.Analyze(parser.FlatAST());
+        }
+
+        if (const auto issues = analyzer.IssueCount();
+            issues > 0) {
+            Log->critical("Aborting");
+            Log->error("Compilation failed with {} issue{}",
+                       issues,
+                       issues > 1 ? "s" : ""
+            );
+
+            parser.PrintParseTree();
+            return Exit(ExitCode::SemanticError);
+        }
+
+        {
+            ScopedTimer codegen_timer(time_codegen);
+            if (compile_settings.EmitLineTable()) {
+                codegen.EmitLineTable(in_path.filename().string());
+            }
+            codegen.ObtainSemanticAnalysisInfo(analyzer);
+            codegen.Generate(parser.FlatAST());
+        }
+
+        {
+            ScopedTimer write_timer(time_write);
+            if (out_path.has_parent_path()) {
+                std::filesystem::create_directories(out_path.parent_path());
+            }
+
+            // an earlier cache hit may have left a hard link to the cache entry here, which we must not write through
+            std::error_code ec;
+            std::filesystem::remove(out_path, ec);
+
+            std::ofstream out_file(out_path, std::ios::binary);
+            if (not out_file) {
+                Log->error("Failed to open output file '{}'", out_path.string());
+                return Exit(ExitCode::OutputOpenError);
+            }
+            const auto output = codegen.Bytecode().Serialize();
+            out_file.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+
+            if (not out_file) {
+                Log->error("Failed to write to output file '{}'", out_path.string());
+                return Exit(ExitCode::OutputWriteError);
+            }
+
+            output_size = output.size();
+
+            if (cache != nullptr) {
+                cache->Store(*cache_key, output);
+            }
+        }
+    }
+
+    const auto compile_str = fmt::format("Compiled '{}' => '{}'",
+                                         in_path.filename().string(),
+                                         out_path.filename().string()
+    );
+
+    Log->info(compile_str);
+    Log->info("Operation completed in {}us", time_total.count());
+    Log->info("Output written to '{}'", out_path.string());
+
+    const auto divider = std::string(compile_str.size(), '-');
+
+    if (compile_settings.EmitVerbose()) {
+        const auto& bytecode = codegen.Bytecode();
+        Log->info(divider);
+        Log->info("  Tokens:         {}", lexer.TokenCount());
+        Log->info("  Instructions:   {} bytes", bytecode.Instructions().size());
+        Log->info("  Constant Pool:  {} constants ({} bytes)",
+                  bytecode.ConstantCount(),
+                  bytecode.ConstantPoolBytesCount()
+        );
+        if (bytecode.HasLineTable()) {
+            Log->info("  Line Table:     {} entries", bytecode.LineTable().size());
+        }
+        Log->info("  Executable:     {} bytes", output_size);
+        Log->info("");
+        Log->info("  == Lex:     {}us", time_lex.count());
+        Log->info("  == Parse:   {}us", time_parse.count());
+        Log->info("  == Analyze: {}us", time_analysis.count());
+        Log->info("  == Codegen: {}us", time_codegen.count());
+        Log->info("  == Write:   {}us", time_write.count());
+        Log->info("");
+        Log->info("  ---- Total: {}us", time_total.count());
+    }
+
+    if (compile_settings.EmitParseTree()) {
+        Log->info("{}\n", divider);
+        parser.PrintParseTree();
+    }
+
+    if (compile_settings.EmitTokens()) {
+        Log->info("{}\n", divider);
+        sigil::PrintTokens(parser.ViewTokenStream());
+    }
+
+    return Exit(ExitCode::Success);
+}
+
+
+CompileResult CompileCaptured(const CompileSettings& settings, const CompileJob& job, CompileCache* const cache) {
+    mana::GlobalLoggerSink().BeginCapture();
+    const int exit_code = CompileFile(settings, job, cache);
+
+    return {exit_code, mana::GlobalLoggerSink().EndCapture()};
+}
+
+int CompileAll(const CompileSettings& settings, const std::span<const CompileJob> jobs, CompileCache* const cache) {
+    CompileTally tally;
+
+    if (settings.JobCount() == 1 || jobs.size() == 1) {
+        for (const auto& job : jobs) {
+            tally.Add(CompileFile(settings, job, cache));
+        }
+        return tally.Finish();
+    }
+
+    ThreadPool pool(std::min<u64>(settings.JobCount(), jobs.size()));
+
+    std::vector<std::future<CompileResult>> results;
+    results.reserve(jobs.size());
+
+    // diagnostics are held back per file, so each file's output stays in one piece
+    for (const auto& job : jobs) {
+        results.push_back(pool.Submit([&settings, &job, cache] {
+            return CompileCaptured(settings, job, cache);
+        }));
+    }
+
+    // and released in input order, no matter which file finishes first
+    for (auto& pending : results) {
+        const auto result = pending.get();
+        mana::GlobalLoggerSink().Write(result.log);
+        tally.Add(result.exit_code);
+    }
+
+    return tally.Finish();
+}
+
+std::optional<int> CompileRemotely(const CompileSettings& settings, const std::span<const CompileJob> jobs) {
+    const int server = protocol::Connect(settings.ServerSocket());
+    if (server < 0) {
+        Log->warn("No compile server is listening on '{}'", settings.ServerSocket().string());
+        return std::nullopt;
+    }
+
+    // the server doesn't share our working directory
+    std::vector<CompileJob> absolute;
+    absolute.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        absolute.push_back({fs::absolute(job.input), job.output.empty() ? job.output : fs::absolute(job.output)});
+    }
+
+    const auto& natives = settings.NativesPath();
+    if (not protocol::SendJobs(server, absolute, settings.Flags(), natives.empty() ? natives : fs::absolute(natives))) {
+        Log->warn("Failed to send jobs to the compile server");
+        protocol::Close(server);
+        return std::nullopt;
+    }
+
+    CompileTally tally;
+    for (u64 i = 0; i < jobs.size(); ++i) {
+        const auto result = protocol::ReceiveResult(server);
+        if (not result) {
+            Log->error("Lost connection to the compile server");
+            protocol::Close(server);
+            return mana::Exit(mana::ExitCode::UnknownCriticalError);
+        }
+
+        mana::GlobalLoggerSink().Write(result->log);
+        tally.Add(result->exit_code);
+    }
+
+    protocol::Close(server);
+    return tally.Finish();
+}
+} // namespace circe
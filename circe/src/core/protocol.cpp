@@ -0,0 +1,329 @@
+#include <circe/core/protocol.hpp>
+#include <circe/core/logger.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <poll.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#    define CIRCE_UNIX_SOCKETS
+#endif
+
+#ifndef MSG_NOSIGNAL
+#    define MSG_NOSIGNAL 0
+#endif
+
+namespace circe::protocol {
+namespace fs = std::filesystem;
+
+namespace {
+// a batch of a few thousand jobs is well under this, anything larger is garbage
+constexpr u32 MESSAGE_MAX = 64 * 1024 * 1024;
+
+class Writer {
+    std::vector<u8> bytes;
+
+public:
+    template <typename T>
+    void Put(const T value) {
+        const auto offset = bytes.size();
+        bytes.resize(offset + sizeof(T));
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    void Put(const std::string_view text) {
+        Put(static_cast<u32>(text.size()));
+        bytes.insert(bytes.end(), text.begin(), text.end());
+    }
+
+    CIRCE_NODISCARD const std::vector<u8>& Bytes() const {
+        return bytes;
+    }
+};
+
+// every read fails once a single one has, so callers only check at the end
+class Reader {
+    std::span<const u8> bytes;
+    usize cursor = 0;
+    bool failed  = false;
+
+public:
+    explicit Reader(const std::span<const u8> bytes)
+        : bytes(bytes) {}
+
+    template <typename T>
+    T Get() {
+        T value {};
+        if (failed || bytes.size() - cursor < sizeof(T)) {
+            failed = true;
+            return value;
+        }
+
+        std::memcpy(&value, bytes.data() + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+    std::string GetString() {
+        const auto size = Get<u32>();
+        if (failed || bytes.size() - cursor < size) {
+            failed = true;
+            return {};
+        }
+
+        std::string text(reinterpret_cast<const char*>(bytes.data() + cursor), size);
+        cursor += size;
+        return text;
+    }
+
+    CIRCE_NODISCARD bool Failed() const {
+        return failed;
+    }
+};
+
+#ifdef CIRCE_UNIX_SOCKETS
+bool SendAll(const int socket, const u8* data, usize size) {
+    while (size > 0) {
+        const auto sent = send(socket, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool ReceiveAll(const int socket, u8* data, usize size) {
+    while (size > 0) {
+        const auto received = recv(socket, data, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+bool Send(const int socket, const Writer& message) {
+    const auto& bytes = message.Bytes();
+    const auto size   = static_cast<u32>(bytes.size());
+
+    return SendAll(socket, reinterpret_cast<const u8*>(&size), sizeof(size))
+           && SendAll(socket, bytes.data(), bytes.size());
+}
+
+std::optional<std::vector<u8>> Receive(const int socket) {
+    u32 size = 0;
+    if (not ReceiveAll(socket, reinterpret_cast<u8*>(&size), sizeof(size)) || size > MESSAGE_MAX) {
+        return std::nullopt;
+    }
+
+    std::vector<u8> bytes(size);
+    if (not ReceiveAll(socket, bytes.data(), bytes.size())) {
+        return std::nullopt;
+    }
+    return bytes;
+}
+
+bool MakeAddress(const fs::path& socket_path, sockaddr_un& address) {
+    const auto path = socket_path.string();
+
+    address            = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        Log->error("Socket path '{}' is too long", path);
+        return false;
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+#endif
+} // namespace
+
+#ifdef CIRCE_UNIX_SOCKETS
+int Connect(const fs::path& socket_path) {
+    sockaddr_un address;
+    if (not MakeAddress(socket_path, address)) {
+        return -1;
+    }
+
+    const int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int Listen(const fs::path& socket_path) {
+    sockaddr_un address;
+    if (not MakeAddress(socket_path, address)) {
+        return -1;
+    }
+
+    const int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    // a server that didn't shut down cleanly leaves its socket file behind
+    std::error_code ec;
+    fs::remove(socket_path, ec);
+
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(sock, SOMAXCONN) != 0) {
+        Log->error("Failed to listen on '{}': {}", socket_path.string(), std::strerror(errno));
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int Accept(const int listener, const i32 timeout_ms) {
+    pollfd waiting {listener, POLLIN, 0};
+    if (poll(&waiting, 1, timeout_ms) <= 0) {
+        return -1;
+    }
+    return accept(listener, nullptr, nullptr);
+}
+
+void Close(const int socket) {
+    if (socket >= 0) {
+        close(socket);
+    }
+}
+
+bool SendJobs(const int socket,
+              const std::span<const CompileJob> jobs,
+              const u16 flags,
+              const fs::path& natives) {
+    Writer message;
+    message.Put(MAGIC);
+    message.Put(VERSION);
+    message.Put(static_cast<u32>(jobs.size()));
+
+    for (const auto& job : jobs) {
+        message.Put(std::string_view(job.input.string()));
+        message.Put(std::string_view(job.output.string()));
+        message.Put(flags);
+        message.Put(std::string_view(natives.string()));
+    }
+
+    return Send(socket, message);
+}
+
+std::optional<std::vector<JobRequest>> ReceiveJobs(const int socket) {
+    const auto bytes = Receive(socket);
+    if (not bytes) {
+        return std::nullopt;
+    }
+
+    Reader message(*bytes);
+    if (message.Get<u32>() != MAGIC || message.Get<u16>() != VERSION) {
+        Log->error("Received a request from an incompatible client");
+        return std::nullopt;
+    }
+
+    const auto count = message.Get<u32>();
+
+    std::vector<JobRequest> requests;
+    for (u32 i = 0; i < count && not message.Failed(); ++i) {
+        auto input       = message.GetString();
+        auto output      = message.GetString();
+        const auto flags = message.Get<u16>();
+        auto natives     = message.GetString();
+
+        requests.push_back({{std::move(input), std::move(output)}, flags, std::move(natives)});
+    }
+
+    if (message.Failed()) {
+        Log->error("Received a malformed request");
+        return std::nullopt;
+    }
+    return requests;
+}
+
+bool SendResult(const int socket, const CompileResult& result) {
+    Writer message;
+    message.Put(static_cast<i32>(result.exit_code));
+    message.Put(static_cast<u32>(result.log.size()));
+
+    for (const auto& record : result.log) {
+        message.Put(std::string_view(record.logger));
+        message.Put(static_cast<u8>(record.level));
+        message.Put(std::string_view(record.text));
+    }
+
+    return Send(socket, message);
+}
+
+std::optional<CompileResult> ReceiveResult(const int socket) {
+    const auto bytes = Receive(socket);
+    if (not bytes) {
+        return std::nullopt;
+    }
+
+    Reader message(*bytes);
+
+    CompileResult result {message.Get<i32>(), {}};
+    const auto count = message.Get<u32>();
+
+    for (u32 i = 0; i < count && not message.Failed(); ++i) {
+        auto logger      = message.GetString();
+        const auto level = static_cast<spdlog::level::level_enum>(message.Get<u8>());
+
+        result.log.push_back({std::move(logger), level, message.GetString()});
+    }
+
+    if (message.Failed()) {
+        return std::nullopt;
+    }
+    return result;
+}
+#else
+int Connect(const fs::path&) {
+    return -1;
+}
+
+int Listen(const fs::path& socket_path) {
+    Log->error("Cannot listen on '{}', compile servers need Unix domain sockets", socket_path.string());
+    return -1;
+}
+
+int Accept(int, i32) {
+    return -1;
+}
+
+void Close(int) {}
+
+bool SendJobs(int, std::span<const CompileJob>, u16, const fs::path&) {
+    return false;
+}
+
+std::optional<std::vector<JobRequest>> ReceiveJobs(int) {
+    return std::nullopt;
+}
+
+bool SendResult(int, const CompileResult&) {
+    return false;
+}
+
+std::optional<CompileResult> ReceiveResult(int) {
+    return std::nullopt;
+}
+#endif
+} // namespace circe::protocol
@@ -0,0 +1,39 @@
+#include <circe/core/thread-pool.hpp>
+
+namespace circe {
+ThreadPool::ThreadPool(const u32 thread_count) {
+    workers.reserve(thread_count);
+    for (u32 i = 0; i < thread_count; ++i) {
+        workers.emplace_back([this] { Work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    // jthreads join on destruction
+    workers.clear();
+}
+
+void ThreadPool::Work() {
+    while (true) {
+        std::move_only_function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return stopping || not queue.empty(); });
+
+            if (queue.empty()) {
+                return;
+            }
+
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        task();
+    }
+}
+} // namespace circe
@@ -61,6 +61,11 @@ void RegisterFrame::Free(std::span<Register> regs) {
 }
 
 void RegisterFrame::Lock(const Register reg) {
+    // locking twice would track the register twice
+    if (IsLocked(reg)) {
+        return;
+    }
+
     i64 idx = -1;
     for (i64 i = 0; i < tracked.size(); ++i) {
         if (tracked[i] == reg) {
@@ -0,0 +1,351 @@
+// circe-bench
+// Compiles synthetic Mana sources of increasing size and reports how each compiler phase scales.
+// Results are written as JSON, so scaling curves can be tracked across commits.
+
+#include <circe/bytecode-generator.hpp>
+#include <circe/core/logger.hpp>
+#include <circe/tools/source-generator.hpp>
+
+#include <sigil/ast/lexer.hpp>
+#include <sigil/ast/parser.hpp>
+#include <sigil/ast/semantic-analyzer.hpp>
+#include <sigil/core/logger.hpp>
+
+#include <CLI11/CLI11.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <spdlog/fmt/fmt.h>
+#include <fstream>
+#include <new>
+#include <print>
+#include <string>
+
+#ifdef __linux__
+#   define CIRCE_BENCH_PROC_STATUS
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/resource.h>
+#   define CIRCE_BENCH_RUSAGE
+#endif
+
+using namespace mana::literals;
+
+namespace {
+std::atomic<u64> allocation_count;
+std::atomic<u64> allocated_bytes;
+} // namespace
+
+// every allocation in the process goes through here, so phases can report how many they made
+void* operator new(const std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+// Peak resident set size in KiB.
+// On Linux the peak can be reset between phases, elsewhere it's the peak of the whole process.
+class PeakMemory {
+    bool resettable = false;
+
+public:
+    PeakMemory() {
+        Reset();
+    }
+
+    bool IsPerPhase() const {
+        return resettable;
+    }
+
+    void Reset() {
+#ifdef CIRCE_BENCH_PROC_STATUS
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.flush();
+        resettable = clear_refs.good();
+#endif
+    }
+
+    u64 Read() const {
+#ifdef CIRCE_BENCH_PROC_STATUS
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.starts_with("VmHWM:")) {
+                return std::strtoull(line.c_str() + 6, nullptr, 10);
+            }
+        }
+#endif
+#ifdef CIRCE_BENCH_RUSAGE
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+#   ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#   else
+        return usage.ru_maxrss;
+#   endif
+#else
+        return 0;
+#endif
+    }
+};
+
+struct Phase {
+    std::string_view name;
+
+    std::vector<f64> samples_ns;
+    u64 allocations = 0;
+    u64 allocated_bytes = 0;
+    u64 peak_rss_kb = 0;
+
+    f64 MedianNs() const {
+        auto sorted = samples_ns;
+        std::ranges::sort(sorted);
+        return sorted.empty() ? 0 : sorted[sorted.size() / 2];
+    }
+};
+
+// times a phase, and records what it allocated and its peak memory
+template <typename Fn>
+void Measure(Phase& phase, PeakMemory& memory, Fn&& fn) {
+    using Clock = std::chrono::steady_clock;
+
+    memory.Reset();
+    const auto allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const auto bytes_before       = allocated_bytes.load(std::memory_order_relaxed);
+
+    const auto start = Clock::now();
+    fn();
+    const auto end = Clock::now();
+
+    phase.samples_ns.push_back(std::chrono::duration<f64, std::nano>(end - start).count());
+
+    // allocations are deterministic, so the last run's counts are as good as any
+    phase.allocations     = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+    phase.allocated_bytes = allocated_bytes.load(std::memory_order_relaxed) - bytes_before;
+    phase.peak_rss_kb     = std::max(phase.peak_rss_kb, memory.Read());
+}
+
+u64 CountNodes(const sigil::ParseNode& node) {
+    u64 count = 1;
+    for (const auto& branch : node.Branches()) {
+        count += CountNodes(branch);
+    }
+    return count;
+}
+
+struct Result {
+    i64 lines = 0;
+    u64 source_bytes = 0;
+    u64 tokens = 0;
+    u64 parse_nodes = 0;
+    u64 ast_nodes = 0;
+    u64 bytecode_bytes = 0;
+    bool ok = true;
+
+    Phase lex {"lex"};
+    Phase parse {"parse"};
+    Phase analyze {"analyze"};
+    Phase codegen {"codegen"};
+};
+
+Result Benchmark(const std::string& source, const i64 lines, const i64 runs, PeakMemory& memory) {
+    Result out;
+    out.lines        = lines;
+    out.source_bytes = source.size();
+
+    for (i64 i = 0; i < runs && out.ok; ++i) {
+        sigil::Lexer lexer;
+        sigil::Parser parser;
+        sigil::SemanticAnalyzer analyzer;
+        circe::BytecodeGenerator codegen;
+
+        // the lexer takes ownership of its source, copy it outside the measurement
+        auto owned_source = source;
+        Measure(out.lex, memory, [&] { lexer.TokenizeSource(std::move(owned_source), "circe-bench"); });
+        out.tokens = lexer.TokenCount();
+
+        // like circe without '--ptree', the p-tree is discarded as the AST gets built
+        parser.RetainParseTree(false);
+        Measure(out.parse,
+                memory,
+                [&] {
+                    parser.AcquireTokens(lexer.Tokens());
+                    out.ok = parser.Parse() && parser.IssueCount() == 0;
+                }
+        );
+        if (not out.ok) {
+            break;
+        }
+
+        if (i == 0) {
+            // so the node count needs a separate, unmeasured parse
+            sigil::Parser retained(lexer.Tokens());
+            if (retained.Parse()) {
+                out.parse_nodes = CountNodes(retained.ViewParseTree());
+            }
+        }
+
+        out.ast_nodes = parser.FlatAST().NodeCount();
+
+        Measure(out.analyze, memory, [&] { analyzer.Analyze(parser.FlatAST()); });
+        if (analyzer.IssueCount() > 0) {
+            out.ok = false;
+            break;
+        }
+
+        Measure(out.codegen,
+                memory,
+                [&] {
+                    codegen.ObtainSemanticAnalysisInfo(analyzer);
+                    codegen.Generate(parser.FlatAST());
+                }
+        );
+        out.bytecode_bytes = codegen.Bytecode().Serialize().size();
+    }
+
+    return out;
+}
+
+f64 PerSecond(const f64 amount, const f64 ns) {
+    return ns > 0 ? amount / (ns / 1e9) : 0;
+}
+
+std::string PhaseJson(const Phase& phase) {
+    return fmt::format(R"("{}": {{"median_ns": {:.0f}, "allocations": {}, "allocated_bytes": {}, "peak_rss_kb": {}}})",
+                       phase.name,
+                       phase.MedianNs(),
+                       phase.allocations,
+                       phase.allocated_bytes,
+                       phase.peak_rss_kb
+    );
+}
+
+std::string ResultJson(const Result& result) {
+    const auto lex_ns   = result.lex.MedianNs();
+    const auto parse_ns = result.parse.MedianNs();
+
+    return fmt::format("    {{\n"
+                       "      \"lines\": {},\n"
+                       "      \"source_bytes\": {},\n"
+                       "      \"ok\": {},\n"
+                       "      \"tokens\": {},\n"
+                       "      \"parse_nodes\": {},\n"
+                       "      \"ast_nodes\": {},\n"
+                       "      \"bytecode_bytes\": {},\n"
+                       "      \"lexer_mb_per_s\": {:.2f},\n"
+                       "      \"lexer_tokens_per_s\": {:.0f},\n"
+                       "      \"parser_nodes_per_s\": {:.0f},\n"
+                       "      \"phases\": {{\n"
+                       "        {},\n"
+                       "        {},\n"
+                       "        {},\n"
+                       "        {}\n"
+                       "      }}\n"
+                       "    }}",
+                       result.lines,
+                       result.source_bytes,
+                       result.ok,
+                       result.tokens,
+                       result.parse_nodes,
+                       result.ast_nodes,
+                       result.bytecode_bytes,
+                       PerSecond(static_cast<f64>(result.source_bytes), lex_ns) / 1e6,
+                       PerSecond(static_cast<f64>(result.tokens), lex_ns),
+                       PerSecond(static_cast<f64>(result.parse_nodes), parse_ns),
+                       PhaseJson(result.lex),
+                       PhaseJson(result.parse),
+                       PhaseJson(result.analyze),
+                       PhaseJson(result.codegen)
+    );
+}
+} // namespace
+
+int main(const int argc, char** argv) {
+    CLI::App cli("circe-bench, the Circe compiler throughput benchmark");
+
+    std::vector<i64> sizes = {1'000, 10'000, 100'000, 1'000'000};
+    i64 runs               = 3;
+    u64 seed               = 1;
+    std::string output;
+    std::string emit_sources;
+
+    cli.add_option("-l,--lines", sizes, "Sizes of the generated sources, in lines.")->check(CLI::PositiveNumber);
+    cli.add_option("-r,--runs", runs, "Runs per size, the median time of each phase is reported.")->check(CLI::PositiveNumber);
+    cli.add_option("-s,--seed", seed, "Seed for the source generator.");
+    cli.add_option("-o,--output", output, "Write the JSON report to this file instead of stdout.");
+    cli.add_option("--emit-sources", emit_sources, "Also write the generated sources to this directory.");
+
+    CLI11_PARSE(cli, argc, argv);
+
+    // diagnostics in generated code would be a generator bug, and are reported through 'ok'
+    sigil::Log->set_level(spdlog::level::err);
+    circe::Log->set_level(spdlog::level::err);
+
+    PeakMemory memory;
+    std::vector<Result> results;
+
+    for (const auto lines : sizes) {
+        circe::tools::SourceGenerator generator(seed);
+        const auto source = generator.Generate(lines);
+
+        if (not emit_sources.empty()) {
+            std::filesystem::create_directories(emit_sources);
+            std::ofstream(std::filesystem::path(emit_sources) / fmt::format("bench-{}.mn", lines)) << source;
+        }
+
+        std::print(stderr, "Compiling {} lines ({} bytes)...\n", lines, source.size());
+        results.push_back(Benchmark(source, lines, runs, memory));
+
+        if (not results.back().ok) {
+            std::print(stderr, "Generated source of {} lines failed to compile\n", lines);
+        }
+    }
+
+    std::string json = fmt::format("{{\n"
+                                   "  \"tool\": \"circe-bench\",\n"
+                                   "  \"seed\": {},\n"
+                                   "  \"runs\": {},\n"
+                                   "  \"peak_rss_per_phase\": {},\n"
+                                   "  \"results\": [\n",
+                                   seed,
+                                   runs,
+                                   memory.IsPerPhase()
+    );
+
+    for (usize i = 0; i < results.size(); ++i) {
+        json.append(ResultJson(results[i]));
+        json.append(i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json.append("  ]\n}\n");
+
+    if (output.empty()) {
+        std::print("{}", json);
+    } else {
+        std::ofstream out(output);
+        if (not out) {
+            std::print(stderr, "Failed to open '{}'\n", output);
+            return 1;
+        }
+        out << json;
+    }
+
+    return std::ranges::all_of(results, &Result::ok) ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#include <circe/tools/source-generator.hpp>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace circe::tools {
+using namespace mana::literals;
+
+// literals are kept small so the constant pool deduplicates them,
+// otherwise large programs would exhaust its 16-bit index space
+constexpr i64 LITERAL_MAX = 64;
+
+SourceGenerator::SourceGenerator(const u64 seed)
+    : rng(seed),
+      lines(0),
+      function_count(0) {}
+
+std::string SourceGenerator::Generate(const i64 target_lines) {
+    out.clear();
+    lines          = 0;
+    function_count = 0;
+
+    // Main is emitted last and takes a handful of lines
+    constexpr i64 main_lines = 6;
+
+    while (lines + main_lines < target_lines) {
+        switch (function_count % 4) {
+        case 0:
+            ArithmeticFunction();
+            break;
+        case 1:
+            LoopFunction();
+            break;
+        case 2:
+            BranchFunction();
+            break;
+        default:
+            ListFunction();
+            break;
+        }
+
+        Line(0, "");
+        ++function_count;
+    }
+
+    Main();
+    return std::move(out);
+}
+
+void SourceGenerator::Line(const i64 indent, const std::string_view text) {
+    out.append(indent * 4, ' ');
+    out.append(text);
+    out.push_back('\n');
+    ++lines;
+}
+
+void SourceGenerator::ArithmeticFunction() {
+    Line(0, fmt::format("fn {}(a: i64, b: i64) -> i64 {{", FunctionName(function_count)));
+
+    const i64 locals = 2 + Literal(4);
+    for (i64 i = 0; i < locals; ++i) {
+        auto expression = Expression(8 + Literal(24));
+        if (i > 0) {
+            expression = fmt::format("x{} - {}", i - 1, expression);
+        }
+        Line(1, fmt::format("data x{} = {}", i, expression));
+    }
+
+    Line(1, fmt::format("return x{}", locals - 1));
+    Line(0, "}");
+}
+
+void SourceGenerator::LoopFunction() {
+    Line(0, fmt::format("fn {}(a: i64, b: i64) -> i64 {{", FunctionName(function_count)));
+    Line(1, "mut data total = 0");
+
+    const i64 depth = 1 + Literal(3);
+    for (i64 i = 0; i < depth; ++i) {
+        Line(1 + i, fmt::format("loop 0..{} => i{} {{", 2 + Literal(16), i));
+    }
+
+    Line(1 + depth, fmt::format("total += i{} * {} + a", depth - 1, Expression(4)));
+    Line(1 + depth, "total %= 1000003");
+
+    for (i64 i = depth; i > 0; --i) {
+        Line(i, "}");
+    }
+
+    Line(1, "return total");
+    Line(0, "}");
+}
+
+void SourceGenerator::BranchFunction() {
+    Line(0, fmt::format("fn {}(a: i64, b: i64) -> i64 {{", FunctionName(function_count)));
+    Line(1, "mut data r = a");
+
+    Line(1, fmt::format("if a < b + {} {{", Literal(LITERAL_MAX)));
+    Line(2, fmt::format("r = {}", Expression(6)));
+    Line(1, fmt::format("}} else if a == {} {{", Literal(LITERAL_MAX)));
+    Line(2, fmt::format("r *= {}", 1 + Literal(LITERAL_MAX)));
+    Line(1, "} else {");
+    Line(2, fmt::format("r -= {}", Expression(4)));
+    Line(1, "}");
+
+    // calls back into the previous function, so programs form a call chain
+    if (function_count > 0) {
+        Line(1, fmt::format("r += {}(b, r)", FunctionName(function_count - 1)));
+    }
+
+    Line(1, "return r");
+    Line(0, "}");
+}
+
+void SourceGenerator::ListFunction() {
+    Line(0, fmt::format("fn {}(a: i64, b: i64) -> i64 {{", FunctionName(function_count)));
+
+    const i64 count = 16 + Literal(112);
+
+    std::string list = "[";
+    for (i64 i = 0; i < count; ++i) {
+        list.append(fmt::format("{}{}", i > 0 ? ", " : "", Literal(LITERAL_MAX)));
+    }
+    list.push_back(']');
+
+    Line(1, fmt::format("data values = {}", list));
+    Line(1, "mut data sum = a");
+    Line(1, fmt::format("loop 0..{} => i {{", count));
+    Line(2, "sum += values[i] * b");
+    Line(1, "}");
+    Line(1, "return sum");
+    Line(0, "}");
+}
+
+void SourceGenerator::Main() {
+    Line(0, "fn Main() {");
+    Line(1, "mut data result = 0");
+
+    if (function_count > 0) {
+        Line(1, fmt::format("result += {}(3, 4)", FunctionName(0)));
+        Line(1, fmt::format("result += {}(5, 6)", FunctionName(function_count - 1)));
+    }
+
+    Line(1, "PrintV(\"{}\\n\", result)");
+    Line(0, "}");
+}
+
+std::string SourceGenerator::Expression(const i64 terms) {
+    static constexpr std::string_view operators[] = {" + ", " - ", " * "};
+
+    std::string expression;
+    i64 open_groups = 0;
+
+    for (i64 i = 0; i < terms; ++i) {
+        if (i > 0) {
+            expression.append(operators[Literal(3)]);
+        }
+
+        if (i + 2 < terms && Literal(5) == 0) {
+            expression.push_back('(');
+            ++open_groups;
+        }
+
+        switch (Literal(3)) {
+        case 0:
+            expression.push_back('a');
+            break;
+        case 1:
+            expression.push_back('b');
+            break;
+        default:
+            expression.append(std::to_string(Literal(LITERAL_MAX)));
+            break;
+        }
+
+        if (open_groups > 0 && Literal(3) == 0) {
+            expression.push_back(')');
+            --open_groups;
+        }
+    }
+
+    expression.append(open_groups, ')');
+    return expression;
+}
+
+std::string SourceGenerator::FunctionName(const i64 index) const {
+    return fmt::format("F{}", index);
+}
+
+i64 SourceGenerator::Literal(const i64 max) {
+    return static_cast<i64>(rng() % static_cast<u64>(max));
+}
+} // namespace circe::tools
@@ -0,0 +1,203 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <hexe/bytecode.hpp>
+
+using namespace hexe;
+using namespace mana::literals;
+
+TEST_CASE("Hexe Serialization", "[hexe][bytecode]") {
+    SECTION("Line table survives a round trip") {
+        ByteCode bytecode;
+        bytecode.SetEntryPoint(0);
+        bytecode.SetMainRegisterFrame(0);
+        bytecode.SetSourceName("sample.mn");
+
+        bytecode.MarkSource(3, 5);
+        bytecode.Write(Op::LoadConstant, {0, bytecode.AddConstant(i64 {12})});
+        bytecode.MarkSource(4, 5);
+        bytecode.Write(Op::Move, {1, 0});
+        bytecode.MarkSource(2, 1);
+        bytecode.Write(Op::Halt);
+
+        REQUIRE(bytecode.HasLineTable());
+
+        ByteCode loaded;
+        REQUIRE(loaded.Deserialize(bytecode.Serialize()));
+
+        REQUIRE(loaded.Serialize() == bytecode.Serialize());
+        REQUIRE(loaded.SourceName() == "sample.mn");
+        REQUIRE(loaded.LineTable().size() == 3);
+
+        // LoadConstant spans offsets 0-4, Move 5-9, Halt 10
+        const auto* first = loaded.LocateSource(2);
+        REQUIRE(first != nullptr);
+        REQUIRE(first->line == 3);
+
+        const auto* last = loaded.LocateSource(10);
+        REQUIRE(last != nullptr);
+        REQUIRE(last->line == 2);
+        REQUIRE(last->column == 1);
+    }
+
+    SECTION("Locations without emitted code are collapsed") {
+        ByteCode bytecode;
+
+        bytecode.MarkSource(1, 1);
+        bytecode.MarkSource(2, 1);
+        bytecode.Write(Op::Halt);
+
+        REQUIRE(bytecode.LineTable().size() == 1);
+        REQUIRE(bytecode.LocateSource(0)->line == 2);
+    }
+
+    SECTION("Line table is optional") {
+        ByteCode bytecode;
+        bytecode.SetEntryPoint(0);
+        bytecode.SetMainRegisterFrame(0);
+        bytecode.Write(Op::LoadConstant, {0, bytecode.AddConstant(1.5)});
+        bytecode.Write(Op::Halt);
+
+        ByteCode loaded;
+        REQUIRE(loaded.Deserialize(bytecode.Serialize()));
+
+        REQUIRE_FALSE(loaded.HasLineTable());
+        REQUIRE(loaded.LocateSource(0) == nullptr);
+        REQUIRE(loaded.Serialize() == bytecode.Serialize());
+    }
+    SECTION("Export table survives a round trip") {
+        ByteCode bytecode;
+        bytecode.SetEntryPoint(0);
+        bytecode.SetMainRegisterFrame(0);
+        bytecode.Write(Op::Halt);
+        bytecode.Write(Op::Return, {0});
+
+        bytecode.AddExport("Update", 1, 300, 2);
+        bytecode.AddExport("Reset", 1, 1, 0);
+
+        ByteCode loaded;
+        REQUIRE(loaded.Deserialize(bytecode.Serialize()));
+
+        REQUIRE(loaded.Serialize() == bytecode.Serialize());
+        REQUIRE(loaded.Exports().size() == 2);
+        REQUIRE(loaded.FindExport("Missing") == nullptr);
+
+        const auto* update = loaded.FindExport("Update");
+        REQUIRE(update != nullptr);
+        REQUIRE(update->address == 1);
+        REQUIRE(update->register_count == 300);
+        REQUIRE(update->param_count == 2);
+    }
+
+    SECTION("Import table survives a round trip") {
+        ByteCode bytecode;
+        bytecode.SetEntryPoint(0);
+        bytecode.SetMainRegisterFrame(0);
+        bytecode.Write(Op::Halt);
+
+        REQUIRE(bytecode.AddImport("Sqrt", 1) == 0);
+        REQUIRE(bytecode.AddImport("Lerp", 3) == 1);
+        REQUIRE(bytecode.AddImport("Sqrt", 1) == 0);
+
+        bytecode.Write(Op::CallNative, {1, 4});
+        bytecode.AddExport("Update", 1, 8, 0);
+
+        ByteCode loaded;
+        REQUIRE(loaded.Deserialize(bytecode.Serialize()));
+
+        REQUIRE(loaded.Serialize() == bytecode.Serialize());
+        REQUIRE(loaded.Exports().size() == 1);
+        REQUIRE(loaded.Imports().size() == 2);
+        REQUIRE(loaded.Imports()[1].name == "Lerp");
+        REQUIRE(loaded.Imports()[1].param_count == 3);
+    }
+
+    SECTION("Packed lists are written to the constant pool at their element width") {
+        ByteCode bytecode;
+        bytecode.SetEntryPoint(0);
+        bytecode.SetMainRegisterFrame(0);
+        bytecode.Write(Op::Halt);
+
+        Value halves {static_cast<u8>(Value::Data::Type::Float32), 3};
+        halves.SetPacked(0, 0.5f);
+        halves.SetPacked(2, -1.5f);
+
+        Value flags {static_cast<u8>(Value::Data::Type::Bits), 10};
+        flags.SetBit(1, true);
+        flags.SetBit(9, true);
+
+        bytecode.AddArray(halves);
+        bytecode.AddArray(flags);
+
+        // type and size, then 3 * 4 bytes of floats and 2 bytes of bits
+        REQUIRE(bytecode.ConstantPoolBytesCount() == 2 * (1 + sizeof(Value::SizeType)) + 12 + 2);
+
+        ByteCode loaded;
+        REQUIRE(loaded.Deserialize(bytecode.Serialize()));
+        REQUIRE(loaded.Serialize() == bytecode.Serialize());
+
+        const auto& constants = loaded.Constants();
+        REQUIRE(constants[0].Count() == 3);
+        REQUIRE(constants[0].Packed<f32>(2) == -1.5f);
+        REQUIRE(constants[1].Count() == 10);
+        REQUIRE(constants[1].Bit(9));
+        REQUIRE_FALSE(constants[1].Bit(8));
+    }
+}
+
+TEST_CASE("Vector Values", "[hexe]") {
+    Value::Lanes lanes {};
+    lanes.as_f32 = {1.f, 2.f, 3.f, 0.f};
+
+    SECTION("Vectors keep their lanes inline through copies and moves") {
+        const Value vector {Value::Data::Type::Vec3, lanes};
+        REQUIRE(vector.IsVector());
+        REQUIRE(vector.LaneCount() == 3);
+
+        Value copy = vector;
+        REQUIRE(copy.Type() == Value::Data::Type::Vec3);
+        REQUIRE(copy.AsLanes().as_f32 == lanes.as_f32);
+
+        const Value moved = std::move(copy);
+        REQUIRE(moved.AsLanes().as_f32[2] == 3.f);
+        REQUIRE_FALSE(copy.IsVector());
+    }
+
+    SECTION("Registers switch between vectors and heap values") {
+        Value reg {i64 {7}};
+
+        reg = Value {Value::Data::Type::Vec2i, lanes};
+        REQUIRE(reg.IsVector());
+
+        reg = Value {2.5};
+        REQUIRE_FALSE(reg.IsVector());
+        REQUIRE(reg.AsFloat() == 2.5);
+
+        reg = Value {Value::Data::Type::Vec4, lanes};
+        REQUIRE(reg.LaneCount() == 4);
+    }
+}
+
+TEST_CASE("Packed Lists", "[hexe]") {
+    SECTION("Packed lists copy only the bytes they take up") {
+        Value bytes {static_cast<u8>(Value::Data::Type::Int8), 5};
+        bytes.SetPacked(4, i8 {-7});
+        REQUIRE(bytes.ByteLength() == 5);
+
+        const Value copy = bytes;
+        REQUIRE(copy.IsPacked());
+        REQUIRE(copy.Count() == 5);
+        REQUIRE(copy.Packed<i8>(4) == -7);
+    }
+
+    SECTION("Bits lists keep eight elements to a byte") {
+        Value flags {static_cast<u8>(Value::Data::Type::Bits), 17};
+        REQUIRE(flags.ByteLength() == 3);
+        REQUIRE(flags.Length() == 1);
+
+        flags.SetBit(16, true);
+        flags.SetBit(3, true);
+        flags.SetBit(3, false);
+        REQUIRE(flags.Bit(16));
+        REQUIRE_FALSE(flags.Bit(3));
+    }
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <circe/core/cache.hpp>
+#include <circe/core/cli.hpp>
+#include <circe/core/driver.hpp>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace circe;
+using namespace mana::literals;
+
+namespace fs = std::filesystem;
+
+namespace {
+// a directory of its own for every test, as the cache's state lives on disk
+fs::path FreshDirectory(const std::string_view name) {
+    const auto directory = fs::temp_directory_path() / "circe-cache-tests" / name;
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    return directory;
+}
+
+void WriteFile(const fs::path& path, const std::string_view contents) {
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+}
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator {in}, {}};
+}
+
+std::vector<u8> Bytes(const std::string_view text) {
+    return {text.begin(), text.end()};
+}
+
+bool operator==(const CacheKey& lhs, const CacheKey& rhs) {
+    return lhs.fnv == rhs.fnv && lhs.crc == rhs.crc;
+}
+} // namespace
+
+TEST_CASE("Compile Cache", "[cache]") {
+    SECTION("Keys cover the source, the options and the salt") {
+        const CompileCache cache(FreshDirectory("keys"), "salt", 1024);
+        const CompileCache resalted(FreshDirectory("keys-resalted"), "pepper", 1024);
+
+        const auto key = cache.Key("fn Main() {}", "");
+        REQUIRE(key == cache.Key("fn Main() {}", ""));
+
+        REQUIRE_FALSE(key == cache.Key("fn Main() { }", ""));
+        REQUIRE_FALSE(key == cache.Key("fn Main() {}", "main.mn"));
+        REQUIRE_FALSE(key == resalted.Key("fn Main() {}", ""));
+
+        // moving bytes from one part to the next is a different key as well
+        REQUIRE_FALSE(cache.Key("b", "a") == cache.Key("", "ab"));
+    }
+
+    SECTION("Entries are only restored once they've been stored") {
+        const auto directory = FreshDirectory("restore");
+        CompileCache cache(directory / "entries", "salt", 1024);
+
+        const auto key = cache.Key("fn Main() {}", "");
+        REQUIRE_FALSE(cache.Restore(key, directory / "out.hexe"));
+        REQUIRE(cache.Misses() == 1);
+        REQUIRE(cache.Hits() == 0);
+
+        cache.Store(key, Bytes("executable"));
+        REQUIRE(cache.Restore(key, directory / "out.hexe"));
+        REQUIRE(cache.Hits() == 1);
+        REQUIRE(ReadFile(directory / "out.hexe") == "executable");
+    }
+
+    SECTION("Stores replace entries whole, and leave no temporary files behind") {
+        const auto directory = FreshDirectory("store");
+        CompileCache cache(directory / "entries", "salt", 1024);
+
+        const auto key = cache.Key("fn Main() {}", "");
+        cache.Store(key, Bytes("first"));
+        cache.Store(key, Bytes("second"));
+
+        i64 entries = 0;
+        for (const auto& file : fs::directory_iterator(directory / "entries")) {
+            REQUIRE(file.path().extension() == ".hexe");
+            ++entries;
+        }
+        REQUIRE(entries == 1);
+
+        REQUIRE(cache.Restore(key, directory / "out.hexe"));
+        REQUIRE(ReadFile(directory / "out.hexe") == "second");
+    }
+
+    SECTION("Eviction removes the least recently used entries until the budget fits") {
+        const auto directory = FreshDirectory("evict");
+        CompileCache cache(directory, "salt", 250);
+
+        const std::array keys = {cache.Key("a", ""), cache.Key("b", ""), cache.Key("c", "")};
+        const auto now       = fs::file_time_type::clock::now();
+
+        for (usize i = 0; i < keys.size(); ++i) {
+            cache.Store(keys[i], std::vector<u8>(100, 'x'));
+            fs::last_write_time(directory / keys[i].FileName(), now - std::chrono::hours(keys.size() - i));
+        }
+
+        // restoring the oldest entry makes it the most recently used
+        REQUIRE(cache.Restore(keys[0], directory / "out.bin"));
+        cache.Evict();
+
+        REQUIRE(fs::exists(directory / keys[0].FileName()));
+        REQUIRE_FALSE(fs::exists(directory / keys[1].FileName()));
+        REQUIRE(fs::exists(directory / keys[2].FileName()));
+
+        // already within budget
+        cache.Evict();
+        REQUIRE(fs::exists(directory / keys[2].FileName()));
+    }
+
+    SECTION("Compiling again only hits while the options and the manifest stay the same") {
+        const auto directory = FreshDirectory("compile");
+        WriteFile(directory / "main.mn", "fn Main() {\n    data x = Twice(21)\n}\n");
+        WriteFile(directory / "natives.txt", "fn Twice(x: i64) -> i64\n");
+
+        const auto source  = (directory / "main.mn").string();
+        const auto natives = (directory / "natives.txt").string();
+        const auto output  = (directory / "out" / "").string();
+
+        const auto settings_for = [&](std::vector<std::string> args) {
+            std::vector<char*> argv;
+            for (auto& arg : args) {
+                argv.push_back(arg.data());
+            }
+            return ParseCommandLineCompileSettings(static_cast<int>(argv.size()), argv.data());
+        };
+
+        const auto plain      = settings_for({"circe", source, "-o", output, "--natives", natives});
+        const auto line_table = settings_for({"circe", source, "-o", output, "--natives", natives, "-g"});
+        const CompileJob job {source, output};
+
+        CompileCache cache(directory / "cache", CompilerFingerprint(), 1 << 20);
+
+        REQUIRE(CompileFile(plain, job, &cache) == 0);
+        REQUIRE(CompileFile(plain, job, &cache) == 0);
+        REQUIRE(cache.Hits() == 1);
+        REQUIRE(cache.Misses() == 1);
+
+        REQUIRE(CompileFile(line_table, job, &cache) == 0);
+        REQUIRE(cache.Misses() == 2);
+
+        WriteFile(directory / "natives.txt", "fn Twice(x: i64) -> i64\nfn Half(x: i64) -> i64\n");
+        REQUIRE(CompileFile(plain, job, &cache) == 0);
+        REQUIRE(cache.Misses() == 3);
+
+        REQUIRE(CompileFile(plain, job, &cache) == 0);
+        REQUIRE(cache.Hits() == 2);
+    }
+}
@@ -32,7 +32,7 @@ TEST_CASE("P-Trees", "[parse][ast]") {
         SECTION("Root is properly formed") {
             REQUIRE_FALSE(tokens.empty());
             REQUIRE(ptree.rule == Rule::Artifact);
-            REQUIRE_FALSE(ptree.branches.empty());
+            REQUIRE_FALSE(ptree.IsLeaf());
         }
 
         SECTION("P-Tree output matches control") {
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <hex/hex.hpp>
+
+#include <hexe/bytecode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+namespace ml = mana::literals;
+
+/**
+ * @brief Runs one program on a set of worker threads, each with a Hex of its own.
+ * The bytecode is shared by every worker, and only ever read, so it has to be fully prepared
+ * (superinstructions fused and so on) before the batch starts, and left alone until it's done.
+ * Workers claim runs one at a time, so uneven runs still keep every thread busy.
+ */
+class Batch {
+    const hexe::ByteCode& bytecode;
+    ml::u32 thread_count;
+
+    // called on every worker's Hex before the bytecode is loaded into it
+    std::function<void(Hex&)> setup;
+
+public:
+    // a thread count of 0 uses every hardware thread
+    Batch(const hexe::ByteCode& bytecode, ml::u32 thread_count, std::function<void(Hex&)> setup = {});
+
+    // runs Main 'runs' times, results are in the order the runs were counted in
+    std::vector<InterpretResult> Execute(ml::usize runs) const;
+
+    // calls the function once per set of arguments, an invalid Value standing in for any call that failed
+    std::vector<hexe::Value> Call(std::string_view function, std::span<const std::vector<hexe::Value>> inputs) const;
+
+    HEX_NODISCARD ml::u32 ThreadCount() const;
+
+private:
+    // runs 'task' for each index below 'count', handing every worker its own loaded Hex
+    // returns false if the bytecode couldn't be loaded
+    bool Distribute(ml::usize count, const std::function<void(Hex&, ml::usize)>& task) const;
+};
+} // namespace hex
@@ -18,6 +18,9 @@ struct CommandLineSettings {
     i64 Populate();
 
     HEX_NODISCARD std::string_view HexeName() const;
+    HEX_NODISCARD i64 Budget() const;
+    HEX_NODISCARD u32 ThreadCount() const;
+    HEX_NODISCARD u64 RunCount() const;
     HEX_NODISCARD bool ShouldExit();
 
 private:
@@ -29,6 +32,9 @@ private:
     bool say_hi;
     bool gen_testfile;
     std::string hexe_name;
+    i64 budget {0};
+    u32 thread_count {1};
+    u64 run_count {0};
     bool should_exit {false};
 };
 } // namespace hex
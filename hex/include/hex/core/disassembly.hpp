@@ -1,5 +1,11 @@
 #pragma once
 
+#include <hexe/opcode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <string>
+
 namespace hexe {
 class ByteCode;
 }
@@ -9,4 +15,16 @@ namespace hex {
  * @brief Prints Hexe bytecode in a human-readable format.
  */
 void PrintBytecode(const hexe::ByteCode& s);
+
+/**
+ * @brief Size in bytes of an encoded instruction, including its opcode.
+ * A fused opcode only spans its leading instruction, as the rest of its sequence stays encoded after it.
+ */
+mana::literals::i64 InstructionSize(hexe::Op op);
+
+/**
+ * @brief Formats the source location of the instruction at 'offset' as 'file.mn:line'.
+ * Returns an empty string if the bytecode carries no line table.
+ */
+std::string FormatSourceLocation(const hexe::ByteCode& s, mana::literals::i64 offset);
 } // namespace hex
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <hexe/value.hpp>
+
+#include <mana/literals.hpp>
+
+// kernels behind the bulk list opcodes (ListFill, ListSum, etc.)
+// these run over a list's contiguous buffer at its element width,
+// with the float kernels and the integer additions on SSE where the CPU has it
+namespace hex::list {
+namespace ml = mana::literals;
+
+void Fill(hexe::Value& list, const hexe::Value& value);
+
+// only as many elements as both lists have get copied
+void Copy(hexe::Value& dst, const hexe::Value& src);
+
+HEX_NODISCARD hexe::Value Slice(const hexe::Value& list, ml::i64 from, ml::i64 to);
+
+HEX_NODISCARD hexe::Value Sum(const hexe::Value& list);
+
+// 0 for an empty list
+HEX_NODISCARD hexe::Value Min(const hexe::Value& list);
+HEX_NODISCARD hexe::Value Max(const hexe::Value& list);
+
+// -1 when no element equals 'value'
+HEX_NODISCARD ml::i64 Find(const hexe::Value& list, const hexe::Value& value);
+
+// ascending, with any NaNs after every number
+void Sort(hexe::Value& list);
+
+// element by element, as long as the shorter of the two lists, whatever is left of the longer one is dropped
+HEX_NODISCARD hexe::Value Add(const hexe::Value& lhs, const hexe::Value& rhs);
+HEX_NODISCARD hexe::Value Mul(const hexe::Value& lhs, const hexe::Value& rhs);
+} // namespace hex::list
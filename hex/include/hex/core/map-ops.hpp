@@ -0,0 +1,28 @@
+#pragma once
+
+#include <hexe/value.hpp>
+
+#include <mana/literals.hpp>
+
+#include <optional>
+
+// kernels behind the Map* opcodes
+// these go by the map's type, as IntMap and StringMap keys hash differently
+namespace hex::map {
+namespace ml = mana::literals;
+
+// nullptr when there's nothing under 'key'
+HEX_NODISCARD const hexe::Value* Find(const hexe::Value& map, const hexe::Value& key);
+
+void Set(hexe::Value& map, const hexe::Value& key, const hexe::Value& value);
+
+// false when there was nothing under 'key'
+HEX_NODISCARD bool Remove(hexe::Value& map, const hexe::Value& key);
+
+HEX_NODISCARD ml::u32 Count(const hexe::Value& map);
+
+// entries stay in insertion order, until a removal moves the last one into the gap it leaves
+// nothing comes back for an index outside of [0, Count)
+HEX_NODISCARD std::optional<hexe::Value> KeyAt(const hexe::Value& map, ml::i64 index);
+HEX_NODISCARD const hexe::Value* ValueAt(const hexe::Value& map, ml::i64 index);
+} // namespace hex::map
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <hexe/opcode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <array>
+#include <vector>
+
+namespace hex {
+namespace ml = mana::literals;
+
+/**
+ * @brief Dynamic opcode frequencies, as recorded by Hex in counting mode.
+ * Unigrams, bigrams and trigrams are kept in dense tables indexed by opcode.
+ */
+class OpcodeStats {
+public:
+    static constexpr ml::u16 OP_COUNT = magic_enum::enum_count<hexe::Op>();
+
+    struct Sequence {
+        std::array<hexe::Op, 3> ops;
+        ml::u8 length;
+        ml::u64 count;
+    };
+
+private:
+    // marks the start of a sequence, so n-grams never span two programs
+    static constexpr ml::u16 NO_OPCODE = OP_COUNT;
+
+    std::vector<ml::u64> unigrams;
+    std::vector<ml::u64> bigrams;
+    std::vector<ml::u64> trigrams;
+
+    ml::u64 total;
+    ml::u16 previous;
+    ml::u16 before_previous;
+
+public:
+    OpcodeStats();
+
+    // called once per dispatch, so this needs to stay cheap
+    void Record(const ml::u8 opcode) {
+        ++unigrams[opcode];
+
+        if (previous != NO_OPCODE) {
+            ++bigrams[previous * OP_COUNT + opcode];
+
+            if (before_previous != NO_OPCODE) {
+                ++trigrams[(before_previous * OP_COUNT + previous) * OP_COUNT + opcode];
+            }
+        }
+
+        before_previous = previous;
+        previous        = opcode;
+        ++total;
+    }
+
+    // ends the current opcode stream, e.g. between two programs
+    void EndSequence();
+
+    void Merge(const OpcodeStats& other);
+
+    HEX_NODISCARD ml::u64 Total() const;
+
+    HEX_NODISCARD ml::u64 Count(hexe::Op op) const;
+    HEX_NODISCARD ml::u64 Count(hexe::Op first, hexe::Op second) const;
+    HEX_NODISCARD ml::u64 Count(hexe::Op first, hexe::Op second, hexe::Op third) const;
+
+    // every observed sequence of the given length (1-3), most frequent first
+    HEX_NODISCARD std::vector<Sequence> Ranked(ml::u8 length) const;
+};
+} // namespace hex
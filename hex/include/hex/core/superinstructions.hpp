@@ -0,0 +1,47 @@
+#pragma once
+
+#include <hexe/opcode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <array>
+#include <span>
+
+namespace hexe {
+class ByteCode;
+}
+
+namespace hex {
+namespace ml = mana::literals;
+
+static constexpr ml::u8 SUPERINSTRUCTION_MAX_LENGTH = 3;
+
+struct Superinstruction {
+    hexe::Op fused;
+    std::array<hexe::Op, SUPERINSTRUCTION_MAX_LENGTH> sequence;
+    ml::u8 length;
+};
+
+/**
+ * @brief All superinstructions compiled into Hex, in opcode order.
+ */
+std::span<const Superinstruction> Superinstructions();
+
+HEX_NODISCARD bool IsSuperinstruction(hexe::Op op);
+
+// returns nullptr for regular opcodes
+HEX_NODISCARD const Superinstruction* FindSuperinstruction(hexe::Op op);
+
+/**
+ * @brief Whether an opcode may start or continue a fused sequence.
+ * Only the final opcode of a sequence is allowed to transfer control.
+ */
+HEX_NODISCARD bool CanPrecedeInFusion(hexe::Op op);
+
+/**
+ * @brief Rewrites the leading opcode of every matching sequence into its fused opcode.
+ * Operands and trailing opcodes are left untouched, so jump targets stay valid.
+ * Longer sequences take priority. Returns the number of rewritten sites.
+ */
+ml::i64 FuseSuperinstructions(hexe::ByteCode& bytecode, std::span<const Superinstruction> enabled);
+} // namespace hex
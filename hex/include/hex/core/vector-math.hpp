@@ -0,0 +1,163 @@
+#pragma once
+
+#include <hexe/value.hpp>
+
+#include <mana/literals.hpp>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#   include <emmintrin.h>
+#   define HEX_VECTOR_SSE
+#endif
+
+// kernels behind the Vec* opcodes
+// these always work on all four lanes, which is fine as the unused ones stay zero
+namespace hex::vec {
+namespace ml = mana::literals;
+
+using Lanes = hexe::Value::Lanes;
+
+// vec2i math wraps around, the same as the SSE2 path does
+// it's done unsigned, as overflowing signed arithmetic is undefined
+inline ml::i32 Wrap(const ml::u32 lane) {
+    return static_cast<ml::i32>(lane);
+}
+
+inline ml::u32 Unwrap(const ml::i32 lane) {
+    return static_cast<ml::u32>(lane);
+}
+
+#ifdef HEX_VECTOR_SSE
+inline __m128 LoadF(const Lanes& v) {
+    return _mm_loadu_ps(v.as_f32.data());
+}
+
+inline Lanes StoreF(const __m128 v) {
+    Lanes out;
+    _mm_storeu_ps(out.as_f32.data(), v);
+    return out;
+}
+
+inline __m128i LoadI(const Lanes& v) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(v.as_i32.data()));
+}
+
+inline Lanes StoreI(const __m128i v) {
+    Lanes out;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out.as_i32.data()), v);
+    return out;
+}
+
+inline Lanes AddF(const Lanes& l, const Lanes& r) {
+    return StoreF(_mm_add_ps(LoadF(l), LoadF(r)));
+}
+
+inline Lanes SubF(const Lanes& l, const Lanes& r) {
+    return StoreF(_mm_sub_ps(LoadF(l), LoadF(r)));
+}
+
+inline Lanes ScaleF(const Lanes& v, const ml::f32 s) {
+    return StoreF(_mm_mul_ps(LoadF(v), _mm_set1_ps(s)));
+}
+
+inline ml::f32 DotF(const Lanes& l, const Lanes& r) {
+    const __m128 products = _mm_mul_ps(LoadF(l), LoadF(r));
+    // (x + z, y + w) in the low lanes, then the two of them added up
+    const __m128 halves = _mm_add_ps(products, _mm_movehl_ps(products, products));
+    return _mm_cvtss_f32(_mm_add_ss(halves, _mm_shuffle_ps(halves, halves, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+inline Lanes Cross(const Lanes& l, const Lanes& r) {
+    const __m128 a = LoadF(l);
+    const __m128 b = LoadF(r);
+
+    // a.yzx * b.zxy - a.zxy * b.yzx, w ends up as 0 * 0 - 0 * 0
+    const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+
+    return StoreF(_mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx)));
+}
+
+inline Lanes AddI(const Lanes& l, const Lanes& r) {
+    return StoreI(_mm_add_epi32(LoadI(l), LoadI(r)));
+}
+
+inline Lanes SubI(const Lanes& l, const Lanes& r) {
+    return StoreI(_mm_sub_epi32(LoadI(l), LoadI(r)));
+}
+#else
+inline Lanes AddF(const Lanes& l, const Lanes& r) {
+    Lanes out;
+    for (ml::u8 i = 0; i < 4; ++i) {
+        out.as_f32[i] = l.as_f32[i] + r.as_f32[i];
+    }
+    return out;
+}
+
+inline Lanes SubF(const Lanes& l, const Lanes& r) {
+    Lanes out;
+    for (ml::u8 i = 0; i < 4; ++i) {
+        out.as_f32[i] = l.as_f32[i] - r.as_f32[i];
+    }
+    return out;
+}
+
+inline Lanes ScaleF(const Lanes& v, const ml::f32 s) {
+    Lanes out;
+    for (ml::u8 i = 0; i < 4; ++i) {
+        out.as_f32[i] = v.as_f32[i] * s;
+    }
+    return out;
+}
+
+inline ml::f32 DotF(const Lanes& l, const Lanes& r) {
+    return l.as_f32[0] * r.as_f32[0] + l.as_f32[1] * r.as_f32[1]
+         + l.as_f32[2] * r.as_f32[2] + l.as_f32[3] * r.as_f32[3];
+}
+
+inline Lanes Cross(const Lanes& l, const Lanes& r) {
+    const auto& a = l.as_f32;
+    const auto& b = r.as_f32;
+    return {{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0], 0.f}};
+}
+
+inline Lanes AddI(const Lanes& l, const Lanes& r) {
+    Lanes out;
+    for (ml::u8 i = 0; i < 4; ++i) {
+        out.as_i32[i] = Wrap(Unwrap(l.as_i32[i]) + Unwrap(r.as_i32[i]));
+    }
+    return out;
+}
+
+inline Lanes SubI(const Lanes& l, const Lanes& r) {
+    Lanes out;
+    for (ml::u8 i = 0; i < 4; ++i) {
+        out.as_i32[i] = Wrap(Unwrap(l.as_i32[i]) - Unwrap(r.as_i32[i]));
+    }
+    return out;
+}
+#endif
+
+inline Lanes ScaleI(const Lanes& v, const ml::i32 s) {
+    Lanes out {};
+    out.as_i32 = {Wrap(Unwrap(v.as_i32[0]) * Unwrap(s)), Wrap(Unwrap(v.as_i32[1]) * Unwrap(s)), 0, 0};
+    return out;
+}
+
+inline ml::i32 DotI(const Lanes& l, const Lanes& r) {
+    return Wrap(Unwrap(l.as_i32[0]) * Unwrap(r.as_i32[0]) + Unwrap(l.as_i32[1]) * Unwrap(r.as_i32[1]));
+}
+
+inline ml::f32 Length(const Lanes& v) {
+    return std::sqrt(DotF(v, v));
+}
+
+// the zero vector has no direction, and stays as it is
+inline Lanes Normalize(const Lanes& v) {
+    const ml::f32 length = Length(v);
+    return length == 0.f ? v : ScaleF(v, 1.f / length);
+}
+} // namespace hex::vec
@@ -12,7 +12,10 @@
 #   define TRACE_DISPATCH()                                                                    \
     const auto offset = ip - bytecode->Instructions().data();                                  \
         if (offset < bytecode->Instructions().size()) {                                        \
-            Log->debug("{:04} | {:<16}", offset, magic_enum::enum_name(static_cast<Op>(*ip))); \
+            Log->debug("{:04} | {:<16} {}",                                                    \
+                       offset,                                                                 \
+                       magic_enum::enum_name(static_cast<Op>(*ip)),                            \
+                       FormatSourceLocation(*bytecode, offset));                               \
         }
 #else
 #   define TRACE_DISPATCH()
@@ -4,6 +4,16 @@
 #include <hexe/bytecode.hpp>
 
 #include <array>
+#include <concepts>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace hex {
 namespace ml = mana::literals;
@@ -14,24 +24,249 @@ enum class InterpretResult {
     OK,
     CompileError,
     RuntimeError,
+    Yielded,   // only fibers yield, see Hex::Resume
+    Suspended, // ran out of its instruction budget, see Hex::Continue
 };
 
+enum class ExecutionMode {
+    Standard,
+    Counting, // records every dispatched opcode, see OpcodeStats
+    Budgeted, // backward jumps and calls spend from an instruction budget, and stop once it runs out
+};
+
+class OpcodeStats;
+class WorkerPool;
+
 struct StackFrame {
-    ml::u8* ret_addr;
+    const ml::u8* ret_addr;
     ml::i64 reg_frame;
 };
 
+// an exported function, resolved once so calling it involves no lookup
+struct FunctionHandle {
+    ml::u32 address;
+    ml::u16 register_count;
+    ml::u8 param_count;
+};
+
+enum class FiberState : ml::u8 {
+    Suspended, // spawned or yielded, and waiting to be resumed
+    Finished,
+    Failed,
+};
+
+/// A function of the loaded bytecode that runs until it yields, and picks up where it left off when resumed.
+///
+/// Fibers carry only their own registers and call stack, which start out at the size of the function's frame
+/// and grow as calls need them to, so thousands can share one Hex and the bytecode it loaded.
+class Fiber {
+    friend class Hex;
+
+    // register 0 is the fiber's return register, the function's window starts right after it
+    std::vector<hexe::Value> registers;
+    std::vector<StackFrame> call_stack;
+
+    const hexe::ByteCode* bytecode = nullptr;
+
+    const ml::u8* ip         = nullptr;
+    ml::i64 frame_offset     = 0;
+    ml::i64 current_function = 0;
+
+    FiberState state = FiberState::Failed;
+
+public:
+    HEX_NODISCARD FiberState State() const;
+
+    // the function's return value, once it has finished
+    HEX_NODISCARD const hexe::Value& Result() const;
+
+    // bytes the fiber takes up, counting its registers' storage
+    HEX_NODISCARD ml::usize Footprint() const;
+};
+
+// a host function scripts can call, which reads its arguments straight out of the caller's registers
+using NativeFunction = std::function<hexe::Value(std::span<const hexe::Value>)>;
+
+struct Native {
+    NativeFunction function;
+    ml::u8 param_count;
+};
+
+namespace detail {
+template <typename T>
+T FromValue(const hexe::Value& value) {
+    if constexpr (std::same_as<T, bool>) {
+        return value.AsBool();
+    } else if constexpr (std::floating_point<T>) {
+        return static_cast<T>(value.AsFloat());
+    } else if constexpr (std::signed_integral<T>) {
+        return static_cast<T>(value.AsInt());
+    } else if constexpr (std::unsigned_integral<T>) {
+        return static_cast<T>(value.AsUint());
+    } else {
+        static_assert(std::same_as<T, std::string_view>, "Natives can only take primitives and string views");
+        return value.AsString();
+    }
+}
+
+template <typename R, typename... Args, ml::usize... I>
+hexe::Value CallTyped(R (*function)(Args...), const std::span<const hexe::Value> args, std::index_sequence<I...>) {
+    if constexpr (std::same_as<R, void>) {
+        function(FromValue<std::remove_cvref_t<Args>>(args[I])...);
+        return {};
+    } else {
+        return hexe::Value(function(FromValue<std::remove_cvref_t<Args>>(args[I])...));
+    }
+}
+} // namespace detail
+
 class Hex {
-    std::array<hexe::Value, hexe::REGISTER_TOTAL> registers = {};
-    std::array<StackFrame, CALL_STACK_SIZE> call_stack      = {};
+    std::array<hexe::Value, hexe::REGISTER_TOTAL> main_registers = {};
+    std::array<StackFrame, CALL_STACK_SIZE> main_call_stack      = {};
+
+    // these point into the fiber being resumed, if there is one
+    hexe::Value* registers   = main_registers.data();
+    StackFrame* call_stack   = main_call_stack.data();
+    ml::i64 register_limit   = hexe::REGISTER_TOTAL;
+    ml::i64 call_stack_limit = CALL_STACK_SIZE;
+    Fiber* fiber             = nullptr;
 
-    ml::u8* ip               = nullptr;
+    const ml::u8* ip         = nullptr;
     ml::i64 frame_offset     = 0;
     ml::i64 current_function = -1;
 
+    // what's left of the budget the current run was given, only spent in the budgeted mode
+    ml::i64 budget = 0;
+
+    // a budgeted run ran out, and is waiting for Continue to pick it back up
+    bool preempted = false;
+
+    // a native is running, which may resume fibers but not call functions
+    bool in_native = false;
+
+    // registers the largest function of the loaded bytecode needs
+    // calls make sure there's room for two, as a frame stages its callee's arguments right after itself
+    ml::i64 frame_limit = 0;
+
+    const hexe::ByteCode* loaded = nullptr;
+    OpcodeStats* stats           = nullptr;
+
+    std::map<std::string, Native, std::less<>> natives;
+
+    // the loaded bytecode's imports, in the order CallNative refers to them
+    std::vector<const Native*> linked;
+
+    // splits parallel loops up, created once one is worth it
+    std::unique_ptr<WorkerPool> pool;
+    ml::u32 parallelism = 0;
+
+    // the pool's own Hexes run slices of a parallel loop, which end at its Join
+    bool slicing = false;
+
+    friend class WorkerPool;
+
+    enum class LoopFork : ml::u8 {
+        Serial, // the body runs on as a regular loop
+        Joined, // every iteration ran on the pool
+        Failed,
+    };
+
 public:
-    InterpretResult Execute(hexe::ByteCode* next_slice);
+    Hex();
+    ~Hex();
+
+    // the active registers point into the Hex itself
+    Hex(const Hex&)            = delete;
+    Hex& operator=(const Hex&) = delete;
+
+    InterpretResult Execute(const hexe::ByteCode* next_slice);
+
+    // same as Execute, but records every dispatched opcode into 'opcode_stats'
+    // this is considerably slower, and only meant for profiling
+    InterpretResult Execute(const hexe::ByteCode* next_slice, OpcodeStats& opcode_stats);
+
+    // same as Execute, but only lets the program take 'budget' backward jumps and calls,
+    // past which it returns Suspended, and Continue picks it up again
+    // straight-line code spends nothing, so this bounds the time spent in loops and recursion
+    InterpretResult Execute(const hexe::ByteCode* next_slice, ml::i64 budget);
+
+    // carries on with a run that was Suspended, with a new budget
+    InterpretResult Continue(ml::i64 budget);
+
+    // makes 'bytecode' the one functions are called from, without running Main
+    // Execute does this as well, and registers keep whatever Main left in them
+    // returns false if the bytecode imports a native that wasn't registered
+    bool Load(const hexe::ByteCode* bytecode);
+
+    // natives have to be registered before the bytecode calling them is loaded
+    // registering a name again replaces the earlier function
+    void RegisterNative(std::string_view name, ml::u8 param_count, NativeFunction function);
+
+    // arguments and the return value are converted to and from the function's own types
+    template <typename R, typename... Args>
+    void RegisterNative(const std::string_view name, R (*function)(Args...)) {
+        RegisterNative(name,
+                       sizeof...(Args),
+                       [function](const std::span<const hexe::Value> args) {
+                           return detail::CallTyped(function, args, std::index_sequence_for<Args...> {});
+                       }
+        );
+    }
+
+    HEX_NODISCARD std::optional<FunctionHandle> Find(std::string_view name) const;
+
+    // runs a function of the loaded bytecode until it returns, and gives back its return value
+    // natives can't call functions, as the run that called them would lose its registers
+    hexe::Value Call(FunctionHandle function, std::span<const hexe::Value> args);
+    hexe::Value Call(std::string_view name, std::span<const hexe::Value> args);
+
+    template <typename... Args>
+    hexe::Value Call(const FunctionHandle function, const Args&... args) {
+        const std::array<hexe::Value, sizeof...(Args)> values {hexe::Value(args)...};
+        return Call(function, std::span<const hexe::Value>(values));
+    }
+
+    template <typename... Args>
+    hexe::Value Call(const std::string_view name, const Args&... args) {
+        const std::array<hexe::Value, sizeof...(Args)> values {hexe::Value(args)...};
+        return Call(name, std::span<const hexe::Value>(values));
+    }
+
+    // sets up a fiber for a function of the loaded bytecode, which only starts running once resumed
+    // fibers stay tied to that bytecode, and fail to resume once another is loaded
+    HEX_NODISCARD Fiber Spawn(FunctionHandle function, std::span<const hexe::Value> args);
+
+    // runs the fiber until it yields or returns
+    // natives may resume other fibers, whatever was running carries on once they yield
+    FiberState Resume(Fiber& resumed);
+
+    // same as Resume, but the fiber is also suspended once it spends its budget, like Execute does
+    FiberState Resume(Fiber& resumed, ml::i64 budget);
+
+    // how many threads parallel loops are split between, counting the one running into them
+    // 1 runs them like any other loop, 0 uses every hardware thread, which is the default
+    void SetParallelism(ml::u32 thread_count);
 
     std::string ValueToString(const hexe::Value& value);
+
+private:
+    bool EnterMain(const hexe::ByteCode* bytecode);
+    bool Link(const hexe::ByteCode& bytecode);
+
+    // makes room for the next call, which only fibers are able to
+    bool Grow();
+
+    template <ExecutionMode Mode>
+    FiberState Switch(Fiber& resumed, ml::i64 fiber_budget);
+
+    // hands the parallel loop whose body starts at 'body' to the pool, if it's worth splitting up
+    LoopFork ForkLoop(const ml::u8* body, ml::u16 frame);
+
+    // runs iterations 'first' through 'last' of a parallel loop on the pool's behalf
+    // the registers below 'frame' are borrowed from the owner's, which waits for the loop to finish
+    bool RunSlice(const Hex& owner, const ml::u8* body, ml::u16 frame, ml::i64 first, ml::i64 last);
+
+    template <ExecutionMode Mode>
+    InterpretResult Run(const hexe::ByteCode* bytecode);
 };
 } // namespace hex
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <hex/hex.hpp>
+
+#include <mana/literals.hpp>
+
+#include <span>
+#include <vector>
+
+namespace hex {
+namespace ml = mana::literals;
+
+/**
+ * @brief Round-robin scheduler over the fibers of one Hex.
+ * Each tick resumes every fiber once, in the order they were spawned, and drops those that are done.
+ */
+class Scheduler {
+    Hex& vm;
+
+    std::vector<Fiber> fibers;
+
+    // natives may spawn fibers mid-tick, which would move the one being resumed
+    std::vector<Fiber> spawned;
+
+public:
+    explicit Scheduler(Hex& vm);
+
+    // the fiber first runs on the next tick, returns false if it couldn't be spawned
+    bool Spawn(FunctionHandle function, std::span<const hexe::Value> args);
+
+    // returns how many fibers are still suspended
+    ml::usize Tick();
+
+    // same as Tick, but each fiber is also suspended once it spends 'budget', see Hex::Resume
+    ml::usize Tick(ml::i64 budget);
+
+    HEX_NODISCARD ml::usize Count() const;
+
+private:
+    template <typename Resume>
+    ml::usize Advance(Resume resume);
+};
+} // namespace hex
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <hexe/bytecode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace hex::tools {
+namespace ml = mana::literals;
+
+/**
+ * @brief Collects .hexe executables from the given files and directories.
+ * Directories are searched recursively, and the result is sorted for reproducible reports.
+ */
+std::vector<std::filesystem::path> CollectExecutables(std::span<const std::string> inputs);
+
+bool LoadExecutable(const std::filesystem::path& path, hexe::ByteCode& bytecode);
+
+/**
+ * @brief Sends stdout to the null device for as long as it lives,
+ * so the output of benchmarked programs doesn't bury the report.
+ */
+class SilencedOutput {
+    int saved_stdout;
+
+public:
+    SilencedOutput();
+    ~SilencedOutput();
+
+    SilencedOutput(const SilencedOutput&)            = delete;
+    SilencedOutput& operator=(const SilencedOutput&) = delete;
+};
+} // namespace hex::tools
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mana/literals.hpp>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace hex::tools {
+namespace ml = mana::literals;
+
+enum class PerfEvent : ml::u8 {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1dMisses,
+    LLCMisses,
+    PageFaults,
+};
+
+std::string_view PerfEventName(PerfEvent event);
+
+/**
+ * @brief Hardware and software event counters around a region of code, backed by perf_event_open on Linux.
+ *
+ * Each event is opened on its own, so the ones the host refuses (common in containers
+ * and VMs, or with a strict perf_event_paranoid) are simply reported as unavailable,
+ * while the rest keep counting. On other platforms every event is unavailable.
+ */
+class PerfCounters {
+public:
+    static constexpr auto EVENT_COUNT = static_cast<ml::usize>(PerfEvent::PageFaults) + 1;
+
+    struct Sample {
+        std::array<std::optional<ml::f64>, EVENT_COUNT> values;
+
+        std::optional<ml::f64> operator[](PerfEvent event) const;
+        Sample& operator+=(const Sample& other);
+        Sample& operator/=(ml::f64 divisor);
+    };
+
+private:
+    std::array<int, EVENT_COUNT> fds;
+    std::array<std::string, EVENT_COUNT> errors;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&)            = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool IsAvailable(PerfEvent event) const;
+    bool AnyAvailable() const;
+
+    // why the event couldn't be opened, empty if it's available
+    std::string_view Error(PerfEvent event) const;
+
+    void Start();
+    void Stop();
+
+    // values since the last Start, scaled up if the kernel had to multiplex the counters
+    Sample Read() const;
+};
+} // namespace hex::tools
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <hex/hex.hpp>
+
+#include <hexe/bytecode.hpp>
+
+#include <mana/literals.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hex {
+namespace ml = mana::literals;
+
+/**
+ * @brief Threads splitting the iterations of parallel loops between them, each running slices on a Hex of its own.
+ * The loop's whole range starts out with the thread that ran into it, which works through it as well.
+ * Workers halve whatever range they take down to the grain size, keeping the halves at the back of their own queue,
+ * and idle workers steal the largest ranges from the front of everyone else's, so uneven iterations even out.
+ */
+class WorkerPool {
+    struct Range {
+        ml::i64 first;
+        ml::i64 last;
+    };
+
+    struct Worker {
+        std::unique_ptr<Hex> vm;
+
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    const hexe::ByteCode* bytecode;
+
+    // worker 0 belongs to whichever thread runs the loop
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // the loop being run, only read by workers once they've taken a range of it
+    const Hex* owner   = nullptr;
+    const ml::u8* body = nullptr;
+    ml::u16 frame      = 0;
+    ml::i64 grain      = 1;
+
+    std::atomic<ml::i64> remaining = 0;
+    std::atomic<bool> failed       = false;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+
+    ml::u64 generation = 0;
+    ml::u32 busy       = 0;
+    bool stopping      = false;
+
+    // last, so they're joined before anything they use is destroyed
+    std::vector<std::jthread> threads;
+
+public:
+    // every worker gets the owner's natives and loaded bytecode
+    WorkerPool(const Hex& owner, ml::u32 thread_count);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&)            = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    HEX_NODISCARD const hexe::ByteCode* Bytecode() const;
+
+    // below this many iterations, a loop isn't worth waking any threads for
+    HEX_NODISCARD static bool IsWorthSplitting(ml::i64 iterations);
+
+    // runs iterations 'first' through 'last' of the body, which starts right after the loop's ParallelFor
+    // returns once every iteration has, false if any of them failed
+    bool Run(const Hex& loop_owner, const ml::u8* loop_body, ml::u16 loop_frame, ml::i64 first, ml::i64 last);
+
+private:
+    void Serve(ml::usize index);
+    void Work(ml::usize index);
+
+    bool Take(ml::usize index, Range& range);
+};
+} // namespace hex
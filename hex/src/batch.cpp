@@ -0,0 +1,103 @@
+#include <hex/batch.hpp>
+#include <hex/core/logger.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace hex {
+Batch::Batch(const hexe::ByteCode& bytecode, const ml::u32 thread_count, std::function<void(Hex&)> setup)
+    : bytecode(bytecode),
+      thread_count(thread_count > 0 ? thread_count : std::max(std::thread::hardware_concurrency(), 1u)),
+      setup(std::move(setup)) {}
+
+std::vector<InterpretResult> Batch::Execute(const ml::usize runs) const {
+    std::vector results(runs, InterpretResult::RuntimeError);
+
+    Distribute(runs,
+               [this, &results](Hex& vm, const ml::usize run) {
+                   results[run] = vm.Execute(&bytecode);
+               }
+    );
+
+    return results;
+}
+
+std::vector<hexe::Value> Batch::Call(const std::string_view function,
+                                     const std::span<const std::vector<hexe::Value>> inputs) const {
+    std::vector<hexe::Value> results(inputs.size());
+
+    const auto* entry = bytecode.FindExport(function);
+    if (entry == nullptr) {
+        Log->error("No exported function is named '{}'", function);
+        return results;
+    }
+
+    const FunctionHandle handle {
+        static_cast<ml::u32>(entry->address),
+        entry->register_count,
+        entry->param_count,
+    };
+
+    Distribute(inputs.size(),
+               [handle, inputs, &results](Hex& vm, const ml::usize call) {
+                   results[call] = vm.Call(handle, std::span<const hexe::Value>(inputs[call]));
+               }
+    );
+
+    return results;
+}
+
+ml::u32 Batch::ThreadCount() const {
+    return thread_count;
+}
+
+bool Batch::Distribute(const ml::usize count, const std::function<void(Hex&, ml::usize)>& task) const {
+    std::atomic<ml::usize> next = 0;
+
+    const auto make_vm = [this] {
+        auto vm = std::make_unique<Hex>();
+
+        // the batch already keeps every thread busy, setup may still ask for more
+        vm->SetParallelism(1);
+        if (setup) {
+            setup(*vm);
+        }
+        return vm;
+    };
+
+    const auto work = [&next, count, &task](Hex& vm) {
+        for (auto i = next++; i < count; i = next++) {
+            task(vm, i);
+        }
+    };
+
+    // every worker is set up the same way, so if the first one links, they all do
+    const auto first = make_vm();
+    if (not first->Load(&bytecode)) {
+        Log->error("Failed to load the batch's bytecode");
+        return false;
+    }
+
+    const auto workers = std::clamp<ml::usize>(count, 1, thread_count);
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(workers - 1);
+
+        for (ml::usize i = 1; i < workers; ++i) {
+            threads.emplace_back([&make_vm, &work, this] {
+                const auto vm = make_vm();
+                if (vm->Load(&bytecode)) {
+                    work(*vm);
+                }
+            });
+        }
+
+        // the calling thread works through the runs as well, rather than sitting idle
+        work(*first);
+    }
+
+    return true;
+}
+} // namespace hex
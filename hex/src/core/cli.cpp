@@ -15,6 +15,20 @@ CommandLineSettings::CommandLineSettings(const int argc, char** argv)
 i64 CommandLineSettings::Populate() {
     cli->set_version_flag("-v,--version", "Hex v" HEX_VER_STRING);
     cli->add_option("-e, --executable,executable", hexe_name, "The executable to run.");
+    cli->add_option("--budget",
+                    budget,
+                    "Suspend execution every time this many backward jumps and calls have been taken, then continue it, "
+                    "like a host spreading a script over several frames would."
+    );
+    cli->add_option("-j,--threads",
+                    thread_count,
+                    "Number of VMs running the executable in parallel, all sharing the one loaded program. "
+                    "0 uses every hardware thread."
+    );
+    cli->add_option("--runs",
+                    run_count,
+                    "How many times to run the executable, spread over the threads. Defaults to once per thread."
+    );
 
     try {
         cli->parse(argc, argv);
@@ -37,6 +51,18 @@ std::string_view CommandLineSettings::HexeName() const {
     return hexe_name;
 }
 
+i64 CommandLineSettings::Budget() const {
+    return budget;
+}
+
+u32 CommandLineSettings::ThreadCount() const {
+    return thread_count;
+}
+
+u64 CommandLineSettings::RunCount() const {
+    return run_count;
+}
+
 bool CommandLineSettings::ShouldExit() {
     return should_exit;
 }
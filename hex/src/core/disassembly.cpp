@@ -1,5 +1,6 @@
 #include <hex/core/disassembly.hpp>
 #include <hex/core/logger.hpp>
+#include <hex/core/superinstructions.hpp>
 
 #include <hexe/bytecode.hpp>
 #include <hexe/value.hpp>
@@ -20,16 +21,141 @@ static u16 ReadPayload(const u8 first_byte, const u8 second_byte) {
     return static_cast<u16>(first_byte | (second_byte << 8));
 }
 
+i64 InstructionSize(const Op op) {
+    switch (op) {
+        using enum Op;
+    case Halt:
+    case Err:
+    case Yield:
+    case Join:
+        return 1;
+
+    case Return:
+    case Print:
+    case Jump:
+    case ListSort:
+        return 3;
+
+    case LoadConstant:
+    case Move:
+    case Negate:
+    case Not:
+    case PrintValue:
+    case JumpWhenTrue:
+    case JumpWhenFalse:
+    case CallNative:
+    case ParallelFor:
+    case VecLength:
+    case VecNormalize:
+    case ListFill:
+    case ListCopy:
+    case ListSum:
+    case ListMin:
+    case ListMax:
+    case MapCreate:
+    case MapCount:
+        return 5;
+
+    case Call:
+        return 1 + CALL_BYTES;
+
+    case Add:
+    case Sub:
+    case Div:
+    case Mul:
+    case Mod:
+    case Cmp_Greater:
+    case Cmp_GreaterEq:
+    case Cmp_Lesser:
+    case Cmp_LesserEq:
+    case Equals:
+    case NotEquals:
+    case ListCreate:
+    case ListRead:
+    case ListWrite:
+    case ListStore:
+    case ListReadI8:
+    case ListReadI16:
+    case ListReadI32:
+    case ListReadU8:
+    case ListReadU16:
+    case ListReadU32:
+    case ListReadF32:
+    case ListReadBit:
+    case ListStore8:
+    case ListStore16:
+    case ListStore32:
+    case ListStoreF32:
+    case ListStoreBit:
+    case VecAdd:
+    case VecSub:
+    case VecScale:
+    case VecDot:
+    case VecCross:
+    case VecLane:
+    case ListFind:
+    case ListAdd:
+    case ListMul:
+    case MapSet:
+    case MapHas:
+    case MapRemove:
+    case MapKeyAt:
+    case MapValueAt:
+        return 7;
+
+    case ListSlice:
+    case MapGet:
+        return 9;
+
+    case VecMake:
+        return 13;
+
+    default:
+        break;
+    }
+
+    if (const auto* fused = FindSuperinstruction(op)) {
+        return InstructionSize(fused->sequence[0]);
+    }
+
+    // unknown opcodes are skipped one byte at a time
+    return 1;
+}
+
+std::string FormatSourceLocation(const ByteCode& s, const i64 offset) {
+    const auto* entry = s.LocateSource(offset);
+    if (entry == nullptr) {
+        return {};
+    }
+
+    return fmt::format("{}:{}", s.SourceName(), entry->line);
+}
+
 void PrintBytecode(const ByteCode& s) {
     using enum Value::Data::Type;
 
-    const auto& code = s.Instructions();
+    const auto& code       = s.Instructions();
+    const auto& line_table = s.LineTable();
+    usize next_line        = 0;
 
     for (i64 i = 0; i < code.size(); ++i) {
         const i64 offset = i;
-        const auto op    = static_cast<Op>(code[i]);
+        auto op          = static_cast<Op>(code[i]);
         const auto name  = magic_enum::enum_name(op);
 
+        // fused opcodes decode as the leading opcode of their sequence
+        if (const auto* fused = FindSuperinstruction(op)) {
+            op = fused->sequence[0];
+        }
+
+        // annotate where each statement's instructions begin
+        while (next_line < line_table.size() && line_table[next_line].offset <= offset) {
+            if (line_table[next_line].offset == offset) {
+                Log->debug("{:>8} ; {}:{}", "", s.SourceName(), line_table[next_line].line);
+            }
+            ++next_line;
+        }
+
         // Helper to read 2-byte payloads and advance the loop counter
         auto read = [&] {
             u16 val = ReadPayload(code[i + 1], code[i + 2]);
@@ -41,13 +167,16 @@ void PrintBytecode(const ByteCode& s) {
         switch (op) {
             using enum Op;
         case Halt:
-        case Err: {
+        case Err:
+        case Yield:
+        case Join: {
             Log->debug("{:08X} | {:<15}\n", offset, name);
             break;
         }
 
         case Print:
-        case Return: {
+        case Return:
+        case ListSort: {
             const u16 reg = read();
             Log->debug("{:08X} | {:<15} R{}\n", offset, name, reg);
             break;
@@ -100,6 +229,14 @@ void PrintBytecode(const ByteCode& s) {
         case Move:
         case Negate:
         case PrintValue:
+        case VecLength:
+        case VecNormalize:
+        case ListFill:
+        case ListCopy:
+        case ListSum:
+        case ListMin:
+        case ListMax:
+        case MapCount:
         case Not: {
             const u16 dst = read();
             const u16 src = read();
@@ -117,7 +254,19 @@ void PrintBytecode(const ByteCode& s) {
         case Cmp_Lesser:
         case Cmp_LesserEq:
         case Equals:
-        case NotEquals: {
+        case NotEquals:
+        case VecAdd:
+        case VecSub:
+        case VecScale:
+        case VecDot:
+        case VecCross:
+        case ListFind:
+        case ListAdd:
+        case ListMul:
+        case MapHas:
+        case MapRemove:
+        case MapKeyAt:
+        case MapValueAt: {
             const u16 dst = read();
             const u16 lhs = read();
             const u16 rhs = read();
@@ -165,7 +314,15 @@ void PrintBytecode(const ByteCode& s) {
             break;
         }
 
-        case ListRead: {
+        case ListRead:
+        case ListReadI8:
+        case ListReadI16:
+        case ListReadI32:
+        case ListReadU8:
+        case ListReadU16:
+        case ListReadU32:
+        case ListReadF32:
+        case ListReadBit: {
             const u16 src = read();
             const u16 idx = read();
             const u16 dst = read();
@@ -181,6 +338,114 @@ void PrintBytecode(const ByteCode& s) {
             break;
         }
 
+        case ListStore:
+        case ListStore8:
+        case ListStore16:
+        case ListStore32:
+        case ListStoreF32:
+        case ListStoreBit: {
+            const u16 dst = read();
+            const u16 idx = read();
+            const u16 src = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- R{}", offset, name, fmt::format("R{}[R{}]", dst, idx), src);
+            break;
+        }
+
+        case ListSlice: {
+            const u16 dst  = read();
+            const u16 src  = read();
+            const u16 from = read();
+            const u16 to   = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- R{}[R{}..R{}]", offset, name, fmt::format("R{}", dst), src, from, to);
+            break;
+        }
+
+        case MapCreate: {
+            const u16 type = read();
+            const u16 dst  = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- {}",
+                       offset,
+                       name,
+                       fmt::format("R{}", dst),
+                       magic_enum::enum_name(static_cast<Value::Data::Type>(type))
+            );
+            break;
+        }
+
+        case MapGet: {
+            const u16 dst      = read();
+            const u16 src      = read();
+            const u16 key      = read();
+            const u16 fallback = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- R{}[R{}] or R{}", offset, name, fmt::format("R{}", dst), src, key, fallback);
+            break;
+        }
+
+        case MapSet: {
+            const u16 dst = read();
+            const u16 key = read();
+            const u16 src = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- R{}", offset, name, fmt::format("R{}[R{}]", dst, key), src);
+            break;
+        }
+
+        case VecMake: {
+            const u16 type = read();
+            const u16 dst  = read();
+            const u16 x    = read();
+            const u16 y    = read();
+            const u16 z    = read();
+            const u16 w    = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- {}(R{}, R{}, R{}, R{})",
+                       offset,
+                       name,
+                       fmt::format("R{}", dst),
+                       magic_enum::enum_name(static_cast<Value::Data::Type>(type)),
+                       x,
+                       y,
+                       z,
+                       w
+            );
+            break;
+        }
+
+        case VecLane: {
+            const u16 dst = read();
+            const u16 src = read();
+            const u16 idx = read();
+            Log->debug("{:08X} | {:<15} {:<10} <- R{}[R{}]", offset, name, fmt::format("R{}", dst), src, idx);
+            break;
+        }
+
+        case ParallelFor: {
+            const u16 frame = read();
+            const i16 dist  = static_cast<i16>(read());
+            // Offset + Opcode (1) + Frame (2) + Destination (2)
+            Log->debug("{:08X} | {:<15} {:<10} => {:08X}",
+                       offset,
+                       name,
+                       fmt::format("(Frame: {})", frame),
+                       offset + 5 + dist
+            );
+            break;
+        }
+
+        case CallNative: {
+            const u16 idx  = read();
+            const u16 base = read();
+
+            const auto& imports = s.Imports();
+            const auto native   = idx < imports.size() ? std::string_view(imports[idx].name) : "???";
+            Log->debug("{:08X} | {:<15} {:<10} ==> {} [import index: {}]",
+                       offset,
+                       name,
+                       fmt::format("(Args: R{})", base),
+                       native,
+                       idx
+            );
+            break;
+        }
+
         default:
             Log->debug("{:08X} | {:<15} ({})", offset, "???", static_cast<u8>(op));
             break;
@@ -0,0 +1,359 @@
+#include <hex/core/list-math.hpp>
+#include <hex/core/vector-math.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace hex::list {
+using namespace hexe;
+using namespace mana::literals;
+
+using enum Value::Data::Type;
+
+namespace {
+// what an element widens to once it's in a register
+template <typename T>
+using Wide = std::conditional_t<std::is_floating_point_v<T>,
+                                f64,
+                                std::conditional_t<std::is_signed_v<T>, i64, u64>>;
+
+template <typename T>
+Wide<T> AsWide(const Value& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return value.AsFloat();
+    } else if constexpr (std::is_signed_v<T>) {
+        return value.AsInt();
+    } else {
+        return value.AsUint();
+    }
+}
+
+// calls 'kernel' with a T of the type a numeric list's elements are stored as
+// Bits lists count bits rather than elements, so they never make it here
+template <typename Kernel>
+decltype(auto) WithElementType(const Value::Data::Type type, Kernel&& kernel) {
+    switch (type) {
+    case Int8:
+        return kernel(i8 {});
+    case Int16:
+        return kernel(i16 {});
+    case Int32:
+        return kernel(i32 {});
+    case Int64:
+        return kernel(i64 {});
+    case Uint8:
+        return kernel(u8 {});
+    case Uint16:
+        return kernel(u16 {});
+    case Uint32:
+        return kernel(u32 {});
+    case Uint64:
+        return kernel(u64 {});
+    case Float32:
+        return kernel(f32 {});
+    case Float64:
+        return kernel(f64 {});
+    default:
+        // emptied lists lose their type, but they have no elements to misread either
+        return kernel(i64 {});
+    }
+}
+
+template <typename T>
+Wide<T> SumOf(const T* elements, const u32 count) {
+    Wide<T> total {};
+    u32 i = 0;
+
+#ifdef HEX_VECTOR_SSE
+    if constexpr (std::is_same_v<T, f64>) {
+        __m128d lanes = _mm_setzero_pd();
+        for (; i + 2 <= count; i += 2) {
+            lanes = _mm_add_pd(lanes, _mm_loadu_pd(elements + i));
+        }
+        total = _mm_cvtsd_f64(_mm_add_sd(lanes, _mm_unpackhi_pd(lanes, lanes)));
+    } else if constexpr (std::is_same_v<T, f32>) {
+        __m128 lanes = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            lanes = _mm_add_ps(lanes, _mm_loadu_ps(elements + i));
+        }
+
+        std::array<f32, 4> partial;
+        _mm_storeu_ps(partial.data(), lanes);
+        total = f64 {partial[0]} + partial[1] + partial[2] + partial[3];
+    }
+#endif
+
+    if constexpr (std::is_floating_point_v<T>) {
+        for (; i < count; ++i) {
+            total += elements[i];
+        }
+        return total;
+    } else {
+        // wraps around like Combine does, without overflowing signed arithmetic on the way
+        u64 sum = 0;
+        for (; i < count; ++i) {
+            sum += static_cast<u64>(elements[i]);
+        }
+        return static_cast<Wide<T>>(sum);
+    }
+}
+
+// 'count' can't be 0
+template <typename T, bool IsMax>
+T ExtremeOf(const T* elements, const u32 count) {
+    const auto pick = [](const T a, const T b) {
+        return IsMax ? std::max(a, b) : std::min(a, b);
+    };
+
+    T best = elements[0];
+    u32 i  = 1;
+
+#ifdef HEX_VECTOR_SSE
+    if constexpr (std::is_same_v<T, f32>) {
+        if (count >= 4) {
+            __m128 lanes = _mm_loadu_ps(elements);
+            for (i = 4; i + 4 <= count; i += 4) {
+                const __m128 next = _mm_loadu_ps(elements + i);
+                lanes             = IsMax ? _mm_max_ps(lanes, next) : _mm_min_ps(lanes, next);
+            }
+
+            std::array<f32, 4> partial;
+            _mm_storeu_ps(partial.data(), lanes);
+            best = pick(pick(partial[0], partial[1]), pick(partial[2], partial[3]));
+        }
+    } else if constexpr (std::is_same_v<T, f64>) {
+        if (count >= 2) {
+            __m128d lanes = _mm_loadu_pd(elements);
+            for (i = 2; i + 2 <= count; i += 2) {
+                const __m128d next = _mm_loadu_pd(elements + i);
+                lanes              = IsMax ? _mm_max_pd(lanes, next) : _mm_min_pd(lanes, next);
+            }
+
+            std::array<f64, 2> partial;
+            _mm_storeu_pd(partial.data(), lanes);
+            best = pick(partial[0], partial[1]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        best = pick(best, elements[i]);
+    }
+    return best;
+}
+
+#ifdef HEX_VECTOR_SSE
+template <typename T>
+__m128i AddLanes(const __m128i l, const __m128i r) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm_add_epi8(l, r);
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_add_epi16(l, r);
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm_add_epi32(l, r);
+    } else {
+        return _mm_add_epi64(l, r);
+    }
+}
+#endif
+
+template <typename T, bool IsMul>
+void Combine(T* out, const T* lhs, const T* rhs, const u32 count) {
+    u32 i = 0;
+
+#ifdef HEX_VECTOR_SSE
+    if constexpr (std::is_same_v<T, f32>) {
+        for (; i + 4 <= count; i += 4) {
+            const __m128 l = _mm_loadu_ps(lhs + i);
+            const __m128 r = _mm_loadu_ps(rhs + i);
+            _mm_storeu_ps(out + i, IsMul ? _mm_mul_ps(l, r) : _mm_add_ps(l, r));
+        }
+    } else if constexpr (std::is_same_v<T, f64>) {
+        for (; i + 2 <= count; i += 2) {
+            const __m128d l = _mm_loadu_pd(lhs + i);
+            const __m128d r = _mm_loadu_pd(rhs + i);
+            _mm_storeu_pd(out + i, IsMul ? _mm_mul_pd(l, r) : _mm_add_pd(l, r));
+        }
+    } else if constexpr (not IsMul) {
+        // SSE2 only multiplies some of the integer widths, so those are left to the loop below
+        constexpr u32 lanes = sizeof(__m128i) / sizeof(T);
+        for (; i + lanes <= count; i += lanes) {
+            const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+            const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), AddLanes<T>(l, r));
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+            out[i] = IsMul ? lhs[i] * rhs[i] : lhs[i] + rhs[i];
+        } else {
+            // wraps around at the element's width, without overflowing signed arithmetic on the way
+            const auto l = static_cast<u64>(lhs[i]);
+            const auto r = static_cast<u64>(rhs[i]);
+            out[i]       = static_cast<T>(IsMul ? l * r : l + r);
+        }
+    }
+}
+
+// lists of different lengths aren't an error, the result simply stops where the shorter one does,
+// the same as Copy does
+template <bool IsMul>
+Value Combined(const Value& lhs, const Value& rhs) {
+    const auto count = std::min(lhs.Count(), rhs.Count());
+
+    // bools have no arithmetic, which the analyzer makes sure of
+    Value out {static_cast<u8>(lhs.Type()), lhs.Type() == Bits ? 0 : count};
+    if (out.Count() == 0) {
+        return out;
+    }
+
+    WithElementType(lhs.Type(), [&]<typename T>(T) {
+        Combine<T, IsMul>(out.Elements<T>(), lhs.Elements<T>(), rhs.Elements<T>(), count);
+    });
+    return out;
+}
+
+template <bool IsMax>
+Value Extreme(const Value& list) {
+    if (list.Type() == Bits) {
+        return Value {i64 {0}};
+    }
+
+    return WithElementType(list.Type(), [&]<typename T>(T) {
+        if (list.Count() == 0) {
+            return Value {Wide<T> {}};
+        }
+        return Value {static_cast<Wide<T>>(ExtremeOf<T, IsMax>(list.Elements<T>(), list.Count()))};
+    });
+}
+} // namespace
+
+void Fill(Value& list, const Value& value) {
+    if (list.Type() == Bits) {
+        if (list.ByteLength() != 0) {
+            std::memset(list.Elements<u8>(), value.AsBool() ? 0xFF : 0, list.ByteLength());
+        }
+        return;
+    }
+
+    WithElementType(list.Type(), [&]<typename T>(T) {
+        std::fill_n(list.Elements<T>(), list.Count(), static_cast<T>(AsWide<T>(value)));
+    });
+}
+
+void Copy(Value& dst, const Value& src) {
+    const auto count = std::min(dst.Count(), src.Count());
+
+    if (dst.Type() == Bits) {
+        for (u32 i = 0; i < count; ++i) {
+            dst.SetBit(i, src.Bit(i));
+        }
+        return;
+    }
+
+    // a list may well be copied onto itself
+    if (count != 0) {
+        std::memmove(dst.Elements<u8>(), src.Elements<u8>(), count * Value::ElementSize(dst.Type()));
+    }
+}
+
+Value Slice(const Value& list, i64 from, i64 to) {
+    const i64 count = list.Count();
+
+    from = std::clamp<i64>(from, 0, count);
+    to   = std::clamp<i64>(to, from, count);
+
+    const auto length = static_cast<Value::SizeType>(to - from);
+    Value out {static_cast<u8>(list.Type()), length};
+
+    if (list.Type() == Bits) {
+        for (u32 i = 0; i < length; ++i) {
+            out.SetBit(i, list.Bit(from + i));
+        }
+        return out;
+    }
+
+    if (length != 0) {
+        const auto width = Value::ElementSize(list.Type());
+        std::memcpy(out.Elements<u8>(), list.Elements<u8>() + from * width, length * width);
+    }
+    return out;
+}
+
+Value Sum(const Value& list) {
+    if (list.Type() == Bits) {
+        return Value {i64 {0}};
+    }
+
+    return WithElementType(list.Type(), [&]<typename T>(T) {
+        return Value {SumOf(list.Elements<T>(), list.Count())};
+    });
+}
+
+Value Min(const Value& list) {
+    return Extreme<false>(list);
+}
+
+Value Max(const Value& list) {
+    return Extreme<true>(list);
+}
+
+i64 Find(const Value& list, const Value& value) {
+    const auto count = list.Count();
+
+    if (list.Type() == Bits) {
+        const bool wanted = value.AsBool();
+        for (u32 i = 0; i < count; ++i) {
+            if (list.Bit(i) == wanted) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // compared at full width, so 300 isn't found in a [u8] as the 44 it would narrow to
+    return WithElementType(list.Type(), [&]<typename T>(T) -> i64 {
+        const auto wanted    = AsWide<T>(value);
+        const auto* elements = list.Elements<T>();
+        const auto* found    = std::find_if(elements, elements + count, [wanted](const T element) {
+            return static_cast<Wide<T>>(element) == wanted;
+        });
+
+        return found == elements + count ? -1 : found - elements;
+    });
+}
+
+void Sort(Value& list) {
+    if (list.Type() == Bits) {
+        return;
+    }
+
+    WithElementType(list.Type(), [&]<typename T>(T) {
+        auto* first = list.Elements<T>();
+        auto* last  = first + list.Count();
+
+        // NaNs compare false against everything, which breaks the ordering std::sort relies on,
+        // so they're moved to the back before the rest gets sorted
+        if constexpr (std::is_floating_point_v<T>) {
+            last = std::partition(first, last, [](const T element) {
+                return not std::isnan(element);
+            });
+        }
+
+        std::sort(first, last);
+    });
+}
+
+Value Add(const Value& lhs, const Value& rhs) {
+    return Combined<false>(lhs, rhs);
+}
+
+Value Mul(const Value& lhs, const Value& rhs) {
+    return Combined<true>(lhs, rhs);
+}
+} // namespace hex::list
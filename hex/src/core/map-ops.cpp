@@ -0,0 +1,82 @@
+#include <hex/core/map-ops.hpp>
+
+#include <hexe/map.hpp>
+
+#include <string>
+
+namespace hex::map {
+using namespace hexe;
+using namespace mana::literals;
+
+using enum Value::Data::Type;
+
+const Value* Find(const Value& map, const Value& key) {
+    if (map.Type() == IntMap) {
+        const auto& ints = map.AsIntMap();
+        const auto it    = ints.find(key.AsInt());
+        return it == ints.end() ? nullptr : &it->second;
+    }
+
+    const auto& strings = map.AsStringMap();
+    const auto it       = strings.find(key.AsString());
+    return it == strings.end() ? nullptr : &it->second;
+}
+
+void Set(Value& map, const Value& key, const Value& value) {
+    if (map.Type() == IntMap) {
+        map.AsIntMap()[key.AsInt()] = value;
+        return;
+    }
+
+    // only keys which are new get copied into the map
+    auto& strings   = map.AsStringMap();
+    const auto name = key.AsString();
+
+    if (const auto it = strings.find(name); it != strings.end()) {
+        it->second = value;
+        return;
+    }
+    strings.insert_unique(std::string {name}, value);
+}
+
+bool Remove(Value& map, const Value& key) {
+    if (map.Type() == IntMap) {
+        return map.AsIntMap().erase(key.AsInt()) != 0;
+    }
+
+    auto& strings = map.AsStringMap();
+    const auto it = strings.find(key.AsString());
+    if (it == strings.end()) {
+        return false;
+    }
+
+    strings.erase(it);
+    return true;
+}
+
+u32 Count(const Value& map) {
+    return map.Type() == IntMap ? map.AsIntMap().size() : map.AsStringMap().size();
+}
+
+std::optional<Value> KeyAt(const Value& map, const i64 index) {
+    if (index < 0 || index >= Count(map)) {
+        return std::nullopt;
+    }
+
+    if (map.Type() == IntMap) {
+        return Value {map.AsIntMap().values()[index].first};
+    }
+    return Value {std::string_view {map.AsStringMap().values()[index].first}};
+}
+
+const Value* ValueAt(const Value& map, const i64 index) {
+    if (index < 0 || index >= Count(map)) {
+        return nullptr;
+    }
+
+    if (map.Type() == IntMap) {
+        return &map.AsIntMap().values()[index].second;
+    }
+    return &map.AsStringMap().values()[index].second;
+}
+} // namespace hex::map
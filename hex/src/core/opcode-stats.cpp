@@ -0,0 +1,92 @@
+#include <hex/core/opcode-stats.hpp>
+
+#include <algorithm>
+
+namespace hex {
+using namespace hexe;
+using namespace mana::literals;
+
+OpcodeStats::OpcodeStats()
+    : unigrams(OP_COUNT),
+      bigrams(OP_COUNT * OP_COUNT),
+      trigrams(OP_COUNT * OP_COUNT * OP_COUNT),
+      total {0},
+      previous {NO_OPCODE},
+      before_previous {NO_OPCODE} {}
+
+void OpcodeStats::EndSequence() {
+    previous        = NO_OPCODE;
+    before_previous = NO_OPCODE;
+}
+
+void OpcodeStats::Merge(const OpcodeStats& other) {
+    const auto add = [](std::vector<u64>& into, const std::vector<u64>& from) {
+        for (usize i = 0; i < into.size(); ++i) {
+            into[i] += from[i];
+        }
+    };
+
+    add(unigrams, other.unigrams);
+    add(bigrams, other.bigrams);
+    add(trigrams, other.trigrams);
+
+    total += other.total;
+}
+
+u64 OpcodeStats::Total() const {
+    return total;
+}
+
+u64 OpcodeStats::Count(const Op op) const {
+    return unigrams[static_cast<u8>(op)];
+}
+
+u64 OpcodeStats::Count(const Op first, const Op second) const {
+    return bigrams[static_cast<u8>(first) * OP_COUNT + static_cast<u8>(second)];
+}
+
+u64 OpcodeStats::Count(const Op first, const Op second, const Op third) const {
+    return trigrams[(static_cast<u8>(first) * OP_COUNT + static_cast<u8>(second)) * OP_COUNT
+                    + static_cast<u8>(third)];
+}
+
+std::vector<OpcodeStats::Sequence> OpcodeStats::Ranked(const u8 length) const {
+    std::vector<Sequence> out;
+
+    const std::vector<u64>* table = nullptr;
+    switch (length) {
+    case 1:
+        table = &unigrams;
+        break;
+    case 2:
+        table = &bigrams;
+        break;
+    case 3:
+        table = &trigrams;
+        break;
+    default:
+        return out;
+    }
+
+    for (usize i = 0; i < table->size(); ++i) {
+        const auto count = (*table)[i];
+        if (count == 0) {
+            continue;
+        }
+
+        Sequence sequence {{}, length, count};
+
+        // indices are the opcodes in base OP_COUNT, most significant first
+        auto index = i;
+        for (i64 k = length - 1; k >= 0; --k) {
+            sequence.ops[k] = static_cast<Op>(index % OP_COUNT);
+            index           /= OP_COUNT;
+        }
+
+        out.push_back(sequence);
+    }
+
+    std::ranges::sort(out, std::greater {}, &Sequence::count);
+    return out;
+}
+} // namespace hex
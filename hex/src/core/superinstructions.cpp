@@ -0,0 +1,116 @@
+#include <hex/core/superinstructions.hpp>
+#include <hex/core/disassembly.hpp>
+
+#include <hexe/bytecode.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace hex {
+using namespace hexe;
+using namespace mana::literals;
+
+#define HEX_SUPERINSTRUCTION_2(a, b)    Superinstruction {Op::a##_##b, {Op::a, Op::b, Op::Halt}, 2},
+#define HEX_SUPERINSTRUCTION_3(a, b, c) Superinstruction {Op::a##_##b##_##c, {Op::a, Op::b, Op::c}, 3},
+
+static constexpr Superinstruction SUPERINSTRUCTION_TABLE[] = {
+    HEXE_SUPERINSTRUCTIONS_2(HEX_SUPERINSTRUCTION_2)
+    HEXE_SUPERINSTRUCTIONS_3(HEX_SUPERINSTRUCTION_3)
+    // keeps the table well-formed when no superinstructions are compiled in
+    Superinstruction {Op::Halt, {}, 0},
+};
+
+#undef HEX_SUPERINSTRUCTION_2
+#undef HEX_SUPERINSTRUCTION_3
+
+static constexpr usize SUPERINSTRUCTION_COUNT = std::size(SUPERINSTRUCTION_TABLE) - 1;
+
+std::span<const Superinstruction> Superinstructions() {
+    return {SUPERINSTRUCTION_TABLE, SUPERINSTRUCTION_COUNT};
+}
+
+bool IsSuperinstruction(const Op op) {
+    return FindSuperinstruction(op) != nullptr;
+}
+
+const Superinstruction* FindSuperinstruction(const Op op) {
+    if constexpr (SUPERINSTRUCTION_COUNT == 0) {
+        return nullptr;
+    }
+
+    // fused opcodes are always last, in table order
+    const auto first = static_cast<u8>(SUPERINSTRUCTION_TABLE[0].fused);
+    const auto index = static_cast<i64>(static_cast<u8>(op)) - first;
+
+    if (index < 0 || index >= SUPERINSTRUCTION_COUNT) {
+        return nullptr;
+    }
+
+    return &SUPERINSTRUCTION_TABLE[index];
+}
+
+bool CanPrecedeInFusion(const Op op) {
+    switch (op) {
+        using enum Op;
+    case Halt:
+    case Err:
+    case Return:
+    case Jump:
+    case JumpWhenTrue:
+    case JumpWhenFalse:
+    case Call:
+    case Yield:
+    case ParallelFor:
+    case Join:
+        return false;
+    default:
+        return not IsSuperinstruction(op);
+    }
+}
+
+i64 FuseSuperinstructions(ByteCode& bytecode, const std::span<const Superinstruction> enabled) {
+    if (enabled.empty()) {
+        return 0;
+    }
+
+    std::vector<const Superinstruction*> by_length(enabled.size());
+    std::ranges::transform(enabled, by_length.begin(), [](const auto& s) { return &s; });
+    std::ranges::stable_sort(by_length, std::greater {}, &Superinstruction::length);
+
+    // decode instruction boundaries first, rewriting as we go would hide the original sequence
+    const auto& code = std::as_const(bytecode).Instructions();
+
+    std::vector<i64> starts;
+    for (i64 offset = 0; offset < code.size(); offset += InstructionSize(static_cast<Op>(code[offset]))) {
+        starts.push_back(offset);
+    }
+
+    std::vector<Op> original(starts.size());
+    for (i64 i = 0; i < starts.size(); ++i) {
+        original[i] = static_cast<Op>(code[starts[i]]);
+    }
+
+    i64 rewritten = 0;
+    for (i64 i = 0; i < starts.size(); ++i) {
+        for (const auto* candidate : by_length) {
+            if (i + candidate->length > starts.size()) {
+                continue;
+            }
+
+            const bool matches = std::equal(candidate->sequence.begin(),
+                                            candidate->sequence.begin() + candidate->length,
+                                            original.begin() + i
+            );
+
+            if (matches) {
+                bytecode.PatchOpcode(starts[i], candidate->fused);
+                ++rewritten;
+                break;
+            }
+        }
+    }
+
+    return rewritten;
+}
+} // namespace hex
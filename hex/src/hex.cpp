@@ -1,16 +1,33 @@
 #include <hex/hex.hpp>
 
+#include <hex/core/disassembly.hpp>
 #include <hex/core/logger.hpp>
+#include <hex/core/opcode-stats.hpp>
+#include <hex/core/list-math.hpp>
+#include <hex/core/map-ops.hpp>
+#include <hex/core/vector-math.hpp>
 #include <hex/core/vm_trace.hpp>
+#include <hex/worker-pool.hpp>
 
 #include <magic_enum/magic_enum.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <memory>
 #include <print>
+#include <thread>
+#include <tuple>
+#include <utility>
 
 namespace hex {
 using namespace hexe;
 
+namespace {
+// host calls return here, which halts and hands control back to the host
+constexpr u8 HOST_RETURN[] = {static_cast<u8>(Op::Halt)};
+} // namespace
+
 // payloads are little endian
 #define READ_PAYLOAD (static_cast<u16>(*ip | *(ip + 1) << 8))
 #define NEXT_PAYLOAD (ip += 2, (static_cast<u16>(*(ip - 2) | *(ip - 1) << 8)))
@@ -20,6 +37,389 @@ using namespace hexe;
 #define REG(idx) registers[frame_offset + (idx)]
 #define RETURN_REGISTER registers[REGISTER_RETURN]
 
+// every loop and recursion goes through a backward jump or a call, so those are all the budget counts
+// ip is already at the destination, which is where a continued run picks up from
+#define SPEND_BUDGET()                                      \
+    if constexpr (Mode == ExecutionMode::Budgeted) {        \
+        if (--budget <= 0) [[unlikely]] {                   \
+            preempted = true;                               \
+            return InterpretResult::Suspended;              \
+        }                                                   \
+    }
+
+#define BACKWARD_BRANCH(jump)                               \
+    if constexpr (Mode == ExecutionMode::Budgeted) {        \
+        const auto* const branch = ip;                      \
+        jump                                                \
+        if (ip < branch) {                                  \
+            SPEND_BUDGET()                                  \
+        }                                                   \
+    } else {                                                \
+        jump                                                \
+    }
+
+// handler bodies, shared between regular and fused opcodes
+#define HANDLER_Return        \
+    RETURN();                 \
+    frame_offset -= call_stack[current_function].reg_frame; \
+    ip           = call_stack[current_function--].ret_addr;
+
+#define HANDLER_LoadConstant  LOADK();
+#define HANDLER_Move          MOVE();
+
+#define HANDLER_Add           BINARY_OP(+);
+#define HANDLER_Sub           BINARY_OP(-);
+#define HANDLER_Div           BINARY_OP(/);
+#define HANDLER_Mul           BINARY_OP(*);
+#define HANDLER_Mod           BINARY_OP(%);
+
+#define HANDLER_Negate        NEGATE();
+#define HANDLER_Not           BOOL_NOT();
+
+#define HANDLER_Cmp_Greater   BINARY_OP(>);
+#define HANDLER_Cmp_GreaterEq BINARY_OP(>=);
+#define HANDLER_Cmp_Lesser    BINARY_OP(<);
+#define HANDLER_Cmp_LesserEq  BINARY_OP(<=);
+#define HANDLER_Equals        BINARY_OP(==);
+#define HANDLER_NotEquals     BINARY_OP(!=);
+
+#define HANDLER_Jump          BACKWARD_BRANCH(JUMP();)
+#define HANDLER_JumpWhenTrue  BACKWARD_BRANCH(JUMP_TRUE();)
+#define HANDLER_JumpWhenFalse BACKWARD_BRANCH(JUMP_FALSE();)
+
+#define HANDLER_Call                                                \
+    /* first setup the next stack frame */                          \
+    frame_offset += *ip;                                            \
+                                                                    \
+    if (frame_offset + 2 * frame_limit > register_limit             \
+        || current_function + 1 == call_stack_limit) [[unlikely]] { \
+        if (not Grow()) {                                           \
+            return InterpretResult::RuntimeError;                   \
+        }                                                           \
+    }                                                               \
+                                                                    \
+    call_stack[++current_function].ret_addr = ip + CALL_BYTES;      \
+    call_stack[current_function].reg_frame  = *ip;                  \
+                                                                    \
+    /* then call */                                                 \
+    ++ip;                                                           \
+    u32 t = CALL_TARGET;                                            \
+    ip    = code_start + t;                                         \
+    SPEND_BUDGET()
+
+#define HANDLER_Print                               \
+    const auto s = REG(NEXT_PAYLOAD).AsString();    \
+    std::print("{}", s);
+
+#define HANDLER_PrintValue                                      \
+    const auto s = REG(NEXT_PAYLOAD).AsString();                \
+    const auto v = ValueToString(REG(NEXT_PAYLOAD));            \
+                                                                \
+    std::vprint_nonunicode(s, std::make_format_args(v));
+
+#define HANDLER_ListCreate                  \
+    const u8 type   = NEXT_PAYLOAD;         \
+    const auto size = NEXT_PAYLOAD;         \
+                                            \
+    REG(NEXT_PAYLOAD) = Value {type, size};
+
+#define HANDLER_ListRead                                \
+    const auto src    = NEXT_PAYLOAD;                   \
+    const auto idx    = NEXT_PAYLOAD;                   \
+    const auto& val   = REG(src);                       \
+    REG(NEXT_PAYLOAD) = {val.Type(), val[REG(idx).AsInt()]};
+
+#define HANDLER_ListWrite                   \
+    const auto dst = NEXT_PAYLOAD;          \
+    const auto idx = NEXT_PAYLOAD;          \
+    REG(dst)[idx]  = REG(NEXT_PAYLOAD).Raw();
+
+#define HANDLER_ListStore                                   \
+    const auto dst            = NEXT_PAYLOAD;               \
+    const auto idx            = NEXT_PAYLOAD;               \
+    REG(dst)[REG(idx).AsInt()] = REG(NEXT_PAYLOAD).Raw();
+
+// packed lists hold their elements at their declared width, registers hold them at full width
+#define HANDLER_LIST_READ_PACKED(T, Wide)                                           \
+    const auto src    = NEXT_PAYLOAD;                                               \
+    const auto idx    = NEXT_PAYLOAD;                                               \
+    REG(NEXT_PAYLOAD) = Value {static_cast<Wide>(REG(src).Packed<T>(REG(idx).AsInt()))};
+
+#define HANDLER_ListReadI8  HANDLER_LIST_READ_PACKED(i8, i64)
+#define HANDLER_ListReadI16 HANDLER_LIST_READ_PACKED(i16, i64)
+#define HANDLER_ListReadI32 HANDLER_LIST_READ_PACKED(i32, i64)
+#define HANDLER_ListReadU8  HANDLER_LIST_READ_PACKED(u8, u64)
+#define HANDLER_ListReadU16 HANDLER_LIST_READ_PACKED(u16, u64)
+#define HANDLER_ListReadU32 HANDLER_LIST_READ_PACKED(u32, u64)
+#define HANDLER_ListReadF32 HANDLER_LIST_READ_PACKED(f32, f64)
+
+#define HANDLER_ListReadBit                             \
+    const auto src    = NEXT_PAYLOAD;                   \
+    const auto idx    = NEXT_PAYLOAD;                   \
+    REG(NEXT_PAYLOAD) = Value {REG(src).Bit(REG(idx).AsInt())};
+
+// signed and unsigned elements of the same width truncate alike
+#define HANDLER_LIST_STORE_PACKED(T, As)                                            \
+    const auto dst = NEXT_PAYLOAD;                                                  \
+    const auto idx = NEXT_PAYLOAD;                                                  \
+    REG(dst).SetPacked<T>(REG(idx).AsInt(), static_cast<T>(REG(NEXT_PAYLOAD).As()));
+
+#define HANDLER_ListStore8   HANDLER_LIST_STORE_PACKED(u8, AsInt)
+#define HANDLER_ListStore16  HANDLER_LIST_STORE_PACKED(u16, AsInt)
+#define HANDLER_ListStore32  HANDLER_LIST_STORE_PACKED(u32, AsInt)
+#define HANDLER_ListStoreF32 HANDLER_LIST_STORE_PACKED(f32, AsFloat)
+
+#define HANDLER_ListStoreBit                \
+    const auto dst = NEXT_PAYLOAD;          \
+    const auto idx = NEXT_PAYLOAD;          \
+    REG(dst).SetBit(REG(idx).AsInt(), REG(NEXT_PAYLOAD).AsBool());
+
+// bulk list operations, which run over the whole buffer at once in hex::list
+#define HANDLER_ListFill                    \
+    const auto dst = NEXT_PAYLOAD;          \
+    list::Fill(REG(dst), REG(NEXT_PAYLOAD));
+
+#define HANDLER_ListCopy                    \
+    const auto dst = NEXT_PAYLOAD;          \
+    list::Copy(REG(dst), REG(NEXT_PAYLOAD));
+
+#define HANDLER_ListSlice                                   \
+    const auto dst  = NEXT_PAYLOAD;                         \
+    const auto src  = NEXT_PAYLOAD;                         \
+    const auto from = NEXT_PAYLOAD;                         \
+    const auto to   = NEXT_PAYLOAD;                         \
+    REG(dst) = list::Slice(REG(src), REG(from).AsInt(), REG(to).AsInt());
+
+#define HANDLER_LIST_REDUCE(Kernel)         \
+    const auto dst = NEXT_PAYLOAD;          \
+    REG(dst)       = list::Kernel(REG(NEXT_PAYLOAD));
+
+#define HANDLER_ListSum HANDLER_LIST_REDUCE(Sum)
+#define HANDLER_ListMin HANDLER_LIST_REDUCE(Min)
+#define HANDLER_ListMax HANDLER_LIST_REDUCE(Max)
+
+#define HANDLER_ListFind                                    \
+    const auto dst = NEXT_PAYLOAD;                          \
+    const auto src = NEXT_PAYLOAD;                          \
+    REG(dst) = Value {list::Find(REG(src), REG(NEXT_PAYLOAD))};
+
+#define HANDLER_ListSort list::Sort(REG(NEXT_PAYLOAD));
+
+#define HANDLER_LIST_COMBINE(Kernel)        \
+    const auto dst = NEXT_PAYLOAD;          \
+    const auto l   = NEXT_PAYLOAD;          \
+    REG(dst) = list::Kernel(REG(l), REG(NEXT_PAYLOAD));
+
+#define HANDLER_ListAdd HANDLER_LIST_COMBINE(Add)
+#define HANDLER_ListMul HANDLER_LIST_COMBINE(Mul)
+
+#define HANDLER_MapCreate                                               \
+    const auto type   = static_cast<Value::Data::Type>(NEXT_PAYLOAD);   \
+    REG(NEXT_PAYLOAD) = Value::NewMap(type);
+
+#define HANDLER_MapGet                                                  \
+    const auto dst      = NEXT_PAYLOAD;                                 \
+    const auto src      = NEXT_PAYLOAD;                                 \
+    const auto key      = NEXT_PAYLOAD;                                 \
+    const auto fallback = NEXT_PAYLOAD;                                 \
+    const auto* found   = map::Find(REG(src), REG(key));                \
+    REG(dst) = found != nullptr ? *found : REG(fallback);
+
+#define HANDLER_MapSet                                                  \
+    const auto dst = NEXT_PAYLOAD;                                      \
+    const auto key = NEXT_PAYLOAD;                                      \
+    map::Set(REG(dst), REG(key), REG(NEXT_PAYLOAD));
+
+#define HANDLER_MapHas                                                  \
+    const auto dst = NEXT_PAYLOAD;                                      \
+    const auto src = NEXT_PAYLOAD;                                      \
+    REG(dst) = Value {map::Find(REG(src), REG(NEXT_PAYLOAD)) != nullptr};
+
+#define HANDLER_MapRemove                                               \
+    const auto dst = NEXT_PAYLOAD;                                      \
+    const auto src = NEXT_PAYLOAD;                                      \
+    REG(dst) = Value {map::Remove(REG(src), REG(NEXT_PAYLOAD))};
+
+#define HANDLER_MapCount                                                \
+    const auto dst = NEXT_PAYLOAD;                                      \
+    REG(dst) = Value {i64 {map::Count(REG(NEXT_PAYLOAD))}};
+
+// the index comes from the program, so it can be out of range without the bytecode being malformed
+#define MAP_INDEX_CHECK(in_range, op)                                      \
+    if (not(in_range)) [[unlikely]] {                                      \
+        Log->error(op " index {} is out of range for a map of {} entries", \
+                   index,                                                  \
+                   map::Count(REG(src)));                                  \
+        return InterpretResult::RuntimeError;                              \
+    }
+
+#define HANDLER_MapKeyAt                                                \
+    const auto dst   = NEXT_PAYLOAD;                                    \
+    const auto src   = NEXT_PAYLOAD;                                    \
+    const auto index = REG(NEXT_PAYLOAD).AsInt();                       \
+    auto key         = map::KeyAt(REG(src), index);                     \
+    MAP_INDEX_CHECK(key.has_value(), "MapKeyAt")                        \
+    REG(dst) = std::move(*key);
+
+#define HANDLER_MapValueAt                                              \
+    const auto dst    = NEXT_PAYLOAD;                                   \
+    const auto src    = NEXT_PAYLOAD;                                   \
+    const auto index  = REG(NEXT_PAYLOAD).AsInt();                      \
+    const auto* value = map::ValueAt(REG(src), index);                  \
+    MAP_INDEX_CHECK(value != nullptr, "MapValueAt")                     \
+    REG(dst) = *value;
+
+// natives may resume fibers, which run natives of their own
+#define HANDLER_CallNative                                                  \
+    const auto& native = *natives_start[NEXT_PAYLOAD];                      \
+    const auto base    = NEXT_PAYLOAD;                                      \
+    const bool outer   = std::exchange(in_native, true);                    \
+    RETURN_REGISTER    = native.function({&REG(base), native.param_count}); \
+    in_native          = outer;
+
+// ip is already past the opcode, so resuming carries on from the next one
+// outside a fiber there's nothing to suspend
+#define HANDLER_Yield                       \
+    if (fiber != nullptr) {                 \
+        return InterpretResult::Yielded;    \
+    }
+
+// ip is already at the body, which the workers start their slices from
+#define HANDLER_ParallelFor                                 \
+    const auto frame    = NEXT_PAYLOAD;                     \
+    const auto distance = static_cast<i16>(NEXT_PAYLOAD);   \
+                                                            \
+    switch (ForkLoop(ip, frame)) {                          \
+    case LoopFork::Serial:                                  \
+        break;                                              \
+    case LoopFork::Joined:                                  \
+        ip += distance;                                     \
+        break;                                              \
+    case LoopFork::Failed:                                  \
+        return InterpretResult::RuntimeError;               \
+    }
+
+// whatever the body calls may have parallel loops of its own, which run serially and carry on past their Join
+#define HANDLER_Join                                \
+    if (slicing && current_function == 0) {         \
+        return InterpretResult::OK;                 \
+    }
+
+// there are always four lane registers, the ones past the vector's width are ignored
+#define HANDLER_VecMake                                                         \
+    const auto type = static_cast<Value::Data::Type>(NEXT_PAYLOAD);             \
+    const auto dst  = NEXT_PAYLOAD;                                             \
+    const u16 src[] = {NEXT_PAYLOAD, NEXT_PAYLOAD, NEXT_PAYLOAD, NEXT_PAYLOAD}; \
+                                                                                \
+    Value::Lanes lanes {};                                                      \
+    if (type == Value::Data::Type::Vec2i) {                                     \
+        lanes.as_i32 = {static_cast<i32>(REG(src[0]).AsInt()),                  \
+                        static_cast<i32>(REG(src[1]).AsInt()), 0, 0};           \
+    } else {                                                                    \
+        const u8 count = type == Value::Data::Type::Vec2 ? 2                    \
+                       : type == Value::Data::Type::Vec3 ? 3 : 4;               \
+        for (u8 lane = 0; lane < count; ++lane) {                               \
+            lanes.as_f32[lane] = static_cast<f32>(REG(src[lane]).AsFloat());    \
+        }                                                                       \
+    }                                                                           \
+    REG(dst) = Value {type, lanes};
+
+// only vec2i keeps integer lanes, every other vector's math is the same regardless of its width
+#define HANDLER_VecAdd                                                          \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& l  = REG(NEXT_PAYLOAD);                                         \
+    const auto& r  = REG(NEXT_PAYLOAD);                                         \
+    const auto vt  = static_cast<Value::Data::Type>(l.Type());                  \
+    REG(dst) = Value {vt, vt == Value::Data::Type::Vec2i                        \
+                              ? vec::AddI(l.AsLanes(), r.AsLanes())             \
+                              : vec::AddF(l.AsLanes(), r.AsLanes())};
+
+#define HANDLER_VecSub                                                          \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& l  = REG(NEXT_PAYLOAD);                                         \
+    const auto& r  = REG(NEXT_PAYLOAD);                                         \
+    const auto vt  = static_cast<Value::Data::Type>(l.Type());                  \
+    REG(dst) = Value {vt, vt == Value::Data::Type::Vec2i                        \
+                              ? vec::SubI(l.AsLanes(), r.AsLanes())             \
+                              : vec::SubF(l.AsLanes(), r.AsLanes())};
+
+#define HANDLER_VecScale                                                        \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& v  = REG(NEXT_PAYLOAD);                                         \
+    const auto& s  = REG(NEXT_PAYLOAD);                                         \
+    const auto vt  = static_cast<Value::Data::Type>(v.Type());                  \
+    REG(dst) = Value {vt, vt == Value::Data::Type::Vec2i                        \
+                              ? vec::ScaleI(v.AsLanes(), static_cast<i32>(s.AsInt()))   \
+                              : vec::ScaleF(v.AsLanes(), static_cast<f32>(s.AsFloat()))};
+
+#define HANDLER_VecDot                                                          \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& l  = REG(NEXT_PAYLOAD);                                         \
+    const auto& r  = REG(NEXT_PAYLOAD);                                         \
+    if (l.Type() == Value::Data::Type::Vec2i) {                                 \
+        REG(dst) = Value {static_cast<i64>(vec::DotI(l.AsLanes(), r.AsLanes()))}; \
+    } else {                                                                    \
+        REG(dst) = Value {static_cast<f64>(vec::DotF(l.AsLanes(), r.AsLanes()))}; \
+    }
+
+#define HANDLER_VecCross                                                        \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& l  = REG(NEXT_PAYLOAD);                                         \
+    const auto& r  = REG(NEXT_PAYLOAD);                                         \
+    REG(dst) = Value {Value::Data::Type::Vec3, vec::Cross(l.AsLanes(), r.AsLanes())};
+
+#define HANDLER_VecLength                                                       \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    REG(dst) = Value {static_cast<f64>(vec::Length(REG(NEXT_PAYLOAD).AsLanes()))};
+
+#define HANDLER_VecNormalize                                                    \
+    const auto dst = NEXT_PAYLOAD;                                              \
+    const auto& v  = REG(NEXT_PAYLOAD);                                         \
+    REG(dst) = Value {static_cast<Value::Data::Type>(v.Type()), vec::Normalize(v.AsLanes())};
+
+// constant indices are checked by the analyzer, the rest come from the program like map indices do
+#define HANDLER_VecLane                                                         \
+    const auto dst  = NEXT_PAYLOAD;                                             \
+    const auto& v   = REG(NEXT_PAYLOAD);                                        \
+    const auto lane = REG(NEXT_PAYLOAD).AsInt();                                \
+    if (lane < 0 || lane >= v.LaneCount()) [[unlikely]] {                       \
+        Log->error("Lane index {} is out of range for a vector of {} lanes",    \
+                   lane,                                                        \
+                   v.LaneCount());                                              \
+        return InterpretResult::RuntimeError;                                   \
+    }                                                                           \
+    if (v.Type() == Value::Data::Type::Vec2i) {                                 \
+        REG(dst) = Value {static_cast<i64>(v.AsLanes().as_i32[lane])};          \
+    } else {                                                                    \
+        REG(dst) = Value {static_cast<f64>(v.AsLanes().as_f32[lane])};          \
+    }
+
+// a fused opcode runs each handler of its sequence back to back,
+// skipping over the opcode bytes that would otherwise have been dispatched
+#define FUSED_LABEL_2(a, b)    a##_##b
+#define FUSED_LABEL_3(a, b, c) a##_##b##_##c
+
+#define FUSED_ENTRY_2(a, b)    &&FUSED_LABEL_2(a, b),
+#define FUSED_ENTRY_3(a, b, c) &&FUSED_LABEL_3(a, b, c),
+
+#define FUSED_HANDLER_2(a, b)                   \
+    FUSED_LABEL_2(a, b) : {                     \
+        { HANDLER_##a }                         \
+        ++ip;                                   \
+        { HANDLER_##b }                         \
+    }                                           \
+    DISPATCH();
+
+#define FUSED_HANDLER_3(a, b, c)                \
+    FUSED_LABEL_3(a, b, c) : {                  \
+        { HANDLER_##a }                         \
+        ++ip;                                   \
+        { HANDLER_##b }                         \
+        ++ip;                                   \
+        { HANDLER_##c }                         \
+    }                                           \
+    DISPATCH();
+
 /// --- Note ---
 /// The reason we don't do bounds checks in Release builds is because they shouldn't be necessary.
 ///
@@ -28,10 +428,419 @@ using namespace hexe;
 /// These issues should never reach users. Users expect speed from Hex.
 /// The safety of executing Hexe code is therefore determined by Circe's codegen, and Hex' stability.
 /// As Hex' VM loop is relatively simple, we afford ourselves to keep safety checks to Debug builds.
-InterpretResult Hex::Execute(ByteCode* bytecode) {
-    ip                          = bytecode->EntryPoint();
-    auto* const code_start      = bytecode->Instructions().data();
-    const auto* const constants = bytecode->Constants().data();
+InterpretResult Hex::Execute(const ByteCode* bytecode) {
+    if (not EnterMain(bytecode)) {
+        return InterpretResult::RuntimeError;
+    }
+    return Run<ExecutionMode::Standard>(bytecode);
+}
+
+InterpretResult Hex::Execute(const ByteCode* bytecode, OpcodeStats& opcode_stats) {
+    if (not EnterMain(bytecode)) {
+        return InterpretResult::RuntimeError;
+    }
+
+    stats             = &opcode_stats;
+    const auto result = Run<ExecutionMode::Counting>(bytecode);
+    stats->EndSequence();
+    stats = nullptr;
+
+    return result;
+}
+
+InterpretResult Hex::Execute(const ByteCode* bytecode, const i64 budget) {
+    if (not EnterMain(bytecode)) {
+        return InterpretResult::RuntimeError;
+    }
+
+    this->budget = budget;
+    return Run<ExecutionMode::Budgeted>(bytecode);
+}
+
+Hex::Hex() = default;
+
+// the pool's type is only complete in here
+Hex::~Hex() = default;
+
+InterpretResult Hex::Continue(const i64 budget) {
+    if (not preempted) {
+        Log->error("Attempted to continue a run which wasn't suspended");
+        return InterpretResult::RuntimeError;
+    }
+
+    preempted    = false;
+    this->budget = budget;
+    return Run<ExecutionMode::Budgeted>(loaded);
+}
+
+bool Hex::Load(const ByteCode* bytecode) {
+    if (not Link(*bytecode)) {
+        loaded = nullptr;
+        return false;
+    }
+
+    // every function is exported, Main aside, which calls never enter
+    frame_limit = 0;
+    for (const auto& entry : bytecode->Exports()) {
+        frame_limit = std::max<i64>(frame_limit, entry.register_count);
+    }
+
+    loaded = bytecode;
+    return true;
+}
+
+void Hex::RegisterNative(const std::string_view name, const u8 param_count, NativeFunction function) {
+    // the pool's workers have copies of the natives from when it was created
+    pool.reset();
+
+    // bytecode linked earlier may point at the native being replaced
+    if (const auto it = natives.find(name); it != natives.end()) {
+        it->second = {std::move(function), param_count};
+        return;
+    }
+
+    natives.emplace(std::string(name), Native {std::move(function), param_count});
+}
+
+std::optional<FunctionHandle> Hex::Find(const std::string_view name) const {
+    if (loaded == nullptr) {
+        return std::nullopt;
+    }
+
+    const auto* entry = loaded->FindExport(name);
+    if (entry == nullptr) {
+        return std::nullopt;
+    }
+
+    return FunctionHandle {
+        static_cast<u32>(entry->address),
+        entry->register_count,
+        entry->param_count,
+    };
+}
+
+Value Hex::Call(const FunctionHandle function, const std::span<const Value> args) {
+    if (loaded == nullptr) {
+        Log->error("Attempted to call a function before loading any bytecode");
+        return {};
+    }
+
+    if (args.size() != function.param_count) {
+        Log->error("Function at {:08X} takes {} arguments, but was given {}",
+                   function.address,
+                   function.param_count,
+                   args.size()
+        );
+        return {};
+    }
+
+    if (preempted) {
+        Log->error("Attempted to call a function while a suspended run is waiting to continue");
+        return {};
+    }
+
+    // the run that called the native still needs its registers and call stack
+    if (in_native) {
+        Log->error("Attempted to call a function from a native, while the run that called it is still going");
+        return {};
+    }
+
+    if (loaded->MainRegisterFrame() + function.register_count > register_limit) {
+        Log->error("Function at {:08X} needs more registers than Hex has", function.address);
+        return {};
+    }
+
+    // Main has either finished or never run, so the callee's window only has to clear the globals
+    frame_offset     = loaded->MainRegisterFrame();
+    current_function = 0;
+    call_stack[0]    = {HOST_RETURN, frame_offset};
+
+    // parameters take up the first registers of the callee's window
+    for (usize i = 0; i < args.size(); ++i) {
+        registers[frame_offset + i] = args[i];
+    }
+
+    ip = loaded->Instructions().data() + function.address;
+    if (Run<ExecutionMode::Standard>(loaded) != InterpretResult::OK) {
+        return {};
+    }
+
+    return registers[REGISTER_RETURN];
+}
+
+Value Hex::Call(const std::string_view name, const std::span<const Value> args) {
+    const auto function = Find(name);
+    if (not function) {
+        Log->error("No exported function is named '{}'", name);
+        return {};
+    }
+
+    return Call(*function, args);
+}
+
+FiberState Fiber::State() const {
+    return state;
+}
+
+const Value& Fiber::Result() const {
+    return registers[REGISTER_RETURN];
+}
+
+usize Fiber::Footprint() const {
+    usize bytes = sizeof(Fiber)
+                  + registers.capacity() * sizeof(Value)
+                  + call_stack.capacity() * sizeof(StackFrame);
+
+    for (const auto& value : registers) {
+        bytes += value.ByteLength();
+    }
+    return bytes;
+}
+
+Fiber Hex::Spawn(const FunctionHandle function, const std::span<const Value> args) {
+    Fiber spawned;
+
+    if (loaded == nullptr) {
+        Log->error("Attempted to spawn a fiber before loading any bytecode");
+        return spawned;
+    }
+
+    if (args.size() != function.param_count) {
+        Log->error("Function at {:08X} takes {} arguments, but was given {}",
+                   function.address,
+                   function.param_count,
+                   args.size()
+        );
+        return spawned;
+    }
+
+    // past the function's own frame is where it stages the arguments of whatever it calls
+    spawned.registers.resize(1 + function.register_count + frame_limit);
+    std::ranges::copy(args, spawned.registers.begin() + 1);
+
+    // returning from the function hands control back to the host, like Call does
+    spawned.call_stack.push_back({HOST_RETURN, 1});
+
+    spawned.bytecode     = loaded;
+    spawned.ip           = loaded->Instructions().data() + function.address;
+    spawned.frame_offset = 1;
+    spawned.state        = FiberState::Suspended;
+
+    return spawned;
+}
+
+FiberState Hex::Resume(Fiber& resumed) {
+    return Switch<ExecutionMode::Standard>(resumed, 0);
+}
+
+FiberState Hex::Resume(Fiber& resumed, const i64 budget) {
+    return Switch<ExecutionMode::Budgeted>(resumed, budget);
+}
+
+template <ExecutionMode Mode>
+FiberState Hex::Switch(Fiber& resumed, const i64 fiber_budget) {
+    if (resumed.state != FiberState::Suspended) {
+        return resumed.state;
+    }
+
+    if (resumed.bytecode != loaded) {
+        Log->error("Attempted to resume a fiber spawned from bytecode which is no longer loaded");
+        resumed.state = FiberState::Failed;
+        return resumed.state;
+    }
+
+    // a native may be resuming this fiber from inside another, which carries on afterwards
+    const auto outer = std::tuple {
+        registers, call_stack, register_limit, call_stack_limit, fiber, ip, frame_offset, current_function,
+        budget, preempted
+    };
+
+    registers        = resumed.registers.data();
+    call_stack       = resumed.call_stack.data();
+    register_limit   = static_cast<i64>(resumed.registers.size());
+    call_stack_limit = static_cast<i64>(resumed.call_stack.size());
+    fiber            = &resumed;
+    budget           = fiber_budget;
+
+    ip               = resumed.ip;
+    frame_offset     = resumed.frame_offset;
+    current_function = resumed.current_function;
+
+    const auto result = Run<Mode>(loaded);
+
+    resumed.ip               = ip;
+    resumed.frame_offset     = frame_offset;
+    resumed.current_function = current_function;
+
+    switch (result) {
+    case InterpretResult::Yielded:
+    case InterpretResult::Suspended:
+        resumed.state = FiberState::Suspended;
+        break;
+    case InterpretResult::OK:
+        resumed.state = FiberState::Finished;
+        break;
+    default:
+        resumed.state = FiberState::Failed;
+        break;
+    }
+
+    std::tie(registers,
+             call_stack,
+             register_limit,
+             call_stack_limit,
+             fiber,
+             ip,
+             frame_offset,
+             current_function,
+             budget,
+             preempted) = outer;
+    return resumed.state;
+}
+
+void Hex::SetParallelism(const u32 thread_count) {
+    if (thread_count != parallelism) {
+        pool.reset();
+    }
+    parallelism = thread_count;
+}
+
+Hex::LoopFork Hex::ForkLoop(const u8* body, const u16 frame) {
+    const auto first = REG(frame).AsInt();
+    const auto last  = REG(frame + 1).AsInt();
+
+    // a slice already has a thread to itself, so whatever it calls into runs serially
+    if (slicing || not WorkerPool::IsWorthSplitting(last - first + 1)) {
+        return LoopFork::Serial;
+    }
+
+    const auto threads = parallelism > 0 ? parallelism : std::max(std::thread::hardware_concurrency(), 1u);
+    if (threads < 2) {
+        return LoopFork::Serial;
+    }
+
+    if (pool == nullptr || pool->Bytecode() != loaded) {
+        pool = std::make_unique<WorkerPool>(*this, threads);
+    }
+
+    return pool->Run(*this, body, frame, first, last) ? LoopFork::Joined : LoopFork::Failed;
+}
+
+bool Hex::RunSlice(const Hex& owner, const u8* body, const u16 frame, const i64 first, const i64 last) {
+    frame_offset     = owner.frame_offset;
+    current_function = 0;
+    call_stack[0]    = {HOST_RETURN, frame_offset};
+
+    // lists are borrowed as they are rather than copied, as they may be huge, and the body writes to them in place
+    // the analyzer makes sure it doesn't assign to any of the borrowed registers themselves
+    // the return register stays this Hex's own, as whatever the body calls returns into it
+    const auto borrowed_start = std::max<i64>(frame_offset, REGISTER_RETURN + 1);
+    const auto borrowed_end   = frame_offset + frame;
+
+    for (auto r = borrowed_start; r < borrowed_end; ++r) {
+        std::destroy_at(&registers[r]);
+        std::memcpy(static_cast<void*>(&registers[r]), &owner.registers[r], sizeof(Value));
+    }
+
+    REG(frame)     = Value {first};
+    REG(frame + 1) = Value {last};
+
+    ip                = body;
+    const auto result = Run<ExecutionMode::Standard>(loaded);
+
+    // handed back without being destroyed, their storage is still the owner's
+    for (auto r = borrowed_start; r < borrowed_end; ++r) {
+        std::construct_at(&registers[r]);
+    }
+
+    return result == InterpretResult::OK;
+}
+
+bool Hex::Grow() {
+    const auto needed          = frame_offset + 2 * frame_limit;
+    const bool needs_registers = needed > register_limit;
+    const bool needs_frames    = current_function + 1 == call_stack_limit;
+
+    // the main registers and call stack are as large as a fiber's may get
+    if (needs_registers && (fiber == nullptr || needed > REGISTER_TOTAL)) {
+        Log->error("Ran out of registers");
+        return false;
+    }
+
+    if (needs_frames && (fiber == nullptr || call_stack_limit == CALL_STACK_SIZE)) {
+        Log->error("Call stack overflow");
+        return false;
+    }
+
+    // doubling keeps deep recursion from growing one call at a time
+    if (needs_registers) {
+        const auto size = std::min<i64>(std::max(register_limit * 2, needed), REGISTER_TOTAL);
+        fiber->registers.resize(size);
+
+        registers      = fiber->registers.data();
+        register_limit = size;
+    }
+
+    if (needs_frames) {
+        const auto size = std::min<i64>(call_stack_limit * 2, CALL_STACK_SIZE);
+        fiber->call_stack.resize(size);
+
+        call_stack       = fiber->call_stack.data();
+        call_stack_limit = size;
+    }
+
+    return true;
+}
+
+bool Hex::Link(const ByteCode& bytecode) {
+    linked.clear();
+
+    bool resolved = true;
+    for (const auto& import : bytecode.Imports()) {
+        const auto it = natives.find(import.name);
+        if (it == natives.end()) {
+            Log->error("Bytecode calls native '{}', which the host hasn't registered", import.name);
+            resolved = false;
+            continue;
+        }
+
+        if (it->second.param_count != import.param_count) {
+            Log->error("Native '{}' was compiled to take {} arguments, but the host's takes {}",
+                       import.name,
+                       import.param_count,
+                       it->second.param_count
+            );
+            resolved = false;
+            continue;
+        }
+
+        linked.push_back(&it->second);
+    }
+
+    return resolved;
+}
+
+bool Hex::EnterMain(const ByteCode* bytecode) {
+    if (not Load(bytecode)) {
+        return false;
+    }
+
+    ip               = bytecode->Instructions().data() + bytecode->EntryPointValue();
+    frame_offset     = 0;
+    current_function = 0;
+    preempted        = false;
+
+    call_stack[0].reg_frame = bytecode->MainRegisterFrame();
+    call_stack[0].ret_addr  = nullptr; // main doesn't return to anything.
+
+    return true;
+}
+
+template <ExecutionMode Mode>
+InterpretResult Hex::Run(const ByteCode* bytecode) {
+    auto* const code_start          = bytecode->Instructions().data();
+    const auto* const constants     = bytecode->Constants().data();
+    const auto* const natives_start = linked.data();
 
     // this is for computed goto
     // it's important to note this list's order is rigid
@@ -64,183 +873,451 @@ InterpretResult Hex::Execute(ByteCode* bytecode) {
         &&list_create,
         &&list_read,
         &&list_write,
+        &&call_native,
+        &&yield,
+        &&parallel_for,
+        &&join,
+        &&vec_make,
+        &&vec_add,
+        &&vec_sub,
+        &&vec_scale,
+        &&vec_dot,
+        &&vec_cross,
+        &&vec_length,
+        &&vec_normalize,
+        &&vec_lane,
+        &&list_store,
+        &&list_read_i8,
+        &&list_read_i16,
+        &&list_read_i32,
+        &&list_read_u8,
+        &&list_read_u16,
+        &&list_read_u32,
+        &&list_read_f32,
+        &&list_read_bit,
+        &&list_store_8,
+        &&list_store_16,
+        &&list_store_32,
+        &&list_store_f32,
+        &&list_store_bit,
+        &&list_fill,
+        &&list_copy,
+        &&list_slice,
+        &&list_sum,
+        &&list_min,
+        &&list_max,
+        &&list_find,
+        &&list_sort,
+        &&list_add,
+        &&list_mul,
+        &&map_create,
+        &&map_get,
+        &&map_set,
+        &&map_has,
+        &&map_remove,
+        &&map_count,
+        &&map_key_at,
+        &&map_value_at,
+        HEXE_SUPERINSTRUCTIONS_2(FUSED_ENTRY_2)
+        HEXE_SUPERINSTRUCTIONS_3(FUSED_ENTRY_3)
     };
 
+    // counting compiles away entirely in the standard mode
+#define COUNT_DISPATCH()                               \
+    if constexpr (Mode == ExecutionMode::Counting) {   \
+        stats->Record(*ip);                            \
+    }
+
 #ifdef HEX_DEBUG
     constexpr auto dispatch_max = dispatch_table.size();
 
 #   define DISPATCH()                                                                          \
     {                                                                                          \
         TRACE_DISPATCH()                                                                       \
+        COUNT_DISPATCH()                                                                       \
         auto  label = *ip < dispatch_max ? dispatch_table[*ip++] : &&err;                      \
         goto *label;                                                                           \
     }
 #else
     // we do no bounds checking whatsoever in release
-#   define DISPATCH() goto *dispatch_table[*ip++]
+#   define DISPATCH()                          \
+    {                                          \
+        COUNT_DISPATCH()                       \
+        goto *dispatch_table[*ip++];           \
+    }
 #endif
 
     // Start VM
-    call_stack[++current_function].reg_frame = bytecode->MainRegisterFrame();
-    call_stack[current_function].ret_addr    = nullptr; // main doesn't return to anything.
     DISPATCH();
 
 halt:
-    std::print("\n\n");
-    Log->set_pattern("%^<%n>%$ %v");
+    // the program ending and a host call returning look the same from here
+    // whatever comes after is up to the host, as it may be running any number of VMs at once
     return InterpretResult::OK;
 
 err:
     return InterpretResult::CompileError;
 
 ret: {
-        RETURN();
-        frame_offset -= call_stack[current_function].reg_frame;
-        ip           = call_stack[current_function--].ret_addr;
+        HANDLER_Return
     }
     DISPATCH();
 
 load_constant: {
-        LOADK();
+        HANDLER_LoadConstant
     }
     DISPATCH();
 
 move: {
-        MOVE();
+        HANDLER_Move
     }
     DISPATCH();
 
 add: {
-        BINARY_OP(+);
+        HANDLER_Add
     }
     DISPATCH();
 
 sub: {
-        BINARY_OP(-);
+        HANDLER_Sub
     }
     DISPATCH();
 
 div: {
-        BINARY_OP(/);
+        HANDLER_Div
     }
     DISPATCH();
 
 mul: {
-        BINARY_OP(*);
+        HANDLER_Mul
     }
     DISPATCH();
 
 mod: {
-        BINARY_OP(%);
+        HANDLER_Mod
     }
     DISPATCH();
 
 negate: {
-        NEGATE();
+        HANDLER_Negate
     }
     DISPATCH();
 
 bool_not: {
-        BOOL_NOT();
+        HANDLER_Not
     }
     DISPATCH();
 
 cmp_greater: {
-        BINARY_OP(>);
+        HANDLER_Cmp_Greater
     }
     DISPATCH();
 
 cmp_greater_eq: {
-        BINARY_OP(>=);
+        HANDLER_Cmp_GreaterEq
     }
     DISPATCH();
 
 cmp_lesser: {
-        BINARY_OP(<);
+        HANDLER_Cmp_Lesser
     }
     DISPATCH();
 
 cmp_lesser_eq: {
-        BINARY_OP(<=);
+        HANDLER_Cmp_LesserEq
     }
     DISPATCH();
 
 equals: {
-        BINARY_OP(==);
+        HANDLER_Equals
     }
     DISPATCH();
 not_equals: {
-        BINARY_OP(!=);
+        HANDLER_NotEquals
     }
     DISPATCH();
 
 jmp: {
-        JUMP();
+        HANDLER_Jump
     }
     DISPATCH();
 
 jmp_true: {
-        JUMP_TRUE();
+        HANDLER_JumpWhenTrue
     }
     DISPATCH();
 
 jmp_false: {
-        JUMP_FALSE();
+        HANDLER_JumpWhenFalse
     }
     DISPATCH();
 
 call: {
-        // first setup the next stack frame
-        frame_offset += *ip;
-
-        call_stack[++current_function].ret_addr = ip + CALL_BYTES;
-        call_stack[current_function].reg_frame  = *ip;
-
-        // then call
-        ++ip;
-        u32 t = CALL_TARGET;
-        ip    = code_start + t;
+        HANDLER_Call
     }
     DISPATCH();
 
 print: {
-        const auto s = REG(NEXT_PAYLOAD).AsString();
-        std::print("{}", s);
+        HANDLER_Print
     }
     DISPATCH();
 
 print_val: {
-        const auto s = REG(NEXT_PAYLOAD).AsString();
-        const auto v = ValueToString(REG(NEXT_PAYLOAD));
-
-        std::vprint_nonunicode(s, std::make_format_args(v));
+        HANDLER_PrintValue
     }
     DISPATCH();
 
 list_create: {
-        const u8 type   = NEXT_PAYLOAD;
-        const auto size = NEXT_PAYLOAD;
-
-        REG(NEXT_PAYLOAD) = Value {type, size};
+        HANDLER_ListCreate
     }
     DISPATCH();
 
 list_read: {
-        const auto src    = NEXT_PAYLOAD;
-        const auto idx    = NEXT_PAYLOAD;
-        const auto val    = REG(src);
-        REG(NEXT_PAYLOAD) = {val.Type(), val[REG(idx).AsInt()]};
+        HANDLER_ListRead
     }
     DISPATCH();
 
 list_write: {
-        const auto dst = NEXT_PAYLOAD;
-        const auto idx = NEXT_PAYLOAD;
-        REG(dst)[idx]  = REG(NEXT_PAYLOAD).Raw();
+        HANDLER_ListWrite
+    }
+    DISPATCH();
+
+list_store: {
+        HANDLER_ListStore
+    }
+    DISPATCH();
+
+list_read_i8: {
+        HANDLER_ListReadI8
+    }
+    DISPATCH();
+
+list_read_i16: {
+        HANDLER_ListReadI16
+    }
+    DISPATCH();
+
+list_read_i32: {
+        HANDLER_ListReadI32
+    }
+    DISPATCH();
+
+list_read_u8: {
+        HANDLER_ListReadU8
+    }
+    DISPATCH();
+
+list_read_u16: {
+        HANDLER_ListReadU16
+    }
+    DISPATCH();
+
+list_read_u32: {
+        HANDLER_ListReadU32
+    }
+    DISPATCH();
+
+list_read_f32: {
+        HANDLER_ListReadF32
+    }
+    DISPATCH();
+
+list_read_bit: {
+        HANDLER_ListReadBit
+    }
+    DISPATCH();
+
+list_store_8: {
+        HANDLER_ListStore8
+    }
+    DISPATCH();
+
+list_store_16: {
+        HANDLER_ListStore16
+    }
+    DISPATCH();
+
+list_store_32: {
+        HANDLER_ListStore32
+    }
+    DISPATCH();
+
+list_store_f32: {
+        HANDLER_ListStoreF32
+    }
+    DISPATCH();
+
+list_store_bit: {
+        HANDLER_ListStoreBit
+    }
+    DISPATCH();
+
+list_fill: {
+        HANDLER_ListFill
+    }
+    DISPATCH();
+
+list_copy: {
+        HANDLER_ListCopy
+    }
+    DISPATCH();
+
+list_slice: {
+        HANDLER_ListSlice
+    }
+    DISPATCH();
+
+list_sum: {
+        HANDLER_ListSum
+    }
+    DISPATCH();
+
+list_min: {
+        HANDLER_ListMin
+    }
+    DISPATCH();
+
+list_max: {
+        HANDLER_ListMax
+    }
+    DISPATCH();
+
+list_find: {
+        HANDLER_ListFind
+    }
+    DISPATCH();
+
+list_sort: {
+        HANDLER_ListSort
+    }
+    DISPATCH();
+
+list_add: {
+        HANDLER_ListAdd
+    }
+    DISPATCH();
+
+list_mul: {
+        HANDLER_ListMul
+    }
+    DISPATCH();
+
+map_create: {
+        HANDLER_MapCreate
     }
     DISPATCH();
+
+map_get: {
+        HANDLER_MapGet
+    }
+    DISPATCH();
+
+map_set: {
+        HANDLER_MapSet
+    }
+    DISPATCH();
+
+map_has: {
+        HANDLER_MapHas
+    }
+    DISPATCH();
+
+map_remove: {
+        HANDLER_MapRemove
+    }
+    DISPATCH();
+
+map_count: {
+        HANDLER_MapCount
+    }
+    DISPATCH();
+
+map_key_at: {
+        HANDLER_MapKeyAt
+    }
+    DISPATCH();
+
+map_value_at: {
+        HANDLER_MapValueAt
+    }
+    DISPATCH();
+
+call_native: {
+        HANDLER_CallNative
+    }
+    DISPATCH();
+
+yield: {
+        HANDLER_Yield
+    }
+    DISPATCH();
+
+parallel_for: {
+        HANDLER_ParallelFor
+    }
+    DISPATCH();
+
+join: {
+        HANDLER_Join
+    }
+    DISPATCH();
+
+vec_make: {
+        HANDLER_VecMake
+    }
+    DISPATCH();
+
+vec_add: {
+        HANDLER_VecAdd
+    }
+    DISPATCH();
+
+vec_sub: {
+        HANDLER_VecSub
+    }
+    DISPATCH();
+
+vec_scale: {
+        HANDLER_VecScale
+    }
+    DISPATCH();
+
+vec_dot: {
+        HANDLER_VecDot
+    }
+    DISPATCH();
+
+vec_cross: {
+        HANDLER_VecCross
+    }
+    DISPATCH();
+
+vec_length: {
+        HANDLER_VecLength
+    }
+    DISPATCH();
+
+vec_normalize: {
+        HANDLER_VecNormalize
+    }
+    DISPATCH();
+
+vec_lane: {
+        HANDLER_VecLane
+    }
+    DISPATCH();
+
+    HEXE_SUPERINSTRUCTIONS_2(FUSED_HANDLER_2)
+    HEXE_SUPERINSTRUCTIONS_3(FUSED_HANDLER_3)
+
+#undef COUNT_DISPATCH
+#undef DISPATCH
 }
 
+template InterpretResult Hex::Run<ExecutionMode::Standard>(const ByteCode*);
+template InterpretResult Hex::Run<ExecutionMode::Counting>(const ByteCode*);
+template InterpretResult Hex::Run<ExecutionMode::Budgeted>(const ByteCode*);
+
 std::string Hex::ValueToString(const Value& v) {
     using enum Value::Data::Type;
     switch (v.Type()) {
@@ -256,6 +1333,24 @@ std::string Hex::ValueToString(const Value& v) {
         return std::string {v.AsString()};
     case None:
         return "none";
+    case Vec2i: {
+        const auto& lanes = v.AsLanes().as_i32;
+        return fmt::format("({}, {})", lanes[0], lanes[1]);
+    }
+    case Vec2:
+    case Vec3:
+    case Vec4: {
+        const auto& lanes = v.AsLanes().as_f32;
+
+        std::string out = fmt::format("({:.2f}", lanes[0]);
+        for (u8 lane = 1; lane < v.LaneCount(); ++lane) {
+            out += fmt::format(", {:.2f}", lanes[lane]);
+        }
+        return out + ")";
+    }
+    case IntMap:
+    case StringMap:
+        return fmt::format("[{} entries]", map::Count(v));
     default:
         return "???";
     }
@@ -1,19 +1,64 @@
+#include <hex/batch.hpp>
 #include <hex/core/cli.hpp>
 #include <hex/core/disassembly.hpp>
 #include <hex/core/logger.hpp>
+#include <hex/core/superinstructions.hpp>
 #include <hex/hex.hpp>
 
 #include <hexe/bytecode.hpp>
 
 #include <magic_enum/magic_enum.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
+#include <print>
 
 using namespace hex;
 using namespace mana;
 
-void Execute(const std::filesystem::path& hexe_path) {
+InterpretResult RunOnce(const hexe::ByteCode& bytecode, const i64 budget) {
+    Hex vm;
+
+    auto result = budget > 0 ? vm.Execute(&bytecode, budget) : vm.Execute(&bytecode);
+    i64 slices  = 1;
+    while (result == InterpretResult::Suspended) {
+        result = vm.Continue(budget);
+        ++slices;
+    }
+
+    if (result == InterpretResult::OK) {
+        std::print("\n\n");
+    }
+
+    if (budget > 0) {
+        Log->info("Ran in {} slice{}\n", slices, slices == 1 ? "" : "s");
+    }
+    return result;
+}
+
+// the result is OK only if every run's was
+InterpretResult RunBatch(const hexe::ByteCode& bytecode, const u32 thread_count, const u64 run_count) {
+    const Batch batch(bytecode, thread_count);
+    const auto runs = run_count > 0 ? run_count : batch.ThreadCount();
+
+    const auto results = batch.Execute(runs);
+    const auto failed  = [](const InterpretResult result) { return result != InterpretResult::OK; };
+
+    std::print("\n\n");
+    Log->info("Ran {} time{} on {} thread{}, {} failed\n",
+              runs,
+              runs == 1 ? "" : "s",
+              batch.ThreadCount(),
+              batch.ThreadCount() == 1 ? "" : "s",
+              std::ranges::count_if(results, failed)
+    );
+
+    const auto first_failure = std::ranges::find_if(results, failed);
+    return first_failure == results.end() ? InterpretResult::OK : *first_failure;
+}
+
+void Execute(const std::filesystem::path& hexe_path, const CommandLineSettings& cli) {
     namespace chrono = std::chrono;
     using namespace std::chrono_literals;
 
@@ -39,18 +84,38 @@ void Execute(const std::filesystem::path& hexe_path) {
     const auto end_deser = chrono::high_resolution_clock::now();
 
     Log->debug("Entry point: {:08X}", bytecode.EntryPointValue());
+    if (bytecode.HasLineTable()) {
+        Log->debug("Line Table: {} entries for '{}'", bytecode.LineTable().size(), bytecode.SourceName());
+    }
+    if (not bytecode.Exports().empty()) {
+        Log->debug("Exports: {} functions", bytecode.Exports().size());
+    }
+    if (not bytecode.Imports().empty()) {
+        Log->debug("Imports: {} natives", bytecode.Imports().size());
+    }
     Log->debug("Main Register Frame: {}\n", bytecode.MainRegisterFrame());
 
     Log->debug("--- Reading executable '{}' ---", hexe_path.filename().c_str());
     Log->debug("");
     PrintBytecode(bytecode);
 
+    if (const auto fused = FuseSuperinstructions(bytecode, Superinstructions());
+        fused > 0) {
+        Log->debug("Fused {} superinstruction sites", fused);
+    }
+
+    const bool batched = cli.ThreadCount() != 1 || cli.RunCount() > 0;
+    if (batched && cli.Budget() > 0) {
+        Log->warn("Batches run without a budget");
+    }
+
     Log->info("Executing...\n");
-    Hex vm;
 
     const auto start_interp  = chrono::high_resolution_clock::now();
-    const auto interp_result = vm.Execute(&bytecode);
-    const auto end_interp    = chrono::high_resolution_clock::now();
+    const auto interp_result = batched
+                                   ? RunBatch(bytecode, cli.ThreadCount(), cli.RunCount())
+                                   : RunOnce(bytecode, cli.Budget());
+    const auto end_interp = chrono::high_resolution_clock::now();
 
     const auto result = magic_enum::enum_name(interp_result);
     Log->info("Interpret Result: {}\n", result);
@@ -84,5 +149,5 @@ int main(const int argc, char** argv) {
         return result;
     }
 
-    Execute(hexe_name);
+    Execute(hexe_name, cli);
 }
@@ -0,0 +1,52 @@
+#include <hex/scheduler.hpp>
+
+#include <iterator>
+
+namespace hex {
+Scheduler::Scheduler(Hex& vm)
+    : vm(vm) {}
+
+bool Scheduler::Spawn(const FunctionHandle function, const std::span<const hexe::Value> args) {
+    auto fiber = vm.Spawn(function, args);
+    if (fiber.State() != FiberState::Suspended) {
+        return false;
+    }
+
+    spawned.push_back(std::move(fiber));
+    return true;
+}
+
+template <typename Resume>
+ml::usize Scheduler::Advance(Resume resume) {
+    fibers.insert(fibers.end(), std::make_move_iterator(spawned.begin()), std::make_move_iterator(spawned.end()));
+    spawned.clear();
+
+    // compacts in place, so the survivors keep their order
+    ml::usize kept = 0;
+    for (auto& fiber : fibers) {
+        if (resume(fiber) != FiberState::Suspended) {
+            continue;
+        }
+
+        if (&fiber != &fibers[kept]) {
+            fibers[kept] = std::move(fiber);
+        }
+        ++kept;
+    }
+
+    fibers.erase(fibers.begin() + static_cast<std::ptrdiff_t>(kept), fibers.end());
+    return kept;
+}
+
+ml::usize Scheduler::Tick() {
+    return Advance([this](Fiber& fiber) { return vm.Resume(fiber); });
+}
+
+ml::usize Scheduler::Tick(const ml::i64 budget) {
+    return Advance([this, budget](Fiber& fiber) { return vm.Resume(fiber, budget); });
+}
+
+ml::usize Scheduler::Count() const {
+    return fibers.size() + spawned.size();
+}
+} // namespace hex
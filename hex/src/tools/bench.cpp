@@ -0,0 +1,214 @@
+// hex-bench
+// Times a corpus of Hexe programs, first as compiled and then with each superinstruction fused in,
+// so the gain of every fused sequence can be measured on our own workload.
+// Where the host allows it, hardware counters are reported per dispatched instruction as well.
+
+#include <hex/hex.hpp>
+#include <hex/core/opcode-stats.hpp>
+#include <hex/core/superinstructions.hpp>
+#include <hex/tools/corpus.hpp>
+#include <hex/tools/perf-counters.hpp>
+
+#include <CLI11/CLI11.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <print>
+
+using namespace hex;
+using namespace hexe;
+using namespace mana::literals;
+
+struct Measurement {
+    f64 median_ns = 0;
+    InterpretResult result = InterpretResult::OK;
+
+    // mean over all runs
+    tools::PerfCounters::Sample counters;
+};
+
+// runs the program 'runs' times on a fresh VM each, and keeps the median
+Measurement Measure(const ByteCode& bytecode, const i64 runs, tools::PerfCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<f64> samples;
+    samples.reserve(runs);
+
+    Measurement out;
+    for (i64 i = 0; i < runs; ++i) {
+        const auto vm = std::make_unique<Hex>();
+
+        tools::SilencedOutput silenced;
+
+        counters.Start();
+        const auto start = Clock::now();
+        out.result       = vm->Execute(&bytecode);
+        const auto end   = Clock::now();
+        counters.Stop();
+
+        samples.push_back(std::chrono::duration<f64, std::nano>(end - start).count());
+
+        if (i == 0) {
+            out.counters = counters.Read();
+        } else {
+            out.counters += counters.Read();
+        }
+    }
+
+    std::ranges::sort(samples);
+    out.median_ns = samples[samples.size() / 2];
+    out.counters /= static_cast<f64>(runs);
+
+    return out;
+}
+
+f64 Gain(const f64 baseline, const f64 measured) {
+    return baseline > 0 ? 100.0 * (baseline - measured) / baseline : 0;
+}
+
+void PrintCounters(const tools::PerfCounters::Sample& sample, const u64 dispatches) {
+    if (dispatches == 0) {
+        return;
+    }
+
+    for (const auto event : magic_enum::enum_values<tools::PerfEvent>()) {
+        if (const auto value = sample[event]) {
+            std::print("    {:<42} {:>12.0f}    {:>8.3f} /dispatch\n",
+                       tools::PerfEventName(event),
+                       *value,
+                       *value / static_cast<f64>(dispatches)
+            );
+        }
+    }
+}
+
+void PrintCounterAvailability(const tools::PerfCounters& counters) {
+    if (not counters.AnyAvailable()) {
+        std::print("Hardware counters unavailable, reporting wall-clock time only ({})\n",
+                   counters.Error(tools::PerfEvent::Cycles)
+        );
+        return;
+    }
+
+    for (const auto event : magic_enum::enum_values<tools::PerfEvent>()) {
+        if (not counters.IsAvailable(event)) {
+            std::print("Counter '{}' unavailable ({})\n", tools::PerfEventName(event), counters.Error(event));
+        }
+    }
+}
+
+int main(const int argc, char** argv) {
+    CLI::App cli("hex-bench, the Hex benchmark runner");
+
+    std::vector<std::string> inputs;
+    i64 runs = 15;
+
+    cli.add_option("inputs", inputs, "Hexe executables, or directories containing them.")->required();
+    cli.add_option("-r,--runs", runs, "Runs per measurement, the median is reported.")->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(cli, argc, argv);
+
+    const auto executables = tools::CollectExecutables(inputs);
+    if (executables.empty()) {
+        std::print(stderr, "No executables to benchmark.\n");
+        return 1;
+    }
+
+    tools::PerfCounters counters;
+    PrintCounterAvailability(counters);
+
+    const auto superinstructions = Superinstructions();
+
+    f64 total_baseline = 0;
+    f64 total_fused    = 0;
+    std::vector<f64> total_per_fusion(superinstructions.size());
+
+    for (const auto& path : executables) {
+        ByteCode bytecode;
+        if (not tools::LoadExecutable(path, bytecode)) {
+            continue;
+        }
+
+        OpcodeStats stats;
+        {
+            const auto vm = std::make_unique<Hex>();
+
+            tools::SilencedOutput silenced;
+            vm->Execute(&bytecode, stats);
+        }
+
+        const auto baseline = Measure(bytecode, runs, counters);
+        total_baseline      += baseline.median_ns;
+
+        std::print("\n{} ({}, {} dispatches)\n",
+                   path.filename().string(),
+                   magic_enum::enum_name(baseline.result),
+                   stats.Total()
+        );
+        std::print("  {:<44} {:>12.0f} ns {:>8.2f} ns/dispatch\n",
+                   "baseline",
+                   baseline.median_ns,
+                   stats.Total() > 0 ? baseline.median_ns / static_cast<f64>(stats.Total()) : 0.0
+        );
+        PrintCounters(baseline.counters, stats.Total());
+
+        for (usize i = 0; i < superinstructions.size(); ++i) {
+            auto fused_program = bytecode;
+
+            const auto& superinstruction = superinstructions[i];
+            const auto sites             = FuseSuperinstructions(fused_program, {&superinstruction, 1});
+
+            if (sites == 0) {
+                total_per_fusion[i] += baseline.median_ns;
+                continue;
+            }
+
+            const auto fused    = Measure(fused_program, runs, counters);
+            total_per_fusion[i] += fused.median_ns;
+
+            std::print("  {:<44} {:>12.0f} ns {:>+7.2f}% ({} sites)\n",
+                       magic_enum::enum_name(superinstruction.fused),
+                       fused.median_ns,
+                       Gain(baseline.median_ns, fused.median_ns),
+                       sites
+            );
+        }
+
+        auto fused_program = bytecode;
+        const auto sites   = FuseSuperinstructions(fused_program, superinstructions);
+        const auto fused   = sites > 0 ? Measure(fused_program, runs, counters) : baseline;
+        total_fused        += fused.median_ns;
+
+        std::print("  {:<44} {:>12.0f} ns {:>+7.2f}% ({} sites)\n",
+                   "all superinstructions",
+                   fused.median_ns,
+                   Gain(baseline.median_ns, fused.median_ns),
+                   sites
+        );
+        if (sites > 0) {
+            PrintCounters(fused.counters, stats.Total());
+        }
+    }
+
+    std::print("\nCorpus of {} programs\n", executables.size());
+    std::print("  {:<44} {:>12.0f} ns\n", "baseline", total_baseline);
+
+    for (usize i = 0; i < superinstructions.size(); ++i) {
+        std::print("  {:<44} {:>12.0f} ns {:>+7.2f}%\n",
+                   magic_enum::enum_name(superinstructions[i].fused),
+                   total_per_fusion[i],
+                   Gain(total_baseline, total_per_fusion[i])
+        );
+    }
+
+    std::print("  {:<44} {:>12.0f} ns {:>+7.2f}%\n",
+               "all superinstructions",
+               total_fused,
+               Gain(total_baseline, total_fused)
+    );
+
+    return 0;
+}
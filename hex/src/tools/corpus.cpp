@@ -0,0 +1,87 @@
+#include <hex/tools/corpus.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <print>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define HEX_TOOLS_POSIX
+#endif
+
+namespace hex::tools {
+namespace fs = std::filesystem;
+using namespace mana::literals;
+
+std::vector<fs::path> CollectExecutables(const std::span<const std::string> inputs) {
+    std::vector<fs::path> out;
+
+    for (const auto& input : inputs) {
+        const fs::path path = input;
+
+        if (fs::is_directory(path)) {
+            for (const auto& entry : fs::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".hexe") {
+                    out.push_back(entry.path());
+                }
+            }
+            continue;
+        }
+
+        if (not fs::exists(path)) {
+            std::print(stderr, "Skipping '{}': file does not exist\n", path.string());
+            continue;
+        }
+
+        out.push_back(path);
+    }
+
+    std::ranges::sort(out);
+    return out;
+}
+
+bool LoadExecutable(const fs::path& path, hexe::ByteCode& bytecode) {
+    std::ifstream in_file(path, std::ios::binary);
+    if (not in_file) {
+        std::print(stderr, "Failed to read file '{}'\n", path.string());
+        return false;
+    }
+
+    const std::vector<u8> raw {std::istreambuf_iterator {in_file}, {}};
+
+    if (not bytecode.Deserialize(raw)) {
+        std::print(stderr, "Failed to load '{}'\n", path.string());
+        return false;
+    }
+
+    return true;
+}
+
+SilencedOutput::SilencedOutput()
+    : saved_stdout {-1} {
+    std::fflush(stdout);
+
+#ifdef HEX_TOOLS_POSIX
+    saved_stdout = dup(STDOUT_FILENO);
+
+    if (const int null_device = open("/dev/null", O_WRONLY);
+        null_device >= 0) {
+        dup2(null_device, STDOUT_FILENO);
+        close(null_device);
+    }
+#endif
+}
+
+SilencedOutput::~SilencedOutput() {
+    std::fflush(stdout);
+
+#ifdef HEX_TOOLS_POSIX
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+#endif
+}
+} // namespace hex::tools
@@ -0,0 +1,185 @@
+// hex-mine
+// Runs a corpus of Hexe programs in counting mode, ranks the opcode sequences they dispatch,
+// and generates hexe/superinstructions.hpp for the sequences worth fusing.
+
+#include <hex/hex.hpp>
+#include <hex/core/opcode-stats.hpp>
+#include <hex/core/superinstructions.hpp>
+#include <hex/tools/corpus.hpp>
+
+#include <CLI11/CLI11.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <print>
+
+using namespace hex;
+using namespace hexe;
+using namespace mana::literals;
+
+std::string SequenceName(const OpcodeStats::Sequence& sequence, const std::string_view separator) {
+    std::string out;
+    for (i64 i = 0; i < sequence.length; ++i) {
+        if (i > 0) {
+            out += separator;
+        }
+        out += magic_enum::enum_name(sequence.ops[i]);
+    }
+    return out;
+}
+
+// a sequence can only be fused if nothing but its last opcode transfers control
+bool IsFusable(const OpcodeStats::Sequence& sequence) {
+    for (i64 i = 0; i < sequence.length; ++i) {
+        const auto op = sequence.ops[i];
+
+        if (op == Op::Halt || op == Op::Err || IsSuperinstruction(op)) {
+            return false;
+        }
+
+        if (i < sequence.length - 1 && not CanPrecedeInFusion(op)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// every fused dispatch saves one dispatch per trailing opcode
+u64 SavedDispatches(const OpcodeStats::Sequence& sequence) {
+    return sequence.count * (sequence.length - 1);
+}
+
+void Report(const OpcodeStats& stats, const u8 length, const i64 limit) {
+    static constexpr std::string_view titles[] = {"", "Opcodes", "Bigrams", "Trigrams"};
+
+    std::print("\n{}\n", titles[length]);
+
+    i64 listed = 0;
+    for (const auto& sequence : stats.Ranked(length)) {
+        if (listed++ == limit) {
+            break;
+        }
+
+        const auto share = 100.0 * static_cast<f64>(sequence.count) / static_cast<f64>(stats.Total());
+        std::print("  {:>3}. {:<52} {:>14} {:>7.2f}%{}\n",
+                   listed,
+                   SequenceName(sequence, " -> "),
+                   sequence.count,
+                   share,
+                   length > 1 && not IsFusable(sequence) ? "  (not fusable)" : ""
+        );
+    }
+}
+
+std::string GenerateHeader(std::span<const OpcodeStats::Sequence> selected) {
+    std::string out = R"(#pragma once
+
+// Superinstructions fuse a run of opcodes into a single dispatch.
+//
+// This file is generated by hex-mine from dynamic opcode statistics,
+// so regenerate it from a representative corpus rather than editing it by hand.
+//
+// Each entry is the fused opcode sequence in execution order.
+// A fused opcode keeps every operand of its sequence in place,
+// which means only the leading opcode byte of a sequence gets rewritten to use it.
+)";
+
+    for (const u8 length : {2, 3}) {
+        out += fmt::format("\n#define HEXE_SUPERINSTRUCTIONS_{}(X)", length);
+
+        for (const auto& sequence : selected) {
+            if (sequence.length == length) {
+                out += fmt::format(" \\\n    X({})", SequenceName(sequence, ", "));
+            }
+        }
+        out += "\n";
+    }
+
+    return out;
+}
+
+int main(const int argc, char** argv) {
+    CLI::App cli("hex-mine, the Hex superinstruction miner");
+
+    std::vector<std::string> inputs;
+    std::string output_path;
+    i64 top    = 8;
+    i64 report = 20;
+
+    cli.add_option("inputs", inputs, "Hexe executables, or directories containing them.")->required();
+    cli.add_option("-n,--top", top, "How many superinstructions to generate.");
+    cli.add_option("-o,--output", output_path, "Where to write the generated superinstructions header.");
+    cli.add_option("-r,--report", report, "How many sequences to list per length.");
+
+    CLI11_PARSE(cli, argc, argv);
+
+    const auto executables = tools::CollectExecutables(inputs);
+    if (executables.empty()) {
+        std::print(stderr, "No executables to mine.\n");
+        return 1;
+    }
+
+    OpcodeStats stats;
+
+    for (const auto& path : executables) {
+        ByteCode bytecode;
+        if (not tools::LoadExecutable(path, bytecode)) {
+            continue;
+        }
+
+        // Hex is too large for the stack
+        const auto vm = std::make_unique<Hex>();
+
+        InterpretResult result;
+        {
+            tools::SilencedOutput silenced;
+            result = vm->Execute(&bytecode, stats);
+        }
+
+        std::print("{:<48} {}\n", path.filename().string(), magic_enum::enum_name(result));
+    }
+
+    std::print("\nDispatches: {}\n", stats.Total());
+
+    Report(stats, 1, report);
+    Report(stats, 2, report);
+    Report(stats, 3, report);
+
+    std::vector<OpcodeStats::Sequence> candidates;
+    for (const u8 length : {2, 3}) {
+        for (const auto& sequence : stats.Ranked(length)) {
+            if (IsFusable(sequence)) {
+                candidates.push_back(sequence);
+            }
+        }
+    }
+
+    std::ranges::stable_sort(candidates, std::greater {}, SavedDispatches);
+    if (candidates.size() > top) {
+        candidates.resize(top);
+    }
+
+    std::print("\nSelected superinstructions\n");
+    for (const auto& sequence : candidates) {
+        const auto saved = 100.0 * static_cast<f64>(SavedDispatches(sequence)) / static_cast<f64>(stats.Total());
+        std::print("  {:<52} saves {:>5.2f}% of dispatches\n", SequenceName(sequence, "_"), saved);
+    }
+
+    if (output_path.empty()) {
+        return 0;
+    }
+
+    std::ofstream out_file(output_path);
+    if (not out_file) {
+        std::print(stderr, "Failed to open '{}'\n", output_path);
+        return 1;
+    }
+
+    out_file << GenerateHeader(candidates);
+    std::print("\nWrote '{}', rebuild Hex to use it.\n", output_path);
+
+    return 0;
+}
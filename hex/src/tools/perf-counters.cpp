@@ -0,0 +1,203 @@
+#include <hex/tools/perf-counters.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <algorithm>
+
+#ifdef __linux__
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+
+#   include <cerrno>
+#   include <cstring>
+#endif
+
+namespace hex::tools {
+using namespace mana::literals;
+
+std::string_view PerfEventName(const PerfEvent event) {
+    switch (event) {
+    case PerfEvent::Cycles:
+        return "cycles";
+    case PerfEvent::Instructions:
+        return "instructions";
+    case PerfEvent::BranchMisses:
+        return "branch-misses";
+    case PerfEvent::L1dMisses:
+        return "L1d-misses";
+    case PerfEvent::LLCMisses:
+        return "LLC-misses";
+    case PerfEvent::PageFaults:
+        return "page-faults";
+    }
+
+    return "unknown";
+}
+
+std::optional<f64> PerfCounters::Sample::operator[](const PerfEvent event) const {
+    return values[static_cast<usize>(event)];
+}
+
+PerfCounters::Sample& PerfCounters::Sample::operator+=(const Sample& other) {
+    for (usize i = 0; i < EVENT_COUNT; ++i) {
+        if (values[i] && other.values[i]) {
+            *values[i] += *other.values[i];
+        } else {
+            values[i].reset();
+        }
+    }
+    return *this;
+}
+
+PerfCounters::Sample& PerfCounters::Sample::operator/=(const f64 divisor) {
+    for (auto& value : values) {
+        if (value) {
+            *value /= divisor;
+        }
+    }
+    return *this;
+}
+
+#ifdef __linux__
+namespace {
+perf_event_attr MakeAttributes(const PerfEvent event) {
+    perf_event_attr attr {};
+    attr.size = sizeof(perf_event_attr);
+
+    constexpr u64 read_miss = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+
+    switch (event) {
+    case PerfEvent::Cycles:
+        attr.type   = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PerfEvent::Instructions:
+        attr.type   = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PerfEvent::BranchMisses:
+        attr.type   = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case PerfEvent::L1dMisses:
+        attr.type   = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | read_miss;
+        break;
+    case PerfEvent::LLCMisses:
+        attr.type   = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL | read_miss;
+        break;
+    case PerfEvent::PageFaults:
+        attr.type   = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+        break;
+    }
+
+    // user space only, which is also what an unprivileged process is allowed to count
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return attr;
+}
+
+int OpenEvent(const PerfEvent event) {
+    auto attr = MakeAttributes(event);
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (const auto event : magic_enum::enum_values<PerfEvent>()) {
+        const auto index = static_cast<usize>(event);
+
+        fds[index] = OpenEvent(event);
+        if (fds[index] == -1) {
+            errors[index] = std::strerror(errno);
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : fds) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounters::Start() {
+    for (const int fd : fds) {
+        if (fd != -1) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::Stop() {
+    for (const int fd : fds) {
+        if (fd != -1) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+PerfCounters::Sample PerfCounters::Read() const {
+    Sample out;
+
+    for (usize i = 0; i < EVENT_COUNT; ++i) {
+        if (fds[i] == -1) {
+            continue;
+        }
+
+        struct {
+            u64 value;
+            u64 time_enabled;
+            u64 time_running;
+        } data {};
+
+        if (read(fds[i], &data, sizeof(data)) != sizeof(data) || data.time_running == 0) {
+            continue;
+        }
+
+        out.values[i] = static_cast<f64>(data.value);
+        if (data.time_running < data.time_enabled) {
+            *out.values[i] *= static_cast<f64>(data.time_enabled) / static_cast<f64>(data.time_running);
+        }
+    }
+
+    return out;
+}
+#else
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+    errors.fill("not supported on this platform");
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Start() {}
+
+void PerfCounters::Stop() {}
+
+PerfCounters::Sample PerfCounters::Read() const {
+    return {};
+}
+#endif
+
+bool PerfCounters::IsAvailable(const PerfEvent event) const {
+    return fds[static_cast<usize>(event)] != -1;
+}
+
+bool PerfCounters::AnyAvailable() const {
+    return std::ranges::any_of(fds, [](const int fd) { return fd != -1; });
+}
+
+std::string_view PerfCounters::Error(const PerfEvent event) const {
+    return errors[static_cast<usize>(event)];
+}
+} // namespace hex::tools
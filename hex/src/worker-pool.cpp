@@ -0,0 +1,176 @@
+#include <hex/worker-pool.hpp>
+
+#include <algorithm>
+
+namespace hex {
+namespace {
+// fewer iterations than this per slice, and handing them out costs more than running them
+constexpr ml::i64 MIN_GRAIN = 16;
+
+// a few slices per worker let the ones done early help out the rest
+constexpr ml::i64 SLICES_PER_WORKER = 8;
+} // namespace
+
+WorkerPool::WorkerPool(const Hex& owner, const ml::u32 thread_count)
+    : bytecode(owner.loaded) {
+    workers.reserve(thread_count);
+
+    for (ml::u32 i = 0; i < thread_count; ++i) {
+        auto& worker = *workers.emplace_back(std::make_unique<Worker>());
+
+        worker.vm          = std::make_unique<Hex>();
+        worker.vm->natives = owner.natives;
+        worker.vm->slicing = true;
+        worker.vm->Load(bytecode);
+    }
+
+    threads.reserve(thread_count - 1);
+    for (ml::u32 i = 1; i < thread_count; ++i) {
+        threads.emplace_back([this, i] {
+            Serve(i);
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+}
+
+const hexe::ByteCode* WorkerPool::Bytecode() const {
+    return bytecode;
+}
+
+bool WorkerPool::IsWorthSplitting(const ml::i64 iterations) {
+    return iterations >= 2 * MIN_GRAIN;
+}
+
+bool WorkerPool::Run(const Hex& loop_owner,
+                     const ml::u8* loop_body,
+                     const ml::u16 loop_frame,
+                     const ml::i64 first,
+                     const ml::i64 last) {
+    const auto iterations = last - first + 1;
+    {
+        std::lock_guard lock(mutex);
+
+        owner = &loop_owner;
+        body  = loop_body;
+        frame = loop_frame;
+        grain = std::max(MIN_GRAIN, iterations / (static_cast<ml::i64>(workers.size()) * SLICES_PER_WORKER));
+
+        failed    = false;
+        remaining = iterations;
+
+        {
+            std::lock_guard range_lock(workers[0]->mutex);
+            workers[0]->ranges.push_back({first, last});
+        }
+
+        ++generation;
+    }
+    wake.notify_all();
+
+    Work(0);
+
+    // workers may still be running the last slices
+    std::unique_lock lock(mutex);
+    idle.wait(lock,
+              [this] {
+                  return busy == 0;
+              }
+    );
+
+    return not failed;
+}
+
+void WorkerPool::Serve(const ml::usize index) {
+    ml::u64 seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock,
+                      [this, seen] {
+                          return stopping || generation != seen;
+                      }
+            );
+
+            if (stopping) {
+                return;
+            }
+
+            seen = generation;
+            ++busy;
+        }
+
+        Work(index);
+
+        {
+            std::lock_guard lock(mutex);
+            --busy;
+        }
+        idle.notify_all();
+    }
+}
+
+void WorkerPool::Work(const ml::usize index) {
+    auto& worker = *workers[index];
+
+    Range range {};
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (not Take(index, range)) {
+            // the last slices are still running elsewhere
+            std::this_thread::yield();
+            continue;
+        }
+
+        // the upper halves are left for this worker to come back to, or for others to steal
+        while (range.last - range.first + 1 > grain) {
+            const auto middle = range.first + (range.last - range.first) / 2;
+            {
+                std::lock_guard lock(worker.mutex);
+                worker.ranges.push_back({middle + 1, range.last});
+            }
+            range.last = middle;
+        }
+
+        if (not worker.vm->RunSlice(*owner, body, frame, range.first, range.last)) {
+            failed = true;
+        }
+
+        remaining.fetch_sub(range.last - range.first + 1, std::memory_order_acq_rel);
+    }
+}
+
+bool WorkerPool::Take(const ml::usize index, Range& range) {
+    // the most recent half is the smallest, and closest to what this worker just ran
+    {
+        auto& own = *workers[index];
+
+        std::lock_guard lock(own.mutex);
+        if (not own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+
+    // the oldest is the largest, which saves coming back to steal again soon
+    for (ml::usize i = 1; i < workers.size(); ++i) {
+        auto& victim = *workers[(index + i) % workers.size()];
+
+        std::lock_guard lock(victim.mutex);
+        if (not victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace hex
@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/hex.hpp>
+
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+
+namespace {
+constexpr auto COUNTING = R"(
+fn Dive(n: i64) {
+    if n == 0 {
+        return
+    }
+    Dive(n - 1)
+    Record(n)
+}
+
+fn Main() {
+    mut data total = 0
+    loop 1..100 => i {
+        total += i
+        Record(total)
+    }
+    Dive(20)
+}
+)";
+
+constexpr auto STRAIGHT = R"(
+fn Main() {
+    Record(1)
+    Record(2)
+    Record(3)
+}
+)";
+
+constexpr auto NATIVES = "fn Record(x: i64)\n";
+
+// runs the program to completion, continuing with 'budget' each time it's suspended
+struct BudgetedRun {
+    InterpretResult result = InterpretResult::OK;
+    i64 suspensions        = 0;
+};
+
+BudgetedRun RunWithBudget(Hex& vm, const hexe::ByteCode& bytecode, const i64 budget) {
+    BudgetedRun run {vm.Execute(&bytecode, budget)};
+    while (run.result == InterpretResult::Suspended) {
+        ++run.suspensions;
+        run.result = vm.Continue(budget);
+    }
+    return run;
+}
+} // namespace
+
+TEST_CASE("Instruction Budgets", "[hex][budget]") {
+    std::vector<i64> recorded;
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+
+    SECTION("A suspended run carries on where it left off") {
+        const auto bytecode = Compile(COUNTING, NATIVES);
+
+        REQUIRE(vm.Execute(&bytecode) == InterpretResult::OK);
+        const auto expected = recorded;
+        REQUIRE(expected.size() == 120);
+
+        for (const i64 budget : {1, 7, 64}) {
+            recorded.clear();
+
+            const auto run = RunWithBudget(vm, bytecode, budget);
+            REQUIRE(run.result == InterpretResult::OK);
+            REQUIRE(run.suspensions > 0);
+            REQUIRE(recorded == expected);
+        }
+    }
+
+    SECTION("Smaller budgets suspend more often, and a large enough one never does") {
+        const auto bytecode = Compile(COUNTING, NATIVES);
+
+        const auto small = RunWithBudget(vm, bytecode, 5);
+        const auto large = RunWithBudget(vm, bytecode, 50);
+        const auto whole = RunWithBudget(vm, bytecode, 1'000'000);
+
+        REQUIRE(small.suspensions > large.suspensions);
+        REQUIRE(large.suspensions > 0);
+        REQUIRE(whole.suspensions == 0);
+    }
+
+    SECTION("Calls spend from the budget, as recursion has no backward jumps") {
+        const auto bytecode = Compile("fn Dive(n: i64) {\n    if n == 0 {\n        return\n    }\n    Dive(n - 1)\n}\n"
+                                      "fn Main() {\n    Dive(40)\n}\n");
+
+        const auto run = RunWithBudget(vm, bytecode, 10);
+        REQUIRE(run.result == InterpretResult::OK);
+        REQUIRE(run.suspensions >= 4);
+    }
+
+    SECTION("Straight-line code spends nothing") {
+        const auto bytecode = Compile(STRAIGHT, NATIVES);
+
+        REQUIRE(vm.Execute(&bytecode, 1) == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<i64> {1, 2, 3});
+    }
+
+    SECTION("Only a suspended run can be continued") {
+        const auto bytecode = Compile(STRAIGHT, NATIVES);
+
+        REQUIRE(vm.Continue(100) == InterpretResult::RuntimeError);
+
+        REQUIRE(vm.Execute(&bytecode, 100) == InterpretResult::OK);
+        REQUIRE(vm.Continue(100) == InterpretResult::RuntimeError);
+        REQUIRE(recorded.size() == 3);
+    }
+}
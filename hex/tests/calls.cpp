@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/hex.hpp>
+
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+
+namespace {
+constexpr auto CALLS = R"(
+fn Add(a: i64, b: i64) -> i64 {
+    return a + b
+}
+
+fn Sum(n: i64) -> i64 {
+    mut data total = 0
+    loop 1..n => i {
+        total += i
+    }
+    return total
+}
+
+fn Main() {
+    Record(Sum(1000))
+}
+)";
+
+constexpr auto NATIVES = "fn Record(x: i64)\n";
+} // namespace
+
+TEST_CASE("Host Calls", "[hex][call]") {
+    const auto bytecode = Compile(CALLS, NATIVES);
+
+    std::vector<i64> recorded;
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+
+    SECTION("Functions can be called without running Main") {
+        REQUIRE(vm.Load(&bytecode));
+
+        const auto add = vm.Find("Add");
+        REQUIRE(add.has_value());
+        REQUIRE(add->param_count == 2);
+
+        const auto result = vm.Call(*add, i64 {40}, i64 {2});
+        REQUIRE(result.Type() == Value::Data::Int64);
+        REQUIRE(result.AsInt() == 42);
+        REQUIRE(recorded.empty());
+    }
+
+    SECTION("Calls by name find the same function") {
+        REQUIRE(vm.Load(&bytecode));
+        REQUIRE(vm.Call("Add", i64 {-5}, i64 {5}).AsInt() == 0);
+        REQUIRE_FALSE(vm.Find("Missing").has_value());
+    }
+
+    SECTION("Calls can be repeated after Main, without running it again") {
+        REQUIRE(vm.Execute(&bytecode) == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<i64> {500500});
+
+        const auto sum = vm.Find("Sum");
+        REQUIRE(sum.has_value());
+
+        for (i64 n = 1; n <= 100; ++n) {
+            REQUIRE(vm.Call(*sum, n).AsInt() == n * (n + 1) / 2);
+        }
+        REQUIRE(recorded.size() == 1);
+    }
+
+    SECTION("The wrong number of arguments is refused") {
+        REQUIRE(vm.Load(&bytecode));
+
+        const auto add = vm.Find("Add");
+        REQUIRE(add.has_value());
+
+        REQUIRE(vm.Call(*add, i64 {1}).Type() == Value::Data::Invalid);
+        REQUIRE(vm.Call(*add, i64 {1}, i64 {2}, i64 {3}).Type() == Value::Data::Invalid);
+
+        // a refused call leaves nothing behind for the next one
+        REQUIRE(vm.Call(*add, i64 {1}, i64 {2}).AsInt() == 3);
+    }
+
+    SECTION("Calls are refused while a suspended run waits to continue") {
+        REQUIRE(vm.Execute(&bytecode, 10) == InterpretResult::Suspended);
+
+        const auto add = vm.Find("Add");
+        REQUIRE(add.has_value());
+        REQUIRE(vm.Call(*add, i64 {1}, i64 {2}).Type() == Value::Data::Invalid);
+
+        auto result = InterpretResult::Suspended;
+        while (result == InterpretResult::Suspended) {
+            result = vm.Continue(100);
+        }
+
+        REQUIRE(result == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<i64> {500500});
+        REQUIRE(vm.Call(*add, i64 {1}, i64 {2}).AsInt() == 3);
+    }
+
+    SECTION("Natives can't call functions, and the run that called them carries on") {
+        std::vector<Value::Data::Type> reentered;
+        vm.RegisterNative("Record", 1, [&](const std::span<const Value> args) {
+            recorded.push_back(args[0].AsInt());
+            reentered.push_back(vm.Call("Add", i64 {1}, i64 {2}).Type());
+            return Value {};
+        });
+
+        REQUIRE(vm.Execute(&bytecode) == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<i64> {500500});
+        REQUIRE(reentered == std::vector {Value::Data::Invalid});
+
+        REQUIRE(vm.Call("Add", i64 {1}, i64 {2}).AsInt() == 3);
+    }
+
+    SECTION("Nothing can be called before bytecode is loaded") {
+        REQUIRE(vm.Call("Add", i64 {1}, i64 {2}).Type() == Value::Data::Invalid);
+    }
+}
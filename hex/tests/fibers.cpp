@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/hex.hpp>
+#include <hex/scheduler.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+
+namespace {
+constexpr auto PATROLS = R"(
+fn Patrol(id: i64, steps: i64) -> i64 {
+    mut data position = 0
+
+    loop 1..steps => i {
+        position += 1
+        Record(id * 100 + position)
+        yield
+    }
+
+    return position
+}
+
+fn Dive(n: i64) {
+    if n == 0 {
+        Record(0)
+        yield
+        return
+    }
+    Dive(n - 1)
+    Record(n)
+}
+
+fn Main() {}
+)";
+
+constexpr auto NATIVES = "fn Record(x: i64)\n";
+
+std::array<Value, 2> Args(const i64 id, const i64 steps) {
+    return {Value(id), Value(steps)};
+}
+} // namespace
+
+TEST_CASE("Fibers", "[hex][fiber]") {
+    const auto bytecode = Compile(PATROLS, NATIVES);
+
+    std::vector<i64> recorded;
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+    REQUIRE(vm.Load(&bytecode));
+
+    const auto patrol = vm.Find("Patrol");
+    REQUIRE(patrol.has_value());
+
+    SECTION("A fiber runs up to each yield, and finishes with its return value") {
+        auto fiber = vm.Spawn(*patrol, Args(1, 3));
+        REQUIRE(fiber.State() == FiberState::Suspended);
+        REQUIRE(recorded.empty());
+
+        for (i64 step = 1; step <= 3; ++step) {
+            REQUIRE(vm.Resume(fiber) == FiberState::Suspended);
+            REQUIRE(recorded.back() == 100 + step);
+        }
+
+        REQUIRE(vm.Resume(fiber) == FiberState::Finished);
+        REQUIRE(fiber.Result().AsInt() == 3);
+        REQUIRE(recorded.size() == 3);
+
+        // finished fibers stay finished
+        REQUIRE(vm.Resume(fiber) == FiberState::Finished);
+        REQUIRE(recorded.size() == 3);
+    }
+
+    SECTION("Fibers keep their own registers between resumes") {
+        auto first  = vm.Spawn(*patrol, Args(1, 2));
+        auto second = vm.Spawn(*patrol, Args(2, 2));
+
+        REQUIRE(vm.Resume(first) == FiberState::Suspended);
+        REQUIRE(vm.Resume(second) == FiberState::Suspended);
+        REQUIRE(vm.Resume(second) == FiberState::Suspended);
+        REQUIRE(vm.Resume(first) == FiberState::Suspended);
+
+        REQUIRE(recorded == std::vector<i64> {101, 201, 202, 102});
+
+        REQUIRE(vm.Resume(first) == FiberState::Finished);
+        REQUIRE(vm.Resume(second) == FiberState::Finished);
+        REQUIRE(first.Result().AsInt() == 2);
+        REQUIRE(second.Result().AsInt() == 2);
+    }
+
+    SECTION("Fibers grow to fit calls deeper than their first frame") {
+        const auto dive = vm.Find("Dive");
+        REQUIRE(dive.has_value());
+
+        const std::array args {Value(i64 {200})};
+        auto fiber = vm.Spawn(*dive, args);
+
+        // the yield is 200 calls deep, and the way back up has to find every frame where it was
+        const auto footprint = fiber.Footprint();
+        REQUIRE(vm.Resume(fiber) == FiberState::Suspended);
+        REQUIRE(fiber.Footprint() > footprint);
+        REQUIRE(recorded == std::vector<i64> {0});
+
+        REQUIRE(vm.Resume(fiber) == FiberState::Finished);
+        REQUIRE(recorded.size() == 201);
+        REQUIRE(recorded.back() == 200);
+    }
+
+    SECTION("Spawning with the wrong number of arguments fails") {
+        const std::array args {Value(i64 {1})};
+        auto fiber = vm.Spawn(*patrol, args);
+
+        REQUIRE(fiber.State() == FiberState::Failed);
+        REQUIRE(vm.Resume(fiber) == FiberState::Failed);
+        REQUIRE(recorded.empty());
+    }
+
+    SECTION("Fibers fail to resume once other bytecode is loaded") {
+        auto fiber = vm.Spawn(*patrol, Args(1, 3));
+        REQUIRE(vm.Resume(fiber) == FiberState::Suspended);
+
+        const auto other = Compile(PATROLS, NATIVES);
+        REQUIRE(vm.Load(&other));
+
+        REQUIRE(vm.Resume(fiber) == FiberState::Failed);
+        REQUIRE(recorded.size() == 1);
+    }
+}
+
+TEST_CASE("Scheduler", "[hex][fiber]") {
+    const auto bytecode = Compile(PATROLS, NATIVES);
+
+    std::vector<i64> recorded;
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+    REQUIRE(vm.Load(&bytecode));
+
+    const auto patrol = vm.Find("Patrol");
+    REQUIRE(patrol.has_value());
+
+    Scheduler scheduler(vm);
+
+    SECTION("Each tick resumes every fiber once, in spawn order, and drops the finished ones") {
+        REQUIRE(scheduler.Spawn(*patrol, Args(1, 1)));
+        REQUIRE(scheduler.Spawn(*patrol, Args(2, 2)));
+        REQUIRE(scheduler.Spawn(*patrol, Args(3, 3)));
+        REQUIRE(scheduler.Count() == 3);
+
+        REQUIRE(scheduler.Tick() == 3);
+        REQUIRE(recorded == std::vector<i64> {101, 201, 301});
+
+        REQUIRE(scheduler.Tick() == 2);
+        REQUIRE(scheduler.Tick() == 1);
+        REQUIRE(scheduler.Tick() == 0);
+
+        REQUIRE(recorded == std::vector<i64> {101, 201, 301, 202, 302, 303});
+        REQUIRE(scheduler.Count() == 0);
+    }
+
+    SECTION("Fibers which can't be spawned are never scheduled") {
+        const std::array args {Value(i64 {1})};
+        REQUIRE_FALSE(scheduler.Spawn(*patrol, args));
+        REQUIRE(scheduler.Count() == 0);
+        REQUIRE(scheduler.Tick() == 0);
+    }
+
+    SECTION("Budgeted ticks suspend long fibers without losing their place") {
+        REQUIRE(scheduler.Spawn(*patrol, Args(1, 4)));
+
+        // a budget of one suspends the fiber at its first backward jump, well before it yields
+        ml::usize ticks = 0;
+        while (scheduler.Tick(1) > 0) {
+            ++ticks;
+        }
+
+        REQUIRE(recorded == std::vector<i64> {101, 102, 103, 104});
+        REQUIRE(ticks > 4);
+    }
+}
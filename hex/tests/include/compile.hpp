@@ -0,0 +1,40 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <circe/bytecode-generator.hpp>
+
+#include <sigil/ast/lexer.hpp>
+#include <sigil/ast/parser.hpp>
+#include <sigil/ast/semantic-analyzer.hpp>
+
+#include <hexe/bytecode.hpp>
+
+#include <string>
+#include <string_view>
+
+// compiles a program in memory, with natives declared the way a manifest would
+inline hexe::ByteCode Compile(const std::string_view source, const std::string_view natives = {}) {
+    sigil::Lexer lexer;
+    sigil::Parser parser;
+    sigil::SemanticAnalyzer analyzer;
+    circe::BytecodeGenerator codegen;
+
+    if (not natives.empty()) {
+        REQUIRE(analyzer.RegisterNatives(natives, "natives"));
+    }
+
+    REQUIRE(lexer.TokenizeSource(std::string(source), "test"));
+
+    parser.AcquireTokens(lexer.Tokens());
+    parser.RetainParseTree(false);
+    REQUIRE(parser.Parse());
+    REQUIRE(parser.IssueCount() == 0);
+
+    analyzer.Analyze(parser.FlatAST());
+    REQUIRE(analyzer.IssueCount() == 0);
+
+    codegen.ObtainSemanticAnalysisInfo(analyzer);
+    codegen.Generate(parser.FlatAST());
+    return codegen.Bytecode();
+}
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <hex/core/list-math.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+using enum Value::Data::Type;
+
+namespace {
+template <typename T>
+Value ListOf(const Value::Data::Type type, const std::initializer_list<T> elements) {
+    Value list {static_cast<u8>(type), static_cast<Value::SizeType>(elements.size())};
+    std::ranges::copy(elements, list.Elements<T>());
+    return list;
+}
+
+template <typename T>
+std::vector<T> ElementsOf(const Value& list) {
+    return {list.Elements<T>(), list.Elements<T>() + list.Count()};
+}
+} // namespace
+
+TEST_CASE("List Kernels", "[hex][list]") {
+    SECTION("Empty lists have nothing to reduce, find or combine") {
+        const Value empty {static_cast<u8>(Float32), 0};
+        REQUIRE(empty.Count() == 0);
+
+        REQUIRE(list::Sum(empty).AsFloat() == 0.0);
+        REQUIRE(list::Min(empty).AsFloat() == 0.0);
+        REQUIRE(list::Max(empty).AsFloat() == 0.0);
+        REQUIRE(list::Find(empty, Value {1.0}) == -1);
+
+        REQUIRE(list::Add(empty, empty).Count() == 0);
+        REQUIRE(list::Mul(empty, ListOf<f32>(Float32, {1.0f, 2.0f})).Count() == 0);
+        REQUIRE(list::Slice(empty, 0, 4).Count() == 0);
+
+        Value sorted = empty;
+        list::Sort(sorted);
+        REQUIRE(sorted.Count() == 0);
+    }
+
+    SECTION("Counts which aren't a multiple of the lane width reach every element") {
+        // 7 floats is a run of 4 lanes and 3 left over, 19 bytes a run of 16 and 3 left over
+        const auto floats = ListOf<f32>(Float32, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, -7.0f});
+        REQUIRE(list::Sum(floats).AsFloat() == 14.0);
+        REQUIRE(list::Min(floats).AsFloat() == -7.0);
+        REQUIRE(list::Max(floats).AsFloat() == 6.0);
+        REQUIRE(ElementsOf<f32>(list::Mul(floats, floats)).back() == 49.0f);
+
+        const auto doubles = ListOf<f64>(Float64, {0.5, 1.5, 2.5, 3.5, 9.5});
+        REQUIRE(list::Sum(doubles).AsFloat() == 17.5);
+        REQUIRE(list::Max(doubles).AsFloat() == 9.5);
+        REQUIRE(ElementsOf<f64>(list::Add(doubles, doubles)).back() == 19.0);
+
+        Value bytes {static_cast<u8>(Uint8), 19};
+        for (u32 i = 0; i < bytes.Count(); ++i) {
+            bytes.Elements<u8>()[i] = static_cast<u8>(i);
+        }
+
+        const auto doubled = ElementsOf<u8>(list::Add(bytes, bytes));
+        REQUIRE(doubled.size() == 19);
+        for (u32 i = 0; i < doubled.size(); ++i) {
+            REQUIRE(doubled[i] == 2 * i);
+        }
+    }
+
+    SECTION("Combining lists of different lengths stops at the shorter one") {
+        const auto longer  = ListOf<i32>(Int32, {1, 2, 3, 4, 5});
+        const auto shorter = ListOf<i32>(Int32, {10, 20});
+
+        REQUIRE(ElementsOf<i32>(list::Add(longer, shorter)) == std::vector<i32> {11, 22});
+        REQUIRE(ElementsOf<i32>(list::Mul(shorter, longer)) == std::vector<i32> {10, 40});
+    }
+
+    SECTION("Integer arithmetic wraps around at the element's width, and sums widen") {
+        const auto bytes = ListOf<u8>(Uint8, {250, 200});
+        REQUIRE(ElementsOf<u8>(list::Add(bytes, ListOf<u8>(Uint8, {10, 100}))) == std::vector<u8> {4, 44});
+        REQUIRE(list::Sum(bytes).AsUint() == 450);
+
+        const auto signed_bytes = ListOf<i8>(Int8, {127, -128});
+        REQUIRE(ElementsOf<i8>(list::Add(signed_bytes, ListOf<i8>(Int8, {1, -1}))) == std::vector<i8> {-128, 127});
+
+        const auto words = ListOf<i16>(Int16, {300, -300});
+        REQUIRE(ElementsOf<i16>(list::Mul(words, words)) == std::vector<i16> {24464, 24464});
+
+        const auto longs = ListOf<i64>(Int64, {std::numeric_limits<i64>::max(), 5});
+        REQUIRE(ElementsOf<i64>(list::Add(longs, ListOf<i64>(Int64, {1, 1})))
+                == std::vector<i64> {std::numeric_limits<i64>::min(), 6});
+        REQUIRE(list::Sum(longs).AsInt() == std::numeric_limits<i64>::min() + 4);
+        REQUIRE(list::Sum(ListOf<i8>(Int8, {-100, -100, 50})).AsInt() == -150);
+    }
+
+    SECTION("Values wider than the elements are found only where they're equal at full width") {
+        const auto bytes = ListOf<u8>(Uint8, {7, 44, 255});
+        REQUIRE(list::Find(bytes, Value {i64 {44}}) == 1);
+        REQUIRE(list::Find(bytes, Value {i64 {300}}) == -1);
+        REQUIRE(list::Find(bytes, Value {i64 {255 + 256}}) == -1);
+
+        const auto signed_bytes = ListOf<i8>(Int8, {0, -1});
+        REQUIRE(list::Find(signed_bytes, Value {i64 {-1}}) == 1);
+        REQUIRE(list::Find(signed_bytes, Value {i64 {255}}) == -1);
+
+        const auto floats = ListOf<f32>(Float32, {0.5f, 0.1f});
+        REQUIRE(list::Find(floats, Value {0.5}) == 0);
+        REQUIRE(list::Find(floats, Value {0.1}) == -1);
+    }
+
+    SECTION("Slices are clamped to the list") {
+        const auto list = ListOf<i16>(Int16, {1, 2, 3, 4, 5});
+
+        REQUIRE(ElementsOf<i16>(list::Slice(list, 1, 3)) == std::vector<i16> {2, 3});
+        REQUIRE(ElementsOf<i16>(list::Slice(list, -4, 2)) == std::vector<i16> {1, 2});
+        REQUIRE(ElementsOf<i16>(list::Slice(list, 3, 99)) == std::vector<i16> {4, 5});
+        REQUIRE(list::Slice(list, 4, 1).Count() == 0);
+        REQUIRE(list::Slice(list, 7, 9).Count() == 0);
+
+        Value bits {static_cast<u8>(Bits), 10};
+        bits.SetBit(9, true);
+
+        const auto tail = list::Slice(bits, 8, 20);
+        REQUIRE(tail.Count() == 2);
+        REQUIRE_FALSE(tail.Bit(0));
+        REQUIRE(tail.Bit(1));
+    }
+
+    SECTION("Sorting puts NaNs after every number") {
+        constexpr auto nan = std::numeric_limits<f64>::quiet_NaN();
+
+        auto list = ListOf<f64>(Float64, {3.0, nan, -1.0, nan, 2.0, 0.5});
+        list::Sort(list);
+
+        const auto sorted = ElementsOf<f64>(list);
+        REQUIRE(std::vector<f64>(sorted.begin(), sorted.begin() + 4) == std::vector<f64> {-1.0, 0.5, 2.0, 3.0});
+        REQUIRE(std::isnan(sorted[4]));
+        REQUIRE(std::isnan(sorted[5]));
+
+        auto ints = ListOf<u16>(Uint16, {9, 65535, 0, 9});
+        list::Sort(ints);
+        REQUIRE(ElementsOf<u16>(ints) == std::vector<u16> {0, 9, 9, 65535});
+    }
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/core/map-ops.hpp>
+#include <hex/hex.hpp>
+
+#include <fmt/format.h>
+
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+using enum Value::Data::Type;
+
+namespace {
+// 'index' is spliced into a MapKeyAt and a MapValueAt on a map of two entries
+InterpretResult RunIndexed(const std::string_view index, std::vector<i64>& recorded) {
+    const auto bytecode = Compile(fmt::format(R"(
+fn Main() {{
+    mut data m: [i64: i64] = [:]
+    MapSet(m, 7, 70)
+    MapSet(m, 9, 90)
+
+    Record(MapValueAt(m, {0}))
+    Record(MapKeyAt(m, {0}))
+}}
+)",
+                                              index
+                                  ),
+                                  "fn Record(x: i64)\n"
+    );
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+
+    return vm.Execute(&bytecode);
+}
+} // namespace
+
+TEST_CASE("Map Indexing", "[hex][map]") {
+    SECTION("Entries are read back by index while it's within the map") {
+        auto ints = Value::NewMap(IntMap);
+        map::Set(ints, Value {i64 {7}}, Value {1.5});
+
+        REQUIRE(map::KeyAt(ints, 0)->AsInt() == 7);
+        REQUIRE(map::ValueAt(ints, 0)->AsFloat() == 1.5);
+
+        REQUIRE_FALSE(map::KeyAt(ints, 1).has_value());
+        REQUIRE_FALSE(map::KeyAt(ints, -1).has_value());
+        REQUIRE(map::ValueAt(ints, 1) == nullptr);
+
+        auto strings = Value::NewMap(StringMap);
+        REQUIRE_FALSE(map::KeyAt(strings, 0).has_value());
+        REQUIRE(map::ValueAt(strings, 0) == nullptr);
+
+        map::Set(strings, Value {std::string_view {"slime"}}, Value {i64 {3}});
+        REQUIRE(map::KeyAt(strings, 0)->AsString() == "slime");
+    }
+
+    SECTION("Indexing past the end of a map stops the program") {
+        std::vector<i64> recorded;
+        REQUIRE(RunIndexed("1", recorded) == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<i64> {90, 9});
+
+        recorded.clear();
+        REQUIRE(RunIndexed("2", recorded) == InterpretResult::RuntimeError);
+        REQUIRE(recorded.empty());
+
+        REQUIRE(RunIndexed("-1", recorded) == InterpretResult::RuntimeError);
+        REQUIRE(recorded.empty());
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/hex.hpp>
+
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+
+namespace {
+constexpr i64 COUNT = 1000;
+
+// 'range' is spliced into the parallel loop, which writes every element from values bound outside of it
+std::string ParallelProgram(const std::string_view range) {
+    std::string zeroes = "0";
+    for (i64 i = 1; i < COUNT; ++i) {
+        zeroes += ", 0";
+    }
+
+    return fmt::format(R"(
+fn Main() {{
+    mut data xs = [{}]
+    data scale  = 3
+    data offset = 7
+
+    @parallel loop {} => i {{
+        xs[i] = i * scale + offset
+    }}
+
+    loop 0..{} => i {{
+        Record(xs[i])
+    }}
+}}
+)",
+                       zeroes,
+                       range,
+                       COUNT - 1
+    );
+}
+
+std::vector<i64> RunParallel(const hexe::ByteCode& bytecode, const u32 parallelism) {
+    std::vector<i64> recorded;
+
+    Hex vm;
+    vm.SetParallelism(parallelism);
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsInt());
+        return Value {};
+    });
+
+    REQUIRE(vm.Execute(&bytecode) == InterpretResult::OK);
+    return recorded;
+}
+} // namespace
+
+TEST_CASE("Parallel Loops", "[hex][parallel]") {
+    std::vector<i64> expected(COUNT);
+    for (i64 i = 0; i < COUNT; ++i) {
+        expected[i] = i * 3 + 7;
+    }
+
+    // a single thread runs the loop as is, more have the pool split it, borrowing Main's registers
+    for (const u32 parallelism : {1u, 4u, 0u}) {
+        DYNAMIC_SECTION("Every element is written with a parallelism of " << parallelism) {
+            const auto bytecode = Compile(ParallelProgram(fmt::format("0..{}", COUNT - 1)), "fn Record(x: i64)\n");
+            REQUIRE(RunParallel(bytecode, parallelism) == expected);
+        }
+
+        DYNAMIC_SECTION("Descending ranges cover every element with a parallelism of " << parallelism) {
+            const auto bytecode = Compile(ParallelProgram(fmt::format("{}..0", COUNT - 1)), "fn Record(x: i64)\n");
+            REQUIRE(RunParallel(bytecode, parallelism) == expected);
+        }
+    }
+
+    SECTION("Running the same program again on the pool gives the same result") {
+        const auto bytecode = Compile(ParallelProgram(fmt::format("0..{}", COUNT - 1)), "fn Record(x: i64)\n");
+
+        std::vector<i64> recorded;
+
+        Hex vm;
+        vm.SetParallelism(4);
+        vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+            recorded.push_back(args[0].AsInt());
+            return Value {};
+        });
+
+        for (i64 run = 0; run < 3; ++run) {
+            recorded.clear();
+            REQUIRE(vm.Execute(&bytecode) == InterpretResult::OK);
+            REQUIRE(recorded == expected);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <compile.hpp>
+
+#include <hex/core/vector-math.hpp>
+#include <hex/hex.hpp>
+
+#include <fmt/format.h>
+
+#include <limits>
+#include <vector>
+
+using namespace hex;
+using namespace mana::literals;
+
+using hexe::Value;
+
+namespace {
+constexpr auto I32_MAX = std::numeric_limits<i32>::max();
+constexpr auto I32_MIN = std::numeric_limits<i32>::min();
+
+Value::Lanes IntLanes(const i32 x, const i32 y) {
+    Value::Lanes lanes {};
+    lanes.as_i32 = {x, y, 0, 0};
+    return lanes;
+}
+
+// 'index' is held in a variable, so the analyzer can't check it
+InterpretResult RunLane(const std::string_view index, std::vector<f64>& recorded) {
+    const auto bytecode = Compile(fmt::format(R"(
+fn Main() {{
+    data v = Vec3(1.0, 2.0, 3.0)
+    data i = {}
+    Record(v[i])
+}}
+)",
+                                              index
+                                  ),
+                                  "fn Record(x: f64)\n"
+    );
+
+    Hex vm;
+    vm.RegisterNative("Record", 1, [&recorded](const std::span<const Value> args) {
+        recorded.push_back(args[0].AsFloat());
+        return Value {};
+    });
+
+    return vm.Execute(&bytecode);
+}
+} // namespace
+
+TEST_CASE("Vectors", "[hex][vector]") {
+    SECTION("Integer lanes wrap around on overflow") {
+        const auto sum = vec::AddI(IntLanes(I32_MAX, I32_MIN), IntLanes(1, -1));
+        REQUIRE(sum.as_i32[0] == I32_MIN);
+        REQUIRE(sum.as_i32[1] == I32_MAX);
+
+        const auto scaled = vec::ScaleI(IntLanes(I32_MAX, 3), 2);
+        REQUIRE(scaled.as_i32[0] == -2);
+        REQUIRE(scaled.as_i32[1] == 6);
+
+        REQUIRE(vec::DotI(IntLanes(I32_MAX, 1), IntLanes(2, 0)) == -2);
+    }
+
+    SECTION("Lanes past the vector's width stop the program") {
+        std::vector<f64> recorded;
+        REQUIRE(RunLane("2", recorded) == InterpretResult::OK);
+        REQUIRE(recorded == std::vector<f64> {3.0});
+
+        recorded.clear();
+        REQUIRE(RunLane("3", recorded) == InterpretResult::RuntimeError);
+        REQUIRE(RunLane("-1", recorded) == InterpretResult::RuntimeError);
+        REQUIRE(RunLane("7", recorded) == InterpretResult::RuntimeError);
+        REQUIRE(recorded.empty());
+    }
+}
@@ -7,6 +7,8 @@
 
 #include <format>
 #include <limits>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <spdlog/fmt/compile.h>
@@ -40,7 +42,7 @@ class Header {
     static constexpr u64 MAGIC = 0x45584548414e414d; // do not ever change this
 
     static constexpr u8 VERSION_MAJOR  = 0;
-    static constexpr u8 VERSION_MINOR  = 1;
+    static constexpr u8 VERSION_MINOR  = 8;
     static constexpr u16 VERSION_PATCH = 0;
 
 
@@ -59,7 +61,16 @@ public:
 
     u16 main_frame;         // register window for global scope + main
 
-    u8 PADDING_COMPAT_[26]; // extra space reserved for forward compatibility
+    u16 section_flags;      // optional sections following the instructions
+    u32 line_table_size;    // size of line table section in bytes
+    u32 export_table_size;  // size of export table section in bytes
+    u32 import_table_size;  // size of import table section in bytes
+
+    u8 PADDING_COMPAT_[12]; // extra space reserved for forward compatibility
+
+    static constexpr u16 SECTION_LINE_TABLE   = 1 << 0;
+    static constexpr u16 SECTION_EXPORT_TABLE = 1 << 1;
+    static constexpr u16 SECTION_IMPORT_TABLE = 1 << 2;
 
     static constexpr std::string Version = fmt::format("{}.{}.{}"_cf,
                                                    VERSION_MAJOR,
@@ -71,15 +82,37 @@ public:
 };
 // @formatter:on
 
+// a function hosts can call by name, see hex::Hex::Call
 struct FunctionEntry {
+    std::string name;
     i64 address;
     u16 register_count;
+    u8 param_count;
+};
+
+// a function the host provides, see hex::Hex::RegisterNative
+struct NativeImport {
+    std::string name;
+    u8 param_count;
+};
+
+// maps every instruction from 'offset' up to the next entry back to its source
+struct LineEntry {
+    u32 offset;
+    i32 line;
+    i32 column;
 };
 
 class ByteCode {
     std::vector<u8> instructions;
     std::vector<Value> constant_pool;
 
+    std::string source_name;
+    std::vector<LineEntry> line_table;
+
+    std::vector<FunctionEntry> export_table;
+    std::vector<NativeImport> import_table;
+
     i64 entry_point;
     u16 main_frame;
 
@@ -113,6 +146,9 @@ public:
     // Same as Patch, but specifically for Call instructions
     void PatchCall(i64 instruction_index, u32 new_address);
 
+    // Replaces the opcode at the given index, leaving its payloads untouched
+    void PatchOpcode(i64 instruction_index, Op new_opcode);
+
     HEXE_NODISCARD i64 BackIndex() const;
 
     HEXE_NODISCARD const std::vector<u8>& Instructions() const;
@@ -121,11 +157,40 @@ public:
 
     HEXE_NODISCARD const std::vector<Value>& Constants() const;
 
+    // attributes the next instruction written, and everything after it, to line:column
+    // the first call enables the line table section
+    void MarkSource(i32 line, i32 column);
+    void SetSourceName(std::string_view name);
+
+    HEXE_NODISCARD bool HasLineTable() const;
+    HEXE_NODISCARD std::string_view SourceName() const;
+    HEXE_NODISCARD const std::vector<LineEntry>& LineTable() const;
+
+    // returns the entry covering the instruction at 'offset', or nullptr if there is none
+    HEXE_NODISCARD const LineEntry* LocateSource(i64 offset) const;
+
+    // the first export enables the export table section
+    void AddExport(std::string_view name, i64 address, u16 register_count, u8 param_count);
+
+    HEXE_NODISCARD const std::vector<FunctionEntry>& Exports() const;
+
+    // returns nullptr if no function of that name was exported
+    HEXE_NODISCARD const FunctionEntry* FindExport(std::string_view name) const;
+
+    // returns the import's index, which CallNative refers to it by
+    // the first import enables the import table section
+    u16 AddImport(std::string_view name, u8 param_count);
+
+    HEXE_NODISCARD const std::vector<NativeImport>& Imports() const;
+
     // serializes Hex bytecode to a vector of unsigned char (bytes) in the Hexe format
     // the sequence is:
     // - Hexe Header (64 bytes)
     // - Constant Pool (size specified by Hexe Header)
     // - Instructions (2 bytes each, total specified by Hexe Header)
+    // - Line Table (optional, size specified by Hexe Header)
+    // - Export Table (optional, size specified by Hexe Header)
+    // - Import Table (optional, size specified by Hexe Header)
     HEXE_NODISCARD std::vector<u8> Serialize() const;
 
     HEXE_NODISCARD u32 ConstantPoolBytesCount() const;
@@ -158,6 +223,9 @@ public:
         return constant_pool.size() - 1;
     }
 
+    // for lists built ahead of time, packed ones included
+    u16 AddArray(Value array);
+
 private:
     HEXE_NODISCARD Header DeserializeHeader(const std::vector<u8>& header_bytes) const;
     HEXE_NODISCARD u32 Checksum(const void* ptr, usize size) const;
@@ -169,9 +237,30 @@ private:
     // (1) value tail
     //
     HEXE_NODISCARD std::vector<u8> SerializeConstants() const;
-    HEXE_NODISCARD std::vector<u8> SerializeHeader(const std::vector<u8>& code) const;
-
-    HEXE_NODISCARD Header CreateHeader(const std::vector<u8>& code) const;
+    HEXE_NODISCARD std::vector<u8> SerializeHeader(const std::vector<u8>& code,
+                                                   u32 export_table_size,
+                                                   u32 import_table_size) const;
+
+    // The line table is stored as:
+    // (2) source name length, followed by the name itself
+    // then one record per entry, each field a delta from the previous entry:
+    // (LEB128) offset, (zigzag LEB128) line, (zigzag LEB128) column
+    HEXE_NODISCARD std::vector<u8> SerializeLineTable() const;
+    bool DeserializeLineTable(const u8* data, usize size);
+
+    // The export table is stored as one record per function:
+    // (LEB128) name length, followed by the name itself
+    // (LEB128) address, (LEB128) register count, (1) parameter count
+    HEXE_NODISCARD std::vector<u8> SerializeExportTable() const;
+    bool DeserializeExportTable(const u8* data, usize size);
+
+    // The import table is stored as one record per native, in index order:
+    // (LEB128) name length, followed by the name itself
+    // (1) parameter count
+    HEXE_NODISCARD std::vector<u8> SerializeImportTable() const;
+    bool DeserializeImportTable(const u8* data, usize size);
+
+    HEXE_NODISCARD Header CreateHeader(const std::vector<u8>& code, u32 export_table_size, u32 import_table_size) const;
 
     void CheckInstructionSize() const;
     void CheckConstantPoolSize() const;
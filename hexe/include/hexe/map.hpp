@@ -0,0 +1,25 @@
+#pragma once
+
+#include <hexe/value.hpp>
+
+#include <emhash/emhash8.hpp>
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace hexe {
+// string keys are looked up by view, so a lookup never has to copy its key
+struct StringKeyHash {
+    usize operator()(const std::string_view key) const noexcept {
+        return std::hash<std::string_view> {}(key);
+    }
+};
+
+/// Hash maps behind Value's IntMap and StringMap types.
+///
+/// emhash8 keeps its entries packed together in insertion order, and erasing one moves the last
+/// entry into its place, so a map's entries can be walked by index from 0 to its size.
+struct IntHashMap : emhash8::HashMap<i64, Value> {};
+struct StringHashMap : emhash8::HashMap<std::string, Value, StringKeyHash, std::equal_to<>> {};
+} // namespace hexe
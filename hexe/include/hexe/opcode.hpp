@@ -1,5 +1,7 @@
 #pragma once
 
+#include <hexe/superinstructions.hpp>
+
 #include <mana/literals.hpp>
 
 namespace hexe {
@@ -52,6 +54,74 @@ enum class Op : u8 {
     ListCreate,    // Op Ty  Len Reg  -> Creates new Value of type Ty and reserves Len elements at Reg
     ListRead,      // Op Src Idx Dst  -> Copies Src[Idx] into Dst
     ListWrite,     // Op Dst Idx Src  -> Copies Src into Dst[Idx]
+
+    CallNative,    // Op Imp Base     -> Calls native Imp with the registers from Base on as its arguments
+                   //                 == The native's result is placed in the return register
+
+    Yield,         // Op              -> Suspend the running fiber, which resumes at the next instruction
+
+    ParallelFor,   // Op Frame Offset -> Runs the loop body that follows on worker threads, then jumps by Offset past its Join
+                   //                 == Registers Frame and Frame + 1 hold the first and last iteration, which get sliced up
+                   //                 == Workers borrow the registers below Frame, and give each slice a window of its own
+                   //                 == If the range isn't worth splitting up, this does nothing and the body runs as is
+    Join,          // Op              -> Ends a worker's slice of a parallel loop, does nothing anywhere else
+
+    VecMake,       // Op Ty Dst X Y Z W -> Dst = vector of type Ty, out of as many of X Y Z W as it has lanes
+    VecAdd,        // Op Dst L R      -> Dst = L + R, lane by lane
+    VecSub,        // etc.
+    VecScale,      // Op Dst V S      -> Dst = V * S, for a vector V and a scalar S
+    VecDot,        // Op Dst L R      -> Dst = dot product of L and R
+    VecCross,      // Op Dst L R      -> Dst = cross product of L and R, both vec3
+    VecLength,     // Op Dst Src      -> Dst = length of Src
+    VecNormalize,  // Op Dst Src      -> Dst = Src scaled to a length of 1
+    VecLane,       // Op Dst Src Idx  -> Dst = Src[Idx]
+
+    ListStore,     // Op Dst Idx Src  -> Same as ListWrite, but Idx is a register
+
+    ListReadI8,    // Op Src Idx Dst  -> ListRead for packed lists, widening the element into Dst
+    ListReadI16,   // etc.
+    ListReadI32,
+    ListReadU8,
+    ListReadU16,
+    ListReadU32,
+    ListReadF32,
+    ListReadBit,
+    ListStore8,    // Op Dst Idx Src  -> ListStore for packed lists, narrowing Src to the element's width
+    ListStore16,   // etc.
+    ListStore32,
+    ListStoreF32,
+    ListStoreBit,
+
+    ListFill,      // Op Dst Val      -> Sets every element of Dst to Val
+    ListCopy,      // Op Dst Src      -> Copies Src's elements over Dst's, as many as both have
+    ListSlice,     // Op Dst Src From To -> Dst = new list of Src[From..To), clamped to Src's bounds
+    ListSum,       // Op Dst Src      -> Dst = sum of Src's elements
+    ListMin,       // Op Dst Src      -> Dst = smallest of Src's elements, 0 if there are none
+    ListMax,       // etc.
+    ListFind,      // Op Dst Src Val  -> Dst = index of the first element of Src equal to Val, -1 if there is none
+    ListSort,      // Op Dst          -> Sorts Dst's elements in ascending order
+    ListAdd,       // Op Dst L R      -> Dst = new list of L[i] + R[i], as long as the shorter of the two
+    ListMul,       // etc.
+
+    MapCreate,     // Op Type Dst     -> Dst = new empty map, Type being IntMap or StringMap
+    MapGet,        // Op Dst Map Key Fallback -> Dst = value under Key in Map, or Fallback if there is none
+    MapSet,        // Op Map Key Val  -> Puts Val under Key in Map, replacing what was there
+    MapHas,        // Op Dst Map Key  -> Dst = whether Map has a value under Key
+    MapRemove,     // Op Dst Map Key  -> Removes Key from Map, Dst = whether it was there
+    MapCount,      // Op Dst Map      -> Dst = number of entries in Map
+    MapKeyAt,      // Op Dst Map Idx  -> Dst = key of Map's entry at Idx, which runs from 0 up to MapCount
+    MapValueAt,    // etc.
+
+    // bytecode refers to opcodes by number, so new ones go here, along with a bump of Header::VERSION_MINOR
+
+    // fused opcodes, named after their sequence (e.g. LoadConstant_Add)
+    // these must remain last, see superinstructions.hpp
+#define HEXE_FUSED_OP_2(a, b)    a##_##b,
+#define HEXE_FUSED_OP_3(a, b, c) a##_##b##_##c,
+    HEXE_SUPERINSTRUCTIONS_2(HEXE_FUSED_OP_2)
+    HEXE_SUPERINSTRUCTIONS_3(HEXE_FUSED_OP_3)
+#undef HEXE_FUSED_OP_2
+#undef HEXE_FUSED_OP_3
 };
 // @formatter:on
 } // namespace hexe
@@ -0,0 +1,22 @@
+#pragma once
+
+// Superinstructions fuse a run of opcodes into a single dispatch.
+//
+// This file is generated by hex-mine from dynamic opcode statistics,
+// so regenerate it from a representative corpus rather than editing it by hand.
+//
+// Each entry is the fused opcode sequence in execution order.
+// A fused opcode keeps every operand of its sequence in place,
+// which means only the leading opcode byte of a sequence gets rewritten to use it.
+
+#define HEXE_SUPERINSTRUCTIONS_2(X) \
+    X(Add, Jump) \
+    X(Add, LoadConstant) \
+    X(Cmp_Lesser, JumpWhenFalse) \
+    X(LoadConstant, Add) \
+    X(LoadConstant, Cmp_Lesser)
+
+#define HEXE_SUPERINSTRUCTIONS_3(X) \
+    X(Add, LoadConstant, Add) \
+    X(LoadConstant, Cmp_Lesser, JumpWhenFalse) \
+    X(LoadConstant, Add, Jump)
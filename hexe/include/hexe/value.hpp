@@ -3,6 +3,7 @@
 #include <mana/literals.hpp>
 
 #include <array>
+#include <cstring>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -11,6 +12,10 @@ namespace hexe {
 using namespace mana;
 using namespace mana::literals;
 
+// see hexe/map.hpp
+struct IntHashMap;
+struct StringHashMap;
+
 template <typename T>
 concept ValuePrimitiveType = std::is_integral_v<T>
                              || std::is_floating_point_v<T>
@@ -43,10 +48,36 @@ struct Value {
 
             None,
 
+            // f32 lanes, or i32 for Vec2i, kept inline rather than behind 'data'
+            Vec2,
+            Vec3,
+            Vec4,
+            Vec2i,
+
+            // list elements narrower than Data, packed back to back
+            Int8,
+            Int16,
+            Int32,
+            Uint8,
+            Uint16,
+            Uint32,
+            Float32,
+            Bits, // bools, eight to a byte
+
+            // hash maps by key type, which own their entries behind the pointer
+            IntMap,
+            StringMap,
+
             Invalid = 222,
         };
     };
 
+    // lanes past a vector's width stay zero, so math over all four leaves them be
+    union Lanes {
+        std::array<f32, 4> as_f32;
+        std::array<i32, 4> as_i32;
+    };
+
     using SizeType = u32;
 
     Value();
@@ -62,9 +93,14 @@ struct Value {
     Value(bool b);
 
     Value(std::string_view string);
+    // a list of 'length' elements, sized by the element width of 'vt'
     Value(u8 vt, SizeType length);
     Value(Data::Type vt, SizeType size);
     Value(u8 vt, const Data& other);
+    Value(Data::Type vt, const Lanes& vector);
+
+    // an empty map of type 'vt', IntMap or StringMap
+    HEXE_NODISCARD static Value NewMap(Data::Type vt);
 
     Value(const Value& other);
     Value(Value&& other) noexcept;
@@ -103,6 +139,10 @@ struct Value {
 
     HEXE_NODISCARD SizeType Length() const;
     HEXE_NODISCARD SizeType ByteLength() const;
+    HEXE_NODISCARD SizeType Count() const;
+
+    // bytes taken up by each element of a list of type 'vt', Bits aside
+    HEXE_NODISCARD static SizeType ElementSize(Data::Type vt);
 
     HEXE_NODISCARD u64 BitCasted(u32 at) const;
 
@@ -115,6 +155,51 @@ struct Value {
     HEXE_NODISCARD bool AsBool(i64 index = 0) const;
     HEXE_NODISCARD std::string_view AsString() const;
 
+    HEXE_NODISCARD bool IsVector() const;
+    HEXE_NODISCARD u8 LaneCount() const;
+    HEXE_NODISCARD const Lanes& AsLanes() const;
+
+    HEXE_NODISCARD bool IsPacked() const;
+
+    HEXE_NODISCARD bool IsMap() const;
+    HEXE_NODISCARD IntHashMap& AsIntMap();
+    HEXE_NODISCARD const IntHashMap& AsIntMap() const;
+    HEXE_NODISCARD StringHashMap& AsStringMap();
+    HEXE_NODISCARD const StringHashMap& AsStringMap() const;
+
+    // elements of packed lists, T being the C++ type matching the list's
+    template <typename T>
+    HEXE_NODISCARD T Packed(const i64 index) const {
+        T out;
+        std::memcpy(&out, reinterpret_cast<const u8*>(data) + index * sizeof(T), sizeof(T));
+        return out;
+    }
+
+    template <typename T>
+    void SetPacked(const i64 index, const T value) {
+        std::memcpy(reinterpret_cast<u8*>(data) + index * sizeof(T), &value, sizeof(T));
+    }
+
+    // a list's elements as one contiguous array, for kernels working over all of them at once
+    template <typename T>
+    HEXE_NODISCARD T* Elements() {
+        return reinterpret_cast<T*>(data);
+    }
+
+    template <typename T>
+    HEXE_NODISCARD const T* Elements() const {
+        return reinterpret_cast<const T*>(data);
+    }
+
+    HEXE_NODISCARD bool Bit(const i64 index) const {
+        return reinterpret_cast<const u8*>(data)[index >> 3] >> (index & 7) & 1;
+    }
+
+    void SetBit(const i64 index, const bool value) {
+        auto& byte = reinterpret_cast<u8*>(data)[index >> 3];
+        byte       = static_cast<u8>((byte & ~(1 << (index & 7))) | (value << (index & 7)));
+    }
+
     void WriteBytesAt(u32 index, const std::array<u8, QWORD>& bytes) const;
 
     Value operator+(const Value& rhs) const;
@@ -167,7 +252,24 @@ private:
         return Data::Type::Bool;
     }
 
-    Data* data;
+    // vectors are the only values which don't live on the heap
+    // maps live there as well, but as a single object rather than a run of Data
+    union {
+        Data* data;
+        Lanes lanes;
+        IntHashMap* int_map;
+        StringHashMap* string_map;
+    };
+
+    // copies, moves and frees whichever map 'other' or this holds
+    void CopyMap(const Value& other);
+    void StealMap(Value& other);
+    void FreeMap();
+
+    // frees whatever this owns, leaving the fields for the caller to overwrite
+    void Release();
+
+    // Bits lists count bits here instead
     SizeType size_bytes = sizeof(Data);
     u8 type;
 
@@ -16,6 +16,8 @@ enum class ExitCode {
 
     OutputOpenError,
     OutputWriteError,
+
+    ServerError,
 };
 
 consteval int Exit(ExitCode exit_code) {
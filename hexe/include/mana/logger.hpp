@@ -6,6 +6,10 @@
 #include <spdlog/spdlog.h>
 
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace mana {
 enum class LogLevel : literals::u8 {
@@ -20,14 +24,33 @@ enum class LogLevel : literals::u8 {
 
 using SpdLogger = std::shared_ptr<spdlog::logger>;
 
+// a message held back by a capture, to be written later
+struct LogRecord {
+    std::string logger;
+    spdlog::level::level_enum level;
+    std::string text;
+};
+
+class CaptureSink;
+
 class LoggerSink {
-    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> LogSink;
+    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> Console;
+    std::shared_ptr<CaptureSink> LogSink;
+
+    std::mutex write_mutex;
 
 public:
     LoggerSink();
 
     auto CreateLogger(std::string_view name, LogLevel default_level = LogLevel::Debug) -> SpdLogger;
 
+    // until EndCapture, anything logged on the calling thread is held back instead of written
+    void BeginCapture();
+    auto EndCapture() -> std::vector<LogRecord>;
+
+    // writes captured records in one piece, so batches from different threads never interleave
+    void Write(std::span<const LogRecord> records);
+
     std::string DefaultPattern;
 };
 
@@ -3,6 +3,7 @@
 
 #include <crc/CRC.h>
 
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -121,6 +122,16 @@ void ByteCode::PatchCall(const i64 instruction_index, u32 new_address) {
     }
 }
 
+void ByteCode::PatchOpcode(const i64 instruction_index, const Op new_opcode) {
+    if (instruction_index < 0 || instruction_index >= instructions.size()) {
+        Log->critical("Internal Compiler Error");
+        Log->error("Attempted to patch opcode at nonexistent index {}", instruction_index);
+        return;
+    }
+
+    instructions[instruction_index] = static_cast<u8>(new_opcode);
+}
+
 i64 ByteCode::BackIndex() const {
     return static_cast<i64>(instructions.size()) - 1;
 }
@@ -141,15 +152,101 @@ const std::vector<Value>& ByteCode::Constants() const {
     return constant_pool;
 }
 
+void ByteCode::MarkSource(const i32 line, const i32 column) {
+    const auto offset = static_cast<u32>(instructions.size());
+
+    if (not line_table.empty()) {
+        auto& last = line_table.back();
+        if (last.line == line && last.column == column) {
+            return;
+        }
+
+        // nothing was emitted for the previous location
+        if (last.offset == offset) {
+            last.line   = line;
+            last.column = column;
+            return;
+        }
+    }
+
+    line_table.emplace_back(offset, line, column);
+}
+
+void ByteCode::SetSourceName(const std::string_view name) {
+    source_name = name;
+}
+
+bool ByteCode::HasLineTable() const {
+    return not line_table.empty();
+}
+
+std::string_view ByteCode::SourceName() const {
+    return source_name;
+}
+
+const std::vector<LineEntry>& ByteCode::LineTable() const {
+    return line_table;
+}
+
+const LineEntry* ByteCode::LocateSource(const i64 offset) const {
+    const auto it = std::ranges::upper_bound(line_table,
+                                             offset,
+                                             {},
+                                             [](const LineEntry& entry) {
+                                                 return static_cast<i64>(entry.offset);
+                                             }
+    );
+
+    if (it == line_table.begin()) {
+        return nullptr;
+    }
+
+    return &*std::prev(it);
+}
+
+void ByteCode::AddExport(const std::string_view name, const i64 address, const u16 register_count, const u8 param_count) {
+    export_table.emplace_back(std::string(name), address, register_count, param_count);
+}
+
+const std::vector<FunctionEntry>& ByteCode::Exports() const {
+    return export_table;
+}
+
+const FunctionEntry* ByteCode::FindExport(const std::string_view name) const {
+    const auto it = std::ranges::find(export_table, name, &FunctionEntry::name);
+    return it == export_table.end() ? nullptr : &*it;
+}
+
+u16 ByteCode::AddImport(const std::string_view name, const u8 param_count) {
+    // every call site of a native shares its import
+    const auto it = std::ranges::find(import_table, name, &NativeImport::name);
+    if (it != import_table.end()) {
+        return static_cast<u16>(it - import_table.begin());
+    }
+
+    import_table.emplace_back(std::string(name), param_count);
+    return static_cast<u16>(import_table.size() - 1);
+}
+
+const std::vector<NativeImport>& ByteCode::Imports() const {
+    return import_table;
+}
+
 std::vector<u8> ByteCode::Serialize() const {
     if (instructions.empty() && constant_pool.empty()) {
         Log->error("Attempted to serialize empty Bytecode instance.");
         return {};
     }
 
-    const auto code = SerializeCode();
+    auto code = SerializeCode();
+
+    const auto exports = SerializeExportTable();
+    code.insert(code.end(), exports.begin(), exports.end());
+
+    const auto imports = SerializeImportTable();
+    code.insert(code.end(), imports.begin(), imports.end());
 
-    std::vector<u8> hexecutable = SerializeHeader(code);
+    std::vector<u8> hexecutable = SerializeHeader(code, exports.size(), imports.size());
     hexecutable.reserve(code.size());
 
     hexecutable.insert(hexecutable.end(), code.begin(), code.end());
@@ -164,9 +261,201 @@ std::vector<u8> ByteCode::SerializeCode() const {
     std::vector<u8> code = constants_bytes;
     code.insert(code.end(), inst_bytes.begin(), inst_bytes.end());
 
+    if (HasLineTable()) {
+        const auto line_bytes = SerializeLineTable();
+        code.insert(code.end(), line_bytes.begin(), line_bytes.end());
+    }
+
     return code;
 }
 
+static void WriteVarint(std::vector<u8>& out, u64 value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<u8>(value));
+}
+
+static void WriteSignedVarint(std::vector<u8>& out, const i64 value) {
+    // zigzag, so small negative deltas stay small
+    WriteVarint(out, (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+}
+
+static bool ReadVarint(const u8*& cursor, const u8* end, u64& value) {
+    value = 0;
+    for (i64 shift = 0; cursor < end && shift < 64; shift += 7) {
+        const u8 byte = *cursor++;
+        value         |= static_cast<u64>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ReadSignedVarint(const u8*& cursor, const u8* end, i64& value) {
+    u64 raw;
+    if (not ReadVarint(cursor, end, raw)) {
+        return false;
+    }
+    value = static_cast<i64>(raw >> 1) ^ -static_cast<i64>(raw & 1);
+    return true;
+}
+
+std::vector<u8> ByteCode::SerializeLineTable() const {
+    std::vector<u8> out;
+    out.reserve(sizeof(u16) + source_name.size() + line_table.size() * 3);
+
+    const auto name_size = static_cast<u16>(std::min<usize>(source_name.size(), std::numeric_limits<u16>::max()));
+    out.push_back(name_size & 0xFF);
+    out.push_back((name_size >> BYTE_BITS) & 0xFF);
+    out.insert(out.end(), source_name.begin(), source_name.begin() + name_size);
+
+    LineEntry previous {0, 0, 0};
+    for (const auto& entry : line_table) {
+        WriteVarint(out, entry.offset - previous.offset);
+        WriteSignedVarint(out, static_cast<i64>(entry.line) - previous.line);
+        WriteSignedVarint(out, static_cast<i64>(entry.column) - previous.column);
+
+        previous = entry;
+    }
+
+    return out;
+}
+
+bool ByteCode::DeserializeLineTable(const u8* data, const usize size) {
+    line_table.clear();
+    source_name.clear();
+
+    if (size < sizeof(u16)) {
+        Log->error("Line table section is truncated.");
+        return false;
+    }
+
+    const u8* cursor    = data;
+    const u8* const end = data + size;
+
+    const u16 name_size = cursor[0] | cursor[1] << BYTE_BITS;
+    cursor              += sizeof(u16);
+
+    if (name_size > end - cursor) {
+        Log->error("Line table section is truncated.");
+        return false;
+    }
+    source_name.assign(reinterpret_cast<const char*>(cursor), name_size);
+    cursor += name_size;
+
+    LineEntry current {0, 0, 0};
+    while (cursor < end) {
+        u64 offset_delta;
+        i64 line_delta, column_delta;
+
+        if (not ReadVarint(cursor, end, offset_delta)
+            || not ReadSignedVarint(cursor, end, line_delta)
+            || not ReadSignedVarint(cursor, end, column_delta)) {
+            Log->error("Line table entry {} is malformed.", line_table.size());
+            line_table.clear();
+            return false;
+        }
+
+        current.offset += static_cast<u32>(offset_delta);
+        current.line   += static_cast<i32>(line_delta);
+        current.column += static_cast<i32>(column_delta);
+
+        line_table.push_back(current);
+    }
+
+    return true;
+}
+
+std::vector<u8> ByteCode::SerializeExportTable() const {
+    std::vector<u8> out;
+
+    for (const auto& entry : export_table) {
+        WriteVarint(out, entry.name.size());
+        out.insert(out.end(), entry.name.begin(), entry.name.end());
+
+        WriteVarint(out, entry.address);
+        WriteVarint(out, entry.register_count);
+        out.push_back(entry.param_count);
+    }
+
+    return out;
+}
+
+bool ByteCode::DeserializeExportTable(const u8* data, const usize size) {
+    export_table.clear();
+
+    const u8* cursor    = data;
+    const u8* const end = data + size;
+
+    while (cursor < end) {
+        u64 name_size, address, register_count;
+
+        if (not ReadVarint(cursor, end, name_size) || name_size > static_cast<u64>(end - cursor)) {
+            Log->error("Export table entry {} is malformed.", export_table.size());
+            export_table.clear();
+            return false;
+        }
+
+        std::string name(reinterpret_cast<const char*>(cursor), name_size);
+        cursor += name_size;
+
+        if (not ReadVarint(cursor, end, address)
+            || not ReadVarint(cursor, end, register_count)
+            || cursor == end) {
+            Log->error("Export table entry {} is malformed.", export_table.size());
+            export_table.clear();
+            return false;
+        }
+
+        const u8 param_count = *cursor++;
+        export_table.emplace_back(std::move(name), address, register_count, param_count);
+    }
+
+    return true;
+}
+
+std::vector<u8> ByteCode::SerializeImportTable() const {
+    std::vector<u8> out;
+
+    for (const auto& entry : import_table) {
+        WriteVarint(out, entry.name.size());
+        out.insert(out.end(), entry.name.begin(), entry.name.end());
+        out.push_back(entry.param_count);
+    }
+
+    return out;
+}
+
+bool ByteCode::DeserializeImportTable(const u8* data, const usize size) {
+    import_table.clear();
+
+    const u8* cursor    = data;
+    const u8* const end = data + size;
+
+    while (cursor < end) {
+        u64 name_size;
+
+        // the parameter count follows the name
+        if (not ReadVarint(cursor, end, name_size) || name_size >= static_cast<u64>(end - cursor)) {
+            Log->error("Import table entry {} is malformed.", import_table.size());
+            import_table.clear();
+            return false;
+        }
+
+        std::string name(reinterpret_cast<const char*>(cursor), name_size);
+        cursor += name_size;
+
+        const u8 param_count = *cursor++;
+        import_table.emplace_back(std::move(name), param_count);
+    }
+
+    return true;
+}
+
 std::vector<u8> ByteCode::SerializeConstants() const {
     std::vector<u8> out;
 
@@ -180,6 +469,13 @@ std::vector<u8> ByteCode::SerializeConstants() const {
             out.push_back((value.size_bytes >> i * BYTE_BITS) & 0xFF);
         }
 
+        // packed lists are written out as they're laid out, narrow elements and all
+        if (value.IsPacked()) {
+            const auto* packed = reinterpret_cast<const u8*>(value.data);
+            out.insert(out.end(), packed, packed + value.ByteLength());
+            continue;
+        }
+
         // need to serialize each value separately
         for (i64 i = 0; i < value.Length(); ++i) {
             const auto serializable = value.BitCasted(i);
@@ -193,8 +489,10 @@ std::vector<u8> ByteCode::SerializeConstants() const {
     return out;
 }
 
-std::vector<u8> ByteCode::SerializeHeader(const std::vector<u8>& code) const {
-    const Header header = CreateHeader(code);
+std::vector<u8> ByteCode::SerializeHeader(const std::vector<u8>& code,
+                                          const u32 export_table_size,
+                                          const u32 import_table_size) const {
+    const Header header = CreateHeader(code, export_table_size, import_table_size);
 
     std::vector<u8> header_bytes;
     header_bytes.reserve(sizeof(Header));
@@ -217,12 +515,18 @@ std::vector<u8> ByteCode::SerializeHeader(const std::vector<u8>& code) const {
     serialize(header.version_minor);
     serialize(header.version_patch);
     serialize(header.main_frame);
+    serialize(header.section_flags);
+    serialize(header.line_table_size);
+    serialize(header.export_table_size);
+    serialize(header.import_table_size);
     serialize(header.PADDING_COMPAT_);
 
     return header_bytes;
 }
 
-Header ByteCode::CreateHeader(const std::vector<u8>& code) const {
+Header ByteCode::CreateHeader(const std::vector<u8>& code,
+                              const u32 export_table_size,
+                              const u32 import_table_size) const {
     Header header {
         .magic         = Header::MAGIC,
         .entry_point   = static_cast<u64>(entry_point),
@@ -235,6 +539,22 @@ Header ByteCode::CreateHeader(const std::vector<u8>& code) const {
         .main_frame    = main_frame,
     };
 
+    // everything between the instructions and the export table belongs to the line table
+    header.section_flags     = 0;
+    header.export_table_size = export_table_size;
+    header.import_table_size = import_table_size;
+    header.line_table_size   = code.size() - header.constant_size - header.code_size
+                               - export_table_size - import_table_size;
+    if (header.line_table_size > 0) {
+        header.section_flags |= Header::SECTION_LINE_TABLE;
+    }
+    if (header.export_table_size > 0) {
+        header.section_flags |= Header::SECTION_EXPORT_TABLE;
+    }
+    if (header.import_table_size > 0) {
+        header.section_flags |= Header::SECTION_IMPORT_TABLE;
+    }
+
     // padding should be all 1's, safer than uninitialized
     std::memset(header.PADDING_COMPAT_, 0xFF, sizeof(header.PADDING_COMPAT_));
 
@@ -245,7 +565,7 @@ u32 ByteCode::ConstantPoolBytesCount() const {
     u32 out = 0;
 
     for (const auto& value : constant_pool) {
-        out += value.Length() * sizeof(Value::Data);
+        out += value.IsPacked() ? value.ByteLength() : value.Length() * sizeof(Value::Data);
         out += sizeof(value.type);
         out += sizeof(Value::SizeType);
     }
@@ -297,6 +617,10 @@ Header ByteCode::DeserializeHeader(const std::vector<u8>& header_bytes) const {
     deserialize_header(header.version_minor);
     deserialize_header(header.version_patch);
     deserialize_header(header.main_frame);
+    deserialize_header(header.section_flags);
+    deserialize_header(header.line_table_size);
+    deserialize_header(header.export_table_size);
+    deserialize_header(header.import_table_size);
 
     // padding can just be copied 1:1
     for (i64 p = 0, h = offset; h < sizeof(Header); ++h, ++p) {
@@ -332,6 +656,15 @@ bool ByteCode::Deserialize(const std::vector<u8>& bytes) {
 
     constant_pool.clear();
     instructions.clear();
+    line_table.clear();
+    source_name.clear();
+    export_table.clear();
+    import_table.clear();
+
+    if (bytes.size() < sizeof(Header)) {
+        Log->error("Sequence is too short to contain a Hexe header.");
+        return false;
+    }
 
     // validate header
     const auto header = DeserializeHeader({bytes.begin(), bytes.begin() + sizeof(Header)});
@@ -374,6 +707,15 @@ bool ByteCode::Deserialize(const std::vector<u8>& bytes) {
         offset += sizeof(Value::SizeType);
 
         auto value = Value {type, size};
+        if (value.IsPacked()) {
+            if (value.ByteLength() != 0) {
+                std::memcpy(value.data, bytes.data() + offset, value.ByteLength());
+            }
+            offset += value.ByteLength();
+            constant_pool.push_back(value);
+            continue;
+        }
+
         for (u32 i = 0; i < value.Length(); ++i) {
             for (i64 k = 0; k < value_bytes.size(); ++k) {
                 value_bytes[k] = bytes[k + offset];
@@ -384,7 +726,56 @@ bool ByteCode::Deserialize(const std::vector<u8>& bytes) {
         constant_pool.push_back(value);
     }
 
-    instructions.insert(instructions.begin(), bytes.begin() + pool_range.end, bytes.end());
+    const IndexRange code_range {
+        pool_range.end,
+        static_cast<i64>(header.code_size),
+    };
+
+    if (code_range.end > bytes.size()) {
+        Log->error("Instruction section exceeds the size of the executable.");
+        return false;
+    }
+
+    instructions.insert(instructions.begin(), bytes.begin() + code_range.start, bytes.begin() + code_range.end);
+
+    if (header.section_flags & Header::SECTION_LINE_TABLE) {
+        const IndexRange line_range {
+            code_range.end,
+            header.line_table_size,
+        };
+
+        if (line_range.end > bytes.size()
+            || not DeserializeLineTable(bytes.data() + line_range.start, header.line_table_size)) {
+            Log->error("Failed to read line table, source locations will be unavailable.");
+        }
+    }
+
+    if (header.section_flags & Header::SECTION_EXPORT_TABLE) {
+        // the line table's size is zero when it's absent
+        const IndexRange export_range {
+            code_range.end + header.line_table_size,
+            header.export_table_size,
+        };
+
+        if (export_range.end > bytes.size()
+            || not DeserializeExportTable(bytes.data() + export_range.start, header.export_table_size)) {
+            Log->error("Failed to read export table, functions can't be called by name.");
+        }
+    }
+
+    if (header.section_flags & Header::SECTION_IMPORT_TABLE) {
+        const IndexRange import_range {
+            code_range.end + header.line_table_size + header.export_table_size,
+            header.import_table_size,
+        };
+
+        // unlike the other sections, the program can't run without this one
+        if (import_range.end > bytes.size()
+            || not DeserializeImportTable(bytes.data() + import_range.start, header.import_table_size)) {
+            Log->error("Failed to read import table.");
+            return false;
+        }
+    }
 
     if (header.entry_point >= instructions.size()) {
         Log->error("Entry point index out of bounds.");
@@ -410,6 +801,13 @@ u16 ByteCode::AddConstant(const std::string_view string) {
     return constant_pool.size() - 1;
 }
 
+u16 ByteCode::AddArray(Value array) {
+    constant_pool.push_back(std::move(array));
+
+    CheckConstantPoolSize();
+    return constant_pool.size() - 1;
+}
+
 void ByteCode::CheckInstructionSize() const {
     /// TODO: ideally we handle this in such a way that we don't need to crash
     /// also i hate exceptions
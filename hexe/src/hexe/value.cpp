@@ -1,10 +1,13 @@
 #include <hexe/value.hpp>
 #include <hexe/logger.hpp>
+#include <hexe/map.hpp>
 
 #include <magic_enum/magic_enum.hpp>
 
+#include <array>
 #include <stdexcept>
 #include <cstring>
+#include <utility>
 
 namespace hexe {
 #ifdef __GNUC__
@@ -74,6 +77,21 @@ namespace hexe {
 
 using enum Value::Data::Type;
 
+constexpr Value::SizeType BITS_PER_BYTE = 8;
+constexpr Value::SizeType BITS_PER_DATA = BITS_PER_BYTE * sizeof(Value::Data);
+
+// vectors keep their lanes inline and maps own a single object, every other type owns a run of Data.
+// one lookup tells the two apart, so copying and freeing scalars stays a single branch
+constexpr auto OWNS_DATA_RUN = [] {
+    std::array<bool, 256> owns {};
+    owns.fill(true);
+
+    for (const auto vt : {Vec2, Vec3, Vec4, Vec2i, IntMap, StringMap}) {
+        owns[vt] = false;
+    }
+    return owns;
+}();
+
 Value::Value()
     : data {nullptr},
       size_bytes(0),
@@ -116,7 +134,7 @@ Value::Value(const std::string_view string)
 }
 
 Value::Value(const u8 vt, const SizeType length)
-    : Value(static_cast<Data::Type>(vt), length * sizeof(Data)) {}
+    : Value(static_cast<Data::Type>(vt), vt == Bits ? length : length * ElementSize(static_cast<Data::Type>(vt))) {}
 
 Value::Value(const Data::Type vt, const SizeType size)
     : size_bytes {size},
@@ -135,23 +153,60 @@ Value::Value(u8 vt, const Data& other)
     : data {new Data[1] {other}},
       type {vt} {}
 
+Value::Value(const Data::Type vt, const Lanes& vector)
+    : lanes {vector},
+      size_bytes {0},
+      type {vt} {}
+
+Value Value::NewMap(const Data::Type vt) {
+    Value map;
+    map.type = vt;
+
+    if (vt == IntMap) {
+        map.int_map = new IntHashMap {};
+    } else {
+        map.string_map = new StringHashMap {};
+    }
+    return map;
+}
 
 Value::Value(const Value& other)
     : data {nullptr},
       size_bytes {other.size_bytes},
       type {other.type} {
+    if (not OWNS_DATA_RUN[other.type]) [[unlikely]] {
+        if (other.IsVector()) {
+            lanes = other.lanes;
+        } else {
+            CopyMap(other);
+        }
+        return;
+    }
+
     if (other.data == nullptr || other.size_bytes == 0) {
         return;
     }
 
     data = new Data[other.Length()] {};
-    std::memcpy(data, other.data, other.size_bytes);
+    std::memcpy(data, other.data, other.ByteLength());
 }
 
 Value::Value(Value&& other) noexcept
     : data {nullptr},
       size_bytes {other.size_bytes},
       type {other.type} {
+    if (not OWNS_DATA_RUN[other.type]) [[unlikely]] {
+        if (other.IsVector()) {
+            lanes = other.lanes;
+
+            other.data = nullptr;
+            other.type = Invalid;
+        } else {
+            StealMap(other);
+        }
+        return;
+    }
+
     if (other.data == nullptr || other.size_bytes == 0) {
         other.size_bytes = 0;
         other.type       = Invalid;
@@ -167,9 +222,7 @@ Value::Value(Value&& other) noexcept
 }
 
 Value& Value::operator=(const Data& other) {
-    if (data != nullptr) {
-        delete[] data;
-    }
+    Release();
     data = new Data[1] {other};
     return *this;
 }
@@ -179,8 +232,18 @@ Value& Value::operator=(const Value& other) {
         return *this;
     }
 
-    if (data != nullptr) {
-        delete[] data;
+    Release();
+
+    if (not OWNS_DATA_RUN[other.type]) [[unlikely]] {
+        size_bytes = 0;
+        type       = other.type;
+
+        if (other.IsVector()) {
+            lanes = other.lanes;
+        } else {
+            CopyMap(other);
+        }
+        return *this;
     }
 
     if (other.data == nullptr || other.size_bytes == 0) {
@@ -194,7 +257,7 @@ Value& Value::operator=(const Value& other) {
     type       = other.type;
     data       = new Data[other.Length()];
 
-    std::memcpy(data, other.data, other.size_bytes);
+    std::memcpy(data, other.data, other.ByteLength());
     return *this;
 }
 
@@ -203,8 +266,21 @@ Value& Value::operator=(Value&& other) noexcept {
         return *this;
     }
 
-    if (data != nullptr) {
-        delete[] data;
+    Release();
+
+    if (not OWNS_DATA_RUN[other.type]) [[unlikely]] {
+        size_bytes = 0;
+        type       = other.type;
+
+        if (other.IsVector()) {
+            lanes = other.lanes;
+
+            other.data = nullptr;
+            other.type = Invalid;
+        } else {
+            StealMap(other);
+        }
+        return *this;
     }
 
     if (other.data == nullptr || other.size_bytes == 0) {
@@ -226,29 +302,64 @@ Value& Value::operator=(Value&& other) noexcept {
 }
 
 Value::~Value() {
-    if (data == nullptr) {
-        return;
-    }
-
 #ifdef MANA_DEBUG
-    if (size_bytes == 0) {
+    if (OWNS_DATA_RUN[type] && data != nullptr && size_bytes == 0) {
         Log->critical("Empty value was non-null in destructor");
         std::terminate();
     }
 #endif
 
-    delete[] data;
+    Release();
+}
+
+void Value::Release() {
+    if (OWNS_DATA_RUN[type]) [[likely]] {
+        delete[] data;
+    } else if (IsMap()) {
+        FreeMap();
+    }
 }
 
 Value::SizeType Value::Length() const {
     // divide and round up
+    if (type == Bits) {
+        return (size_bytes + BITS_PER_DATA - 1) / BITS_PER_DATA;
+    }
     return (size_bytes + sizeof(Data) - 1) / sizeof(Data);
 }
 
 Value::SizeType Value::ByteLength() const {
+    if (type == Bits) {
+        return (size_bytes + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+    }
     return size_bytes;
 }
 
+Value::SizeType Value::Count() const {
+    if (type == Bits) {
+        return size_bytes;
+    }
+    return size_bytes / ElementSize(static_cast<Data::Type>(type));
+}
+
+Value::SizeType Value::ElementSize(const Data::Type vt) {
+    switch (vt) {
+    case Int8:
+    case Uint8:
+    case Bits:
+        return BYTE;
+    case Int16:
+    case Uint16:
+        return WORD;
+    case Int32:
+    case Uint32:
+    case Float32:
+        return DWORD;
+    default:
+        return sizeof(Data);
+    }
+}
+
 u64 Value::BitCasted(const u32 at) const {
     if (at >= Length()) {
         Log->critical("Internal Compiler Error: Attempted to bitcast out of bounds");
@@ -388,6 +499,80 @@ std::string_view Value::AsString() const {
     return {reinterpret_cast<char*>(data), size_bytes};
 }
 
+bool Value::IsVector() const {
+    return type >= Vec2 && type <= Vec2i;
+}
+
+u8 Value::LaneCount() const {
+    switch (type) {
+    case Vec2:
+    case Vec2i:
+        return 2;
+    case Vec3:
+        return 3;
+    case Vec4:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+const Value::Lanes& Value::AsLanes() const {
+    return lanes;
+}
+
+bool Value::IsPacked() const {
+    return type >= Int8 && type <= Bits;
+}
+
+bool Value::IsMap() const {
+    return type == IntMap || type == StringMap;
+}
+
+IntHashMap& Value::AsIntMap() {
+    return *int_map;
+}
+
+const IntHashMap& Value::AsIntMap() const {
+    return *int_map;
+}
+
+StringHashMap& Value::AsStringMap() {
+    return *string_map;
+}
+
+const StringHashMap& Value::AsStringMap() const {
+    return *string_map;
+}
+
+void Value::CopyMap(const Value& other) {
+    if (other.type == IntMap) {
+        int_map = new IntHashMap {*other.int_map};
+    } else {
+        string_map = new StringHashMap {*other.string_map};
+    }
+}
+
+void Value::StealMap(Value& other) {
+    if (other.type == IntMap) {
+        int_map = std::exchange(other.int_map, nullptr);
+    } else {
+        string_map = std::exchange(other.string_map, nullptr);
+    }
+
+    other.size_bytes = 0;
+    other.type       = Invalid;
+}
+
+void Value::FreeMap() {
+    if (type == IntMap) {
+        delete int_map;
+    } else {
+        delete string_map;
+    }
+    data = nullptr;
+}
+
 Value Value::operator%(const Value& rhs) const {
     COMPUTED_GOTO();
 CASE_INT:
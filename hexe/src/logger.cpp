@@ -1,8 +1,53 @@
 #include <mana/logger.hpp>
 
+#include <spdlog/sinks/sink.h>
+
+#include <optional>
+
 namespace mana {
+namespace {
+// empty unless the thread is capturing
+thread_local std::optional<std::vector<LogRecord>> captured;
+} // namespace
+
+/// Sink shared by every logger.
+/// Forwards to the console, unless the logging thread is capturing its records.
+class CaptureSink final : public spdlog::sinks::sink {
+    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> console;
+
+public:
+    explicit CaptureSink(std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> console)
+        : console(std::move(console)) {}
+
+    void log(const spdlog::details::log_msg& msg) override {
+        if (not captured) {
+            console->log(msg);
+            return;
+        }
+
+        captured->push_back({
+            std::string(msg.logger_name.data(), msg.logger_name.size()),
+            msg.level,
+            std::string(msg.payload.data(), msg.payload.size()),
+        });
+    }
+
+    void flush() override {
+        console->flush();
+    }
+
+    void set_pattern(const std::string& pattern) override {
+        console->set_pattern(pattern);
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        console->set_formatter(std::move(sink_formatter));
+    }
+};
+
 LoggerSink::LoggerSink() {
-    LogSink        = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    Console        = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    LogSink        = std::make_shared<CaptureSink>(Console);
     DefaultPattern = "%^<%n>%$ %v";
 }
 
@@ -15,4 +60,30 @@ auto LoggerSink::CreateLogger(const std::string_view name, LogLevel default_leve
 
     return ret;
 }
+
+void LoggerSink::BeginCapture() {
+    if (not captured) {
+        captured.emplace();
+    }
+}
+
+auto LoggerSink::EndCapture() -> std::vector<LogRecord> {
+    if (not captured) {
+        return {};
+    }
+
+    auto records = std::move(*captured);
+    captured.reset();
+
+    return records;
+}
+
+void LoggerSink::Write(const std::span<const LogRecord> records) {
+    std::lock_guard lock(write_mutex);
+
+    for (const auto& record : records) {
+        Console->log(spdlog::details::log_msg(record.logger, record.level, record.text));
+    }
+    Console->flush();
+}
 } // namespace mana
@@ -1,3 +1,35 @@
 #pragma once
 
 #include <salem/core/logger.hpp>
+
+#include <mana/literals.hpp>
+
+#include <filesystem>
+
+namespace salem {
+struct ServerSettings {
+    friend ServerSettings ParseCommandLineServerSettings(int argc, char** argv);
+
+    SALEM_NODISCARD const std::filesystem::path& SocketPath() const;
+    SALEM_NODISCARD mana::literals::u32 JobCount() const;
+
+    // empty when caching is off
+    SALEM_NODISCARD const std::filesystem::path& CacheDirectory() const;
+    SALEM_NODISCARD mana::literals::u64 CacheSizeLimit() const;
+
+    SALEM_NODISCARD bool ShouldExit() const;
+    SALEM_NODISCARD int ErrorCode() const;
+
+private:
+    std::filesystem::path socket_path;
+    mana::literals::u32 job_count {0};
+
+    std::filesystem::path cache_directory;
+    mana::literals::u64 cache_size_mib {512};
+
+    bool should_exit {false};
+    int exit_code {mana::literals::SENTINEL};
+};
+
+ServerSettings ParseCommandLineServerSettings(int argc, char** argv);
+} // namespace salem
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <mana/logger.hpp>
+
+#ifndef SALEM_LOG_NAME
+#    define SALEM_LOG_NAME "Salem"
+#endif
+
+#ifndef SALEM_LOG_LEVEL
+#    if defined(SALEM_DEBUG)
+#        define SALEM_LOG_LEVEL mana::LogLevel::Debug
+#    elif defined(SALEM_RELEASE)
+#        define SALEM_LOG_LEVEL mana::LogLevel::Info
+#    else
+#        define SALEM_LOG_LEVEL mana::LogLevel::Off
+#    endif
+#endif
+
+namespace salem {
+extern mana::SpdLogger Log;
+}
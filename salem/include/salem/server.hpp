@@ -0,0 +1,47 @@
+#pragma once
+
+#include <salem/core/cli.hpp>
+
+#include <circe/core/cache.hpp>
+#include <circe/core/thread-pool.hpp>
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+namespace salem {
+using namespace mana::literals;
+
+/// Compiles batches of files for circe clients, which connect over a Unix domain socket.
+///
+/// Staying up keeps what every circe process would otherwise set up again: the loggers,
+/// each worker's interned names and analyzer tables, and the compilation cache.
+/// Jobs from every client share one pool of workers.
+class CompileServer {
+    std::filesystem::path socket_path;
+    int listener = -1;
+
+    circe::ThreadPool pool;
+    u32 worker_count;
+
+    std::optional<circe::CompileCache> cache;
+
+    std::mutex connection_mutex;
+    std::condition_variable connections_closed;
+    u32 open_connections = 0;
+
+public:
+    explicit CompileServer(const ServerSettings& settings);
+    ~CompileServer();
+
+    CompileServer(const CompileServer&)            = delete;
+    CompileServer& operator=(const CompileServer&) = delete;
+
+    // serves clients until interrupted
+    int Run();
+
+private:
+    void Serve(int connection);
+};
+} // namespace salem
@@ -0,0 +1,67 @@
+#include <salem/core/cli.hpp>
+
+#include <CLI11/CLI11.hpp>
+
+#include <thread>
+
+namespace salem {
+const std::filesystem::path& ServerSettings::SocketPath() const {
+    return socket_path;
+}
+
+mana::literals::u32 ServerSettings::JobCount() const {
+    return job_count;
+}
+
+const std::filesystem::path& ServerSettings::CacheDirectory() const {
+    return cache_directory;
+}
+
+mana::literals::u64 ServerSettings::CacheSizeLimit() const {
+    return cache_size_mib * 1024 * 1024;
+}
+
+bool ServerSettings::ShouldExit() const {
+    return should_exit;
+}
+
+int ServerSettings::ErrorCode() const {
+    return exit_code;
+}
+
+ServerSettings ParseCommandLineServerSettings(int argc, char** argv) {
+    auto cli = std::make_unique<CLI::App>("Salem, the Mana compile server");
+    ServerSettings ret;
+
+    cli->set_version_flag("-v,--version", "Sigil v" SIGIL_VER_STRING "\nSalem v" SALEM_VER_STRING);
+    cli->add_option("socket", ret.socket_path, "Unix domain socket to listen on, for circe --server.")->required();
+
+    cli->add_option("-j,--jobs",
+                    ret.job_count,
+                    "Number of files to compile in parallel. 0 uses every hardware thread."
+    )->capture_default_str();
+
+    cli->add_option("--cache-dir",
+                    ret.cache_directory,
+                    "Reuse executables compiled from identical sources, kept in this directory."
+    );
+    cli->add_option("--cache-size",
+                    ret.cache_size_mib,
+                    "Size in MiB the cache is trimmed to after each batch, least recently used first."
+    )->capture_default_str();
+
+    ret.exit_code = 0;
+    try {
+        cli->parse(argc, argv);
+    }
+    catch (const CLI::ParseError& e) {
+        ret.exit_code   = cli->exit(e);
+        ret.should_exit = true;
+    }
+
+    if (ret.job_count == 0) {
+        ret.job_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return ret;
+}
+} // namespace salem
@@ -0,0 +1,5 @@
+#include <salem/core/logger.hpp>
+
+namespace salem {
+mana::SpdLogger Log = mana::GlobalLoggerSink().CreateLogger(SALEM_LOG_NAME, SALEM_LOG_LEVEL);
+}
@@ -1,4 +1,15 @@
-#define SIGIL_LOGGER_NAME "Salem"
-// #include <hex/core/cli.hpp>
+#include <salem/core/cli.hpp>
+#include <salem/server.hpp>
 
-int main() {}
+using namespace salem;
+
+int main(int argc, char** argv) {
+    const auto settings = ParseCommandLineServerSettings(argc, argv);
+
+    if (settings.ErrorCode() != 0 || settings.ShouldExit()) {
+        return settings.ErrorCode();
+    }
+
+    CompileServer server(settings);
+    return server.Run();
+}
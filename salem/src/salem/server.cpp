@@ -0,0 +1,133 @@
+#include <salem/server.hpp>
+
+#include <circe/core/driver.hpp>
+#include <circe/core/protocol.hpp>
+
+#include <mana/exit-codes.hpp>
+
+#include <csignal>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace salem {
+namespace protocol = circe::protocol;
+
+namespace {
+volatile std::sig_atomic_t stop_requested = 0;
+
+// how often the accept loop checks whether it should stop
+constexpr i32 ACCEPT_TIMEOUT_MS = 200;
+
+extern "C" void RequestStop(int) {
+    stop_requested = 1;
+}
+} // namespace
+
+CompileServer::CompileServer(const ServerSettings& settings)
+    : socket_path(settings.SocketPath()),
+      pool(settings.JobCount()),
+      worker_count(settings.JobCount()) {
+    if (not settings.CacheDirectory().empty()) {
+        cache.emplace(settings.CacheDirectory(), circe::CompilerFingerprint(), settings.CacheSizeLimit());
+    }
+}
+
+CompileServer::~CompileServer() {
+    protocol::Close(listener);
+}
+
+int CompileServer::Run() {
+    using namespace mana;
+
+    listener = protocol::Listen(socket_path);
+    if (listener < 0) {
+        return Exit(ExitCode::ServerError);
+    }
+
+    std::signal(SIGINT, RequestStop);
+    std::signal(SIGTERM, RequestStop);
+
+    Log->info("Listening on '{}' with {} worker{}", socket_path.string(), worker_count, worker_count > 1 ? "s" : "");
+
+    while (stop_requested == 0) {
+        const int connection = protocol::Accept(listener, ACCEPT_TIMEOUT_MS);
+        if (connection < 0) {
+            continue;
+        }
+
+        {
+            std::lock_guard lock(connection_mutex);
+            ++open_connections;
+        }
+
+        std::thread([this, connection] {
+            Serve(connection);
+
+            {
+                std::lock_guard lock(connection_mutex);
+                --open_connections;
+            }
+            connections_closed.notify_all();
+        }).detach();
+    }
+
+    Log->info("Shutting down");
+
+    // clients that are already connected still get their results
+    std::unique_lock lock(connection_mutex);
+    connections_closed.wait(lock, [this] { return open_connections == 0; });
+
+    protocol::Close(listener);
+    listener = -1;
+
+    std::error_code ec;
+    std::filesystem::remove(socket_path, ec);
+
+    if (cache) {
+        cache->LogStatistics();
+    }
+    return Exit(ExitCode::Success);
+}
+
+void CompileServer::Serve(const int connection) {
+    const auto requests = protocol::ReceiveJobs(connection);
+    if (not requests) {
+        protocol::Close(connection);
+        return;
+    }
+
+    circe::CompileCache* const shared_cache = cache ? &*cache : nullptr;
+
+    std::vector<std::future<circe::CompileResult>> results;
+    results.reserve(requests->size());
+
+    for (const auto& request : *requests) {
+        results.push_back(pool.Submit([request, shared_cache] {
+            const auto settings = circe::CompileSettings::FromFlags(request.flags, request.natives);
+            return circe::CompileCaptured(settings, request.job, shared_cache);
+        }));
+    }
+
+    // results go out in the order the jobs came in, as the client expects
+    // a client that hung up still has its jobs finished, which is harmless
+    bool connected = true;
+    u64 failed     = 0;
+    for (auto& pending : results) {
+        const auto result = pending.get();
+        if (result.exit_code != mana::Exit(mana::ExitCode::Success)) {
+            ++failed;
+        }
+
+        connected = connected && protocol::SendResult(connection, result);
+    }
+
+    protocol::Close(connection);
+
+    if (cache) {
+        cache->Evict();
+    }
+
+    Log->debug("Served {} job{}, {} failed", results.size(), results.size() == 1 ? "" : "s", failed);
+}
+} // namespace salem
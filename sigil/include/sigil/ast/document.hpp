@@ -0,0 +1,88 @@
+#pragma once
+
+#include <sigil/ast/flat-tree.hpp>
+#include <sigil/ast/lexer.hpp>
+#include <sigil/ast/syntax-tree.hpp>
+#include <sigil/ast/token.hpp>
+
+#include <mana/literals.hpp>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sigil {
+namespace ml = mana::literals;
+
+// lines and columns count from 1, like they do for tokens
+struct TextPosition {
+    ml::i32 line;
+    ml::i32 column;
+};
+
+/// A source file that stays parsed across edits, for tools like language servers.
+///
+/// Tokens are kept per line and the AST per top-level declaration. An edit relexes only the lines it touches,
+/// then reparses only the declarations that span them, while every other declaration keeps its AST.
+/// Like the lexer and parser, it goes through the calling thread's source file and interner.
+class Document {
+    struct Line {
+        std::string text;
+
+        // offsets count from the start of the line, and lines are only filled in when parsing
+        std::vector<Token> tokens;
+
+        // brackets opened minus brackets closed
+        ml::i32 depth_change;
+        bool opens_declaration;
+    };
+
+    struct Declaration {
+        ml::i32 first_line;
+        ml::i32 line_count;
+
+        // lines may have been added or removed above the declaration since it was parsed
+        ml::i32 parsed_line;
+        ml::i32 issues;
+
+        std::vector<ast::NodePtr> nodes;
+    };
+
+    std::string name;
+    std::vector<Line> lines;
+    std::vector<Declaration> declarations;
+
+    Lexer lexer;
+    ml::i64 reparsed;
+
+public:
+    explicit Document(std::string_view name);
+
+    void Open(std::string_view text);
+
+    // replaces everything from 'start' up to 'end' (exclusive), the way language server edits do
+    void Edit(TextPosition start, TextPosition end, std::string_view replacement);
+
+    SIGIL_NODISCARD std::string Text() const;
+    SIGIL_NODISCARD ml::i32 LineCount() const;
+
+    // offsets are relative to the start of the line
+    SIGIL_NODISCARD std::span<const Token> LineTokens(ml::i32 line) const;
+
+    SIGIL_NODISCARD ml::i32 IssueCount() const;
+
+    // how many declarations the last edit had to parse again
+    SIGIL_NODISCARD ml::i64 ReparsedCount() const;
+
+    // lowers every declaration in order, with statements at the lines they're at now
+    void Lower(ast::FlatTree& tree) const;
+
+private:
+    SIGIL_NODISCARD std::vector<Line> Tokenize(const std::string& text);
+
+    // rebuilds the declaration list, parsing any declaration that isn't entirely outside the edited lines
+    void Reconcile(ml::i32 edit_begin, ml::i32 edit_end, ml::i32 line_delta);
+    void Parse(Declaration& declaration);
+};
+} // namespace sigil
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <sigil/ast/syntax-tree.hpp>
+#include <sigil/ast/visitor.hpp>
+
+#include <mana/literals.hpp>
+
+#include <hexe/value.hpp>
+
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sigil::ast {
+namespace ml = mana::literals;
+
+using NodeId = ml::u32;
+
+constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+
+// children are listed in the order they're stored in, optional ones in brackets
+enum class NodeKind : ml::u8 {
+    Scope,                  // statements...
+    FunctionDeclaration,    // body                         payload: Functions()
+    DataDeclaration,        // [initializer]                names: binding, annotation
+    MutableDataDeclaration, // [initializer]                names: binding, annotation
+
+    Identifier,             //                              names: identifier
+    Assignment,             // value                        names: identifier, Operator(), OperandType()
+    ElementAssignment,      // index, value                 names: identifier, Operator(), OperandType()
+
+    Return,                 // [expr]
+    Yield,
+    Invocation,             // args...                      names: identifier
+
+    If,                     // condition, then, [else]
+
+    Loop,                   // body
+    LoopIf,                 // condition, body
+    LoopIfPost,             // body, condition
+    LoopFixed,              // count, body
+    LoopRange,              // [origin], destination, body  names: counter
+    LoopRangeMutable,       // [origin], destination, body  names: counter
+    LoopRangeParallel,      // [origin], destination, body  names: counter
+
+    Break,                  // [condition]                  names: label
+    Skip,                   // [condition]                  names: label
+
+    Unary,                  // value                        payload: Operator(), OperandType()
+    Binary,                 // left, right                  payload: Operator(), OperandType()
+
+    List,                   // values...                    payload: element type
+    Map,                    //                              payload: IntMap or StringMap, '[:]'
+    ListAccess,             // item, index                  payload: OperandType()
+
+    LiteralBool,            //                              payload: value
+    LiteralInt,             //                              payload: Int()
+    LiteralFloat,           //                              payload: Float()
+    LiteralString,          //                              payload: String()
+};
+
+struct FunctionInfo {
+    NameID name;
+    NameID return_type;
+    ml::u32 first_param;
+    ml::u32 param_count;
+};
+
+/// Struct-of-arrays AST.
+///
+/// A node is an index into parallel pools: its kind, a range of the shared child list,
+/// a payload, and the source location of statements.
+/// Names, literals and function signatures live in side tables the payload indexes into.
+/// Passes walk it by switching on the kind, rather than through virtual dispatch.
+class FlatTree {
+    std::vector<NodeKind> kinds;
+    std::vector<ml::u32> child_starts;
+    std::vector<ml::u32> child_counts;
+    std::vector<ml::u32> payloads;
+    std::vector<SourceLocation> locations;
+
+    std::vector<NodeId> children;
+    std::vector<NodeId> declarations;
+
+    std::vector<NameID> names;
+    std::vector<FunctionInfo> functions;
+    std::vector<Parameter> parameters;
+    std::vector<ml::i64> ints;
+    std::vector<ml::f64> floats;
+    std::vector<std::string> strings;
+
+    // where a node's operator is kept, operand types go in the two bytes above it
+    ml::u32& OperatorSlot(NodeId node);
+    SIGIL_NODISCARD ml::u32 OperatorSlot(NodeId node) const;
+
+public:
+    void Reserve(ml::i64 node_count);
+    void Clear();
+
+    NodeId AddNode(NodeKind kind, std::span<const NodeId> node_children, ml::u32 payload = 0);
+    void AddDeclaration(NodeId node);
+
+    // consecutive names share a payload, so they can be looked up with Name(node, i)
+    ml::u32 AddNames(std::initializer_list<NameID> new_names);
+    ml::u32 AddFunction(NameID name, NameID return_type, std::span<const Parameter> params);
+    ml::u32 AddInt(ml::i64 value);
+    ml::u32 AddFloat(ml::f64 value);
+    ml::u32 AddString(std::string_view value);
+
+    void SetLocation(NodeId node, SourceLocation location);
+    void SetListType(NodeId node, hexe::Value::Data::Type type);
+
+    // operators on vectors compile to opcodes of their own, so the analyzer records the vectors involved
+    void SetOperandTypes(NodeId node, hexe::Value::Data::Type lhs, hexe::Value::Data::Type rhs = hexe::Value::Data::Type::Invalid);
+
+    // moves the statements of every node from 'first' onwards, for subtrees whose source has since moved
+    void ShiftLines(NodeId first, ml::i32 lines);
+
+    SIGIL_NODISCARD NodeKind Kind(NodeId node) const;
+    SIGIL_NODISCARD std::span<const NodeId> Children(NodeId node) const;
+    SIGIL_NODISCARD NodeId Child(NodeId node, ml::u32 index) const;
+    SIGIL_NODISCARD ml::u32 ChildCount(NodeId node) const;
+    SIGIL_NODISCARD SourceLocation Location(NodeId node) const;
+
+    SIGIL_NODISCARD NameID Name(NodeId node, ml::u32 index = 0) const;
+    SIGIL_NODISCARD TokenType Operator(NodeId node) const;
+    SIGIL_NODISCARD const FunctionInfo& Function(NodeId node) const;
+    SIGIL_NODISCARD std::span<const Parameter> Parameters(NodeId node) const;
+    SIGIL_NODISCARD bool Bool(NodeId node) const;
+    SIGIL_NODISCARD ml::i64 Int(NodeId node) const;
+    SIGIL_NODISCARD ml::f64 Float(NodeId node) const;
+    SIGIL_NODISCARD std::string_view String(NodeId node) const;
+    SIGIL_NODISCARD hexe::Value::Data::Type ListType(NodeId node) const;
+
+    // Int64 for operands the analyzer didn't record, which is never a vector
+    SIGIL_NODISCARD hexe::Value::Data::Type OperandType(NodeId node, ml::u32 index) const;
+
+    SIGIL_NODISCARD std::span<const NodeId> Declarations() const;
+    SIGIL_NODISCARD ml::i64 NodeCount() const;
+};
+
+/// Lowers declarations into a FlatTree.
+///
+/// The parser lowers each declaration straight from its p-tree, without building any nodes.
+/// Nodes of the pointer-based AST can be lowered as well, which is how a Document's cached declarations are.
+class FlatTreeBuilder final : public Visitor {
+    FlatTree& tree;
+    NodeId result;
+
+    // children of the nodes being lowered, so they don't each need their own vector
+    std::vector<NodeId> scratch;
+    std::vector<Parameter> parameters;
+
+public:
+    explicit FlatTreeBuilder(FlatTree& tree);
+
+    NodeId Lower(const Node& node);
+
+    // NO_NODE if the p-tree isn't a declaration
+    NodeId LowerDeclaration(const ParseNode& node);
+
+    void Visit(const Artifact& artifact) override;
+    void Visit(const Scope& node) override;
+
+    void Visit(const FunctionDeclaration& node) override;
+    void Visit(const MutableDataDeclaration& node) override;
+    void Visit(const DataDeclaration& node) override;
+
+    void Visit(const Identifier& node) override;
+    void Visit(const Assignment& node) override;
+    void Visit(const ElementAssignment& node) override;
+
+    void Visit(const Return& node) override;
+    void Visit(const Yield& node) override;
+    void Visit(const Invocation& node) override;
+
+    void Visit(const If& node) override;
+
+    void Visit(const Loop& node) override;
+    void Visit(const LoopIf& node) override;
+    void Visit(const LoopIfPost& node) override;
+    void Visit(const LoopFixed& node) override;
+    void Visit(const LoopRange& node) override;
+    void Visit(const LoopRangeMutable& node) override;
+    void Visit(const LoopRangeParallel& node) override;
+
+    void Visit(const Break& node) override;
+    void Visit(const Skip& node) override;
+
+    void Visit(const UnaryExpr& node) override;
+    void Visit(const BinaryExpr& node) override;
+
+    void Visit(const ListExpression& list) override;
+    void Visit(const ListAccess& access) override;
+
+    void Visit(const Literal<bool>& literal) override;
+    void Visit(const Literal<ml::i64>& literal) override;
+    void Visit(const Literal<ml::f64>& literal) override;
+
+    void Visit(const StringLiteral& string) override;
+
+private:
+    // null nodes are optional children that weren't there
+    void LowerOptional(const NodePtr& node);
+    void AddNodeFromScratch(NodeKind kind, std::size_t base, ml::u32 payload = 0);
+
+    void LowerInitializer(NodeKind kind, const Initializer& node);
+    void LowerRange(NodeKind kind, const LoopRange& node);
+    void LowerLoopControl(NodeKind kind, const LoopControl& node);
+
+    // these mirror what the node classes build out of the p-tree
+    // and return NO_NODE wherever the node classes would have been null
+    NodeId LowerScope(const ParseNode& node);
+    NodeId LowerStatement(const ParseNode& stmt);
+    NodeId LowerExpression(const ParseNode& node);
+    NodeId LowerFunction(const ParseNode& node);
+    NodeId LowerInitializer(NodeKind kind, const ParseNode& node);
+    NodeId LowerIf(const ParseNode& node);
+    NodeId LowerRange(NodeKind kind, const ParseNode& node);
+    NodeId LowerLoopControl(NodeKind kind, const ParseNode& node);
+    NodeId LowerBinary(const ParseNode& node);
+    NodeId LowerList(const ParseNode& node);
+    NodeId LowerListValue(const ParseNode& elem);
+    NodeId LowerLiteral(const Token& token);
+
+    void PushOptional(NodeId node);
+};
+} // namespace sigil::ast
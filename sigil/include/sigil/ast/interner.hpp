@@ -0,0 +1,141 @@
+#pragma once
+
+#include <mana/literals.hpp>
+
+#include <emhash/emhash8.hpp>
+
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sigil {
+namespace ml = mana::literals;
+
+using NameID = ml::u32;
+
+constexpr NameID NO_NAME = std::numeric_limits<NameID>::max();
+
+/// Hands out dense IDs for identifier and type names.
+///
+/// The lexer interns identifiers as it meets them, so every later phase compares and
+/// looks names up by ID. The primitive type names are interned first, in PrimitiveType order,
+/// followed by the entry point, which is what makes PrimitiveID and ENTRY_POINT_ID fixed.
+/// Names are copied, so IDs outlive the source they were lexed from.
+class Interner {
+    emhash8::HashMap<std::string_view, NameID> ids;
+    std::vector<std::string_view> names;
+
+    // deque elements never move, so the views above stay valid
+    std::deque<std::string> storage;
+
+public:
+    Interner();
+
+    NameID Intern(std::string_view name);
+
+    // forgets every name past the first 'count', which never go below the primitives and the entry point
+    void Truncate(ml::u32 count);
+
+    // NO_NAME if the name was never interned
+    SIGIL_NODISCARD NameID Find(std::string_view name) const;
+
+    // empty for NO_NAME
+    SIGIL_NODISCARD std::string_view Name(NameID id) const;
+    SIGIL_NODISCARD ml::u32 Count() const;
+};
+
+// each thread compiles with its own set of names, like Lexer::Source
+// threads which compile many files should Truncate it between them, or it keeps every name it has seen
+SIGIL_NODISCARD Interner& Names();
+
+/// Table keyed by NameID.
+///
+/// A lookup indexes a slot array by ID instead of hashing. Entries are kept in insertion order,
+/// and erasing one moves the last entry into its place, as emhash8 does.
+template <typename T>
+class NameMap {
+    static constexpr ml::u32 NO_SLOT = std::numeric_limits<ml::u32>::max();
+
+    std::vector<ml::u32> slots;
+    std::vector<std::pair<NameID, T>> entries;
+
+public:
+    using iterator       = typename std::vector<std::pair<NameID, T>>::iterator;
+    using const_iterator = typename std::vector<std::pair<NameID, T>>::const_iterator;
+
+    SIGIL_NODISCARD bool contains(const NameID id) const {
+        return id < slots.size() && slots[id] != NO_SLOT;
+    }
+
+    T& operator[](const NameID id) {
+        if (id >= slots.size()) {
+            slots.resize(id + 1, NO_SLOT);
+        }
+
+        if (slots[id] == NO_SLOT) {
+            slots[id] = static_cast<ml::u32>(entries.size());
+            entries.emplace_back(id, T {});
+        }
+
+        return entries[slots[id]].second;
+    }
+
+    SIGIL_NODISCARD T& at(const NameID id) {
+        return entries[slots.at(id)].second;
+    }
+
+    SIGIL_NODISCARD const T& at(const NameID id) const {
+        return entries[slots.at(id)].second;
+    }
+
+    SIGIL_NODISCARD iterator find(const NameID id) {
+        return contains(id) ? entries.begin() + slots[id] : entries.end();
+    }
+
+    SIGIL_NODISCARD const_iterator find(const NameID id) const {
+        return contains(id) ? entries.begin() + slots[id] : entries.end();
+    }
+
+    void erase(const NameID id) {
+        if (not contains(id)) {
+            return;
+        }
+
+        const auto slot = slots[id];
+        if (slot != entries.size() - 1) {
+            entries[slot]               = std::move(entries.back());
+            slots[entries[slot].first] = slot;
+        }
+
+        entries.pop_back();
+        slots[id] = NO_SLOT;
+    }
+
+    SIGIL_NODISCARD ml::usize size() const {
+        return entries.size();
+    }
+
+    SIGIL_NODISCARD bool empty() const {
+        return entries.empty();
+    }
+
+    iterator begin() {
+        return entries.begin();
+    }
+
+    iterator end() {
+        return entries.end();
+    }
+
+    const_iterator begin() const {
+        return entries.begin();
+    }
+
+    const_iterator end() const {
+        return entries.end();
+    }
+};
+} // namespace sigil
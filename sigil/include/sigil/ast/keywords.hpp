@@ -4,7 +4,7 @@
 #include <string_view>
 #include <sigil/ast/token.hpp>
 
-#include <unordered_map>
+#include <algorithm>
 #include <array>
 
 namespace sigil {
@@ -23,11 +23,12 @@ enum class PrimitiveType : u8 {
     F32, F64,
     Char, String,
     Byte, Bool,
+    Vec2, Vec3, Vec4, Vec2i,
     Fn,
     None,
 };
 
-inline constexpr u8 NUM_PRIMITIVES = 18;
+inline constexpr u8 NUM_PRIMITIVES = 22;
 
 inline constexpr std::array<std::string_view, NUM_PRIMITIVES> PRIMITIVES = {
     "i8",
@@ -48,6 +49,10 @@ inline constexpr std::array<std::string_view, NUM_PRIMITIVES> PRIMITIVES = {
     "string",
     "byte",
     "bool",
+    "vec2",
+    "vec3",
+    "vec4",
+    "vec2i",
     "fn",
 
     "none"
@@ -65,67 +70,165 @@ constexpr std::string PrimitiveNameString(const PrimitiveType type) {
     return std::string(PrimitiveName(type));
 }
 
-using KeywordMap = std::unordered_map<std::string_view, TokenType>;
+// the interner hands these out before anything else
+constexpr NameID PrimitiveID(const PrimitiveType type) {
+    return PrimitiveIndex(type);
+}
+
+inline constexpr NameID ENTRY_POINT_ID = NUM_PRIMITIVES;
+
+inline bool IsEntryPoint(const NameID name) {
+    return name == ENTRY_POINT_ID;
+}
+
+struct Keyword {
+    std::string_view text;
+    TokenType type;
+};
+
 // @formatter:off
-inline const KeywordMap KEYWORDS = {
-    {PrimitiveName(PrimitiveType::I8),        TokenType::KW_i8         },
-    {PrimitiveName(PrimitiveType::I16),       TokenType::KW_i16        },
-    {PrimitiveName(PrimitiveType::I32),       TokenType::KW_i32        },
-    {PrimitiveName(PrimitiveType::I64),       TokenType::KW_i64        },
-    {PrimitiveName(PrimitiveType::Isize),     TokenType::KW_isize      },
-
-    {PrimitiveName(PrimitiveType::U8),        TokenType::KW_u8         },
-    {PrimitiveName(PrimitiveType::U16),       TokenType::KW_u16        },
-    {PrimitiveName(PrimitiveType::U32),       TokenType::KW_u32        },
-    {PrimitiveName(PrimitiveType::U64),       TokenType::KW_u64        },
-    {PrimitiveName(PrimitiveType::Usize),     TokenType::KW_usize      },
-
-    {PrimitiveName(PrimitiveType::F32),       TokenType::KW_f32        },
-    {PrimitiveName(PrimitiveType::F64),       TokenType::KW_f64        },
-
-    {PrimitiveName(PrimitiveType::Char),      TokenType::KW_char       },
-    {PrimitiveName(PrimitiveType::String),    TokenType::KW_string     },
-
-    {PrimitiveName(PrimitiveType::Byte),      TokenType::KW_byte       },
-    {PrimitiveName(PrimitiveType::Bool),      TokenType::KW_bool       },
-    {PrimitiveName(PrimitiveType::Fn),        TokenType::KW_fn         },
-
-    {PrimitiveName(PrimitiveType::None),      TokenType::Lit_none      },
-
-    {"data",      TokenType::KW_data       },
-    {"mut",       TokenType::KW_mut        },
-    {"const",     TokenType::KW_const      },
-
-    {"type",      TokenType::KW_type       },
-    {"Tag",       TokenType::KW_Tag        },
-    {"enum",      TokenType::KW_enum       },
-    {"variant",   TokenType::KW_variant    },
-    {"interface", TokenType::KW_interface  },
-
-    {"module",    TokenType::KW_module     },
-    {"public",    TokenType::KW_public     },
-    {"private",   TokenType::KW_private    },
-    {"import",    TokenType::KW_import     },
-    {"as",        TokenType::KW_as         },
-
-    {"return",    TokenType::KW_return     },
-    {"true",      TokenType::Lit_true      },
-    {"false",     TokenType::Lit_false     },
-    {"if",        TokenType::KW_if         },
-    {"else",      TokenType::KW_else       },
-    {"match",     TokenType::KW_match      },
-
-    {"loop",      TokenType::KW_loop       },
-    {"for",       TokenType::KW_for        },
-    {"in",        TokenType::KW_in         },
-    {"break",     TokenType::KW_break      },
-    {"skip",      TokenType::KW_skip       },
-
-    {"when",      TokenType::KW_when       },
-
-    {"and",       TokenType::Op_LogicalAnd },
-    {"or",        TokenType::Op_LogicalOr  },
-    {"not",       TokenType::Op_LogicalNot },
+inline constexpr std::array KEYWORDS = {
+    Keyword {PrimitiveName(PrimitiveType::I8),        TokenType::KW_i8         },
+    Keyword {PrimitiveName(PrimitiveType::I16),       TokenType::KW_i16        },
+    Keyword {PrimitiveName(PrimitiveType::I32),       TokenType::KW_i32        },
+    Keyword {PrimitiveName(PrimitiveType::I64),       TokenType::KW_i64        },
+    Keyword {PrimitiveName(PrimitiveType::Isize),     TokenType::KW_isize      },
+
+    Keyword {PrimitiveName(PrimitiveType::U8),        TokenType::KW_u8         },
+    Keyword {PrimitiveName(PrimitiveType::U16),       TokenType::KW_u16        },
+    Keyword {PrimitiveName(PrimitiveType::U32),       TokenType::KW_u32        },
+    Keyword {PrimitiveName(PrimitiveType::U64),       TokenType::KW_u64        },
+    Keyword {PrimitiveName(PrimitiveType::Usize),     TokenType::KW_usize      },
+
+    Keyword {PrimitiveName(PrimitiveType::F32),       TokenType::KW_f32        },
+    Keyword {PrimitiveName(PrimitiveType::F64),       TokenType::KW_f64        },
+
+    Keyword {PrimitiveName(PrimitiveType::Char),      TokenType::KW_char       },
+    Keyword {PrimitiveName(PrimitiveType::String),    TokenType::KW_string     },
+
+    Keyword {PrimitiveName(PrimitiveType::Byte),      TokenType::KW_byte       },
+    Keyword {PrimitiveName(PrimitiveType::Bool),      TokenType::KW_bool       },
+
+    Keyword {PrimitiveName(PrimitiveType::Vec2),      TokenType::KW_vec2       },
+    Keyword {PrimitiveName(PrimitiveType::Vec3),      TokenType::KW_vec3       },
+    Keyword {PrimitiveName(PrimitiveType::Vec4),      TokenType::KW_vec4       },
+    Keyword {PrimitiveName(PrimitiveType::Vec2i),     TokenType::KW_vec2i      },
+
+    Keyword {PrimitiveName(PrimitiveType::Fn),        TokenType::KW_fn         },
+
+    Keyword {PrimitiveName(PrimitiveType::None),      TokenType::Lit_none      },
+
+    Keyword {"data",      TokenType::KW_data       },
+    Keyword {"mut",       TokenType::KW_mut        },
+    Keyword {"const",     TokenType::KW_const      },
+
+    Keyword {"type",      TokenType::KW_type       },
+    Keyword {"Tag",       TokenType::KW_Tag        },
+    Keyword {"enum",      TokenType::KW_enum       },
+    Keyword {"variant",   TokenType::KW_variant    },
+    Keyword {"interface", TokenType::KW_interface  },
+
+    Keyword {"module",    TokenType::KW_module     },
+    Keyword {"public",    TokenType::KW_public     },
+    Keyword {"private",   TokenType::KW_private    },
+    Keyword {"import",    TokenType::KW_import     },
+    Keyword {"as",        TokenType::KW_as         },
+
+    Keyword {"return",    TokenType::KW_return     },
+    Keyword {"yield",     TokenType::KW_yield      },
+    Keyword {"true",      TokenType::Lit_true      },
+    Keyword {"false",     TokenType::Lit_false     },
+    Keyword {"if",        TokenType::KW_if         },
+    Keyword {"else",      TokenType::KW_else       },
+    Keyword {"match",     TokenType::KW_match      },
+
+    Keyword {"loop",      TokenType::KW_loop       },
+    Keyword {"for",       TokenType::KW_for        },
+    Keyword {"in",        TokenType::KW_in         },
+    Keyword {"break",     TokenType::KW_break      },
+    Keyword {"skip",      TokenType::KW_skip       },
+
+    Keyword {"when",      TokenType::KW_when       },
+
+    Keyword {"and",       TokenType::Op_LogicalAnd },
+    Keyword {"or",        TokenType::Op_LogicalOr  },
+    Keyword {"not",       TokenType::Op_LogicalNot },
 };
 // @formatter:on
+
+static_assert([] {
+    for (u8 i = 0; i < NUM_PRIMITIVES; ++i) {
+        if (KEYWORDS[i].text != PRIMITIVES[i]) {
+            return false;
+        }
+    }
+    return true;
+}(), "The primitives must lead KEYWORDS in PrimitiveType order, the lexer names them by index");
+
+/**
+ * @brief Perfect hash over KEYWORDS, built at compile time.
+ *
+ * A keyword is identified by its length and its first, second and last characters.
+ * The multiplier is searched for during compilation, so adding a keyword never needs a hand-tuned table,
+ * and a keyword set that can't be hashed without collisions fails to compile.
+ */
+class KeywordTable {
+public:
+    static constexpr ml::usize SIZE = 256;
+
+    static constexpr ml::usize MIN_LENGTH = std::ranges::min(KEYWORDS, {}, [](const Keyword& k) { return k.text.size(); }).text.size();
+    static constexpr ml::usize MAX_LENGTH = std::ranges::max(KEYWORDS, {}, [](const Keyword& k) { return k.text.size(); }).text.size();
+
+private:
+    // index into KEYWORDS plus one, zero marks an empty slot
+    std::array<u8, SIZE> slots {};
+    ml::u32 multiplier = 0;
+
+    static constexpr ml::u32 Hash(const std::string_view text, const ml::u32 multiplier) {
+        const ml::u32 key = static_cast<u8>(text[0])
+                            | static_cast<u8>(text[1]) << 8
+                            | static_cast<u8>(text.back()) << 16
+                            | static_cast<ml::u32>(text.size()) << 24;
+
+        return (key * multiplier) >> 24;
+    }
+
+public:
+    consteval KeywordTable() {
+        static_assert(KEYWORDS.size() < 256, "KeywordTable slots only fit 8-bit indices");
+        static_assert(MIN_LENGTH >= 2, "KeywordTable hashes the second character of a keyword");
+
+        for (multiplier = 0x9E3779B1; ; multiplier += 2) {
+            slots.fill(0);
+
+            bool collided = false;
+            for (ml::usize i = 0; i < KEYWORDS.size() && not collided; ++i) {
+                auto& slot = slots[Hash(KEYWORDS[i].text, multiplier)];
+
+                collided = slot != 0;
+                slot     = static_cast<u8>(i + 1);
+            }
+
+            if (not collided) {
+                return;
+            }
+        }
+    }
+
+    // The keyword an identifier spells, if any
+    constexpr const Keyword* Find(const std::string_view identifier) const {
+        if (identifier.size() < MIN_LENGTH || identifier.size() > MAX_LENGTH) {
+            return nullptr;
+        }
+
+        const auto slot = slots[Hash(identifier, multiplier)];
+        if (slot == 0 || KEYWORDS[slot - 1].text != identifier) {
+            return nullptr;
+        }
+
+        return &KEYWORDS[slot - 1];
+    }
+};
+
+inline constexpr KeywordTable KEYWORD_TABLE;
 } // namespace sigil
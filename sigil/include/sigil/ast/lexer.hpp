@@ -14,6 +14,10 @@ namespace sigil {
 namespace ml = mana::literals;
 
 class Lexer {
+    // the source being tokenized, padded with zeroes past its length
+    const char* text;
+    ml::i32 text_length;
+
     ml::i32 cursor;
 
     ml::i32 line_start;
@@ -27,6 +31,9 @@ public:
     Lexer();
 
     bool Tokenize(const std::filesystem::path& file_path);
+
+    // tokenizes source that isn't backed by a file, such as generated code
+    bool TokenizeSource(std::string source, std::string_view name);
     void Reset();
 
     SIGIL_NODISCARD ml::usize TokenCount() const;
@@ -35,6 +42,7 @@ public:
     SIGIL_NODISCARD const std::vector<Token>& Tokens() const;
 
 private:
+    void TokenizeLines();
     void TokenizeLine();
 
     SIGIL_NODISCARD ml::u16 GetTokenColumnIndex(ml::u16 token_length) const;
@@ -5,22 +5,93 @@
 
 #include <mana/literals.hpp>
 
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <vector>
 
 namespace sigil {
+namespace ml = mana::literals;
+
+class ParseTree;
+
+/// A node of a ParseTree.
+///
+/// Nodes live in the tree's arena and link to each other by index.
+/// They don't own their tokens, instead they refer to spans of the parser's token stream.
 class ParseNode {
-    ParseNode* parent;
+    friend class ParseTree;
 
-public:
-    using Branch = std::shared_ptr<ParseNode>;
+    static constexpr ml::u32 NONE = std::numeric_limits<ml::u32>::max();
+
+    ParseTree* tree;
+    ml::u32 id;
+    ml::u32 parent;
+
+    ml::u32 first_branch;
+    ml::u32 last_branch;
+    ml::u32 prev_sibling;
+    ml::u32 next_sibling;
+    ml::u32 branch_count;
+
+    ml::u32 first_run;
+    ml::u32 last_run;
+    ml::u32 token_count;
 
-    std::vector<Branch> branches;
-    std::vector<Token> tokens;
+public:
     ast::Rule rule;
 
-    explicit ParseNode(ast::Rule rule = ast::Rule::Undefined);
-    explicit ParseNode(ParseNode* parent, ast::Rule rule = ast::Rule::Undefined);
+    class BranchIterator {
+        const ParseTree* tree;
+        ml::u32 id;
+
+    public:
+        using value_type      = ParseNode;
+        using difference_type = std::ptrdiff_t;
+
+        BranchIterator();
+        BranchIterator(const ParseTree* tree, ml::u32 id);
+
+        const ParseNode& operator*() const;
+        const ParseNode* operator->() const;
+
+        BranchIterator& operator++();
+        BranchIterator operator++(int);
+
+        bool operator==(const BranchIterator& other) const;
+    };
+
+    class TokenIterator {
+        const ParseTree* tree;
+        ml::u32 run;
+        ml::u32 offset;
+
+    public:
+        using value_type      = Token;
+        using difference_type = std::ptrdiff_t;
+
+        TokenIterator();
+        TokenIterator(const ParseTree* tree, ml::u32 run);
+
+        const Token& operator*() const;
+        const Token* operator->() const;
+
+        TokenIterator& operator++();
+        TokenIterator operator++(int);
+
+        bool operator==(const TokenIterator& other) const;
+    };
+
+    template <typename Iterator>
+    struct Range {
+        Iterator first;
+        Iterator last;
+
+        SIGIL_NODISCARD Iterator begin() const { return first; }
+        SIGIL_NODISCARD Iterator end() const { return last; }
+    };
+
+    ParseNode();
 
     SIGIL_NODISCARD ParseNode& NewBranch(ast::Rule new_rule = ast::Rule::Undefined);
 
@@ -35,5 +106,71 @@ public:
     void AcquireBranchesOf(ParseNode& target, ml::i64 start, ml::i64 end);
     void AcquireBranchesOf(ParseNode& target, ml::i64 start = 0);
     void AcquireTailBranchOf(ParseNode& target);
+
+    // 'index' refers to the parser's token stream
+    void AddToken(ml::u32 index);
+
+    SIGIL_NODISCARD ml::i64 BranchCount() const;
+    SIGIL_NODISCARD ml::i64 TokenCount() const;
+
+    // walks from whichever end is closer
+    SIGIL_NODISCARD const ParseNode& Branch(ml::i64 idx) const;
+    SIGIL_NODISCARD const Token& TokenAt(ml::i64 idx) const;
+
+    SIGIL_NODISCARD Range<BranchIterator> Branches() const;
+    SIGIL_NODISCARD Range<TokenIterator> Tokens() const;
+
+private:
+    SIGIL_NODISCARD ParseNode& Node(ml::u32 node_id) const;
+    SIGIL_NODISCARD ml::u32 BranchId(ml::i64 idx) const;
+
+    void Unlink(ParseNode& branch);
+    void Append(ParseNode& branch);
+};
+
+/// Bump arena owning every node of a parse tree.
+///
+/// Nodes are allocated in fixed-size blocks which are never moved,
+/// so references to them stay valid while the tree grows.
+class ParseTree {
+    friend class ParseNode;
+
+    static constexpr ml::u32 BLOCK_SHIFT = 12;
+    static constexpr ml::u32 BLOCK_SIZE  = 1 << BLOCK_SHIFT;
+
+    // a node's tokens aren't necessarily contiguous in the stream (e.g. operators between operands),
+    // so each node keeps a chain of runs
+    struct TokenRun {
+        ml::u32 start;
+        ml::u32 count;
+        ml::u32 next;
+    };
+
+    std::vector<std::unique_ptr<ParseNode[]>> blocks;
+    ml::u32 node_count;
+
+    std::vector<TokenRun> runs;
+    const std::vector<Token>* tokens;
+
+public:
+    explicit ParseTree(const std::vector<Token>* tokens);
+
+    ParseTree(const ParseTree&)            = delete;
+    ParseTree& operator=(const ParseTree&) = delete;
+
+    // discards every node but keeps the arena's memory around for reuse
+    void Reset(ast::Rule root_rule);
+
+    SIGIL_NODISCARD ParseNode& Root();
+    SIGIL_NODISCARD const ParseNode& Root() const;
+
+    SIGIL_NODISCARD ml::i64 NodeCount() const;
+
+private:
+    SIGIL_NODISCARD ParseNode& NewNode(ml::u32 parent, ast::Rule rule);
+    SIGIL_NODISCARD ParseNode& Node(ml::u32 id) const;
+
+    // only the most recent allocation can be given back
+    void ReleaseNode(const ParseNode& node);
 };
 } // namespace sigil
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <sigil/ast/flat-tree.hpp>
 #include <sigil/ast/parse-tree.hpp>
 #include <sigil/ast/syntax-tree.hpp>
 #include <sigil/ast/token.hpp>
@@ -15,9 +16,12 @@ class Parser {
 
     TokenStream tokens;
     ml::i64 cursor;
-    ParseNode parse_tree;
+    ParseTree parse_tree;
+    bool retain_parse_tree;
 
     std::unique_ptr<ast::Artifact> syntax_tree;
+    ast::FlatTree flat_tree;
+    ast::FlatTreeBuilder flat_builder;
     ml::i32 issue_counter;
 
 public:
@@ -28,11 +32,19 @@ public:
     void AcquireTokens(const TokenStream& tks);
     void AcquireTokens(TokenStream&& tks);
 
+    /// Keeps the whole p-tree around after parsing, so it can be viewed or emitted,
+    /// along with the pointer-based AST built from it.
+    /// Otherwise, each declaration's p-tree is discarded as soon as it's been lowered into the flat AST.
+    /// Retained by default.
+    void RetainParseTree(bool retain);
+
     SIGIL_NODISCARD bool Parse();
 
     SIGIL_NODISCARD const ParseNode& ViewParseTree() const;
     SIGIL_NODISCARD const TokenStream& ViewTokenStream() const;
     SIGIL_NODISCARD ast::Node* AST() const;
+    SIGIL_NODISCARD ast::FlatTree& FlatAST();
+    SIGIL_NODISCARD const ast::FlatTree& FlatAST() const;
 
     SIGIL_NODISCARD ml::i32 IssueCount() const;
 
@@ -64,6 +76,7 @@ private:
 
     bool ProgressedParseTree(ParseNode& node);
 
+    // builds and lowers the AST nodes of every declaration currently in the p-tree
     void ConstructAST(const ParseNode& node);
 
     /// Verifies a required parsing condition and records a recoverable syntax error.
@@ -95,18 +108,18 @@ private:
     bool MatchedFunctionDeclaration(ParseNode& node);
     bool MatchedParameterList(ParseNode& node);
     bool MatchedReturn(ParseNode& node);
+    bool MatchedYield(ParseNode& node);
 
     bool MatchedInvocation(ParseNode& node);
 
     bool MatchedDataDeclaration(ParseNode& node);
     bool MatchedAssignment(ParseNode& node);
+    bool MatchedElementAssignment(ParseNode& node);
 
     bool MatchedExpression(ParseNode& node);
-    bool MatchedLogical(ParseNode& node);
-    bool MatchedEquality(ParseNode& node);
-    bool MatchedComparison(ParseNode& node);
-    bool MatchedTerm(ParseNode& node);
-    bool MatchedFactor(ParseNode& node);
+
+    // precedence climbing over every binary operator at least as strong as 'min_power'
+    bool MatchedBinaryExpr(ParseNode& node, ml::u8 min_power);
 
     bool MatchedUnary(ParseNode& node);
     bool MatchedListAccess(ParseNode& node);
@@ -115,16 +128,5 @@ private:
 
     bool MatchedArrayLiteral(ParseNode& node);
     bool MatchedElemList(ParseNode& node);
-
-
-    using MatcherFnPtr   = bool (Parser::*)(ParseNode&);
-    using OpCheckerFnPtr = bool (*)(TokenType);
-
-    SIGIL_NODISCARD bool MatchedBinaryExpr(
-        ParseNode& node,
-        OpCheckerFnPtr is_valid_operator,
-        MatcherFnPtr matched_operand,
-        ast::Rule rule
-    );
 };
 } // namespace sigil
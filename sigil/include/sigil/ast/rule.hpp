@@ -32,6 +32,7 @@ enum class Rule : ml::u8 {
     LoopIfPost,
     LoopFixed,
     LoopRange,
+    LoopRangeParallel,
 
     LoopBody,
     LoopRangeExpr,
@@ -39,8 +40,10 @@ enum class Rule : ml::u8 {
     LoopControl,
 
     Return,
+    Yield,
 
     Assignment,
+    ElementAssignment,
     Expression,
 
     Scope,
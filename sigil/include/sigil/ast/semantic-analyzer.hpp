@@ -1,11 +1,14 @@
 #pragma once
 
-#include <sigil/ast/visitor.hpp>
+#include <sigil/ast/flat-tree.hpp>
+#include <sigil/ast/interner.hpp>
+#include <sigil/ast/symbol-table.hpp>
 
 #include <mana/literals.hpp>
 
-#include <emhash/emhash8.hpp>
-
+#include <array>
+#include <limits>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -29,40 +32,32 @@ enum class Mutability : u8 {
     Const,
 };
 
-using ScopeID = i8;
+using ScopeID = u32;
 
 constexpr ScopeID GLOBAL_SCOPE = 0;
 
+constexpr u32 NOT_PARALLEL = std::numeric_limits<u32>::max();
+
 struct Symbol {
-    std::string_view type;
-    ScopeID scope         = GLOBAL_SCOPE;
+    NameID type           = NO_NAME;
     Mutability mutability = Mutability::Const;
-    bool is_param         = false;
-
-    Symbol(std::string_view type, ScopeID scope, Mutability mutability)
-        : type {type},
-          scope {scope},
-          mutability {mutability} {}
-
-    Symbol(std::string_view type, bool is_param)
-        : type {type},
-          scope {-1},
-          is_param {is_param} {}
-
-    Symbol() = default;
 };
 
-
-using SymbolTable = emhash8::HashMap<std::string_view, Symbol>;
+using SymbolTable = ScopedSymbolTable<Symbol>;
 
 struct Function {
-    SymbolTable locals;
-    std::string_view return_type;
-    ScopeID scope  = GLOBAL_SCOPE;
-    u8 param_count = 0;
+    std::vector<NameID> param_types;
+    NameID return_type = NO_NAME;
+
+    // bindings declared in the body, not counting the parameters
+    u16 local_count = 0;
+    u8 param_count  = 0;
+
+    // provided by the host at runtime, so it has no body
+    bool is_native = false;
 };
 
-using FunctionTable = emhash8::HashMap<std::string_view, Function>;
+using FunctionTable = NameMap<Function>;
 
 struct TypeInfo {
     FunctionTable functions;
@@ -75,102 +70,135 @@ struct TypeInfo {
     TypeInfo() = default;
 };
 
-struct StrHash {
-    // hash on string_view; reuse for all inputs
-    size_t operator()(std::string_view sv) const noexcept {
-        return std::hash<std::string_view> {}(sv);
-    }
-
-    size_t operator()(const std::string& s) const noexcept {
-        return (*this)(std::string_view {s});
-    }
-
-    size_t operator()(const char* s) const noexcept {
-        return (*this)(std::string_view {s});
-    }
-};
-
-struct StrEq {
-    bool operator()(std::string_view a, std::string_view b) const noexcept { return a == b; }
-    bool operator()(const std::string& a, std::string_view b) const noexcept { return std::string_view {a} == b; }
-    bool operator()(std::string_view a, const std::string& b) const noexcept { return a == std::string_view {b}; }
-    bool operator()(const std::string& a, const std::string& b) const noexcept { return a == b; }
-
-    bool operator()(const char* a, const std::string& b) const noexcept {
-        return std::string_view {a} == std::string_view {b};
-    }
-
-    bool operator()(const std::string& a, const char* b) const noexcept {
-        return std::string_view {a} == std::string_view {b};
-    }
-};
-
-using TypeTable = emhash8::HashMap<std::string, TypeInfo, StrHash, StrEq>;
+// array types are interned as well, e.g. '[i64]'
+using TypeTable = NameMap<TypeInfo>;
 
-class SemanticAnalyzer final : public ast::Visitor {
-    SymbolTable globals;
+class SemanticAnalyzer final {
+    SymbolTable symbols;
     TypeTable types;
 
-    std::vector<std::string_view> function_stack;
+    std::vector<NameID> function_stack;
 
     // this gives the analyzer some awareness of the most recently resolved type
     // the buffer only holds one type at a time
     // reading from it expires the type
-    std::array<std::string, 2> type_buffer;
+    std::array<NameID, 2> type_buffer;
+    NameID type_buffer_error;
+
+    // builtins which take any vector, see AnalyzeVectorMath
+    NameID dot_name;
+    NameID cross_name;
+    NameID length_name;
+    NameID normalize_name;
+
+    // builtins which take any list, see AnalyzeListBuiltin
+    enum class ListBuiltin : u8 {
+        Fill,
+        Copy,
+        Slice,
+        Sum,
+        Min,
+        Max,
+        Find,
+        Sort,
+        Add,
+        Mul,
+    };
+
+    NameMap<ListBuiltin> list_builtins;
+
+    // and any map, see AnalyzeMapBuiltin
+    enum class MapBuiltin : u8 {
+        Get,
+        Set,
+        Has,
+        Remove,
+        Count,
+        KeyAt,
+        ValueAt,
+    };
+
+    NameMap<MapBuiltin> map_builtins;
+
+    // what '[:]' is until it takes on the map type it's annotated with
+    NameID empty_map_name;
 
     i32 issue_counter;
 
-    ScopeID current_scope;
     u8 loop_depth;
 
+    // where the innermost parallel loop's counter sits among the bindings, NOT_PARALLEL outside of one
+    // every binding below it is shared by all of the loop's iterations
+    u32 parallel_floor;
+    u8 parallel_loop_depth;
+
+    // only set for the duration of Analyze
+    ast::FlatTree* tree;
+
 public:
     SemanticAnalyzer();
 
     SIGIL_NODISCARD i32 IssueCount() const;
 
-    SIGIL_NODISCARD const SymbolTable& Globals() const;
+    // once analysis is done, only the globals are left in scope
+    SIGIL_NODISCARD std::span<const SymbolTable::Binding> Globals() const;
     SIGIL_NODISCARD const TypeTable& Types() const;
 
-public:
-    void Visit(const ast::Artifact& artifact) override;
-    void Visit(const ast::Scope& node) override;
+    // resolves the element type of the tree's list expressions along the way
+    void Analyze(ast::FlatTree& flat_tree);
 
-    void Visit(const ast::FunctionDeclaration& node) override;
-    void Visit(const ast::MutableDataDeclaration& node) override;
-    void Visit(const ast::DataDeclaration& node) override;
+    // declares the host's native functions from a manifest, one signature per line, e.g. 'fn Sqrt(x: f64) -> f64'
+    // this goes through the lexer, so it has to happen before the source itself is tokenized
+    bool RegisterNatives(std::string_view manifest, std::string_view name);
 
-    void Visit(const ast::Identifier& node) override;
-    void Visit(const ast::Assignment& node) override;
+private:
+    void Analyze(ast::NodeId node);
 
-    void Visit(const ast::Return& node) override;
-    void Visit(const ast::Invocation& node) override;
+    void AnalyzeScope(ast::NodeId node);
+    void AnalyzeStatements(ast::NodeId node);
+    void AnalyzeFunctionDeclaration(ast::NodeId node);
 
-    void Visit(const ast::If& node) override;
+    void AnalyzeIdentifier(ast::NodeId node);
+    void AnalyzeAssignment(ast::NodeId node);
+    void AnalyzeElementAssignment(ast::NodeId node);
 
-    void Visit(const ast::Loop& node) override;
-    void Visit(const ast::LoopIf& node) override;
-    void Visit(const ast::LoopIfPost& node) override;
-    void Visit(const ast::LoopFixed& node) override;
-    void Visit(const ast::LoopRange& node) override;
-    void Visit(const ast::LoopRangeMutable& node) override;
+    void AnalyzeReturn(ast::NodeId node);
+    void AnalyzeInvocation(ast::NodeId node);
+    void AnalyzeVectorMath(ast::NodeId node);
+    void AnalyzeListBuiltin(ast::NodeId node);
+    void AnalyzeMapBuiltin(ast::NodeId node);
 
-    void Visit(const ast::Break& node) override;
-    void Visit(const ast::Skip& node) override;
+    // for builtins which modify the list or map they're given in 'arg'
+    void RequireModifiableBinding(ast::NodeId arg, NameID function);
 
-    void Visit(const ast::UnaryExpr& node) override;
-    void Visit(const ast::BinaryExpr& node) override;
+    void AnalyzeIf(ast::NodeId node);
 
-    void Visit(const ast::ListExpression& array) override;
-    void Visit(const ast::ListAccess& access) override;
+    void AnalyzeLoop(ast::NodeId node);
+    void AnalyzeLoopIf(ast::NodeId node);
+    void AnalyzeLoopIfPost(ast::NodeId node);
+    void AnalyzeLoopFixed(ast::NodeId node);
+    void AnalyzeLoopControl(ast::NodeId node, std::string_view name);
 
-    void Visit(const ast::Literal<f64>& literal) override;
-    void Visit(const ast::Literal<i64>& literal) override;
-    void Visit(const ast::Literal<bool>& literal) override;
+    void AnalyzeUnary(ast::NodeId node);
+    void AnalyzeBinary(ast::NodeId node);
 
-    void Visit(const ast::StringLiteral& string) override;
+    // reports operands the VM's operators can't take, which are lists and maps
+    bool OperatorApplies(NameID type);
 
-private:
-    void RecordFunctionDeclarations(const ast::Artifact& artifact);
+    // records the vectors involved for codegen, and returns the expression's type
+    NameID AnalyzeVectorOperator(ast::NodeId node, TokenType op, NameID lhs_type, NameID rhs_type);
+
+    void AnalyzeList(ast::NodeId node);
+    void AnalyzeListAccess(ast::NodeId node);
+
+    // retypes a list literal to the list type it's annotated with, if their elements match
+    // returns the literal's type from then on
+    NameID AnnotateList(ast::NodeId list, NameID annotation, NameID list_type);
+
+    // gives '[:]' the map type it's assigned to, if it is one, and returns it
+    NameID AnnotateMap(ast::NodeId map, NameID map_type);
+
+    void RecordFunctionDeclarations();
 
     void RegisterPrimitives();
     void RegisterBuiltins();
@@ -178,25 +206,33 @@ private:
     FunctionTable& GetFnTable();
     const FunctionTable& GetFnTable() const;
 
-    std::string_view CurrentFunctionName() const;
+    NameID CurrentFunctionName() const;
 
     Function& CurrentFunction();
     const Function& CurrentFunction() const;
 
-    std::string_view PeekTypeBuffer() const;
-    std::string_view PopTypeBuffer();
-    void BufferType(std::string_view type_name);
+    NameID PeekTypeBuffer() const;
+    NameID PopTypeBuffer();
+    void BufferType(NameID type_name);
 
-    bool TypesMatch(std::string_view lhs, std::string_view rhs) const;
+    bool TypesMatch(NameID lhs, NameID rhs) const;
 
-    void AddSymbol(std::string_view name, std::string_view type, bool is_mutable, ScopeID scope);
-    const Symbol* GetSymbol(std::string_view name) const;
+    // 'T' for a list type '[T]', NO_NAME for anything else
+    NameID ElementType(NameID list_type) const;
 
-    void HandleInitializer(const ast::Initializer& node, bool is_mutable);
-    void PreventAssignmentWithNone(std::string_view type);
+    // 'K' and 'V' for a map type '[K: V]', NO_NAME for anything else
+    NameID MapKeyType(NameID map_type) const;
+    NameID MapValueType(NameID map_type) const;
 
-    void HandleRangedLoop(const ast::LoopRange& node, bool is_mutable);
+    void AddSymbol(NameID name, NameID type, bool is_mutable);
+    const Symbol* GetSymbol(NameID name) const;
 
-public:
+    void HandleInitializer(ast::NodeId node, bool is_mutable);
+    void PreventAssignmentWithNone(NameID type);
+
+    void HandleRangedLoop(ast::NodeId node, bool is_mutable);
+
+    bool InParallelLoop() const;
+    bool IsSharedByIterations(NameID name) const;
 };
 } // namespace sigil
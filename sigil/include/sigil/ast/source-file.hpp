@@ -7,6 +7,10 @@ namespace sigil {
 // perhaps add some safeguards for parallelisation in the future
 class GlobalSourceFile {
     friend class Lexer;
+    friend class Document;
+
+    // zeroes kept past the end of the contents, so the lexer can scan whole blocks without bounds checks
+    static constexpr std::size_t SCAN_PADDING = 64;
 
     std::string name;
     std::string contents;
@@ -18,6 +22,7 @@ class GlobalSourceFile {
 
 private:
     bool Load(const std::filesystem::path& file_path);
+    void Assign(std::string&& source, std::string_view source_name);
     void Reset();
 
 public:
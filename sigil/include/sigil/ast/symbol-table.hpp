@@ -0,0 +1,111 @@
+#pragma once
+
+#include <sigil/ast/interner.hpp>
+
+#include <mana/literals.hpp>
+
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sigil {
+namespace ml = mana::literals;
+
+/// Symbols visible from the current scope, keyed by NameID.
+///
+/// Bindings live on a stack that doubles as an undo log: a scope owns every binding pushed since it was entered,
+/// so leaving it only touches the names it declared. A binding shadows any visible one of the same name,
+/// which becomes visible again once the scope is left.
+/// Whatever is added before the first scope is entered belongs to the global scope, which is never left.
+template <typename T>
+class ScopedSymbolTable {
+public:
+    struct Binding {
+        NameID name;
+        T value;
+
+        // the binding this one shadows
+        ml::u32 shadowed;
+    };
+
+private:
+    static constexpr ml::u32 NO_BINDING = std::numeric_limits<ml::u32>::max();
+
+    // innermost binding of each name
+    std::vector<ml::u32> visible;
+    std::vector<Binding> bindings;
+    std::vector<ml::u32> scope_starts;
+
+public:
+    void EnterScope() {
+        scope_starts.push_back(static_cast<ml::u32>(bindings.size()));
+    }
+
+    // on_exit sees the scope's bindings in the order they were added
+    template <typename OnExit>
+    void ExitScope(OnExit&& on_exit) {
+        const auto start = scope_starts.back();
+        scope_starts.pop_back();
+
+        for (auto i = start; i < bindings.size(); ++i) {
+            on_exit(std::as_const(bindings[i]));
+        }
+
+        // innermost first, in case a name was bound twice in the same scope
+        for (auto i = bindings.size(); i > start; --i) {
+            const auto& binding   = bindings[i - 1];
+            visible[binding.name] = binding.shadowed;
+        }
+
+        bindings.erase(bindings.begin() + start, bindings.end());
+    }
+
+    void ExitScope() {
+        ExitScope([](const Binding&) {});
+    }
+
+    T& Add(const NameID name, T value) {
+        if (name >= visible.size()) {
+            visible.resize(name + 1, NO_BINDING);
+        }
+
+        bindings.push_back({name, std::move(value), visible[name]});
+        visible[name] = static_cast<ml::u32>(bindings.size() - 1);
+
+        return bindings.back().value;
+    }
+
+    SIGIL_NODISCARD T* Find(const NameID name) {
+        if (name >= visible.size() || visible[name] == NO_BINDING) {
+            return nullptr;
+        }
+        return &bindings[visible[name]].value;
+    }
+
+    SIGIL_NODISCARD const T* Find(const NameID name) const {
+        if (name >= visible.size() || visible[name] == NO_BINDING) {
+            return nullptr;
+        }
+        return &bindings[visible[name]].value;
+    }
+
+    // where the name's visible binding sits in Bindings(), past the end if it has none
+    SIGIL_NODISCARD ml::u32 Position(const NameID name) const {
+        if (name >= visible.size() || visible[name] == NO_BINDING) {
+            return static_cast<ml::u32>(bindings.size());
+        }
+        return visible[name];
+    }
+
+    // the global scope is 0
+    SIGIL_NODISCARD ml::u32 Depth() const {
+        return static_cast<ml::u32>(scope_starts.size());
+    }
+
+    // outermost first
+    SIGIL_NODISCARD std::span<const Binding> Bindings() const {
+        return bindings;
+    }
+};
+} // namespace sigil
@@ -8,6 +8,7 @@
 #include <mana/literals.hpp>
 
 #include <memory>
+#include <span>
 #include <vector>
 #include <charconv>
 #include <string_view>
@@ -35,7 +36,9 @@ class Artifact final : public Node {
     std::vector<NodePtr> declarations;
 
 public:
-    Artifact(std::string_view name, const ParseNode& node);
+    explicit Artifact(std::string_view name);
+
+    void AddDeclaration(NodePtr declaration);
 
     SIGIL_NODISCARD auto GetName() const -> std::string_view;
     SIGIL_NODISCARD auto GetChildren() const -> const std::vector<NodePtr>&;
@@ -44,51 +47,51 @@ public:
 };
 
 struct Parameter {
-    std::string_view name;
-    std::string_view type;
+    NameID name;
+    NameID type;
 };
 
 class FunctionDeclaration final : public Node {
-    std::string_view name;
+    NameID name;
     std::vector<Parameter> parameters;
     NodePtr body;
 
-    std::string return_type;
+    NameID return_type;
 
 public:
     explicit FunctionDeclaration(const ParseNode& node);
 
-    SIGIL_NODISCARD std::string_view GetName() const;
+    SIGIL_NODISCARD NameID GetName() const;
     SIGIL_NODISCARD std::span<const Parameter> GetParameters() const;
     SIGIL_NODISCARD const NodePtr& GetBody() const;
-    SIGIL_NODISCARD std::string_view GetReturnType() const;
+    SIGIL_NODISCARD NameID GetReturnType() const;
 
     void Accept(Visitor& visitor) const override;
 };
 
 class Invocation final : public Node {
-    std::string_view identifier;
+    NameID identifier;
     std::vector<NodePtr> arguments;
 
 public:
     explicit Invocation(const ParseNode& node);
 
-    SIGIL_NODISCARD std::string_view GetIdentifier() const;
+    SIGIL_NODISCARD NameID GetIdentifier() const;
     SIGIL_NODISCARD const std::vector<NodePtr>& GetArguments() const;
 
     void Accept(Visitor& visitor) const override;
 };
 
 class Initializer : public Node {
-    std::string_view name;
-    std::string_view type;
+    NameID name;
+    NameID type;
     NodePtr initializer;
 
 public:
     explicit Initializer(const ParseNode& node);
 
-    SIGIL_NODISCARD std::string_view GetName() const;
-    SIGIL_NODISCARD std::string_view GetTypeName() const;
+    SIGIL_NODISCARD NameID GetName() const;
+    SIGIL_NODISCARD NameID GetTypeName() const;
     SIGIL_NODISCARD const NodePtr& GetInitializer() const;
     SIGIL_NODISCARD NodePtr& GetInitializer();
 
@@ -111,13 +114,20 @@ public:
     void Accept(Visitor& visitor) const override;
 };
 
+struct SourceLocation {
+    ml::i32 line;
+    ml::i32 column;
+};
+
 class Statement final : public Node {
     NodePtr child;
+    SourceLocation location;
 
 public:
-    explicit Statement(NodePtr&& node);
+    explicit Statement(NodePtr&& node, SourceLocation location = {});
 
     SIGIL_NODISCARD const NodePtr& GetChild() const;
+    SIGIL_NODISCARD SourceLocation GetLocation() const;
 
     void Accept(Visitor& visitor) const override;
 };
@@ -179,7 +189,7 @@ class LoopRange : public Node {
     NodePtr destination;
     NodePtr body;
 
-    std::string_view counter;
+    NameID counter;
 
 public:
     explicit LoopRange(const ParseNode& node);
@@ -188,7 +198,7 @@ public:
     SIGIL_NODISCARD const NodePtr& GetDestination() const;
     SIGIL_NODISCARD const NodePtr& GetBody() const;
 
-    SIGIL_NODISCARD std::string_view GetCounterName() const;
+    SIGIL_NODISCARD NameID GetCounterName() const;
 
     void Accept(Visitor& visitor) const override;
 };
@@ -200,6 +210,14 @@ public:
     void Accept(Visitor& visitor) const override;
 };
 
+// '@parallel loop', whose iterations may run at the same time on different threads
+class LoopRangeParallel final : public LoopRange {
+public:
+    explicit LoopRangeParallel(const ParseNode& node);
+
+    void Accept(Visitor& visitor) const override;
+};
+
 class ListAccess final : public Node {
     NodePtr item;
     NodePtr index;
@@ -228,13 +246,13 @@ public:
 
 class LoopControl : public Node {
     NodePtr condition;
-    std::string_view label;
+    NameID label;
 
 public:
     explicit LoopControl(const ParseNode& node);
 
     SIGIL_NODISCARD const NodePtr& GetCondition() const;
-    SIGIL_NODISCARD std::string_view GetLabel() const;
+    SIGIL_NODISCARD NameID GetLabel() const;
 
     SIGIL_NODISCARD bool HasLabel() const;
 
@@ -264,17 +282,41 @@ public:
     void Accept(Visitor& visitor) const override;
 };
 
+// suspends the fiber running it, see hex::Fiber
+class Yield final : public Node {
+public:
+    void Accept(Visitor& visitor) const override;
+};
+
 class Assignment final : public Node {
-    std::string_view identifier;
-    std::string_view op;
+    NameID identifier;
+    TokenType op;
     NodePtr value;
 
 public:
     explicit Assignment(const ParseNode& node);
 
-    SIGIL_NODISCARD std::string_view GetIdentifier() const;
+    SIGIL_NODISCARD NameID GetIdentifier() const;
     SIGIL_NODISCARD const NodePtr& GetValue() const;
-    SIGIL_NODISCARD std::string_view GetOp() const;
+    SIGIL_NODISCARD TokenType GetOp() const;
+
+    void Accept(Visitor& visitor) const override;
+};
+
+// xs[i] = v, and its compound forms
+class ElementAssignment final : public Node {
+    NameID identifier;
+    TokenType op;
+    NodePtr index;
+    NodePtr value;
+
+public:
+    explicit ElementAssignment(const ParseNode& node);
+
+    SIGIL_NODISCARD NameID GetIdentifier() const;
+    SIGIL_NODISCARD const NodePtr& GetIndex() const;
+    SIGIL_NODISCARD const NodePtr& GetValue() const;
+    SIGIL_NODISCARD TokenType GetOp() const;
 
     void Accept(Visitor& visitor) const override;
 };
@@ -293,37 +335,38 @@ public:
     SIGIL_NODISCARD const std::vector<NodePtr>& GetStatements() const;
 
     template <NodeType NodeT, typename... Args>
-    void AddStatement(Args&&... args) {
+    void AddStatement(const SourceLocation location, Args&&... args) {
         statements.emplace_back(std::make_shared<Statement>(
-                std::make_shared<NodeT>(std::forward<Args>(args)...)
+                std::make_shared<NodeT>(std::forward<Args>(args)...),
+                location
             )
         );
     }
 
-    void AddStatement(NodePtr&& node) {
-        statements.emplace_back(std::make_shared<Statement>(std::move(node)));
+    void AddStatement(NodePtr&& node, const SourceLocation location) {
+        statements.emplace_back(std::make_shared<Statement>(std::move(node), location));
     }
 };
 
 class Identifier final : public Node {
-    std::string_view name;
+    NameID name;
 
 public:
     explicit Identifier(const ParseNode& node);
 
-    SIGIL_NODISCARD std::string_view GetName() const;
+    SIGIL_NODISCARD NameID GetName() const;
     void Accept(Visitor& visitor) const override;
 };
 
 class BinaryExpr final : public Node {
-    std::string_view op;
+    TokenType op;
     NodePtr left, right;
 
 public:
     explicit BinaryExpr(const ParseNode& node);
-    explicit BinaryExpr(std::string_view op, const ParseNode& left, const ParseNode& right);
+    explicit BinaryExpr(TokenType op, const ParseNode& left, const ParseNode& right);
 
-    SIGIL_NODISCARD std::string_view GetOp() const;
+    SIGIL_NODISCARD TokenType GetOp() const;
 
     SIGIL_NODISCARD auto GetLeft() const -> const Node&;
     SIGIL_NODISCARD auto GetRight() const -> const Node&;
@@ -331,11 +374,11 @@ public:
     void Accept(Visitor& visitor) const override;
 
 private:
-    explicit BinaryExpr(const ParseNode& binary_node, ml::i64 depth);
+    explicit BinaryExpr(std::span<const ParseNode* const> operands, std::span<const Token* const> operators);
 };
 
 class UnaryExpr final : public Node {
-    std::string_view op;
+    TokenType op;
     NodePtr val;
 
 public:
@@ -343,7 +386,7 @@ public:
 
     void Accept(Visitor& visitor) const override;
 
-    SIGIL_NODISCARD std::string_view GetOp() const;
+    SIGIL_NODISCARD TokenType GetOp() const;
     SIGIL_NODISCARD const Node& GetVal() const;
 };
 
@@ -382,6 +425,7 @@ public:
 class ListExpression final : public Node {
     std::vector<NodePtr> values;
     hexe::Value::Data::Type type;
+    bool is_map;
 
 public:
     explicit ListExpression(const ParseNode& node);
@@ -389,6 +433,9 @@ public:
     SIGIL_NODISCARD std::span<const NodePtr> GetValues() const;
     SIGIL_NODISCARD hexe::Value::Data::Type GetType() const;
 
+    // '[:]', which has no values either
+    SIGIL_NODISCARD bool IsMap() const;
+
     void SetType(hexe::Value::Data::Type new_type);
 
     void Accept(Visitor& visitor) const override;
@@ -399,4 +446,17 @@ private:
 
 NodePtr CreateExpression(const ParseNode& node);
 NodePtr CreateDeclaration(const ParseNode& node);
+
+// what the nodes read out of their p-tree, which FlatTreeBuilder reads the same way
+SIGIL_NODISCARD SourceLocation LocationOf(const ParseNode& statement);
+SIGIL_NODISCARD NameID InitializerName(const ParseNode& node);
+SIGIL_NODISCARD NameID InitializerType(const ParseNode& node);
+SIGIL_NODISCARD NameID ReturnTypeOf(const ParseNode& function);
+SIGIL_NODISCARD NameID RangeCounterOf(const ParseNode& range);
+SIGIL_NODISCARD NameID LoopLabelOf(const ParseNode& control);
+SIGIL_NODISCARD bool ReturnsNothing(const ParseNode& node);
+SIGIL_NODISCARD bool IsEmptyMap(const ParseNode& list);
+SIGIL_NODISCARD std::string Unescape(std::string_view literal);
+
+void ReadParameters(const ParseNode& function, std::vector<Parameter>& parameters);
 } // namespace sigil::ast
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sigil/ast/interner.hpp>
+
 #include <mana/literals.hpp>
 
 namespace sigil {
@@ -85,6 +87,11 @@ enum class TokenType : ml::u8 {
     KW_string,
     KW_bool,
 
+    KW_vec2,
+    KW_vec3,
+    KW_vec4,
+    KW_vec2i,
+
     KW_data,
     KW_fn,
     KW_mut,
@@ -103,6 +110,7 @@ enum class TokenType : ml::u8 {
     KW_as,
 
     KW_return,
+    KW_yield,
     KW_if,
     KW_else,
     KW_match,
@@ -129,6 +137,9 @@ struct Token {
 
     TokenType type;
 
+    // interned text of identifiers and primitive type names
+    NameID name = NO_NAME;
+
     bool operator==(const Token& other) const {
         return type == other.type
                && offset == other.offset
@@ -24,8 +24,10 @@ public:
 
     virtual void Visit(const class Identifier&) = 0;
     virtual void Visit(const class Assignment&) = 0;
+    virtual void Visit(const class ElementAssignment&) = 0;
 
     virtual void Visit(const class Return&) = 0;
+    virtual void Visit(const class Yield&) = 0;
     virtual void Visit(const class Invocation&) = 0;
 
     virtual void Visit(const class If&) = 0;
@@ -36,6 +38,7 @@ public:
     virtual void Visit(const class LoopFixed&) = 0;
     virtual void Visit(const class LoopRange&) = 0;
     virtual void Visit(const class LoopRangeMutable&) = 0;
+    virtual void Visit(const class LoopRangeParallel&) = 0;
 
     virtual void Visit(const class Break&) = 0;
     virtual void Visit(const class Skip&) = 0;
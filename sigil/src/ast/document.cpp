@@ -0,0 +1,267 @@
+#include <sigil/ast/document.hpp>
+#include <sigil/ast/parser.hpp>
+#include <sigil/core/logger.hpp>
+
+#include <algorithm>
+
+namespace sigil {
+using namespace mana::literals;
+
+Document::Document(const std::string_view name)
+    : name(name),
+      reparsed {0} {
+    lines.emplace_back();
+}
+
+void Document::Open(const std::string_view text) {
+    lines = Tokenize(std::string(text));
+    declarations.clear();
+
+    Reconcile(1, LineCount() + 1, 0);
+}
+
+void Document::Edit(TextPosition start, TextPosition end, const std::string_view replacement) {
+    const auto clamp_line = [this](TextPosition& position) {
+        position.line   = std::clamp(position.line, 1, LineCount());
+        const auto size = static_cast<i32>(lines[position.line - 1].text.size());
+        position.column = std::clamp(position.column, 1, size + 1);
+    };
+
+    clamp_line(start);
+    clamp_line(end);
+
+    if (end.line < start.line || (end.line == start.line && end.column < start.column)) {
+        Log->error("Edit ends at {}:{}, before it starts at {}:{}", end.line, end.column, start.line, start.column);
+        return;
+    }
+
+    // the edit always covers whole lines, so the lexer never starts in the middle of one
+    std::string text = lines[start.line - 1].text.substr(0, start.column - 1);
+    text += replacement;
+    text += std::string_view(lines[end.line - 1].text).substr(end.column - 1);
+
+    auto edited        = Tokenize(text);
+    const auto added   = static_cast<i32>(edited.size());
+    const auto removed = end.line - start.line + 1;
+
+    const auto first = lines.begin() + (start.line - 1);
+    lines.erase(first, first + removed);
+    lines.insert(lines.begin() + (start.line - 1),
+                 std::make_move_iterator(edited.begin()),
+                 std::make_move_iterator(edited.end())
+    );
+
+    Reconcile(start.line, start.line + added, added - removed);
+}
+
+std::string Document::Text() const {
+    std::string text;
+    for (const auto& line : lines) {
+        if (&line != &lines.front()) {
+            text += '\n';
+        }
+        text += line.text;
+    }
+    return text;
+}
+
+i32 Document::LineCount() const {
+    return static_cast<i32>(lines.size());
+}
+
+std::span<const Token> Document::LineTokens(const i32 line) const {
+    if (line < 1 || line > LineCount()) {
+        return {};
+    }
+    return lines[line - 1].tokens;
+}
+
+i32 Document::IssueCount() const {
+    i32 issues = 0;
+    for (const auto& declaration : declarations) {
+        issues += declaration.issues;
+    }
+    return issues;
+}
+
+i64 Document::ReparsedCount() const {
+    return reparsed;
+}
+
+void Document::Lower(ast::FlatTree& tree) const {
+    tree.Clear();
+    ast::FlatTreeBuilder builder(tree);
+
+    for (const auto& declaration : declarations) {
+        for (const auto& node : declaration.nodes) {
+            const auto first = static_cast<ast::NodeId>(tree.NodeCount());
+            tree.AddDeclaration(builder.Lower(*node));
+
+            if (declaration.first_line != declaration.parsed_line) {
+                tree.ShiftLines(first, declaration.first_line - declaration.parsed_line);
+            }
+        }
+    }
+}
+
+std::vector<Document::Line> Document::Tokenize(const std::string& text) {
+    std::vector<Line> result;
+    std::vector<i32> line_starts;
+
+    usize begin = 0;
+    while (true) {
+        const auto newline = text.find('\n', begin);
+
+        line_starts.push_back(static_cast<i32>(begin));
+        result.push_back({text.substr(begin, newline - begin), {}, 0, false});
+
+        if (newline == std::string::npos) {
+            break;
+        }
+        begin = newline + 1;
+    }
+
+    // lines never affect how each other is tokenized, so the edited ones can be lexed in one go
+    lexer.TokenizeSource(text, name);
+
+    for (auto token : lexer.Tokens()) {
+        if (token.type == TokenType::Eof) {
+            continue;
+        }
+
+        const auto index = std::min<usize>(token.line - 1, result.size() - 1);
+        auto& line       = result[index];
+
+        token.offset -= line_starts[index];
+        line.tokens.push_back(token);
+
+        switch (token.type) {
+            using enum TokenType;
+        case Op_BraceLeft:
+        case Op_ParenLeft:
+        case Op_BracketLeft:
+            ++line.depth_change;
+            break;
+        case Op_BraceRight:
+        case Op_ParenRight:
+        case Op_BracketRight:
+            --line.depth_change;
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (auto& line : result) {
+        if (line.tokens.empty()) {
+            continue;
+        }
+
+        const auto type        = line.tokens.front().type;
+        line.opens_declaration = type == TokenType::KW_fn
+                                 || type == TokenType::KW_data
+                                 || type == TokenType::KW_mut;
+    }
+
+    return result;
+}
+
+void Document::Reconcile(const i32 edit_begin, const i32 edit_end, const i32 line_delta) {
+    auto previous = std::move(declarations);
+    declarations.clear();
+    reparsed = 0;
+
+    // a declaration runs from a line opening one outside any brackets up to the next,
+    // and whatever precedes the first one is treated as a declaration of its own
+    i32 depth = 0;
+    for (i32 i = 0; i < LineCount(); ++i) {
+        if (i == 0 || (depth == 0 && lines[i].opens_declaration)) {
+            declarations.push_back({i + 1, 0, i + 1, 0, {}});
+        }
+
+        ++declarations.back().line_count;
+        depth = std::max(0, depth + lines[i].depth_change);
+    }
+
+    // both lists are ordered by line, so the old declarations only need to be walked once
+    auto old = previous.begin();
+    for (auto& declaration : declarations) {
+        const auto first = declaration.first_line;
+        const auto last  = first + declaration.line_count;
+
+        if (last <= edit_begin || first >= edit_end) {
+            const auto old_first = first >= edit_end ? first - line_delta : first;
+            while (old != previous.end() && old->first_line < old_first) {
+                ++old;
+            }
+
+            // same lines before and after the edit, so the same tokens
+            if (old != previous.end()
+                && old->first_line == old_first
+                && old->line_count == declaration.line_count) {
+                declaration.parsed_line = old->parsed_line;
+                declaration.issues      = old->issues;
+                declaration.nodes       = std::move(old->nodes);
+                continue;
+            }
+        }
+
+        Parse(declaration);
+    }
+}
+
+void Document::Parse(Declaration& declaration) {
+    declaration.parsed_line = declaration.first_line;
+    declaration.issues      = 0;
+    declaration.nodes.clear();
+
+    std::string text;
+    std::vector<Token> tokens;
+    bool has_statements = false;
+
+    for (i32 i = 0; i < declaration.line_count; ++i) {
+        const auto& line = lines[declaration.first_line - 1 + i];
+
+        for (auto token : line.tokens) {
+            token.line = declaration.first_line + i;
+            token.offset += static_cast<i32>(text.size());
+
+            has_statements |= token.type != TokenType::Terminator;
+            tokens.push_back(token);
+        }
+
+        text += line.text;
+        text += '\n';
+    }
+
+    // blank lines and comments
+    if (not has_statements) {
+        return;
+    }
+
+    tokens.push_back(Token {
+            .line   = declaration.first_line + declaration.line_count,
+            .offset = static_cast<i32>(text.size()),
+            .column = 0,
+            .length = 0,
+            .type   = TokenType::Eof,
+        }
+    );
+
+    // the parser reads literals back out of the source, which only needs to hold this declaration
+    Lexer::Source.Assign(std::move(text), name);
+
+    Parser parser(std::move(tokens));
+    const bool parsed = parser.Parse();
+    ++reparsed;
+
+    declaration.issues = parser.IssueCount();
+    if (not parsed) {
+        return;
+    }
+
+    if (const auto* artifact = dynamic_cast<const ast::Artifact*>(parser.AST())) {
+        declaration.nodes = artifact->GetChildren();
+    }
+}
+} // namespace sigil
@@ -0,0 +1,743 @@
+#include <sigil/ast/flat-tree.hpp>
+#include <sigil/ast/source-file.hpp>
+#include <sigil/core/logger.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <charconv>
+
+namespace sigil::ast {
+using namespace mana::literals;
+
+/// FlatTree
+void FlatTree::Reserve(const i64 node_count) {
+    kinds.reserve(node_count);
+    child_starts.reserve(node_count);
+    child_counts.reserve(node_count);
+    payloads.reserve(node_count);
+    locations.reserve(node_count);
+
+    // every node but the declarations is somebody's child
+    children.reserve(node_count);
+}
+
+void FlatTree::Clear() {
+    kinds.clear();
+    child_starts.clear();
+    child_counts.clear();
+    payloads.clear();
+    locations.clear();
+
+    children.clear();
+    declarations.clear();
+
+    names.clear();
+    functions.clear();
+    parameters.clear();
+    ints.clear();
+    floats.clear();
+    strings.clear();
+}
+
+NodeId FlatTree::AddNode(const NodeKind kind, const std::span<const NodeId> node_children, const u32 payload) {
+    const auto node = static_cast<NodeId>(kinds.size());
+
+    kinds.push_back(kind);
+    child_starts.push_back(static_cast<u32>(children.size()));
+    child_counts.push_back(static_cast<u32>(node_children.size()));
+    payloads.push_back(payload);
+    locations.push_back({});
+
+    children.insert(children.end(), node_children.begin(), node_children.end());
+
+    return node;
+}
+
+void FlatTree::AddDeclaration(const NodeId node) {
+    declarations.push_back(node);
+}
+
+u32 FlatTree::AddNames(const std::initializer_list<NameID> new_names) {
+    const auto index = static_cast<u32>(names.size());
+    names.insert(names.end(), new_names);
+    return index;
+}
+
+u32 FlatTree::AddFunction(const NameID name,
+                          const NameID return_type,
+                          const std::span<const Parameter> params
+) {
+    const auto index = static_cast<u32>(functions.size());
+
+    functions.push_back({name, return_type, static_cast<u32>(parameters.size()), static_cast<u32>(params.size())});
+    parameters.insert(parameters.end(), params.begin(), params.end());
+
+    return index;
+}
+
+u32 FlatTree::AddInt(const i64 value) {
+    ints.push_back(value);
+    return static_cast<u32>(ints.size() - 1);
+}
+
+u32 FlatTree::AddFloat(const f64 value) {
+    floats.push_back(value);
+    return static_cast<u32>(floats.size() - 1);
+}
+
+u32 FlatTree::AddString(const std::string_view value) {
+    strings.emplace_back(value);
+    return static_cast<u32>(strings.size() - 1);
+}
+
+void FlatTree::SetLocation(const NodeId node, const SourceLocation location) {
+    locations[node] = location;
+}
+
+void FlatTree::ShiftLines(const NodeId first, const i32 lines) {
+    for (auto node = first; node < locations.size(); ++node) {
+        // only statements have a location
+        if (locations[node].line != 0) {
+            locations[node].line += lines;
+        }
+    }
+}
+
+void FlatTree::SetListType(const NodeId node, const hexe::Value::Data::Type type) {
+    payloads[node] = static_cast<u32>(type);
+}
+
+void FlatTree::SetOperandTypes(const NodeId node, const hexe::Value::Data::Type lhs, const hexe::Value::Data::Type rhs) {
+    auto& slot = OperatorSlot(node);
+    slot       = (slot & 0xFF) | static_cast<u32>(lhs) << 8 | static_cast<u32>(rhs) << 16;
+}
+
+u32& FlatTree::OperatorSlot(const NodeId node) {
+    // assignments keep theirs next to the identifier
+    if (kinds[node] == NodeKind::Assignment || kinds[node] == NodeKind::ElementAssignment) {
+        return names[payloads[node] + 1];
+    }
+    return payloads[node];
+}
+
+u32 FlatTree::OperatorSlot(const NodeId node) const {
+    if (kinds[node] == NodeKind::Assignment || kinds[node] == NodeKind::ElementAssignment) {
+        return names[payloads[node] + 1];
+    }
+    return payloads[node];
+}
+
+NodeKind FlatTree::Kind(const NodeId node) const {
+    return kinds[node];
+}
+
+std::span<const NodeId> FlatTree::Children(const NodeId node) const {
+    return std::span(children).subspan(child_starts[node], child_counts[node]);
+}
+
+NodeId FlatTree::Child(const NodeId node, const u32 index) const {
+    return children[child_starts[node] + index];
+}
+
+u32 FlatTree::ChildCount(const NodeId node) const {
+    return child_counts[node];
+}
+
+SourceLocation FlatTree::Location(const NodeId node) const {
+    return locations[node];
+}
+
+NameID FlatTree::Name(const NodeId node, const u32 index) const {
+    return names[payloads[node] + index];
+}
+
+TokenType FlatTree::Operator(const NodeId node) const {
+    return static_cast<TokenType>(OperatorSlot(node) & 0xFF);
+}
+
+const FunctionInfo& FlatTree::Function(const NodeId node) const {
+    return functions[payloads[node]];
+}
+
+std::span<const Parameter> FlatTree::Parameters(const NodeId node) const {
+    const auto& function = Function(node);
+    return std::span(parameters).subspan(function.first_param, function.param_count);
+}
+
+bool FlatTree::Bool(const NodeId node) const {
+    return payloads[node] != 0;
+}
+
+i64 FlatTree::Int(const NodeId node) const {
+    return ints[payloads[node]];
+}
+
+f64 FlatTree::Float(const NodeId node) const {
+    return floats[payloads[node]];
+}
+
+std::string_view FlatTree::String(const NodeId node) const {
+    return strings[payloads[node]];
+}
+
+hexe::Value::Data::Type FlatTree::ListType(const NodeId node) const {
+    return static_cast<hexe::Value::Data::Type>(payloads[node]);
+}
+
+hexe::Value::Data::Type FlatTree::OperandType(const NodeId node, const u32 index) const {
+    return static_cast<hexe::Value::Data::Type>(OperatorSlot(node) >> (8 + 8 * index) & 0xFF);
+}
+
+std::span<const NodeId> FlatTree::Declarations() const {
+    return declarations;
+}
+
+i64 FlatTree::NodeCount() const {
+    return static_cast<i64>(kinds.size());
+}
+
+/// FlatTreeBuilder
+FlatTreeBuilder::FlatTreeBuilder(FlatTree& tree)
+    : tree {tree},
+      result {NO_NODE} {}
+
+NodeId FlatTreeBuilder::Lower(const Node& node) {
+    result = NO_NODE;
+    node.Accept(*this);
+    return result;
+}
+
+void FlatTreeBuilder::Visit(const Artifact& artifact) {
+    for (const auto& decl : artifact.GetChildren()) {
+        if (decl != nullptr) {
+            tree.AddDeclaration(Lower(*decl));
+        }
+    }
+    result = NO_NODE;
+}
+
+void FlatTreeBuilder::Visit(const Scope& node) {
+    const auto base = scratch.size();
+
+    for (const auto& statement : node.GetStatements()) {
+        // scopes only ever hold statements
+        const auto& stmt = static_cast<const Statement&>(*statement);
+
+        const auto lowered = Lower(*stmt.GetChild());
+        tree.SetLocation(lowered, stmt.GetLocation());
+        scratch.push_back(lowered);
+    }
+
+    AddNodeFromScratch(NodeKind::Scope, base);
+}
+
+void FlatTreeBuilder::Visit(const FunctionDeclaration& node) {
+    const NodeId body = Lower(*node.GetBody());
+    result            = tree.AddNode(NodeKind::FunctionDeclaration,
+                                     {&body, 1},
+                                     tree.AddFunction(node.GetName(), node.GetReturnType(), node.GetParameters())
+    );
+}
+
+void FlatTreeBuilder::Visit(const MutableDataDeclaration& node) {
+    LowerInitializer(NodeKind::MutableDataDeclaration, node);
+}
+
+void FlatTreeBuilder::Visit(const DataDeclaration& node) {
+    LowerInitializer(NodeKind::DataDeclaration, node);
+}
+
+void FlatTreeBuilder::Visit(const Identifier& node) {
+    result = tree.AddNode(NodeKind::Identifier, {}, tree.AddNames({node.GetName()}));
+}
+
+void FlatTreeBuilder::Visit(const Assignment& node) {
+    const NodeId value = Lower(*node.GetValue());
+    result             = tree.AddNode(NodeKind::Assignment,
+                                      {&value, 1},
+                                      tree.AddNames({node.GetIdentifier(), static_cast<NameID>(node.GetOp())})
+    );
+}
+
+void FlatTreeBuilder::Visit(const ElementAssignment& node) {
+    const NodeId parts[] = {Lower(*node.GetIndex()), Lower(*node.GetValue())};
+    result               = tree.AddNode(NodeKind::ElementAssignment,
+                                        parts,
+                                        tree.AddNames({node.GetIdentifier(), static_cast<NameID>(node.GetOp())})
+    );
+}
+
+void FlatTreeBuilder::Visit(const Return& node) {
+    const auto base = scratch.size();
+    LowerOptional(node.GetExpression());
+
+    AddNodeFromScratch(NodeKind::Return, base);
+}
+
+void FlatTreeBuilder::Visit(const Yield& node) {
+    result = tree.AddNode(NodeKind::Yield, {});
+}
+
+void FlatTreeBuilder::Visit(const Invocation& node) {
+    const auto base = scratch.size();
+
+    for (const auto& arg : node.GetArguments()) {
+        LowerOptional(arg);
+    }
+
+    AddNodeFromScratch(NodeKind::Invocation, base, tree.AddNames({node.GetIdentifier()}));
+}
+
+void FlatTreeBuilder::Visit(const If& node) {
+    const auto base = scratch.size();
+    LowerOptional(node.GetCondition());
+    LowerOptional(node.GetThenBlock());
+    LowerOptional(node.GetElseBranch());
+
+    AddNodeFromScratch(NodeKind::If, base);
+}
+
+void FlatTreeBuilder::Visit(const Loop& node) {
+    const NodeId body = Lower(*node.GetBody());
+    result            = tree.AddNode(NodeKind::Loop, {&body, 1});
+}
+
+void FlatTreeBuilder::Visit(const LoopIf& node) {
+    const NodeId parts[] = {Lower(*node.GetCondition()), Lower(*node.GetBody())};
+    result               = tree.AddNode(NodeKind::LoopIf, parts);
+}
+
+void FlatTreeBuilder::Visit(const LoopIfPost& node) {
+    const NodeId parts[] = {Lower(*node.GetBody()), Lower(*node.GetCondition())};
+    result               = tree.AddNode(NodeKind::LoopIfPost, parts);
+}
+
+void FlatTreeBuilder::Visit(const LoopFixed& node) {
+    const NodeId parts[] = {Lower(*node.GetCountTarget()), Lower(*node.GetBody())};
+    result               = tree.AddNode(NodeKind::LoopFixed, parts);
+}
+
+void FlatTreeBuilder::Visit(const LoopRange& node) {
+    LowerRange(NodeKind::LoopRange, node);
+}
+
+void FlatTreeBuilder::Visit(const LoopRangeMutable& node) {
+    LowerRange(NodeKind::LoopRangeMutable, node);
+}
+
+void FlatTreeBuilder::Visit(const LoopRangeParallel& node) {
+    LowerRange(NodeKind::LoopRangeParallel, node);
+}
+
+void FlatTreeBuilder::Visit(const Break& node) {
+    LowerLoopControl(NodeKind::Break, node);
+}
+
+void FlatTreeBuilder::Visit(const Skip& node) {
+    LowerLoopControl(NodeKind::Skip, node);
+}
+
+void FlatTreeBuilder::Visit(const UnaryExpr& node) {
+    const NodeId value = Lower(node.GetVal());
+    result             = tree.AddNode(NodeKind::Unary, {&value, 1}, static_cast<u32>(node.GetOp()));
+}
+
+void FlatTreeBuilder::Visit(const BinaryExpr& node) {
+    const NodeId operands[] = {Lower(node.GetLeft()), Lower(node.GetRight())};
+    result                  = tree.AddNode(NodeKind::Binary, operands, static_cast<u32>(node.GetOp()));
+}
+
+void FlatTreeBuilder::Visit(const ListExpression& list) {
+    // '[:]' only gets its map type from the annotation it's assigned to
+    if (list.IsMap()) {
+        result = tree.AddNode(NodeKind::Map, {}, static_cast<u32>(hexe::Value::Data::Type::Invalid));
+        return;
+    }
+
+    const auto base = scratch.size();
+
+    for (const auto& value : list.GetValues()) {
+        LowerOptional(value);
+    }
+
+    // the element type is only known after semantic analysis
+    AddNodeFromScratch(NodeKind::List, base, static_cast<u32>(hexe::Value::Data::Type::Invalid));
+}
+
+void FlatTreeBuilder::Visit(const ListAccess& access) {
+    const NodeId parts[] = {Lower(*access.GetItem()), Lower(*access.GetIndex())};
+    result               = tree.AddNode(NodeKind::ListAccess, parts);
+}
+
+void FlatTreeBuilder::Visit(const Literal<bool>& literal) {
+    result = tree.AddNode(NodeKind::LiteralBool, {}, literal.Get() ? 1 : 0);
+}
+
+void FlatTreeBuilder::Visit(const Literal<i64>& literal) {
+    result = tree.AddNode(NodeKind::LiteralInt, {}, tree.AddInt(literal.Get()));
+}
+
+void FlatTreeBuilder::Visit(const Literal<f64>& literal) {
+    result = tree.AddNode(NodeKind::LiteralFloat, {}, tree.AddFloat(literal.Get()));
+}
+
+void FlatTreeBuilder::Visit(const StringLiteral& string) {
+    result = tree.AddNode(NodeKind::LiteralString, {}, tree.AddString(string.Get()));
+}
+
+void FlatTreeBuilder::LowerOptional(const NodePtr& node) {
+    if (node != nullptr) {
+        // nested nodes push and pop their own children, so this lands right after the siblings
+        const auto lowered = Lower(*node);
+        scratch.push_back(lowered);
+    }
+}
+
+void FlatTreeBuilder::AddNodeFromScratch(const NodeKind kind, const std::size_t base, const u32 payload) {
+    result = tree.AddNode(kind, std::span(scratch).subspan(base), payload);
+    scratch.resize(base);
+}
+
+void FlatTreeBuilder::LowerInitializer(const NodeKind kind, const Initializer& node) {
+    const auto base = scratch.size();
+    LowerOptional(node.GetInitializer());
+
+    AddNodeFromScratch(kind, base, tree.AddNames({node.GetName(), node.GetTypeName()}));
+}
+
+void FlatTreeBuilder::LowerRange(const NodeKind kind, const LoopRange& node) {
+    const auto base = scratch.size();
+    LowerOptional(node.GetOrigin());
+    LowerOptional(node.GetDestination());
+    LowerOptional(node.GetBody());
+
+    AddNodeFromScratch(kind, base, tree.AddNames({node.GetCounterName()}));
+}
+
+void FlatTreeBuilder::LowerLoopControl(const NodeKind kind, const LoopControl& node) {
+    const auto base = scratch.size();
+    LowerOptional(node.GetCondition());
+
+    AddNodeFromScratch(kind, base, tree.AddNames({node.GetLabel()}));
+}
+
+/// FlatTreeBuilder, from the p-tree
+NodeId FlatTreeBuilder::LowerDeclaration(const ParseNode& node) {
+    switch (node.rule) {
+        using enum Rule;
+
+    case FunctionDeclaration:
+        return LowerFunction(node);
+    case DataDeclaration:
+        return LowerInitializer(NodeKind::DataDeclaration, node);
+    case MutableDataDeclaration:
+        return LowerInitializer(NodeKind::MutableDataDeclaration, node);
+    default:
+        Log->trace("Failed declaration check for '{}'", magic_enum::enum_name(node.rule));
+        return NO_NODE;
+    }
+}
+
+NodeId FlatTreeBuilder::LowerScope(const ParseNode& node) {
+    const auto base = scratch.size();
+
+    for (const auto& stmt : node.Branches()) {
+        const auto lowered = LowerStatement(stmt);
+        if (lowered != NO_NODE) {
+            tree.SetLocation(lowered, LocationOf(stmt));
+            scratch.push_back(lowered);
+        }
+    }
+
+    AddNodeFromScratch(NodeKind::Scope, base);
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerStatement(const ParseNode& stmt) {
+    switch (stmt.rule) {
+        using enum Rule;
+
+    case Return: {
+        const auto base = scratch.size();
+        if (not ReturnsNothing(stmt)) {
+            PushOptional(LowerExpression(stmt.Branch(0)));
+        }
+
+        AddNodeFromScratch(NodeKind::Return, base);
+        return result;
+    }
+    case Yield:
+        return tree.AddNode(NodeKind::Yield, {});
+    case If:
+        return LowerIf(stmt);
+    case Loop: {
+        const NodeId body = LowerScope(stmt.Branch(0));
+        return tree.AddNode(NodeKind::Loop, {&body, 1});
+    }
+    case LoopIf: {
+        const NodeId parts[] = {LowerExpression(stmt.Branch(0)), LowerScope(stmt.Branch(1))};
+        return tree.AddNode(NodeKind::LoopIf, parts);
+    }
+    case LoopIfPost: {
+        const NodeId parts[] = {LowerScope(stmt.Branch(0)), LowerExpression(stmt.Branch(1))};
+        return tree.AddNode(NodeKind::LoopIfPost, parts);
+    }
+    case LoopRange:
+        if (stmt.TokenAt(0).type == TokenType::KW_mut) {
+            return LowerRange(NodeKind::LoopRangeMutable, stmt);
+        }
+        return LowerRange(NodeKind::LoopRange, stmt);
+    case LoopRangeParallel:
+        return LowerRange(NodeKind::LoopRangeParallel, stmt);
+    case LoopFixed: {
+        const NodeId parts[] = {LowerExpression(stmt.Branch(0)), LowerScope(stmt.Branch(1))};
+        return tree.AddNode(NodeKind::LoopFixed, parts);
+    }
+    case LoopControl:
+        if (stmt.TokenAt(0).type == TokenType::KW_break) {
+            return LowerLoopControl(NodeKind::Break, stmt);
+        }
+        if (stmt.TokenAt(0).type == TokenType::KW_skip) {
+            return LowerLoopControl(NodeKind::Skip, stmt);
+        }
+        Log->error("Unexpected loop control statement. Token was '{}'",
+                   magic_enum::enum_name(stmt.TokenAt(0).type)
+        );
+        return NO_NODE;
+    default:
+        break;
+    }
+
+    if (const auto decl = LowerDeclaration(stmt); decl != NO_NODE) {
+        return decl;
+    }
+    if (const auto expr = LowerExpression(stmt); expr != NO_NODE) {
+        return expr;
+    }
+
+    Log->error("Expected statement");
+    return NO_NODE;
+}
+
+NodeId FlatTreeBuilder::LowerExpression(const ParseNode& node) {
+    switch (node.rule) {
+        using enum Rule;
+
+    case Invocation: {
+        const auto base = scratch.size();
+        for (const auto& arg : node.Branches()) {
+            PushOptional(LowerExpression(arg));
+        }
+
+        AddNodeFromScratch(NodeKind::Invocation, base, tree.AddNames({node.TokenAt(0).name}));
+        return result;
+    }
+    case Assignment: {
+        const NodeId value = LowerExpression(node.Branch(0));
+        return tree.AddNode(NodeKind::Assignment,
+                            {&value, 1},
+                            tree.AddNames({node.TokenAt(0).name, static_cast<NameID>(node.TokenAt(1).type)})
+        );
+    }
+    case ElementAssignment: {
+        const NodeId parts[] = {LowerExpression(node.Branch(0)), LowerExpression(node.Branch(1))};
+        return tree.AddNode(NodeKind::ElementAssignment,
+                            parts,
+                            tree.AddNames({node.TokenAt(0).name, static_cast<NameID>(node.TokenAt(1).type)})
+        );
+    }
+    case Grouping:
+        return LowerExpression(node.Branch(0));
+    case Literal:
+        return LowerLiteral(node.TokenCount() == 0 ? Token {} : node.TokenAt(0));
+    case Identifier:
+        return tree.AddNode(NodeKind::Identifier, {}, tree.AddNames({node.TokenAt(0).name}));
+    case ListExpression:
+        return LowerList(node);
+    case ListAccess: {
+        const NodeId parts[] = {LowerExpression(node.Branch(0)), LowerExpression(node.Branch(1))};
+        return tree.AddNode(NodeKind::ListAccess, parts);
+    }
+    case Unary: {
+        const NodeId value = LowerExpression(node.Branch(0));
+        return tree.AddNode(NodeKind::Unary, {&value, 1}, static_cast<u32>(node.TokenAt(0).type));
+    }
+    case Factor:
+    case Term:
+    case Comparison:
+    case Equality:
+    case Logical:
+        return LowerBinary(node);
+    default:
+        Log->trace("Failed expression check for '{}'", magic_enum::enum_name(node.rule));
+        return NO_NODE;
+    }
+}
+
+NodeId FlatTreeBuilder::LowerFunction(const ParseNode& node) {
+    const NodeId body = LowerScope(node.Branch(1));
+
+    parameters.clear();
+    ReadParameters(node, parameters);
+
+    return tree.AddNode(NodeKind::FunctionDeclaration,
+                        {&body, 1},
+                        tree.AddFunction(node.TokenAt(0).name, ReturnTypeOf(node), parameters)
+    );
+}
+
+NodeId FlatTreeBuilder::LowerInitializer(const NodeKind kind, const ParseNode& node) {
+    const auto base = scratch.size();
+    if (not node.IsLeaf()) {
+        PushOptional(LowerExpression(node.Branch(0)));
+    }
+
+    AddNodeFromScratch(kind, base, tree.AddNames({InitializerName(node), InitializerType(node)}));
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerIf(const ParseNode& node) {
+    const auto base = scratch.size();
+    PushOptional(LowerExpression(node.Branch(0)));
+    PushOptional(LowerScope(node.Branch(1)));
+
+    if (node.BranchCount() > 2) {
+        const auto& tail = node.Branch(2).Branch(0);
+        if (tail.rule == Rule::Scope) {
+            PushOptional(LowerScope(tail));
+        } else if (tail.rule == Rule::If) {
+            PushOptional(LowerIf(tail));
+        } else {
+            Log->error("Unexpected rule in else-branch");
+        }
+    }
+
+    AddNodeFromScratch(NodeKind::If, base);
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerRange(const NodeKind kind, const ParseNode& node) {
+    const auto base = scratch.size();
+
+    // it's either a partial or full range
+    const bool has_origin = node.BranchCount() != 2;
+    if (has_origin) {
+        PushOptional(LowerExpression(node.Branch(0)));
+    }
+    PushOptional(LowerExpression(node.Branch(has_origin ? 1 : 0)));
+    PushOptional(LowerScope(node.Branch(has_origin ? 2 : 1)));
+
+    AddNodeFromScratch(kind, base, tree.AddNames({RangeCounterOf(node)}));
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerLoopControl(const NodeKind kind, const ParseNode& node) {
+    const auto base = scratch.size();
+
+    // LoopControl can only have up to 1 branch
+    if (not node.IsLeaf()) {
+        PushOptional(LowerExpression(node.Branch(0)));
+    }
+
+    AddNodeFromScratch(kind, base, tree.AddNames({LoopLabelOf(node)}));
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerBinary(const ParseNode& node) {
+    // 'a - b - c' holds every operand and operator at once, and folds to the left
+    auto operand  = node.Branches().begin();
+    NodeId folded = LowerExpression(*operand);
+
+    for (const auto& op : node.Tokens()) {
+        const NodeId operands[] = {folded, LowerExpression(*++operand)};
+        folded                  = tree.AddNode(NodeKind::Binary, operands, static_cast<u32>(op.type));
+    }
+    return folded;
+}
+
+NodeId FlatTreeBuilder::LowerList(const ParseNode& node) {
+    // '[:]' only gets its map type from the annotation it's assigned to
+    if (IsEmptyMap(node)) {
+        return tree.AddNode(NodeKind::Map, {}, static_cast<u32>(hexe::Value::Data::Type::Invalid));
+    }
+
+    const auto base = scratch.size();
+
+    if (not node.IsLeaf()) {
+        if (node.BranchCount() > 1) {
+            Log->error("ArrayLiteral may only contain one elem list");
+        }
+
+        for (const auto& elem : node.Branch(0).Branches()) {
+            PushOptional(LowerListValue(elem));
+        }
+    }
+
+    // the element type is only known after semantic analysis
+    AddNodeFromScratch(NodeKind::List, base, static_cast<u32>(hexe::Value::Data::Type::Invalid));
+    return result;
+}
+
+NodeId FlatTreeBuilder::LowerListValue(const ParseNode& elem) {
+    switch (elem.rule) {
+        using enum Rule;
+
+    case Grouping:
+        if (elem.IsLeaf()) {
+            Log->warn("Empty grouping inside array literal");
+            return NO_NODE;
+        }
+        return LowerListValue(elem.Branch(0));
+    case ListExpression:
+        return LowerList(elem);
+    case Literal:
+        return LowerLiteral(elem.TokenAt(0));
+    case Equality:
+    case Comparison:
+    case Term:
+    case Factor:
+        return LowerBinary(elem);
+    case Unary:
+        return LowerExpression(elem);
+    default:
+        Log->error("Unexpected rule in elem list");
+        return NO_NODE;
+    }
+}
+
+NodeId FlatTreeBuilder::LowerLiteral(const Token& token) {
+    const auto text = FetchTokenText(token);
+
+    switch (token.type) {
+        using enum TokenType;
+
+    case Lit_true:
+    case Lit_false:
+        return tree.AddNode(NodeKind::LiteralBool, {}, token.type == Lit_true ? 1 : 0);
+    case Lit_Int: {
+        i64 value {};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return tree.AddNode(NodeKind::LiteralInt, {}, tree.AddInt(value));
+    }
+    case Lit_Float: {
+        f64 value {};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return tree.AddNode(NodeKind::LiteralFloat, {}, tree.AddFloat(value));
+    }
+    case Lit_String:
+        return tree.AddNode(NodeKind::LiteralString, {}, tree.AddString(Unescape(text)));
+    case Lit_none:
+        Log->error("Internal Compiler Error: Attempted to manifest 'none' literal");
+        return NO_NODE;
+    default:
+        Log->error("Unexpected token for literal");
+        return NO_NODE;
+    }
+}
+
+void FlatTreeBuilder::PushOptional(const NodeId node) {
+    if (node != NO_NODE) {
+        scratch.push_back(node);
+    }
+}
+} // namespace sigil::ast
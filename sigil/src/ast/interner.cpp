@@ -0,0 +1,60 @@
+#include <sigil/ast/interner.hpp>
+#include <sigil/ast/keywords.hpp>
+
+#include <algorithm>
+
+namespace sigil {
+Interner::Interner() {
+    for (const auto primitive : PRIMITIVES) {
+        Intern(primitive);
+    }
+    Intern(ENTRY_POINT);
+}
+
+NameID Interner::Intern(const std::string_view name) {
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+
+    const std::string_view stored = storage.emplace_back(name);
+    const auto id                 = static_cast<NameID>(names.size());
+
+    names.push_back(stored);
+    ids.emplace(stored, id);
+
+    return id;
+}
+
+void Interner::Truncate(ml::u32 count) {
+    count = std::max(count, ENTRY_POINT_ID + 1);
+
+    while (names.size() > count) {
+        ids.erase(names.back());
+        names.pop_back();
+        storage.pop_back();
+    }
+}
+
+NameID Interner::Find(const std::string_view name) const {
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+    return NO_NAME;
+}
+
+std::string_view Interner::Name(const NameID id) const {
+    if (id >= names.size()) {
+        return {};
+    }
+    return names[id];
+}
+
+ml::u32 Interner::Count() const {
+    return static_cast<ml::u32>(names.size());
+}
+
+Interner& Names() {
+    static thread_local Interner interner;
+    return interner;
+}
+} // namespace sigil
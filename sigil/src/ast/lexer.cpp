@@ -5,42 +5,197 @@
 #include <magic_enum/magic_enum.hpp>
 #include <spdlog/sinks/basic_file_sink.h>
 
-#include <cctype>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <fstream>
 #include <string>
-#include <unordered_map>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define SIGIL_LEXER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SIGIL_LEXER_SSE2
+#endif
 
 namespace sigil {
 using namespace mana::literals;
 
+namespace {
+// character classes, so the hot paths do a table lookup instead of a chain of comparisons
+enum CharClass : u8 {
+    Blank   = 1 << 0, // whitespace which doesn't end the line
+    Newline = 1 << 1,
+    Digit   = 1 << 2,
+    Alpha   = 1 << 3, // letters and underscores
+};
+
+constexpr std::array<u8, 256> CHAR_CLASSES = [] {
+    std::array<u8, 256> table {};
+
+    for (const char c : {' ', '\t', '\r', '\0'}) {
+        table[static_cast<u8>(c)] = Blank;
+    }
+    table['\n'] = Newline;
+
+    for (u8 c = '0'; c <= '9'; ++c) {
+        table[c] = Digit;
+    }
+    for (u8 c = 'a'; c <= 'z'; ++c) {
+        table[c]                           = Alpha;
+        table[static_cast<u8>(c - 'a' + 'A')] = Alpha;
+    }
+    table['_'] = Alpha;
+
+    return table;
+}();
+
+constexpr bool IsClass(const char c, const u8 classes) {
+    return (CHAR_CLASSES[static_cast<u8>(c)] & classes) != 0;
+}
+
+// Block scanners classify a whole block of characters at once, and return a bitmask with one bit per character.
+// Loads may run past the end of the source, which is fine as GlobalSourceFile pads it with zeroes.
+#if defined(SIGIL_LEXER_AVX2)
+#   define SIGIL_LEXER_SIMD
+using Block = __m256i;
+
+constexpr i32 BLOCK_SIZE = 32;
+constexpr u32 FULL_MASK  = 0xFFFFFFFF;
+
+Block Load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const Block*>(p)); }
+Block Splat(const char c) { return _mm256_set1_epi8(c); }
+Block Equal(const Block a, const Block b) { return _mm256_cmpeq_epi8(a, b); }
+Block Greater(const Block a, const Block b) { return _mm256_cmpgt_epi8(a, b); }
+Block Or(const Block a, const Block b) { return _mm256_or_si256(a, b); }
+Block And(const Block a, const Block b) { return _mm256_and_si256(a, b); }
+u32 Mask(const Block b) { return static_cast<u32>(_mm256_movemask_epi8(b)); }
+#elif defined(SIGIL_LEXER_SSE2)
+#   define SIGIL_LEXER_SIMD
+using Block = __m128i;
+
+constexpr i32 BLOCK_SIZE = 16;
+constexpr u32 FULL_MASK  = 0xFFFF;
+
+Block Load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const Block*>(p)); }
+Block Splat(const char c) { return _mm_set1_epi8(c); }
+Block Equal(const Block a, const Block b) { return _mm_cmpeq_epi8(a, b); }
+Block Greater(const Block a, const Block b) { return _mm_cmpgt_epi8(a, b); }
+Block Or(const Block a, const Block b) { return _mm_or_si128(a, b); }
+Block And(const Block a, const Block b) { return _mm_and_si128(a, b); }
+u32 Mask(const Block b) { return static_cast<u32>(_mm_movemask_epi8(b)); }
+#endif
+
+#ifdef SIGIL_LEXER_SIMD
+// signed comparison, so bytes above 0x7F never fall in an ASCII range
+Block InRange(const Block b, const char low, const char high) {
+    return And(Greater(b, Splat(static_cast<char>(low - 1))), Greater(Splat(static_cast<char>(high + 1)), b));
+}
+
+u32 BlankMask(const char* p) {
+    const auto b = Load(p);
+    return Mask(Or(Or(Equal(b, Splat(' ')), Equal(b, Splat('\t'))),
+                   Or(Equal(b, Splat('\r')), Equal(b, Splat('\0')))));
+}
+
+u32 NewlineMask(const char* p) {
+    return Mask(Equal(Load(p), Splat('\n')));
+}
+
+u32 IdentifierMask(const char* p) {
+    const auto b = Load(p);
+
+    // setting the case bit maps upper case letters onto lower case ones, and nothing else onto letters
+    const auto letters = InRange(Or(b, Splat(0x20)), 'a', 'z');
+    return Mask(Or(Or(letters, InRange(b, '0', '9')), Equal(b, Splat('_'))));
+}
+#endif
+
+// first position from 'from' that isn't a blank, capped at 'end'
+i32 SkipBlanks(const char* text, i32 from, const i32 end) {
+#ifdef SIGIL_LEXER_SIMD
+    for (; from < end; from += BLOCK_SIZE) {
+        if (const u32 stop = ~BlankMask(text + from) & FULL_MASK;
+            stop != 0) {
+            return std::min(from + std::countr_zero(stop), end);
+        }
+    }
+    return end;
+#else
+    while (from < end && IsClass(text[from], Blank)) {
+        ++from;
+    }
+    return from;
+#endif
+}
+
+// first newline from 'from', or 'end' if the line runs to the end of the source
+i32 FindNewline(const char* text, i32 from, const i32 end) {
+#ifdef SIGIL_LEXER_SIMD
+    for (; from < end; from += BLOCK_SIZE) {
+        if (const u32 newlines = NewlineMask(text + from);
+            newlines != 0) {
+            return std::min(from + std::countr_zero(newlines), end);
+        }
+    }
+    return end;
+#else
+    while (from < end && text[from] != '\n') {
+        ++from;
+    }
+    return from;
+#endif
+}
+
+// first position from 'from' which can't continue an identifier,
+// the padding past the end of the source always stops it
+i32 SkipIdentifier(const char* text, i32 from) {
+#ifdef SIGIL_LEXER_SIMD
+    while (true) {
+        if (const u32 stop = ~IdentifierMask(text + from) & FULL_MASK;
+            stop != 0) {
+            return from + std::countr_zero(stop);
+        }
+        from += BLOCK_SIZE;
+    }
+#else
+    while (IsClass(text[from], Alpha | Digit)) {
+        ++from;
+    }
+    return from;
+#endif
+}
+} // namespace
+
 thread_local GlobalSourceFile Lexer::Source;
 
 Lexer::Lexer()
-    : cursor {0},
+    : text {nullptr},
+      text_length {0},
+      cursor {0},
       line_start(0),
       line_number {0} {}
 
 bool Lexer::IsNewline() const {
-    return IsNewline(Source[cursor]);
+    return IsNewline(text[cursor]);
 }
 
-bool Lexer::IsNewline(char c) const {
+bool Lexer::IsNewline(const char c) const {
     return c == '\n';
 }
 
 void Lexer::TokenizeLine() {
     line_start = cursor;
 
-    while (cursor < Source.Size() && not IsNewline()) {
+    while (cursor < text_length && not IsNewline()) {
         if (IsLineComment()) {
-            do { ++cursor; }
-            while (not IsNewline());
-
+            cursor = FindNewline(text, cursor, text_length);
             break;
         }
 
-        if (IsWhitespace(Source[cursor])) {
-            ++cursor;
+        if (IsClass(text[cursor], Blank)) {
+            cursor = SkipBlanks(text, cursor, text_length);
             continue;
         }
 
@@ -69,20 +224,41 @@ bool Lexer::Tokenize(const std::filesystem::path& file_path) {
     Reset();
     Source.Load(file_path);
 
+    TokenizeLines();
+    return true;
+}
+
+bool Lexer::TokenizeSource(std::string source, const std::string_view name) {
+    Reset();
+    Source.Assign(std::move(source), name);
+
+    TokenizeLines();
+    return true;
+}
+
+void Lexer::TokenizeLines() {
+    // scanning a local range avoids going through the thread_local source for every character
+    text        = Source.contents.data();
+    text_length = static_cast<i32>(Source.Size());
+
+    // source averages a few bytes per token
+    tokens.reserve(text_length / 4);
+
     // lines count from 1
     line_number = 1;
-    while (cursor < Source.Size()) {
+    while (cursor < text_length) {
         TokenizeLine();
     }
 
     AddEOF();
-    return true;
 }
 
 void Lexer::Reset() {
     tokens.clear();
     Source.Reset();
 
+    text        = nullptr;
+    text_length = 0;
     cursor      = 0;
     line_number = 0;
     line_start  = 0;
@@ -102,30 +278,27 @@ const std::vector<Token>& Lexer::Tokens() const {
 
 // ID = ^[a-zA-Z_][a-zA-Z0-9_]+
 bool Lexer::LexedIdentifier() {
-    if (char current = Source[cursor];
-        current == '_' || std::isalpha(current)) {
-        const u16 start = cursor;
-        u16 length      = 0;
+    if (not IsClass(text[cursor], Alpha)) {
+        return false;
+    }
 
-        while (current == '_' || std::isalnum(current)) {
-            ++length;
-            current = Source[++cursor];
-        }
+    const i32 start = cursor;
+    cursor          = SkipIdentifier(text, cursor + 1);
 
-        if (not MatchedKeyword(Source.Slice(start, length))) {
-            AddToken(TokenType::Identifier, length);
-        }
-        return true;
+    const auto length     = static_cast<u16>(cursor - start);
+    const auto identifier = std::string_view(text + start, length);
+    if (not MatchedKeyword(identifier)) {
+        AddToken(TokenType::Identifier, length);
+        tokens.back().name = Names().Intern(identifier);
     }
-
-    return false;
+    return true;
 }
 
 // only to be entered when current char is " or '
 bool Lexer::LexedString() {
     TokenType literal_type;
 
-    char current_char = Source[cursor];
+    char current_char = text[cursor];
     switch (current_char) {
     case '\"':
         literal_type = TokenType::Lit_String;
@@ -144,7 +317,7 @@ bool Lexer::LexedString() {
 
     const auto starting_char = current_char;
     while (true) {
-        if (static_cast<usize>(++cursor) >= Source.Size()) {
+        if (++cursor >= text_length) {
             Log->warn("Unexpected EOF while lexing string literal");
             AddToken(TokenType::Unknown, length);
             AddEOF();
@@ -158,7 +331,7 @@ bool Lexer::LexedString() {
             return false;
         }
 
-        current_char = Source[cursor];
+        current_char = text[cursor];
 
         // end of string
         if (current_char == starting_char) {
@@ -175,7 +348,7 @@ bool Lexer::LexedString() {
 }
 
 bool Lexer::LexedNumber() {
-    if (not std::isdigit(Source[cursor])) {
+    if (not IsClass(text[cursor], Digit)) {
         return false;
     }
 
@@ -183,7 +356,7 @@ bool Lexer::LexedNumber() {
 
     // INT = ^[-?0-9]+
     const auto eat_digits = [&] {
-        while (std::isdigit(Source[cursor])) {
+        while (IsClass(text[cursor], Digit)) {
             ++length;
             ++cursor;
         }
@@ -193,8 +366,8 @@ bool Lexer::LexedNumber() {
 
     // FLOAT = INT.[0-9]+
     // if we encounter a dot, it can't be an int
-    if (Source[cursor] != '.' // two dots could be a range operator, so we know it's an int
-        || Source[cursor + 1] == '.') {
+    if (text[cursor] != '.' // two dots could be a range operator, so we know it's an int
+        || text[cursor + 1] == '.') {
         AddToken(TokenType::Lit_Int, length);
         return true;
     }
@@ -203,7 +376,7 @@ bool Lexer::LexedNumber() {
     ++length;
     ++cursor;
 
-    if (not std::isdigit(Source[cursor])) {
+    if (not IsClass(text[cursor], Digit)) {
         Log->error("Incomplete float literal.");
         AddToken(TokenType::Unknown, length);
         return false;
@@ -216,8 +389,8 @@ bool Lexer::LexedNumber() {
 }
 
 bool Lexer::LexedOperator() {
-    const auto current = Source[cursor];
-    const auto next    = Source[cursor + 1];
+    const auto current = text[cursor];
+    const auto next    = text[cursor + 1];
     TokenType token_type;
     //
     switch (current) {
@@ -399,7 +572,7 @@ bool Lexer::LexedOperator() {
 
 void Lexer::LexUnknown() {
     u16 length = 0;
-    while (not IsWhitespace(Source[cursor])) {
+    while (not IsWhitespace(text[cursor])) {
         ++cursor;
         ++length;
     }
@@ -410,9 +583,13 @@ void Lexer::LexUnknown() {
 }
 
 bool Lexer::MatchedKeyword(const std::string_view identifier) {
-    if (const auto keyword = KEYWORDS.find(identifier);
-        keyword != KEYWORDS.end()) {
-        AddToken(keyword->second, identifier.length());
+    if (const auto* keyword = KEYWORD_TABLE.Find(identifier)) {
+        AddToken(keyword->type, identifier.length());
+
+        // the primitives lead KEYWORDS in PrimitiveType order, so their index is their name
+        if (const auto index = keyword - KEYWORDS.data(); index < NUM_PRIMITIVES) {
+            tokens.back().name = PrimitiveID(static_cast<PrimitiveType>(index));
+        }
         return true;
     }
 
@@ -420,11 +597,11 @@ bool Lexer::MatchedKeyword(const std::string_view identifier) {
 }
 
 bool Lexer::IsWhitespace(const char c) const {
-    return c == ' ' || c == '\0' || c == '\n' || c == '\r' || c == '\t';
+    return IsClass(c, Blank | Newline);
 }
 
 bool Lexer::IsLineComment() const {
-    return Source[cursor] == '/' && Source[cursor + 1] == '/';
+    return text[cursor] == '/' && text[cursor + 1] == '/';
 }
 
 u16 Lexer::GetTokenColumnIndex(const u16 token_length) const {
@@ -476,7 +653,7 @@ void PrintTokens(const std::vector<Token>& tokens, const PrintingMode mode, cons
 
     constexpr auto align_pos   = 4;
     constexpr auto align_token = 15;
-    for (const auto& [line, offset, column, length, type] : tokens) {
+    for (const auto& [line, offset, column, length, type, name] : tokens) {
         const auto token_type_name = magic_enum::enum_name(type);
 
         // formats as "  line:column  " where the colon is always in the same spot.
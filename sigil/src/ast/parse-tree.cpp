@@ -1,97 +1,340 @@
 #include <sigil/ast/parse-tree.hpp>
 #include <sigil/core/logger.hpp>
 
+#include <magic_enum/magic_enum.hpp>
+
 namespace sigil {
 using namespace mana::literals;
 using namespace ast;
 
-ParseNode::ParseNode(const Rule r)
-    : parent {nullptr},
-      rule {r} {}
-
-ParseNode::ParseNode(ParseNode* p, const Rule r)
-    : parent {p},
-      rule {r} {}
+/// ParseNode
+ParseNode::ParseNode()
+    : tree {nullptr},
+      id {NONE},
+      parent {NONE},
+      first_branch {NONE},
+      last_branch {NONE},
+      prev_sibling {NONE},
+      next_sibling {NONE},
+      branch_count {0},
+      first_run {NONE},
+      last_run {NONE},
+      token_count {0},
+      rule {Rule::Undefined} {}
 
 ParseNode& ParseNode::NewBranch(const Rule new_rule) {
     // because the module node is the root, it's useless to list it as a parent
-    return *branches.emplace_back(
-        std::make_shared<ParseNode>(rule == Rule::Artifact ? nullptr : this, new_rule)
-    );
+    auto& branch = tree->NewNode(rule == Rule::Artifact ? NONE : id, new_rule);
+    Append(branch);
+    return branch;
 }
 
 void ParseNode::PopBranch() {
-    branches.pop_back();
+    auto& branch = Node(last_branch);
+    Unlink(branch);
+    tree->ReleaseNode(branch);
 }
 
 void ParseNode::RemoveBranch(const i64 idx) {
-    branches.erase(branches.begin() + idx);
+    Unlink(Node(BranchId(idx)));
 }
 
 void ParseNode::RemoveBranchFromTail(const i64 idx) {
-    branches.erase(branches.end() - idx);
+    Unlink(Node(BranchId(branch_count - idx)));
 }
 
 bool ParseNode::IsRoot() const {
-    return parent == nullptr;
+    return parent == NONE;
 }
 
 bool ParseNode::IsLeaf() const {
-    return branches.empty();
+    return branch_count == 0;
 }
 
 void ParseNode::AcquireBranchOf(ParseNode& target, const i64 index) {
+    auto& branch = Node(target.BranchId(index));
+
 #ifdef SIGIL_DEBUG
-    if (target.branches[index].get() == this) {
+    if (&branch == this) {
         Log->error("Can not acquire branches of self");
         return;
     }
 #endif
 
-    branches.emplace_back(target.branches[index]);
-    branches.back()->parent = this;
-    target.RemoveBranch(index);
+    target.Unlink(branch);
+    Append(branch);
+    branch.parent = id;
 }
 
 void ParseNode::AcquireBranchesOf(ParseNode& target, const i64 start, const i64 end) {
+    u32 current = target.BranchId(start);
+
     for (i64 i = start; i <= end; ++i) {
+        auto& branch = Node(current);
 #ifdef SIGIL_DEBUG
-        if (target.branches[i].get() == this) {
+        if (&branch == this) {
             Log->error("Can not acquire branches of self");
             return;
         }
 #endif
-        branches.emplace_back(target.branches[i]);
-        branches.back()->parent = this;
-    }
+        current = branch.next_sibling;
 
-    // erase removes up to the penultimate element, but we want inclusive removal
-    target.branches.erase(target.branches.begin() + start, target.branches.begin() + end + 1);
+        target.Unlink(branch);
+        Append(branch);
+        branch.parent = id;
+    }
 }
 
 void ParseNode::AcquireBranchesOf(ParseNode& target, const i64 start) {
-    for (i64 i = start; i < target.branches.size(); ++i) {
-#ifdef SIGIL_DEBUG
-        if (target.branches[i].get() == this) {
-            Log->error("Can not acquire branches of self");
-            return;
-        }
-#endif
-        branches.emplace_back(target.branches[i]);
-        branches.back()->parent = this;
+    if (start >= target.branch_count) {
+        return;
     }
-    target.branches.erase(target.branches.begin() + start, target.branches.end());
+    AcquireBranchesOf(target, start, target.branch_count - 1);
 }
 
 void ParseNode::AcquireTailBranchOf(ParseNode& target) {
-#ifdef SIGIL_DEBUG
-    if (target.branches.back().get() == this) {
-        Log->error("Can not acquire branches of self");
+    AcquireBranchOf(target, target.branch_count - 1);
+}
+
+void ParseNode::AddToken(const u32 index) {
+    auto& runs = tree->runs;
+
+    ++token_count;
+
+    // consecutive tokens just widen the last span
+    if (last_run != NONE && runs[last_run].start + runs[last_run].count == index) {
+        ++runs[last_run].count;
         return;
     }
-#endif
-    branches.emplace_back(target.branches.back());
-    branches.back()->parent = this;
-    target.branches.erase(target.branches.end() - 1);
+
+    const auto run = static_cast<u32>(runs.size());
+    runs.push_back({index, 1, NONE});
+
+    if (last_run == NONE) {
+        first_run = run;
+    } else {
+        runs[last_run].next = run;
+    }
+    last_run = run;
+}
+
+i64 ParseNode::BranchCount() const {
+    return branch_count;
+}
+
+i64 ParseNode::TokenCount() const {
+    return token_count;
+}
+
+const ParseNode& ParseNode::Branch(const i64 idx) const {
+    return Node(BranchId(idx));
+}
+
+const Token& ParseNode::TokenAt(i64 idx) const {
+    const auto& runs = tree->runs;
+
+    for (u32 run = first_run; run != NONE; run = runs[run].next) {
+        if (idx < runs[run].count) {
+            return (*tree->tokens)[runs[run].start + idx];
+        }
+        idx -= runs[run].count;
+    }
+
+    Log->critical("Token index out of range for p-tree node '{}'", magic_enum::enum_name(rule));
+    return tree->tokens->back();
+}
+
+auto ParseNode::Branches() const -> Range<BranchIterator> {
+    return {{tree, first_branch}, {tree, NONE}};
+}
+
+auto ParseNode::Tokens() const -> Range<TokenIterator> {
+    return {{tree, first_run}, {tree, NONE}};
+}
+
+ParseNode& ParseNode::Node(const u32 node_id) const {
+    return tree->Node(node_id);
+}
+
+u32 ParseNode::BranchId(const i64 idx) const {
+    if (idx < branch_count / 2) {
+        u32 current = first_branch;
+        for (i64 i = 0; i < idx; ++i) {
+            current = Node(current).next_sibling;
+        }
+        return current;
+    }
+
+    u32 current = last_branch;
+    for (i64 i = branch_count - 1; i > idx; --i) {
+        current = Node(current).prev_sibling;
+    }
+    return current;
+}
+
+void ParseNode::Unlink(ParseNode& branch) {
+    if (branch.prev_sibling == NONE) {
+        first_branch = branch.next_sibling;
+    } else {
+        Node(branch.prev_sibling).next_sibling = branch.next_sibling;
+    }
+
+    if (branch.next_sibling == NONE) {
+        last_branch = branch.prev_sibling;
+    } else {
+        Node(branch.next_sibling).prev_sibling = branch.prev_sibling;
+    }
+
+    branch.prev_sibling = NONE;
+    branch.next_sibling = NONE;
+    --branch_count;
+}
+
+void ParseNode::Append(ParseNode& branch) {
+    branch.prev_sibling = last_branch;
+    branch.next_sibling = NONE;
+
+    if (last_branch == NONE) {
+        first_branch = branch.id;
+    } else {
+        Node(last_branch).next_sibling = branch.id;
+    }
+
+    last_branch = branch.id;
+    ++branch_count;
+}
+
+/// ParseNode::BranchIterator
+ParseNode::BranchIterator::BranchIterator()
+    : tree {nullptr},
+      id {NONE} {}
+
+ParseNode::BranchIterator::BranchIterator(const ParseTree* tree, const u32 id)
+    : tree {tree},
+      id {id} {}
+
+const ParseNode& ParseNode::BranchIterator::operator*() const {
+    return tree->Node(id);
+}
+
+const ParseNode* ParseNode::BranchIterator::operator->() const {
+    return &tree->Node(id);
+}
+
+auto ParseNode::BranchIterator::operator++() -> BranchIterator& {
+    id = tree->Node(id).next_sibling;
+    return *this;
+}
+
+auto ParseNode::BranchIterator::operator++(int) -> BranchIterator {
+    auto old = *this;
+    ++*this;
+    return old;
+}
+
+bool ParseNode::BranchIterator::operator==(const BranchIterator& other) const {
+    return id == other.id;
+}
+
+/// ParseNode::TokenIterator
+ParseNode::TokenIterator::TokenIterator()
+    : tree {nullptr},
+      run {NONE},
+      offset {0} {}
+
+ParseNode::TokenIterator::TokenIterator(const ParseTree* tree, const u32 run)
+    : tree {tree},
+      run {run},
+      offset {0} {}
+
+const Token& ParseNode::TokenIterator::operator*() const {
+    return (*tree->tokens)[tree->runs[run].start + offset];
+}
+
+const Token* ParseNode::TokenIterator::operator->() const {
+    return &**this;
+}
+
+auto ParseNode::TokenIterator::operator++() -> TokenIterator& {
+    if (++offset == tree->runs[run].count) {
+        run    = tree->runs[run].next;
+        offset = 0;
+    }
+    return *this;
+}
+
+auto ParseNode::TokenIterator::operator++(int) -> TokenIterator {
+    auto old = *this;
+    ++*this;
+    return old;
+}
+
+bool ParseNode::TokenIterator::operator==(const TokenIterator& other) const {
+    return run == other.run && offset == other.offset;
+}
+
+/// ParseTree
+ParseTree::ParseTree(const std::vector<Token>* tokens)
+    : node_count {0},
+      tokens {tokens} {
+    Reset(Rule::Undefined);
+}
+
+void ParseTree::Reset(const Rule root_rule) {
+    node_count = 0;
+    runs.clear();
+
+    // the root is always the first node
+    static_cast<void>(NewNode(ParseNode::NONE, root_rule));
+}
+
+ParseNode& ParseTree::Root() {
+    return Node(0);
+}
+
+const ParseNode& ParseTree::Root() const {
+    return Node(0);
+}
+
+i64 ParseTree::NodeCount() const {
+    return node_count;
+}
+
+ParseNode& ParseTree::NewNode(const u32 parent, const Rule rule) {
+    const u32 id = node_count++;
+
+    if ((id >> BLOCK_SHIFT) == blocks.size()) {
+        blocks.emplace_back(std::make_unique<ParseNode[]>(BLOCK_SIZE));
+    }
+
+    auto& node  = Node(id);
+    node        = ParseNode();
+    node.tree   = this;
+    node.id     = id;
+    node.parent = parent;
+    node.rule   = rule;
+
+    return node;
+}
+
+ParseNode& ParseTree::Node(const u32 id) const {
+    return blocks[id >> BLOCK_SHIFT][id & (BLOCK_SIZE - 1)];
+}
+
+void ParseTree::ReleaseNode(const ParseNode& node) {
+    // speculative branches (e.g. an 'if' that turned out not to be one) are popped right away,
+    // so in practice they're almost always the latest node
+    if (node.id + 1 != node_count || not node.IsLeaf()) {
+        return;
+    }
+
+    if (node.first_run != ParseNode::NONE) {
+        if (node.first_run != node.last_run || node.last_run + 1 != runs.size()) {
+            return;
+        }
+        runs.pop_back();
+    }
+
+    --node_count;
 }
 } // namespace sigil
@@ -6,6 +6,7 @@
 #include <magic_enum/magic_enum.hpp>
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 
 namespace sigil {
@@ -15,18 +16,24 @@ using namespace mana::literals;
 Parser::Parser(TokenStream&& tokens)
     : tokens {std::move(tokens)},
       cursor {},
-      parse_tree {Rule::Undefined},
+      parse_tree {&this->tokens},
+      retain_parse_tree {true},
+      flat_builder {flat_tree},
       issue_counter {0} {}
 
 Parser::Parser(const TokenStream& tokens)
     : tokens {tokens},
       cursor {},
-      parse_tree {Rule::Undefined},
+      parse_tree {&this->tokens},
+      retain_parse_tree {true},
+      flat_builder {flat_tree},
       issue_counter {0} {}
 
 Parser::Parser()
     : cursor {},
-      parse_tree {Rule::Undefined},
+      parse_tree {&tokens},
+      retain_parse_tree {true},
+      flat_builder {flat_tree},
       issue_counter {0} {}
 
 void Parser::AcquireTokens(const TokenStream& tks) {
@@ -37,16 +44,32 @@ void Parser::AcquireTokens(TokenStream&& tks) {
     tokens = std::move(tks);
 }
 
+void Parser::RetainParseTree(const bool retain) {
+    retain_parse_tree = retain;
+}
+
 bool Parser::Parse() {
     if (tokens.empty()) {
         Log->error("No tokens to parse");
         return false;
     }
 
-    parse_tree.rule = Rule::Artifact;
+    parse_tree.Reset(Rule::Artifact);
+    syntax_tree = std::make_unique<Artifact>(Source().Name());
+    flat_tree.Clear();
+    // a rough estimate, most nodes take up one or two tokens
+    flat_tree.Reserve(static_cast<i64>(tokens.size() * 2 / 3));
 
     cursor = 0;
-    while (ProgressedParseTree(parse_tree)) {}
+    while (ProgressedParseTree(parse_tree.Root())) {
+        if (retain_parse_tree || parse_tree.Root().IsLeaf()) {
+            continue;
+        }
+
+        // the declaration's nodes are still hot, so build its AST right away and recycle the arena
+        ConstructAST(parse_tree.Root());
+        parse_tree.Reset(Rule::Artifact);
+    }
 
     // In case there's any trailing newlines
     SkipNewlines();
@@ -61,15 +84,24 @@ bool Parser::Parse() {
             );
         }
         issue_counter++;
+        syntax_tree.reset();
+        flat_tree.Clear();
         return false;
     }
 
-    ConstructAST(parse_tree);
+    if (retain_parse_tree) {
+        ConstructAST(parse_tree.Root());
+    }
+
+    if (flat_tree.Declarations().empty()) {
+        Log->error("Empty module, no AST can be constructed");
+        ++issue_counter;
+    }
     return true;
 }
 
 auto Parser::ViewParseTree() const -> const ParseNode& {
-    return parse_tree;
+    return parse_tree.Root();
 }
 
 auto Parser::ViewTokenStream() const -> const TokenStream& {
@@ -80,25 +112,43 @@ auto Parser::AST() const -> Node* {
     return syntax_tree.get();
 }
 
+auto Parser::FlatAST() -> FlatTree& {
+    return flat_tree;
+}
+
+auto Parser::FlatAST() const -> const FlatTree& {
+    return flat_tree;
+}
+
 ml::i32 Parser::IssueCount() const {
     return issue_counter;
 }
 
 void Parser::PrintParseTree() const {
+    if (not retain_parse_tree) {
+        Log->debug("Parse tree for artifact '{}' was not retained", Source().Name());
+        return;
+    }
+
     Log->debug("Parse tree for artifact '{}'\n\n{}",
                Source().Name(),
-               EmitParseTree(parse_tree)
+               EmitParseTree(parse_tree.Root())
     );
 }
 
 void Parser::EmitParseTree(const std::string_view file_name) const {
+    if (not retain_parse_tree) {
+        Log->error("Parse tree was not retained, nothing to emit to file '{}'", file_name);
+        return;
+    }
+
     std::ofstream out {std::string(file_name) + std::string(".ptree")};
     if (not out.is_open()) {
         Log->error("Failed to open file '{}' for writing", file_name);
         return;
     }
 
-    out << EmitParseTree(parse_tree);
+    out << EmitParseTree(parse_tree.Root());
     if (out.fail()) {
         Log->error("Failed to write to file '{}'", file_name);
         return;
@@ -107,7 +157,7 @@ void Parser::EmitParseTree(const std::string_view file_name) const {
 }
 
 std::string Parser::EmitParseTree() const {
-    return EmitParseTree(parse_tree);
+    return EmitParseTree(parse_tree.Root());
 }
 
 std::string Parser::EmitParseTree(const ParseNode& node, std::string prepend) const {
@@ -122,10 +172,10 @@ std::string Parser::EmitParseTree(const ParseNode& node, std::string prepend) co
 
         prepend.append("== ");
 
-        if (not node.tokens.empty()) {
+        if (node.TokenCount() > 0) {
             std::ranges::replace(prepend, '=', '-');
 
-            for (const auto& token : node.tokens) {
+            for (const auto& token : node.Tokens()) {
                 if (token.type == TokenType::Terminator) {
                     continue;
                 }
@@ -141,13 +191,11 @@ std::string Parser::EmitParseTree(const ParseNode& node, std::string prepend) co
         }
     }
 
-    if (not node.branches.empty()) {
-        for (auto& branch : node.branches) {
-            ret.append(EmitParseTree(*branch, prepend));
-        }
+    for (const auto& branch : node.Branches()) {
+        ret.append(EmitParseTree(branch, prepend));
     }
 
-    if (not node.branches.empty() && node.IsRoot()) {
+    if (not node.IsLeaf() && node.IsRoot()) {
         ret.append("\n");
     }
 
@@ -185,7 +233,7 @@ bool Parser::SkipNewlines() {
 
 void Parser::AddTokensTo(ParseNode& node, const TokenType delimiter) {
     while (CurrentToken().type != delimiter) {
-        node.tokens.push_back(GetAndCycleToken());
+        node.AddToken(cursor++);
     }
 
     AddCycledTokenTo(node);
@@ -193,19 +241,19 @@ void Parser::AddTokensTo(ParseNode& node, const TokenType delimiter) {
 
 void Parser::AddTokensTo(ParseNode& node, const i64 count) {
     for (i64 i = 0; i < count; ++i) {
-        node.tokens.push_back(GetAndCycleToken());
+        node.AddToken(cursor++);
     }
 }
 
 void Parser::AddCurrentTokenTo(ParseNode& node) const {
     if (cursor < tokens.size()) {
-        node.tokens.push_back(CurrentToken());
+        node.AddToken(cursor);
     }
 }
 
 void Parser::AddCycledTokenTo(ParseNode& node) {
     if (cursor < tokens.size()) {
-        node.tokens.push_back(GetAndCycleToken());
+        node.AddToken(cursor++);
     }
 }
 
@@ -241,14 +289,19 @@ void Parser::ConstructAST(const ParseNode& node) {
         return;
     }
 
-    if (node.IsLeaf()) {
-        Log->error("Empty module, no AST can be constructed");
-        ++issue_counter;
-        return;
-    }
+    for (const auto& decl : node.Branches()) {
+        const auto declaration = flat_builder.LowerDeclaration(decl);
+        if (declaration == NO_NODE) {
+            continue;
+        }
+
+        flat_tree.AddDeclaration(declaration);
 
-    // this creates the AST
-    syntax_tree = std::make_unique<Artifact>(Source().Name(), node);
+        // the pointer AST is only built to be inspected alongside the p-tree
+        if (retain_parse_tree) {
+            syntax_tree->AddDeclaration(CreateDeclaration(decl));
+        }
+    }
 }
 
 bool Parser::Expect(const bool condition,
@@ -269,7 +322,7 @@ bool Parser::MatchedDeclaration(ParseNode& node) {
 }
 
 // stmt = decl | if_block | loop
-//      | (return | loop_control | assign | expr) TERMINATOR
+//      | (return | yield | loop_control | assign | expr) TERMINATOR
 bool Parser::MatchedStatement(ParseNode& node) {
     // these statements aren't terminated since they have a scope, so we exit early on match
     if (MatchedDeclaration(node)
@@ -279,6 +332,7 @@ bool Parser::MatchedStatement(ParseNode& node) {
     }
 
     const bool is_statement = MatchedReturn(node)
+                              || MatchedYield(node)
                               || MatchedLoopControl(node)
                               || MatchedAssignment(node)
                               || MatchedExpression(node);
@@ -404,13 +458,31 @@ bool Parser::MatchedLoopControl(ParseNode& node) {
     return true;
 }
 
-// loop = KW_LOOP (ID ':')? loop_body
+// loop = ('@' ID)? KW_LOOP (ID ':')? loop_body
 bool Parser::MatchedLoop(ParseNode& node) {
-    if (CurrentToken().type != TokenType::KW_loop) {
+    const bool is_parallel = CurrentToken().type == TokenType::Op_Attribute;
+    if (not is_parallel && CurrentToken().type != TokenType::KW_loop) {
         return false;
     }
 
     auto& loop = node.NewBranch(Rule::Loop);
+
+    if (is_parallel) {
+        SkipCurrentToken();
+
+        // 'parallel' is the only attribute there is so far, so it doesn't warrant a keyword
+        if (not Expect(CurrentToken().type == TokenType::Identifier && FetchTokenText(CurrentToken()) == "parallel",
+                       loop,
+                       "Unknown attribute, expected '@parallel'"
+        )) {
+            return true;
+        }
+        SkipCurrentToken();
+
+        if (not Expect(CurrentToken().type == TokenType::KW_loop, loop, "Expected loop after '@parallel'")) {
+            return true;
+        }
+    }
     SkipCurrentToken();
 
     if (CurrentToken().type == TokenType::Identifier
@@ -419,7 +491,17 @@ bool Parser::MatchedLoop(ParseNode& node) {
         AddTokensTo(loop, TokenType::Op_Colon);
     }
 
-    Expect(MatchedLoopBody(loop), loop, "Expected loop body");
+    if (not Expect(MatchedLoopBody(loop), loop, "Expected loop body") || not is_parallel) {
+        return true;
+    }
+
+    // the counter being the only token rules out labels and 'mut' alike
+    if (Expect(loop.rule == Rule::LoopRange && loop.TokenCount() == 1,
+               loop,
+               "Only unlabeled ranged loops with an immutable counter can be parallel"
+    )) {
+        loop.rule = Rule::LoopRangeParallel;
+    }
 
     return true;
 }
@@ -457,8 +539,8 @@ bool Parser::MatchedLoopBody(ParseNode& node) {
         // loop x {}
         node.rule = Rule::LoopFixed;
 
-        Expect(node.branches[0]->rule != Rule::Unary
-               && node.branches[0]->tokens[0].type != TokenType::Op_Minus,
+        Expect(node.Branch(0).rule != Rule::Unary
+               && node.Branch(0).TokenAt(0).type != TokenType::Op_Minus,
                node,
                "Negative fixed loops lead to unexpected behaviour"
         );
@@ -543,6 +625,10 @@ bool IsPrimitiveKeyword(const TokenType token) {
     case KW_string:
     case KW_isize:
     case KW_usize:
+    case KW_vec2:
+    case KW_vec3:
+    case KW_vec4:
+    case KW_vec2i:
     case Lit_none: // 'none' is a literal as well as a type
         return true;
     default:
@@ -656,6 +742,19 @@ bool Parser::MatchedReturn(ParseNode& node) {
     return true;
 }
 
+// yield = KW_YIELD
+bool Parser::MatchedYield(ParseNode& node) {
+    if (CurrentToken().type != TokenType::KW_yield) {
+        return false;
+    }
+
+    // the keyword is kept so the statement has a source location
+    auto& yield = node.NewBranch(Rule::Yield);
+    AddCycledTokenTo(yield);
+
+    return true;
+}
+
 // invocation = ID '(' (expr (',' expr)*)? ')'
 bool Parser::MatchedInvocation(ParseNode& node) {
     if (CurrentToken().type != TokenType::Identifier || PeekNextToken().type != TokenType::Op_ParenLeft) {
@@ -714,12 +813,37 @@ bool Parser::MatchedDataDeclaration(ParseNode& node) {
     if (is_annotated) {
         AddCycledTokenTo(decl);
 
+        // data x: [i32]
+        const bool is_list = CurrentToken().type == TokenType::Op_BracketLeft;
+        if (is_list) {
+            AddCycledTokenTo(decl);
+        }
+
         if (Expect(IsType(CurrentToken().type),
                    decl,
                    "Expected type"
         )) {
             AddCycledTokenTo(decl);
         }
+
+        // data x: [string: i32]
+        if (is_list && CurrentToken().type == TokenType::Op_Colon) {
+            AddCycledTokenTo(decl);
+
+            if (Expect(IsType(CurrentToken().type),
+                       decl,
+                       "Expected map value type"
+            )) {
+                AddCycledTokenTo(decl);
+            }
+        }
+
+        if (is_list && Expect(CurrentToken().type == TokenType::Op_BracketRight,
+                              decl,
+                              "Expected ']'"
+        )) {
+            AddCycledTokenTo(decl);
+        }
     }
 
     // data x: i32;
@@ -756,12 +880,16 @@ bool IsCompoundAssignment(const TokenType op) {
            || op == TokenType::Op_ModAssign;
 }
 
-// assign = ID '=' expr
+// assign = ID ('[' expr ']')? '=' expr
 bool Parser::MatchedAssignment(ParseNode& node) {
     if (CurrentToken().type != TokenType::Identifier) {
         return false;
     }
 
+    if (PeekNextToken().type == TokenType::Op_BracketLeft) {
+        return MatchedElementAssignment(node);
+    }
+
     const TokenType op = PeekNextToken().type;
     if (op != TokenType::Op_Assign && not IsCompoundAssignment(op)) {
         return false;
@@ -774,6 +902,31 @@ bool Parser::MatchedAssignment(ParseNode& node) {
     return true;
 }
 
+// an element access only turns out to be assigned to past its closing bracket,
+// so anything else rewinds, to be parsed as an expression instead
+bool Parser::MatchedElementAssignment(ParseNode& node) {
+    const auto start = cursor;
+
+    auto& assignment = node.NewBranch(Rule::ElementAssignment);
+    assignment.AddToken(cursor);
+    SkipTokens(2);
+
+    const bool has_index = MatchedExpression(assignment) && CurrentToken().type == TokenType::Op_BracketRight;
+    const TokenType op   = PeekNextToken().type;
+
+    if (not has_index || (op != TokenType::Op_Assign && not IsCompoundAssignment(op))) {
+        node.PopBranch();
+        cursor = start;
+        return false;
+    }
+
+    SkipCurrentToken();
+    AddCycledTokenTo(assignment);
+
+    Expect(MatchedExpression(assignment), assignment, "Expected expression");
+    return true;
+}
+
 // elem_list = expr (',' expr)* (',')?  ;
 bool Parser::MatchedElemList(ParseNode& node) {
     using enum TokenType;
@@ -804,7 +957,7 @@ bool Parser::MatchedElemList(ParseNode& node) {
     return true;
 }
 
-// array_literal = '[' elem_list? ']'   ;
+// array_literal = '[' (elem_list | ':')? ']'   ;
 bool Parser::MatchedArrayLiteral(ParseNode& node) {
     if (CurrentToken().type != TokenType::Op_BracketLeft) {
         return false;
@@ -822,6 +975,16 @@ bool Parser::MatchedArrayLiteral(ParseNode& node) {
         return true;
     }
 
+    // [:], the empty map
+    if (CurrentToken().type == TokenType::Op_Colon) {
+        AddCycledTokenTo(array_literal); // ':'
+
+        if (Expect(CurrentToken().type == TokenType::Op_BracketRight, array_literal, "Expected ']'")) {
+            AddCycledTokenTo(array_literal); // ']'
+        }
+        return true;
+    }
+
     if (not Expect(MatchedElemList(array_literal),
                    array_literal,
                    "Expected elem list"
@@ -862,7 +1025,7 @@ bool Parser::MatchedGrouping(ParseNode& node) {
         return true;
     }
 
-    if (not Expect(grouping.branches.size() == 1,
+    if (not Expect(grouping.BranchCount() == 1,
                    grouping,
                    "Grouping may not contain more than one expression"
     )) {
@@ -877,7 +1040,7 @@ bool Parser::MatchedGrouping(ParseNode& node) {
     }
 
     AddCycledTokenTo(grouping);
-    Expect(grouping.branches.size() == 1,
+    Expect(grouping.BranchCount() == 1,
            grouping,
            "Grouping may not contain more than one expression"
     );
@@ -967,7 +1130,7 @@ bool Parser::MatchedListAccess(ParseNode& node) {
     }
 
     auto& list_access {node.NewBranch(Rule::ListAccess)};
-    list_access.AcquireBranchOf(node, node.branches.size() - 2);
+    list_access.AcquireBranchOf(node, node.BranchCount() - 2);
 
     SkipCurrentToken();
 
@@ -979,150 +1142,121 @@ bool Parser::MatchedListAccess(ParseNode& node) {
     return true;
 }
 
-bool IsFactorOp(const TokenType token) {
-    switch (token) {
-        using enum TokenType;
+// binary operators bind tighter the higher their power, 0 means the token isn't one
+constexpr ml::u8 NO_BINDING  = 0;
+constexpr ml::u8 MAX_BINDING = 5;
 
-    case Op_FwdSlash:
-    case Op_Asterisk:
-    case Op_Modulo:
-        return true;
-    default:
-        return false;
-    }
-}
+constexpr auto BINDING_POWERS = [] {
+    using enum TokenType;
 
-bool IsTermOp(const TokenType token) {
-    switch (token) {
-        using enum TokenType;
+    std::array<ml::u8, magic_enum::enum_count<TokenType>()> powers {};
 
-    case Op_Minus:
-    case Op_Plus:
-        return true;
-    default:
-        return false;
-    }
-}
+    powers[static_cast<ml::u8>(Op_LogicalAnd)] = 1;
+    powers[static_cast<ml::u8>(Op_LogicalOr)]  = 1;
 
-bool IsComparisonOp(const TokenType token) {
-    switch (token) {
-        using enum TokenType;
+    powers[static_cast<ml::u8>(Op_Equality)] = 2;
+    powers[static_cast<ml::u8>(Op_NotEqual)] = 2;
 
-    case Op_GreaterThan:
-    case Op_GreaterEqual:
-    case Op_LessThan:
-    case Op_LessEqual:
-        return true;
-    default:
-        return false;
-    }
-}
+    powers[static_cast<ml::u8>(Op_GreaterThan)]  = 3;
+    powers[static_cast<ml::u8>(Op_GreaterEqual)] = 3;
+    powers[static_cast<ml::u8>(Op_LessThan)]     = 3;
+    powers[static_cast<ml::u8>(Op_LessEqual)]    = 3;
 
-bool IsEqualityOp(const TokenType token) {
-    switch (token) {
-        using enum TokenType;
+    powers[static_cast<ml::u8>(Op_Minus)] = 4;
+    powers[static_cast<ml::u8>(Op_Plus)]  = 4;
 
-    case Op_Equality:
-    case Op_NotEqual:
-        return true;
-    default:
-        return false;
-    }
-}
+    powers[static_cast<ml::u8>(Op_FwdSlash)] = 5;
+    powers[static_cast<ml::u8>(Op_Asterisk)] = 5;
+    powers[static_cast<ml::u8>(Op_Modulo)]   = 5;
 
-bool IsLogicalOp(const TokenType token) {
-    switch (token) {
-        using enum TokenType;
-
-    case Op_LogicalAnd:
-    case Op_LogicalOr:
-        return true;
-    default:
-        return false;
-    }
-}
+    return powers;
+}();
 
-// expr = logical
-bool Parser::MatchedExpression(ParseNode& node) {
-    return MatchedLogical(node);
-}
+// indexed by binding power
+constexpr std::array BINARY_RULES = {
+    Rule::Undefined,
+    Rule::Logical,
+    Rule::Equality,
+    Rule::Comparison,
+    Rule::Term,
+    Rule::Factor,
+};
 
-// logical = equality ( ('&&' | '||') equality )*
-bool Parser::MatchedLogical(ParseNode& node) {
-    return MatchedBinaryExpr(node, IsLogicalOp, &Parser::MatchedEquality, Rule::Logical);
+ml::u8 BindingPower(const TokenType token) {
+    return BINDING_POWERS[static_cast<ml::u8>(token)];
 }
 
+// expr     = logical
+// logical  = equality ( ('&&' | '||') equality )*
 // equality = comparison (  ('!=' | '==') comparison)*
-bool Parser::MatchedEquality(ParseNode& node) {
-    return MatchedBinaryExpr(node, IsEqualityOp, &Parser::MatchedComparison, Rule::Equality);
-}
-
 // comparison = term ( ('>' | '>=' | '<' | '<=') term)*
-bool Parser::MatchedComparison(ParseNode& node) {
-    return MatchedBinaryExpr(node, IsComparisonOp, &Parser::MatchedTerm, Rule::Comparison);
-}
-
-// term = factor ( ('-' | '+') factor)*
-bool Parser::MatchedTerm(ParseNode& node) {
-    return MatchedBinaryExpr(node, IsTermOp, &Parser::MatchedFactor, Rule::Term);
-}
-
-// factor = unary ( ('/' | '*') unary )*
-bool Parser::MatchedFactor(ParseNode& node) {
-    return MatchedBinaryExpr(node, IsFactorOp, &Parser::MatchedUnary, Rule::Factor);
+// term     = factor ( ('-' | '+') factor)*
+// factor   = unary ( ('/' | '*' | '%') unary )*
+bool Parser::MatchedExpression(ParseNode& node) {
+    return MatchedBinaryExpr(node, NO_BINDING + 1);
 }
 
-bool Parser::MatchedBinaryExpr(ParseNode& node,
-                               const OpCheckerFnPtr is_valid_operator,
-                               const MatcherFnPtr matched_operand,
-                               const Rule rule
-) {
-    if (not(this->*matched_operand)(node)) {
+// operators of the same power are chained into a single node, e.g. 'a + b - c' has three operands
+bool Parser::MatchedBinaryExpr(ParseNode& node, const ml::u8 min_power) {
+    if (not MatchedUnary(node)) {
         return false;
     }
 
     // by this point, we've already created a fresh primary node,
     // so from here on out we don't want to return false and risk destroing AST progress
     // or double parsing
-    if (not is_valid_operator(CurrentToken().type)) {
-        return true; // if there's no operator following, this is just a primary
-    }
 
-    auto& binary_expr = node.NewBranch(rule);
-    AddCycledTokenTo(binary_expr);
+    // each power is handled at most once, and tighter operators have already been consumed by the operands,
+    // so only looser ones can follow
+    ml::u8 ceiling = MAX_BINDING + 1;
 
-    // LHS matched, so we need to make it a child of this expr
-    const auto lhs_index = node.branches.size() - 2;
-    binary_expr.AcquireBranchOf(node, lhs_index);
+    while (true) {
+        const auto power = BindingPower(CurrentToken().type);
+        if (power < min_power || power >= ceiling) {
+            return true; // if there's no operator following, this is just a primary
+        }
+        ceiling = power;
 
-    // we need to store the index early, as branches may be acquired before we add the rhs
-    const auto rhs_index = node.branches.size() - 1;
+        auto& binary_expr = node.NewBranch(BINARY_RULES[power]);
+        AddCycledTokenTo(binary_expr);
 
-    if (not Expect((this->*matched_operand)(node),
-                   binary_expr,
-                   "Expected expression"
-    )) {
-        return true;
-    }
+        // LHS matched, so we need to make it a child of this expr
+        binary_expr.AcquireBranchOf(node, node.BranchCount() - 2);
 
-    while (is_valid_operator(CurrentToken().type)) {
-        AddCycledTokenTo(binary_expr);
+        // operands are matched into the parent and only acquired once they've all been found,
+        // so a malformed expression leaves its partial operands where they were
+        const auto rhs_index = node.BranchCount() - 1;
 
-        if (not Expect((this->*matched_operand)(node),
+        if (not Expect(MatchedBinaryExpr(node, power + 1),
                        binary_expr,
                        "Expected expression"
         )) {
-            return true;
+            continue;
         }
-    }
 
-    binary_expr.AcquireBranchesOf(node, rhs_index + 1);
+        bool matched_operands = true;
+        while (BindingPower(CurrentToken().type) == power) {
+            AddCycledTokenTo(binary_expr);
 
-    Expect(binary_expr.branches.size() >= 2,
-           binary_expr,
-           "Expected more operands in binary expression"
-    );
+            if (not Expect(MatchedBinaryExpr(node, power + 1),
+                           binary_expr,
+                           "Expected expression"
+            )) {
+                matched_operands = false;
+                break;
+            }
+        }
 
-    return true;
+        if (not matched_operands) {
+            continue;
+        }
+
+        binary_expr.AcquireBranchesOf(node, rhs_index + 1);
+
+        Expect(binary_expr.BranchCount() >= 2,
+               binary_expr,
+               "Expected more operands in binary expression"
+        );
+    }
 }
 } // namespace sigil
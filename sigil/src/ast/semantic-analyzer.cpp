@@ -1,7 +1,10 @@
 #include <sigil/ast/semantic-analyzer.hpp>
 #include <sigil/ast/keywords.hpp>
+#include <sigil/ast/lexer.hpp>
 #include <sigil/ast/syntax-tree.hpp>
 
+#include <algorithm>
+#include <optional>
 #include <ranges>
 
 #include <hexe/value.hpp>
@@ -13,31 +16,123 @@ using enum PrimitiveType;
 
 constexpr auto TB_ERROR = "_TYPEBUFFER_ERROR_";
 
-bool IsSignedIntegral(const std::string_view type) {
-    return type == PrimitiveName(I8)
-           || type == PrimitiveName(I16)
-           || type == PrimitiveName(I32)
-           || type == PrimitiveName(I64);
+// primitive IDs follow PrimitiveType, so each family is a range
+bool IsSignedIntegral(const NameID type) {
+    return type >= PrimitiveID(I8) && type <= PrimitiveID(I64);
 }
 
-bool IsUnsignedIntegral(const std::string_view type) {
-    return type == PrimitiveName(U8)
-           || type == PrimitiveName(U16)
-           || type == PrimitiveName(U32)
-           || type == PrimitiveName(U64);
+bool IsUnsignedIntegral(const NameID type) {
+    return type >= PrimitiveID(U8) && type <= PrimitiveID(U64);
 }
 
-bool IsFloatPrimitive(const std::string_view type) {
-    return type == PrimitiveName(F32) || type == PrimitiveName(F64);
+bool IsFloatPrimitive(const NameID type) {
+    return type == PrimitiveID(F32) || type == PrimitiveID(F64);
 }
 
-bool IsIntegral(const std::string_view type) {
+bool IsIntegral(const NameID type) {
     return IsSignedIntegral(type) || IsUnsignedIntegral(type);
 }
 
+bool IsVectorPrimitive(const NameID type) {
+    return type >= PrimitiveID(Vec2) && type <= PrimitiveID(Vec2i);
+}
+
+// what indexing into a vector gives back, as well as what it's scaled by
+NameID LaneType(const NameID vector) {
+    return vector == PrimitiveID(Vec2i) ? PrimitiveID(I32) : PrimitiveID(F32);
+}
+
+i64 LaneCount(const NameID vector) {
+    if (vector == PrimitiveID(Vec3)) {
+        return 3;
+    }
+    if (vector == PrimitiveID(Vec4)) {
+        return 4;
+    }
+    return 2;
+}
+
+// integer literals, negated or not, are the only indices known before the program runs
+std::optional<i64> ConstantIndex(const FlatTree& tree, const NodeId index) {
+    if (tree.Kind(index) == NodeKind::LiteralInt) {
+        return tree.Int(index);
+    }
+
+    if (tree.Kind(index) == NodeKind::Unary && tree.Operator(index) == TokenType::Op_Minus
+        && tree.Kind(tree.Child(index, 0)) == NodeKind::LiteralInt) {
+        return -tree.Int(tree.Child(index, 0));
+    }
+    return std::nullopt;
+}
+
+hexe::Value::Data::Type ConvertPrimitive(const NameID type) {
+    using enum hexe::Value::Data::Type;
+    if (IsSignedIntegral(type)) {
+        return Int64;
+    }
+
+    if (IsUnsignedIntegral(type)) {
+        return Uint64;
+    }
+
+    if (IsFloatPrimitive(type)) {
+        return Float64;
+    }
+
+    if (type == PrimitiveID(PrimitiveType::Bool)) {
+        return Bool;
+    }
+
+    if (type == PrimitiveID(PrimitiveType::String)) {
+        return String;
+    }
+
+    if (IsVectorPrimitive(type)) {
+        constexpr auto first = static_cast<u8>(Vec2);
+        return static_cast<hexe::Value::Data::Type>(first + type - PrimitiveID(PrimitiveType::Vec2));
+    }
+
+    return Invalid;
+}
+
+// how list elements of 'type' are stored, the narrow ones being packed
+hexe::Value::Data::Type ConvertElement(const NameID type) {
+    using enum hexe::Value::Data::Type;
+    switch (type) {
+    case PrimitiveID(I8):
+        return Int8;
+    case PrimitiveID(I16):
+        return Int16;
+    case PrimitiveID(I32):
+        return Int32;
+    case PrimitiveID(U8):
+        return Uint8;
+    case PrimitiveID(U16):
+        return Uint16;
+    case PrimitiveID(U32):
+        return Uint32;
+    case PrimitiveID(F32):
+        return Float32;
+    case PrimitiveID(PrimitiveType::Bool):
+        return Bits;
+    default:
+        return ConvertPrimitive(type);
+    }
+}
+
 SemanticAnalyzer::SemanticAnalyzer()
-    : issue_counter {0},
-      current_scope {GLOBAL_SCOPE} {
+    : type_buffer {NO_NAME, NO_NAME},
+      type_buffer_error {Names().Intern(TB_ERROR)},
+      dot_name {Names().Intern("Dot")},
+      cross_name {Names().Intern("Cross")},
+      length_name {Names().Intern("Length")},
+      normalize_name {Names().Intern("Normalize")},
+      empty_map_name {Names().Intern("[:]")},
+      issue_counter {0},
+      loop_depth {0},
+      parallel_floor {NOT_PARALLEL},
+      parallel_loop_depth {0},
+      tree {nullptr} {
     RegisterPrimitives();
     RegisterBuiltins();
 }
@@ -46,21 +141,25 @@ i32 SemanticAnalyzer::IssueCount() const {
     return issue_counter;
 }
 
-const SymbolTable& SemanticAnalyzer::Globals() const {
-    return globals;
+std::span<const SymbolTable::Binding> SemanticAnalyzer::Globals() const {
+    return symbols.Bindings();
 }
 
 const TypeTable& SemanticAnalyzer::Types() const {
     return types;
 }
 
-void SemanticAnalyzer::Visit(const Artifact& artifact) {
-    RecordFunctionDeclarations(artifact);
+void SemanticAnalyzer::Analyze(FlatTree& flat_tree) {
+    tree = &flat_tree;
+
+    RecordFunctionDeclarations();
 
-    for (const auto& declaration : artifact.GetChildren()) {
-        declaration->Accept(*this);
+    for (const auto declaration : tree->Declarations()) {
+        Analyze(declaration);
     }
 
+    tree = nullptr;
+
     const bool lacks_main = std::ranges::none_of(GetFnTable(),
                                                  [](const auto& kv) {
                                                      return IsEntryPoint(kv.first);
@@ -73,54 +172,138 @@ void SemanticAnalyzer::Visit(const Artifact& artifact) {
     }
 }
 
-void SemanticAnalyzer::Visit(const Scope& node) {
-    ++current_scope;
-
-    for (const auto& statement : node.GetStatements()) {
-        statement->Accept(*this);
+void SemanticAnalyzer::Analyze(const NodeId node) {
+    using enum NodeKind;
+
+    switch (tree->Kind(node)) {
+    case Scope:
+        AnalyzeScope(node);
+        break;
+    case FunctionDeclaration:
+        AnalyzeFunctionDeclaration(node);
+        break;
+    case DataDeclaration:
+        HandleInitializer(node, false);
+        break;
+    case MutableDataDeclaration:
+        HandleInitializer(node, true);
+        break;
+    case Identifier:
+        AnalyzeIdentifier(node);
+        break;
+    case Assignment:
+        AnalyzeAssignment(node);
+        break;
+    case ElementAssignment:
+        AnalyzeElementAssignment(node);
+        break;
+    case Return:
+        AnalyzeReturn(node);
+        break;
+    // only fibers suspend, anywhere else it does nothing
+    case Yield:
+        if (InParallelLoop()) {
+            Log->error("Cannot yield from within a parallel loop");
+            ++issue_counter;
+        }
+        break;
+    case Invocation:
+        AnalyzeInvocation(node);
+        break;
+    case If:
+        AnalyzeIf(node);
+        break;
+    case Loop:
+        AnalyzeLoop(node);
+        break;
+    case LoopIf:
+        AnalyzeLoopIf(node);
+        break;
+    case LoopIfPost:
+        AnalyzeLoopIfPost(node);
+        break;
+    case LoopFixed:
+        AnalyzeLoopFixed(node);
+        break;
+    case LoopRange:
+        HandleRangedLoop(node, false);
+        break;
+    // only codegen cares about the difference
+    case LoopRangeMutable:
+        HandleRangedLoop(node, true);
+        break;
+    case LoopRangeParallel:
+        HandleRangedLoop(node, false);
+        break;
+    case Break:
+        AnalyzeLoopControl(node, "Break");
+        break;
+    case Skip:
+        AnalyzeLoopControl(node, "Skip");
+        break;
+    case Unary:
+        AnalyzeUnary(node);
+        break;
+    case Binary:
+        AnalyzeBinary(node);
+        break;
+    case List:
+        AnalyzeList(node);
+        break;
+    case Map:
+        BufferType(empty_map_name);
+        break;
+    case ListAccess:
+        AnalyzeListAccess(node);
+        break;
+    case LiteralBool:
+        BufferType(PrimitiveID(Bool));
+        break;
+    case LiteralInt:
+        BufferType(PrimitiveID(I64));
+        break;
+    case LiteralFloat:
+        BufferType(PrimitiveID(F64));
+        break;
+    case LiteralString:
+        BufferType(PrimitiveID(String));
+        break;
     }
+}
 
-    if (current_scope == CurrentFunction().scope) {
-        function_stack.pop_back();
-    }
+void SemanticAnalyzer::AnalyzeScope(const NodeId node) {
+    symbols.EnterScope();
+    AnalyzeStatements(node);
+    symbols.ExitScope();
+}
 
-    if (current_scope == GLOBAL_SCOPE) {
-        Log->error("Internal Compiler Error: Attempted to exit global scope");
-        return;
+void SemanticAnalyzer::AnalyzeStatements(const NodeId node) {
+    for (const auto statement : tree->Children(node)) {
+        Analyze(statement);
     }
-    --current_scope;
 }
 
-void SemanticAnalyzer::Visit(const FunctionDeclaration& node) {
-    const auto name = node.GetName();
-    function_stack.push_back(name);
+void SemanticAnalyzer::AnalyzeFunctionDeclaration(const NodeId node) {
+    function_stack.push_back(tree->Function(node).name);
 
-    auto& function = GetFnTable()[name];
-    function.scope = current_scope + 1;
-
-    for (const auto& param : node.GetParameters()) {
-        auto& local = function.locals[param.name];
-
-        local.scope      = function.scope;
-        local.mutability = Mutability::Immutable;
+    // parameters get a scope of their own, around the body's
+    symbols.EnterScope();
+    for (const auto& param : tree->Parameters(node)) {
+        symbols.Add(param.name, {param.type, Mutability::Immutable});
     }
 
-    node.GetBody()->Accept(*this);
-}
-
-void SemanticAnalyzer::Visit(const MutableDataDeclaration& node) {
-    HandleInitializer(node, true);
-}
+    Analyze(tree->Child(node, 0));
 
-void SemanticAnalyzer::Visit(const DataDeclaration& node) {
-    HandleInitializer(node, false);
+    symbols.ExitScope();
+    function_stack.pop_back();
 }
 
-void SemanticAnalyzer::Visit(const Identifier& node) {
-    const auto* symbol = GetSymbol(node.GetName());
+void SemanticAnalyzer::AnalyzeIdentifier(const NodeId node) {
+    const auto name    = tree->Name(node);
+    const auto* symbol = GetSymbol(name);
 
     if (symbol == nullptr) {
-        Log->error("Undefined identifier '{}'", node.GetName());
+        Log->error("Undefined identifier '{}'", Names().Name(name));
         ++issue_counter;
         return;
     }
@@ -129,56 +312,150 @@ void SemanticAnalyzer::Visit(const Identifier& node) {
     BufferType(symbol->type);
 }
 
-void SemanticAnalyzer::Visit(const Assignment& node) {
-    const auto identifier = node.GetIdentifier();
+void SemanticAnalyzer::AnalyzeAssignment(const NodeId node) {
+    const auto identifier = tree->Name(node);
     const auto* symbol    = GetSymbol(identifier);
 
     if (symbol == nullptr) {
-        Log->error("Attempt to assign to undefined name '{}'", identifier);
+        Log->error("Attempt to assign to undefined name '{}'", Names().Name(identifier));
         ++issue_counter;
     } else if (symbol->mutability != Mutability::Mutable) {
-        Log->error("Attempt to assign to immutable binding '{}'", identifier);
+        Log->error("Attempt to assign to immutable binding '{}'", Names().Name(identifier));
+        ++issue_counter;
+    } else if (IsSharedByIterations(identifier)) {
+        Log->error("Attempt to assign to '{}', which every iteration of the parallel loop shares",
+                   Names().Name(identifier)
+        );
         ++issue_counter;
     }
 
-    node.GetValue()->Accept(*this);
+    Analyze(tree->Child(node, 0));
 
-    const auto expr_type = PopTypeBuffer();
-    if (symbol != nullptr && not TypesMatch(expr_type, symbol->type)) {
-        Log->error("Assignment type mismatch: expected '{}', got '{}'", symbol->type, expr_type);
+    auto expr_type = PopTypeBuffer();
+    const auto op  = tree->Operator(node);
+
+    // 'm = [:]' empties the map
+    if (symbol != nullptr && tree->Kind(tree->Child(node, 0)) == NodeKind::Map) {
+        expr_type = AnnotateMap(tree->Child(node, 0), symbol->type);
+    }
+
+    // 'xs += ys' would run the operator on the whole list or map
+    if (symbol != nullptr && op != TokenType::Op_Assign && not OperatorApplies(symbol->type)) {
+        return;
+    }
+
+    // 'v += w' and 'v *= s' are vector arithmetic as well
+    if (symbol != nullptr && IsVectorPrimitive(symbol->type) && op != TokenType::Op_Assign) {
+        AnalyzeVectorOperator(node, op, symbol->type, expr_type);
+    } else if (symbol != nullptr && not TypesMatch(expr_type, symbol->type)) {
+        Log->error("Assignment type mismatch: expected '{}', got '{}'",
+                   Names().Name(symbol->type),
+                   Names().Name(expr_type)
+        );
         ++issue_counter;
     }
     PreventAssignmentWithNone(expr_type);
 }
 
-void SemanticAnalyzer::Visit(const Return& node) {
-    node.GetExpression()->Accept(*this);
-    const auto type = PopTypeBuffer();
+void SemanticAnalyzer::AnalyzeElementAssignment(const NodeId node) {
+    const auto identifier = tree->Name(node);
+    const auto* symbol    = GetSymbol(identifier);
+
+    NameID element_type = NO_NAME;
+
+    if (symbol == nullptr) {
+        Log->error("Attempt to assign to element of undefined name '{}'", Names().Name(identifier));
+        ++issue_counter;
+    } else if (element_type = ElementType(symbol->type); element_type == NO_NAME) {
+        Log->error("Attempt to assign to element of '{}', which isn't a list", Names().Name(identifier));
+        ++issue_counter;
+    } else if (symbol->mutability != Mutability::Mutable) {
+        Log->error("Attempt to assign to element of immutable binding '{}'", Names().Name(identifier));
+        ++issue_counter;
+    }
+
+    if (element_type != NO_NAME) {
+        tree->SetOperandTypes(node, ConvertElement(element_type));
+    }
+
+    const auto index = tree->Child(node, 0);
+    Analyze(index);
+
+    if (not IsIntegral(PopTypeBuffer())) {
+        Log->error("List index must be of integral type");
+        ++issue_counter;
+    }
+
+    // iterations only ever touch an element of their own, so they can't race each other
+    const bool indexed_by_counter = tree->Kind(index) == NodeKind::Identifier
+                                    && symbols.Position(tree->Name(index)) == parallel_floor;
+
+    if (IsSharedByIterations(identifier) && not indexed_by_counter) {
+        Log->error("Parallel loops may only assign to elements of '{}' at the loop's counter",
+                   Names().Name(identifier)
+        );
+        ++issue_counter;
+    } else if (IsSharedByIterations(identifier) && element_type == PrimitiveID(Bool)) {
+        // eight bools share a byte, so even iterations writing their own would race
+        Log->error("Parallel loops cannot assign to elements of '{}', as its bools are packed into bits",
+                   Names().Name(identifier)
+        );
+        ++issue_counter;
+    }
+
+    Analyze(tree->Child(node, 1));
+
+    const auto expr_type = PopTypeBuffer();
+    if (element_type != NO_NAME && not TypesMatch(expr_type, element_type)) {
+        Log->error("Element assignment type mismatch: expected '{}', got '{}'",
+                   Names().Name(element_type),
+                   Names().Name(expr_type)
+        );
+        ++issue_counter;
+    }
+}
+
+void SemanticAnalyzer::AnalyzeReturn(const NodeId node) {
+    if (InParallelLoop()) {
+        Log->error("Cannot return from within a parallel loop");
+        ++issue_counter;
+    }
+
+    // a bare 'return' is the same as 'return none'
+    const bool has_expr = tree->ChildCount(node) != 0;
+    if (has_expr) {
+        Analyze(tree->Child(node, 0));
+    }
+    const auto type = has_expr ? PopTypeBuffer() : PrimitiveID(None);
 
     if (not TypesMatch(CurrentFunction().return_type, type)) {
         Log->error("Return type mismatch: Attempted to return '{1}' out of function with return type '{0}'",
-                   CurrentFunction().return_type,
-                   type
+                   Names().Name(CurrentFunction().return_type),
+                   Names().Name(type)
         );
         ++issue_counter;
     }
 }
 
-void SemanticAnalyzer::Visit(const Invocation& node) {
+void SemanticAnalyzer::AnalyzeInvocation(const NodeId node) {
     const auto& functions = GetFnTable();
-    const auto name       = node.GetIdentifier();
+    const auto name       = tree->Name(node);
 
     if (not functions.contains(name)) {
-        Log->error("Undefined identifier: No invocator exists with name '{}'", name);
+        Log->error("Undefined identifier: No invocator exists with name '{}'", Names().Name(name));
         ++issue_counter;
         return;
     }
 
-    const auto& fn   = functions.at(name);
-    const auto& args = node.GetArguments();
+    const auto& fn  = functions.at(name);
+    const auto args = tree->Children(node);
 
     if (fn.param_count != args.size()) {
-        Log->error("Function '{}' expects {} arguments, but {} were provided", name, fn.param_count, args.size());
+        Log->error("Function '{}' expects {} arguments, but {} were provided",
+                   Names().Name(name),
+                   fn.param_count,
+                   args.size()
+        );
         ++issue_counter;
 
         // still wanna buffer the function's type so errors don't propagate to silly places
@@ -186,59 +463,305 @@ void SemanticAnalyzer::Visit(const Invocation& node) {
         return;
     }
 
-    // params are recorded in reverse order to resolve their types in comma sequences e.g. 'a, b: T'
-    i64 i = 0;
-    for (const auto& local : fn.locals | std::views::values) {
-        if (not local.is_param) {
-            continue;
-        }
+    if (name == dot_name || name == cross_name || name == length_name || name == normalize_name) {
+        AnalyzeVectorMath(node);
+        return;
+    }
+
+    if (list_builtins.contains(name)) {
+        AnalyzeListBuiltin(node);
+        return;
+    }
+
+    if (map_builtins.contains(name)) {
+        AnalyzeMapBuiltin(node);
+        return;
+    }
 
-        args[i]->Accept(*this);
-        ++i;
+    for (i64 i = 0; i < fn.param_types.size(); ++i) {
+        Analyze(args[i]);
 
         const auto arg_type = PopTypeBuffer();
-        if (not TypesMatch(arg_type, local.type)) {
-            Log->error("Argument type mismatch: expected '{}', got '{}'", local.type, arg_type);
+        if (not TypesMatch(arg_type, fn.param_types[i])) {
+            Log->error("Argument type mismatch: expected '{}', got '{}'",
+                       Names().Name(fn.param_types[i]),
+                       Names().Name(arg_type)
+            );
             ++issue_counter;
         }
     }
 
+    // arguments of any type, such as PrintV's value, still get analyzed for what they contain
+    for (i64 i = fn.param_types.size(); i < args.size(); ++i) {
+        Analyze(args[i]);
+        PopTypeBuffer();
+    }
+
     BufferType(fn.return_type);
 }
 
-void SemanticAnalyzer::Visit(const If& node) {
-    node.GetCondition()->Accept(*this);
-    node.GetThenBlock()->Accept(*this);
+void SemanticAnalyzer::AnalyzeVectorMath(const NodeId node) {
+    const auto name = tree->Name(node);
+    const auto args = tree->Children(node);
+
+    Analyze(args[0]);
+    const auto vector = PopTypeBuffer();
+
+    // Dot and Cross take a second vector, which has to be of the same type
+    if (args.size() == 2) {
+        Analyze(args[1]);
+
+        const auto other = PopTypeBuffer();
+        if (IsVectorPrimitive(vector) && other != vector) {
+            Log->error("Argument type mismatch: expected '{}', got '{}'", Names().Name(vector), Names().Name(other));
+            ++issue_counter;
+        }
+    }
+
+    if (not IsVectorPrimitive(vector)) {
+        Log->error("Function '{}' expects a vector, got '{}'", Names().Name(name), Names().Name(vector));
+        ++issue_counter;
+    } else if (name == cross_name && vector != PrimitiveID(Vec3)) {
+        Log->error("Function 'Cross' is only defined for 'vec3', got '{}'", Names().Name(vector));
+        ++issue_counter;
+    } else if ((name == length_name || name == normalize_name) && vector == PrimitiveID(Vec2i)) {
+        Log->error("Function '{}' is not defined for 'vec2i'", Names().Name(name));
+        ++issue_counter;
+    }
 
-    if (const auto& else_branch = node.GetElseBranch()) {
-        else_branch->Accept(*this);
+    if (name == dot_name) {
+        BufferType(LaneType(vector));
+    } else if (name == length_name) {
+        BufferType(PrimitiveID(F32));
+    } else {
+        BufferType(name == cross_name ? PrimitiveID(Vec3) : vector);
     }
 }
 
-void SemanticAnalyzer::Visit(const Loop& node) {
+void SemanticAnalyzer::AnalyzeListBuiltin(const NodeId node) {
+    using enum ListBuiltin;
+
+    const auto name    = tree->Name(node);
+    const auto builtin = list_builtins.at(name);
+    const auto args    = tree->Children(node);
+
+    Analyze(args[0]);
+    const auto list_type    = PopTypeBuffer();
+    const auto element_type = ElementType(list_type);
+
+    std::array<NameID, 2> arg_types {NO_NAME, NO_NAME};
+    for (i64 i = 1; i < args.size(); ++i) {
+        Analyze(args[i]);
+        arg_types[i - 1] = PopTypeBuffer();
+    }
+
+    const bool numeric    = IsIntegral(element_type) || IsFloatPrimitive(element_type);
+    const bool in_place   = builtin == Fill || builtin == Copy || builtin == Sort;
+    const bool needs_math = builtin == Sum || builtin == Min || builtin == Max || builtin == Sort
+                            || builtin == Add || builtin == Mul;
+
+    if (element_type == NO_NAME) {
+        Log->error("Function '{}' expects a list, got '{}'", Names().Name(name), Names().Name(list_type));
+        ++issue_counter;
+    } else if (needs_math && not numeric) {
+        Log->error("Function '{}' expects a list of numbers, got '{}'", Names().Name(name), Names().Name(list_type));
+        ++issue_counter;
+    } else if (not numeric && element_type != PrimitiveID(Bool)) {
+        // strings own their buffers, which a bulk copy would end up sharing
+        Log->error("Function '{}' expects a list of numbers or bools, got '{}'",
+                   Names().Name(name),
+                   Names().Name(list_type)
+        );
+        ++issue_counter;
+    }
+
+    if (in_place) {
+        RequireModifiableBinding(args[0], name);
+    }
+
+    switch (builtin) {
+    case Fill:
+    case Find: {
+        // integer literals fit lists of any integral type, as they do in list literals
+        const bool int_literal = IsIntegral(element_type) && tree->Kind(args[1]) == NodeKind::LiteralInt;
+        if (element_type != NO_NAME && not int_literal && not TypesMatch(arg_types[0], element_type)) {
+            Log->error("Argument type mismatch: expected '{}', got '{}'",
+                       Names().Name(element_type),
+                       Names().Name(arg_types[0])
+            );
+            ++issue_counter;
+        }
+        break;
+    }
+    case Copy:
+    case Add:
+    case Mul:
+        if (arg_types[0] != list_type) {
+            Log->error("Argument type mismatch: expected '{}', got '{}'",
+                       Names().Name(list_type),
+                       Names().Name(arg_types[0])
+            );
+            ++issue_counter;
+        }
+        break;
+    case Slice:
+        if (not IsIntegral(arg_types[0]) || not IsIntegral(arg_types[1])) {
+            Log->error("Slice bounds must be of integral type");
+            ++issue_counter;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (builtin) {
+    case Fill:
+    case Copy:
+    case Sort:
+        BufferType(PrimitiveID(None));
+        break;
+    case Sum:
+        // sums are taken at full width, so they don't overflow the element type
+        if (IsFloatPrimitive(element_type)) {
+            BufferType(PrimitiveID(F64));
+        } else {
+            BufferType(IsUnsignedIntegral(element_type) ? PrimitiveID(U64) : PrimitiveID(I64));
+        }
+        break;
+    case Min:
+    case Max:
+        BufferType(element_type != NO_NAME ? element_type : list_type);
+        break;
+    case Find:
+        BufferType(PrimitiveID(I64));
+        break;
+    default:
+        BufferType(list_type);
+        break;
+    }
+}
+
+void SemanticAnalyzer::AnalyzeMapBuiltin(const NodeId node) {
+    using enum MapBuiltin;
+
+    const auto name    = tree->Name(node);
+    const auto builtin = map_builtins.at(name);
+    const auto args    = tree->Children(node);
+
+    Analyze(args[0]);
+    const auto map_type   = PopTypeBuffer();
+    const auto key_type   = MapKeyType(map_type);
+    const auto value_type = MapValueType(map_type);
+
+    if (key_type == NO_NAME) {
+        Log->error("Function '{}' expects a map, got '{}'", Names().Name(name), Names().Name(map_type));
+        ++issue_counter;
+    }
+
+    if (builtin == Set || builtin == Remove) {
+        RequireModifiableBinding(args[0], name);
+    }
+
+    // integer literals fit keys and values of any integral type, as they do list elements
+    const auto expect = [&](const NodeId arg, const NameID expected) {
+        Analyze(arg);
+
+        const auto type        = PopTypeBuffer();
+        const bool int_literal = IsIntegral(expected) && tree->Kind(arg) == NodeKind::LiteralInt;
+        if (expected != NO_NAME && not int_literal && not TypesMatch(type, expected)) {
+            Log->error("Argument type mismatch: expected '{}', got '{}'", Names().Name(expected), Names().Name(type));
+            ++issue_counter;
+        }
+    };
+
+    switch (builtin) {
+    case Get:
+        expect(args[1], key_type);
+        expect(args[2], value_type);
+        BufferType(value_type != NO_NAME ? value_type : map_type);
+        break;
+    case Set:
+        expect(args[1], key_type);
+        expect(args[2], value_type);
+        BufferType(PrimitiveID(None));
+        break;
+    case Has:
+    case Remove:
+        expect(args[1], key_type);
+        BufferType(PrimitiveID(Bool));
+        break;
+    case Count:
+        BufferType(PrimitiveID(I64));
+        break;
+    case KeyAt:
+    case ValueAt: {
+        Analyze(args[1]);
+        if (not IsIntegral(PopTypeBuffer())) {
+            Log->error("Map index must be of integral type");
+            ++issue_counter;
+        }
+
+        const auto entry_type = builtin == KeyAt ? key_type : value_type;
+        BufferType(entry_type != NO_NAME ? entry_type : map_type);
+        break;
+    }
+    }
+}
+
+void SemanticAnalyzer::RequireModifiableBinding(const NodeId arg, const NameID function) {
+    const bool is_binding = tree->Kind(arg) == NodeKind::Identifier;
+    const auto* symbol    = is_binding ? GetSymbol(tree->Name(arg)) : nullptr;
+
+    if (not is_binding) {
+        Log->error("Function '{}' modifies what it's given, so it must be given a binding", Names().Name(function));
+        ++issue_counter;
+    } else if (symbol != nullptr && symbol->mutability != Mutability::Mutable) {
+        Log->error("Function '{}' cannot modify immutable binding '{}'",
+                   Names().Name(function),
+                   Names().Name(tree->Name(arg))
+        );
+        ++issue_counter;
+    } else if (IsSharedByIterations(tree->Name(arg))) {
+        Log->error("Function '{}' cannot modify '{}', which every iteration of the parallel loop shares",
+                   Names().Name(function),
+                   Names().Name(tree->Name(arg))
+        );
+        ++issue_counter;
+    }
+}
+
+void SemanticAnalyzer::AnalyzeIf(const NodeId node) {
+    // condition, then-block and the optional else branch, in that order
+    for (const auto part : tree->Children(node)) {
+        Analyze(part);
+    }
+}
+
+void SemanticAnalyzer::AnalyzeLoop(const NodeId node) {
     ++loop_depth;
-    node.GetBody()->Accept(*this);
+    Analyze(tree->Child(node, 0));
     --loop_depth;
 }
 
-void SemanticAnalyzer::Visit(const LoopIf& node) {
+void SemanticAnalyzer::AnalyzeLoopIf(const NodeId node) {
     ++loop_depth;
-    node.GetCondition()->Accept(*this);
-    node.GetBody()->Accept(*this);
+    Analyze(tree->Child(node, 0));
+    Analyze(tree->Child(node, 1));
     --loop_depth;
 }
 
-void SemanticAnalyzer::Visit(const LoopIfPost& node) {
+void SemanticAnalyzer::AnalyzeLoopIfPost(const NodeId node) {
+    // body comes first in the tree as well
     ++loop_depth;
-    node.GetBody()->Accept(*this);
-    node.GetCondition()->Accept(*this);
+    Analyze(tree->Child(node, 0));
+    Analyze(tree->Child(node, 1));
     --loop_depth;
 }
 
-void SemanticAnalyzer::Visit(const LoopFixed& node) {
+void SemanticAnalyzer::AnalyzeLoopFixed(const NodeId node) {
     ++loop_depth;
 
-    node.GetCountTarget()->Accept(*this);
+    Analyze(tree->Child(node, 0));
 
     const auto counter_type = PopTypeBuffer();
     if (not IsIntegral(counter_type)) {
@@ -246,100 +769,148 @@ void SemanticAnalyzer::Visit(const LoopFixed& node) {
         ++issue_counter;
     }
 
-    node.GetBody()->Accept(*this);
+    Analyze(tree->Child(node, 1));
 
     --loop_depth;
 }
 
-void SemanticAnalyzer::Visit(const LoopRange& node) {
-    HandleRangedLoop(node, false);
-}
-
-// only codegen cares about the difference
-void SemanticAnalyzer::Visit(const LoopRangeMutable& node) {
-    HandleRangedLoop(node, true);
-}
-
-void SemanticAnalyzer::Visit(const Break& node) {
+void SemanticAnalyzer::AnalyzeLoopControl(const NodeId node, const std::string_view name) {
     if (loop_depth == 0) {
-        Log->error("Break outside loop");
+        Log->error("{} outside loop", name);
         ++issue_counter;
         return;
     }
 
-    if (const auto& cond = node.GetCondition()) {
-        cond->Accept(*this);
-    }
-}
-
-void SemanticAnalyzer::Visit(const Skip& node) {
-    if (loop_depth == 0) {
-        Log->error("Skip outside loop");
+    // iterations of a parallel loop may run in any order, so none of them can end it early
+    // labels could name a loop outside of it, so they're out too
+    const bool leaves_parallel = tree->Kind(node) == NodeKind::Break && loop_depth == parallel_loop_depth;
+    if (InParallelLoop() && (leaves_parallel || tree->Name(node) != NO_NAME)) {
+        Log->error("{} cannot leave a parallel loop", name);
         ++issue_counter;
-        return;
     }
 
-    if (const auto& cond = node.GetCondition()) {
-        cond->Accept(*this);
+    if (tree->ChildCount(node) != 0) {
+        Analyze(tree->Child(node, 0));
     }
 }
 
-void SemanticAnalyzer::Visit(const UnaryExpr& node) {
-    const auto op = node.GetOp();
-    node.GetVal().Accept(*this);
+void SemanticAnalyzer::AnalyzeUnary(const NodeId node) {
+    const auto op = tree->Operator(node);
+    Analyze(tree->Child(node, 0));
     const auto val_type = PopTypeBuffer();
 
-    if (op == "!" && val_type != PrimitiveName(Bool)) {
+    if (not OperatorApplies(val_type)) {
+        BufferType(val_type);
+        return;
+    }
+
+    if (op == TokenType::Op_LogicalNot && val_type != PrimitiveID(Bool)) {
         Log->error("Attempted to negate non-boolean expression");
         ++issue_counter;
     }
-}
 
-void SemanticAnalyzer::Visit(const BinaryExpr& node) {
-    node.GetRight().Accept(*this);
-    node.GetLeft().Accept(*this);
+    // negating a vector scales it by -1
+    if (IsVectorPrimitive(val_type)) {
+        tree->SetOperandTypes(node, ConvertPrimitive(val_type));
+    }
+
+    BufferType(val_type);
 }
 
-hexe::Value::Data::Type ConvertPrimitive(const std::string_view type) {
-    using enum hexe::Value::Data::Type;
-    if (IsSignedIntegral(type)) {
-        return Int64;
+void SemanticAnalyzer::AnalyzeBinary(const NodeId node) {
+    Analyze(tree->Child(node, 1));
+    const auto rhs_type = PopTypeBuffer();
+
+    Analyze(tree->Child(node, 0));
+    const auto lhs_type = PopTypeBuffer();
+
+    if (not OperatorApplies(lhs_type) || not OperatorApplies(rhs_type)) {
+        BufferType(lhs_type);
+        return;
     }
 
-    if (IsUnsignedIntegral(type)) {
-        return Uint64;
+    if (IsVectorPrimitive(lhs_type) || IsVectorPrimitive(rhs_type)) {
+        BufferType(AnalyzeVectorOperator(node, tree->Operator(node), lhs_type, rhs_type));
+        return;
     }
 
-    if (IsFloatPrimitive(type)) {
-        return Float64;
+    BufferType(lhs_type);
+}
+
+bool SemanticAnalyzer::OperatorApplies(const NameID type) {
+    // the VM's operators only know scalars and vectors, lists and maps go through their builtins
+    if (ElementType(type) != NO_NAME) {
+        Log->error("Operators can't be applied to '{}', use the List builtins instead", Names().Name(type));
+        ++issue_counter;
+        return false;
     }
 
-    if (type == PrimitiveName(PrimitiveType::Bool)) {
-        return Bool;
+    if (type == empty_map_name || MapKeyType(type) != NO_NAME) {
+        Log->error("Operators can't be applied to '{}', use the Map builtins instead", Names().Name(type));
+        ++issue_counter;
+        return false;
     }
+    return true;
+}
 
-    if (type == PrimitiveName(PrimitiveType::String)) {
-        return String;
+NameID SemanticAnalyzer::AnalyzeVectorOperator(const NodeId node,
+                                               const TokenType op,
+                                               const NameID lhs_type,
+                                               const NameID rhs_type) {
+    const auto vector = IsVectorPrimitive(lhs_type) ? lhs_type : rhs_type;
+    const auto scalar = IsVectorPrimitive(lhs_type) ? rhs_type : lhs_type;
+
+    switch (op) {
+    case TokenType::Op_Plus:
+    case TokenType::Op_Minus:
+    case TokenType::Op_AddAssign:
+    case TokenType::Op_SubAssign:
+        if (lhs_type != rhs_type) {
+            Log->error("Vector arithmetic type mismatch: '{}' and '{}'", Names().Name(lhs_type), Names().Name(rhs_type));
+            ++issue_counter;
+        }
+        break;
+    // scaling, by a scalar the lanes can hold
+    case TokenType::Op_Asterisk:
+    case TokenType::Op_MulAssign:
+        if (IsVectorPrimitive(scalar)) {
+            Log->error("Vectors can only be multiplied by a scalar, use 'Dot' or 'Cross' instead");
+            ++issue_counter;
+        } else if (not TypesMatch(scalar, LaneType(vector))) {
+            Log->error("Attempt to scale '{}' by '{}', expected '{}'",
+                       Names().Name(vector),
+                       Names().Name(scalar),
+                       Names().Name(LaneType(vector))
+            );
+            ++issue_counter;
+        }
+        break;
+    default:
+        Log->error("Vectors only support '+', '-' and scaling with '*'");
+        ++issue_counter;
+        break;
     }
 
-    return Invalid;
+    tree->SetOperandTypes(node, ConvertPrimitive(lhs_type), ConvertPrimitive(rhs_type));
+    return vector;
 }
 
-void SemanticAnalyzer::Visit(const ListExpression& list) {
-    std::string_view element_type;
+void SemanticAnalyzer::AnalyzeList(const NodeId node) {
+    NameID element_type = NO_NAME;
 
-    for (const auto& value : list.GetValues()) {
-        value->Accept(*this);
+    const auto values = tree->Children(node);
+    for (const auto value : values) {
+        Analyze(value);
         const auto val_type = PopTypeBuffer();
 
-        if (element_type.empty()) {
+        if (element_type == NO_NAME) {
             element_type = val_type;
         }
 
         if (not TypesMatch(element_type, val_type)) {
             Log->error("Array element type mismatch: expected '{}', got '{}'",
-                       element_type,
-                       val_type
+                       Names().Name(element_type),
+                       Names().Name(val_type)
             );
             ++issue_counter;
             return;
@@ -347,73 +918,147 @@ void SemanticAnalyzer::Visit(const ListExpression& list) {
     }
 
     if (not types.contains(element_type)) {
-        Log->error("Unknown array element type '{}'", element_type);
+        Log->error("Unknown array element type '{}'", Names().Name(element_type));
         ++issue_counter;
 
         BufferType(element_type);
         return;
     }
 
+    // list elements live on the heap, which vectors never do
+    if (IsVectorPrimitive(element_type)) {
+        Log->error("Lists of '{}' are not supported yet", Names().Name(element_type));
+        ++issue_counter;
+    }
+
     const auto elem_size = types.at(element_type).size;
 
-    const_cast<ListExpression&>(list).SetType(ConvertPrimitive(element_type));
+    tree->SetListType(node, ConvertElement(element_type));
 
-    std::string array_type {"["};
-    array_type.reserve(element_type.size() + 1);
-    array_type.append(element_type);
-    array_type.append("]");
+    const auto element_name = Names().Name(element_type);
 
-    types[array_type].size = elem_size * list.GetValues().size();
+    std::string array_name {"["};
+    array_name.reserve(element_name.size() + 2);
+    array_name.append(element_name);
+    array_name.append("]");
+
+    const auto array_type  = Names().Intern(array_name);
+    types[array_type].size = elem_size * values.size();
     BufferType(array_type);
 }
 
-void SemanticAnalyzer::Visit(const ListAccess& access) {
-    access.GetItem()->Accept(*this);
+void SemanticAnalyzer::AnalyzeListAccess(const NodeId node) {
+    Analyze(tree->Child(node, 0));
 
     // this is where we'd validate that the item has a valid operator[] specialization
+    const auto item_type = PopTypeBuffer();
 
-    access.GetIndex()->Accept(*this);
-    const auto index_type = PeekTypeBuffer();
+    Analyze(tree->Child(node, 1));
+    const auto index_type = PopTypeBuffer();
 
     if (not IsIntegral(index_type)) {
         Log->error("List index must be of integral type");
         ++issue_counter;
     }
-}
 
-void SemanticAnalyzer::Visit(const Literal<f64>&) {
-    BufferType(PrimitiveName(F64));
-}
+    // vectors are indexed by lane, which the VM doesn't bounds check
+    if (IsVectorPrimitive(item_type)) {
+        const auto lane = ConstantIndex(*tree, tree->Child(node, 1));
+        if (lane && (*lane < 0 || *lane >= LaneCount(item_type))) {
+            Log->error("Lane index {} is out of range for '{}', which has {} lanes",
+                       *lane,
+                       Names().Name(item_type),
+                       LaneCount(item_type)
+            );
+            ++issue_counter;
+        }
+
+        tree->SetOperandTypes(node, ConvertPrimitive(item_type));
+        BufferType(LaneType(item_type));
+        return;
+    }
+
+    const auto element_type = ElementType(item_type);
+    if (element_type == NO_NAME) {
+        Log->error("Attempt to index into '{}', which isn't a list", Names().Name(item_type));
+        ++issue_counter;
 
-void SemanticAnalyzer::Visit(const Literal<i64>&) {
-    BufferType(PrimitiveName(I64));
+        BufferType(item_type);
+        return;
+    }
+
+    tree->SetOperandTypes(node, ConvertElement(element_type));
+    BufferType(element_type);
 }
 
-void SemanticAnalyzer::Visit(const Literal<bool>&) {
-    BufferType(PrimitiveName(Bool));
+NameID SemanticAnalyzer::AnnotateList(const NodeId list, const NameID annotation, const NameID list_type) {
+    const auto element_type = ElementType(annotation);
+    if (element_type == NO_NAME || not types.contains(element_type)) {
+        return list_type;
+    }
+
+    // integer literals are i64, but fit lists of any integral type, unsigned ones included
+    const auto values       = tree->Children(list);
+    const bool int_literals = IsIntegral(element_type)
+                              && std::ranges::all_of(values, [this](const NodeId value) {
+                                  return tree->Kind(value) == NodeKind::LiteralInt;
+                              });
+
+    types[annotation].size = types.at(element_type).size * values.size();
+
+    if (not int_literals && not TypesMatch(ElementType(list_type), element_type)) {
+        return list_type;
+    }
+
+    tree->SetListType(list, ConvertElement(element_type));
+    return annotation;
 }
 
-void SemanticAnalyzer::Visit(const StringLiteral& string) {
-    BufferType(PrimitiveName(String));
+NameID SemanticAnalyzer::AnnotateMap(const NodeId map, const NameID map_type) {
+    const auto key_type   = MapKeyType(map_type);
+    const auto value_type = MapValueType(map_type);
+
+    if (key_type == NO_NAME) {
+        Log->error("'[:]' needs to be given a map type, such as '[i64: f64]'");
+        ++issue_counter;
+        return empty_map_name;
+    }
+
+    // integer keys are all hashed as i64, which unsigned ones don't fit
+    if (not IsSignedIntegral(key_type) && key_type != PrimitiveID(String)) {
+        Log->error("Map keys must be signed integers or strings, got '{}'", Names().Name(key_type));
+        ++issue_counter;
+    }
+
+    if (not types.contains(value_type) || value_type == PrimitiveID(None)) {
+        Log->error("Unknown map value type '{}'", Names().Name(value_type));
+        ++issue_counter;
+    }
+
+    // the map itself is only a pointer to its entries
+    types[map_type] = TypeInfo {TypeSize::QuadWord};
+
+    const bool string_keys = key_type == PrimitiveID(String);
+    tree->SetListType(map, string_keys ? hexe::Value::Data::Type::StringMap : hexe::Value::Data::Type::IntMap);
+    return map_type;
 }
 
-void SemanticAnalyzer::RecordFunctionDeclarations(const Artifact& artifact) {
-    // not the biggest fan of dynamic_cast, but a whole other visitor just to collect
-    // function declarations would be some otherworldly level of premature optimization
-    for (const auto& declaration : artifact.GetChildren()) {
-        if (const auto* fn_decl = dynamic_cast<const FunctionDeclaration*>(declaration.get())) {
-            const auto name = fn_decl->GetName();
+void SemanticAnalyzer::RecordFunctionDeclarations() {
+    for (const auto declaration : tree->Declarations()) {
+        if (tree->Kind(declaration) == NodeKind::FunctionDeclaration) {
+            const auto& fn_decl = tree->Function(declaration);
+            const auto name     = fn_decl.name;
 
             auto& functions = GetFnTable();
             if (functions.contains(name)) {
-                Log->error("Redefinition of function '{}'", name);
+                Log->error("Redefinition of function '{}'", Names().Name(name));
                 ++issue_counter;
                 continue;
             }
 
             auto& fn           = functions[name];
-            const auto& params = fn_decl->GetParameters();
-            fn.return_type     = fn_decl->GetReturnType();
+            const auto params = tree->Parameters(declaration);
+            fn.return_type    = fn_decl.return_type;
 
             if (IsEntryPoint(name)) {
                 if (not params.empty()) {
@@ -421,7 +1066,7 @@ void SemanticAnalyzer::RecordFunctionDeclarations(const Artifact& artifact) {
                     ++issue_counter;
                 }
 
-                if (fn.return_type != PrimitiveName(None)) {
+                if (fn.return_type != PrimitiveID(None)) {
                     Log->error("Entry point function cannot have a return type");
                     ++issue_counter;
                 }
@@ -429,12 +1074,12 @@ void SemanticAnalyzer::RecordFunctionDeclarations(const Artifact& artifact) {
 
             // handle param types only, for invocation arity checks
             for (const auto& param : params) {
-                if (param.type.empty()) {
-                    Log->error("Parameter '{}' has no type annotation", param.name);
+                if (param.type == NO_NAME) {
+                    Log->error("Parameter '{}' has no type annotation", Names().Name(param.name));
                     ++issue_counter;
                 }
 
-                fn.locals[param.name] = {param.type, true};
+                fn.param_types.push_back(param.type);
                 ++fn.param_count;
             }
         }
@@ -443,54 +1088,228 @@ void SemanticAnalyzer::RecordFunctionDeclarations(const Artifact& artifact) {
 
 void SemanticAnalyzer::RegisterPrimitives() {
     // register primitives
-    types[PrimitiveNameString(I8)]    = TypeInfo {TypeSize::Byte};
-    types[PrimitiveNameString(I16)]   = TypeInfo {TypeSize::Word};
-    types[PrimitiveNameString(I32)]   = TypeInfo {TypeSize::DoubleWord};
-    types[PrimitiveNameString(I64)]   = TypeInfo {TypeSize::QuadWord};
-    types[PrimitiveNameString(Isize)] = TypeInfo {TypeSize::QuadWord};
+    types[PrimitiveID(I8)]    = TypeInfo {TypeSize::Byte};
+    types[PrimitiveID(I16)]   = TypeInfo {TypeSize::Word};
+    types[PrimitiveID(I32)]   = TypeInfo {TypeSize::DoubleWord};
+    types[PrimitiveID(I64)]   = TypeInfo {TypeSize::QuadWord};
+    types[PrimitiveID(Isize)] = TypeInfo {TypeSize::QuadWord};
     // we're not supporting 32bit systems for the foreseeable future
     // so isize/usize can just be 64-bit until maybe console support or something changes that
 
-    types[PrimitiveNameString(U8)]    = TypeInfo {TypeSize::Byte};
-    types[PrimitiveNameString(U16)]   = TypeInfo {TypeSize::Word};
-    types[PrimitiveNameString(U32)]   = TypeInfo {TypeSize::DoubleWord};
-    types[PrimitiveNameString(U64)]   = TypeInfo {TypeSize::QuadWord};
-    types[PrimitiveNameString(Usize)] = TypeInfo {TypeSize::QuadWord};
+    types[PrimitiveID(U8)]    = TypeInfo {TypeSize::Byte};
+    types[PrimitiveID(U16)]   = TypeInfo {TypeSize::Word};
+    types[PrimitiveID(U32)]   = TypeInfo {TypeSize::DoubleWord};
+    types[PrimitiveID(U64)]   = TypeInfo {TypeSize::QuadWord};
+    types[PrimitiveID(Usize)] = TypeInfo {TypeSize::QuadWord};
+
+    types[PrimitiveID(F32)] = TypeInfo {TypeSize::DoubleWord};
+    types[PrimitiveID(F64)] = TypeInfo {TypeSize::QuadWord};
 
-    types[PrimitiveNameString(F32)] = TypeInfo {TypeSize::DoubleWord};
-    types[PrimitiveNameString(F64)] = TypeInfo {TypeSize::QuadWord};
+    types[PrimitiveID(Char)]   = TypeInfo {TypeSize::Byte};
+    types[PrimitiveID(String)] = TypeInfo {TypeSize::Arbitrary};
 
-    types[PrimitiveNameString(Char)]   = TypeInfo {TypeSize::Byte};
-    types[PrimitiveNameString(String)] = TypeInfo {TypeSize::Arbitrary};
+    types[PrimitiveID(Byte)] = TypeInfo {TypeSize::Byte};
+    types[PrimitiveID(Bool)] = TypeInfo {TypeSize::Byte};
 
-    types[PrimitiveNameString(Byte)] = TypeInfo {TypeSize::Byte};
-    types[PrimitiveNameString(Bool)] = TypeInfo {TypeSize::Byte};
+    types[PrimitiveID(Vec2)]  = TypeInfo {2 * TypeSize::DoubleWord};
+    types[PrimitiveID(Vec3)]  = TypeInfo {3 * TypeSize::DoubleWord};
+    types[PrimitiveID(Vec4)]  = TypeInfo {4 * TypeSize::DoubleWord};
+    types[PrimitiveID(Vec2i)] = TypeInfo {2 * TypeSize::DoubleWord};
 
-    types[PrimitiveNameString(Fn)]   = TypeInfo {TypeSize::QuadWord}; // same as ptr
-    types[PrimitiveNameString(None)] = TypeInfo {TypeSize::None};
+    types[PrimitiveID(Fn)]   = TypeInfo {TypeSize::QuadWord}; // same as ptr
+    types[PrimitiveID(None)] = TypeInfo {TypeSize::None};
+
+    // a map type is registered once '[:]' takes it on, see AnnotateMap
+    types[empty_map_name] = TypeInfo {TypeSize::QuadWord};
 }
 
 void SemanticAnalyzer::RegisterBuiltins() {
-    auto& print         = GetFnTable()["Print"];
-    print.return_type   = PrimitiveName(None);
-    print.param_count   = 1;
-    print.locals["str"] = {PrimitiveName(String), true};
+    auto& print       = GetFnTable()[Names().Intern("Print")];
+    print.return_type = PrimitiveID(None);
+    print.param_count = 1;
+    print.param_types = {PrimitiveID(String)};
+
+    auto& printv       = GetFnTable()[Names().Intern("PrintV")];
+    printv.return_type = PrimitiveID(None);
+    printv.param_count = 2;
+
+    // the value being formatted may be of any type
+    printv.param_types = {PrimitiveID(String)};
+
+    // vectors are built out of their lanes
+    const auto vector = [this](const std::string_view name, const PrimitiveType type, const u8 lanes) {
+        auto& fn       = GetFnTable()[Names().Intern(name)];
+        fn.return_type = PrimitiveID(type);
+        fn.param_count = lanes;
+        fn.param_types.assign(lanes, LaneType(PrimitiveID(type)));
+    };
+
+    vector("Vec2", Vec2, 2);
+    vector("Vec3", Vec3, 3);
+    vector("Vec4", Vec4, 4);
+    vector("Vec2i", Vec2i, 2);
+
+    // these take any vector, so their types are checked by AnalyzeVectorMath
+    GetFnTable()[dot_name].param_count       = 2;
+    GetFnTable()[cross_name].param_count     = 2;
+    GetFnTable()[length_name].param_count    = 1;
+    GetFnTable()[normalize_name].param_count = 1;
+
+    // and these any list, checked by AnalyzeListBuiltin
+    const auto list = [this](const std::string_view name, const ListBuiltin builtin, const u8 param_count) {
+        const auto id                = Names().Intern(name);
+        list_builtins[id]            = builtin;
+        GetFnTable()[id].param_count = param_count;
+    };
+
+    list("ListFill", ListBuiltin::Fill, 2);
+    list("ListCopy", ListBuiltin::Copy, 2);
+    list("ListSlice", ListBuiltin::Slice, 3);
+    list("ListSum", ListBuiltin::Sum, 1);
+    list("ListMin", ListBuiltin::Min, 1);
+    list("ListMax", ListBuiltin::Max, 1);
+    list("ListFind", ListBuiltin::Find, 2);
+    list("ListSort", ListBuiltin::Sort, 1);
+    list("ListAdd", ListBuiltin::Add, 2);
+    list("ListMul", ListBuiltin::Mul, 2);
+
+    const auto map = [this](const std::string_view name, const MapBuiltin builtin, const u8 param_count) {
+        const auto id                = Names().Intern(name);
+        map_builtins[id]             = builtin;
+        GetFnTable()[id].param_count = param_count;
+    };
+
+    map("MapGet", MapBuiltin::Get, 3);
+    map("MapSet", MapBuiltin::Set, 3);
+    map("MapHas", MapBuiltin::Has, 2);
+    map("MapRemove", MapBuiltin::Remove, 2);
+    map("MapCount", MapBuiltin::Count, 1);
+    map("MapKeyAt", MapBuiltin::KeyAt, 2);
+    map("MapValueAt", MapBuiltin::ValueAt, 2);
+}
+
+bool SemanticAnalyzer::RegisterNatives(const std::string_view manifest, const std::string_view name) {
+    Lexer lexer;
+    if (not lexer.TokenizeSource(std::string(manifest), name)) {
+        Log->error("Failed to tokenize native manifest '{}'", name);
+        ++issue_counter;
+        return false;
+    }
+
+    const auto& tokens = lexer.Tokens();
+    usize cursor       = 0;
+
+    const auto current = [&tokens, &cursor] {
+        return tokens[std::min(cursor, tokens.size() - 1)];
+    };
+
+    const auto expect = [&](const bool matched, const std::string_view what) {
+        if (not matched) {
+            Log->error("{}:{}: Expected {} in native manifest", name, current().line, what);
+            ++issue_counter;
+        }
+        return matched;
+    };
+
+    // natives are only ever called with values, so 'fn' and 'none' can't be parameters
+    const auto is_value_type = [this](const Token& token) {
+        return token.name != NO_NAME
+               && token.name != PrimitiveID(Fn)
+               && token.name != PrimitiveID(None)
+               && types.contains(token.name);
+    };
+
+    while (true) {
+        while (current().type == TokenType::Terminator) {
+            ++cursor;
+        }
+
+        if (current().type == TokenType::Eof) {
+            break;
+        }
+
+        // fn Name
+        if (not expect(current().type == TokenType::KW_fn, "'fn'")) {
+            return false;
+        }
+        ++cursor;
+
+        if (not expect(current().type == TokenType::Identifier, "function name")) {
+            return false;
+        }
+        const auto fn_name = current().name;
+        ++cursor;
+
+        if (GetFnTable().contains(fn_name)) {
+            Log->error("{}:{}: Redefinition of function '{}'", name, current().line, Names().Name(fn_name));
+            ++issue_counter;
+            return false;
+        }
+
+        // (a: T, b: U)
+        if (not expect(current().type == TokenType::Op_ParenLeft, "'('")) {
+            return false;
+        }
+        ++cursor;
+
+        Function native;
+        native.return_type = PrimitiveID(None);
+        native.is_native   = true;
+
+        while (current().type != TokenType::Op_ParenRight) {
+            if (not native.param_types.empty()) {
+                if (not expect(current().type == TokenType::Op_Comma, "','")) {
+                    return false;
+                }
+                ++cursor;
+            }
+
+            if (not expect(current().type == TokenType::Identifier, "parameter name")) {
+                return false;
+            }
+            ++cursor;
+
+            if (not expect(current().type == TokenType::Op_Colon, "parameter type")) {
+                return false;
+            }
+            ++cursor;
+
+            if (not expect(is_value_type(current()), "parameter type")) {
+                return false;
+            }
+            native.param_types.push_back(current().name);
+            ++native.param_count;
+            ++cursor;
+        }
+        ++cursor;
+
+        // -> T
+        if (current().type == TokenType::Op_ReturnType) {
+            ++cursor;
+
+            const bool is_none = current().name == PrimitiveID(None);
+            if (not expect(is_none || is_value_type(current()), "return type")) {
+                return false;
+            }
+            native.return_type = current().name;
+            ++cursor;
+        }
 
-    auto& printv         = GetFnTable()["PrintV"];
-    printv.return_type   = PrimitiveName(None);
-    printv.param_count   = 2;
-    printv.locals["str"] = {PrimitiveName(String), true};
+        GetFnTable()[fn_name] = std::move(native);
+    }
+
+    return true;
 }
 
 FunctionTable& SemanticAnalyzer::GetFnTable() {
-    return types.at(PrimitiveName(Fn)).functions;
+    return types.at(PrimitiveID(Fn)).functions;
 }
 
 const FunctionTable& SemanticAnalyzer::GetFnTable() const {
-    return types.at(PrimitiveName(Fn)).functions;
+    return types.at(PrimitiveID(Fn)).functions;
 }
 
-std::string_view SemanticAnalyzer::CurrentFunctionName() const {
+NameID SemanticAnalyzer::CurrentFunctionName() const {
     return function_stack.back();
 }
 
@@ -502,126 +1321,142 @@ const Function& SemanticAnalyzer::CurrentFunction() const {
     return GetFnTable().at(CurrentFunctionName());
 }
 
-std::string_view SemanticAnalyzer::PeekTypeBuffer() const {
+NameID SemanticAnalyzer::PeekTypeBuffer() const {
     return type_buffer[1];
 }
 
-std::string_view SemanticAnalyzer::PopTypeBuffer() {
+NameID SemanticAnalyzer::PopTypeBuffer() {
     type_buffer[0] = type_buffer[1];
-    type_buffer[1] = TB_ERROR;
+    type_buffer[1] = type_buffer_error;
     return type_buffer[0];
 }
 
-void SemanticAnalyzer::BufferType(const std::string_view type_name) {
+void SemanticAnalyzer::BufferType(const NameID type_name) {
     type_buffer[1] = type_name;
 }
 
-bool SemanticAnalyzer::TypesMatch(const std::string_view lhs, const std::string_view rhs) const {
+bool SemanticAnalyzer::TypesMatch(const NameID lhs, const NameID rhs) const {
     return lhs == rhs
            || (IsSignedIntegral(lhs) && IsSignedIntegral(rhs))
            || (IsUnsignedIntegral(lhs) && IsUnsignedIntegral(rhs))
            || (IsFloatPrimitive(lhs) && IsFloatPrimitive(rhs));
 }
 
-void SemanticAnalyzer::AddSymbol(const std::string_view name,
-                                 const std::string_view type,
-                                 const bool is_mutable,
-                                 const ScopeID scope
-) {
-    const auto redef_error = [this](const std::string_view n) {
-        Log->error("Redefinition of '{}'", n);
-        ++issue_counter;
-    };
-
-    if (globals.contains(name)) {
-        redef_error(name);
-        return;
+NameID SemanticAnalyzer::ElementType(const NameID list_type) const {
+    // list types are interned as '[T]', see AnalyzeList
+    const auto name = Names().Name(list_type);
+    if (name.size() < 3 || not name.starts_with('[') || not name.ends_with(']') || name.contains(':')) {
+        return NO_NAME;
     }
 
-    // we don't have constants yet
-    const auto mutability = is_mutable ? Mutability::Mutable : Mutability::Immutable;
+    return Names().Intern(name.substr(1, name.size() - 2));
+}
 
-    if (scope == GLOBAL_SCOPE) {
-        globals[name] = {type, scope, mutability};
-        return;
+NameID SemanticAnalyzer::MapKeyType(const NameID map_type) const {
+    // map types are interned as '[K: V]', see Initializer
+    const auto name = Names().Name(map_type);
+    const auto colon = name.find(": ");
+    if (not name.starts_with('[') || not name.ends_with(']') || colon == std::string_view::npos || colon == 1) {
+        return NO_NAME;
     }
 
-    auto& locals = CurrentFunction().locals;
-    if (locals.contains(name)) {
-        redef_error(name);
-        return;
+    return Names().Intern(name.substr(1, colon - 1));
+}
+
+NameID SemanticAnalyzer::MapValueType(const NameID map_type) const {
+    if (MapKeyType(map_type) == NO_NAME) {
+        return NO_NAME;
     }
 
-    locals[name] = {type, scope, mutability};
+    const auto name  = Names().Name(map_type);
+    const auto value = name.find(": ") + 2;
+    return Names().Intern(name.substr(value, name.size() - value - 1));
 }
 
-const Symbol* SemanticAnalyzer::GetSymbol(std::string_view name) const {
-    if (globals.contains(name)) {
-        return &globals.at(name);
+void SemanticAnalyzer::AddSymbol(const NameID name, const NameID type, const bool is_mutable) {
+    // bindings may not shadow anything, be it a global or a name from an enclosing scope
+    if (symbols.Find(name) != nullptr) {
+        Log->error("Redefinition of '{}'", Names().Name(name));
+        ++issue_counter;
+        return;
     }
 
-    if (current_scope != GLOBAL_SCOPE) {
-        const auto& locals = CurrentFunction().locals;
-        if (locals.contains(name)) {
-            return &locals.at(name);
-        }
+    // we don't have constants yet
+    const auto mutability = is_mutable ? Mutability::Mutable : Mutability::Immutable;
+    symbols.Add(name, {type, mutability});
+
+    if (symbols.Depth() != GLOBAL_SCOPE) {
+        ++CurrentFunction().local_count;
     }
-    return nullptr;
 }
 
-void SemanticAnalyzer::HandleInitializer(const Initializer& node, const bool is_mutable) {
+const Symbol* SemanticAnalyzer::GetSymbol(const NameID name) const {
+    return symbols.Find(name);
+}
+
+void SemanticAnalyzer::HandleInitializer(const NodeId node, const bool is_mutable) {
     // evaluate expr first
 
-    const bool has_init = node.GetInitializer() != nullptr;
+    const bool has_init = tree->ChildCount(node) != 0;
 
     if (has_init) {
-        auto& init = *node.GetInitializer().get();
-        init.Accept(*this);
+        Analyze(tree->Child(node, 0));
     }
 
-    const auto initializer_type = has_init ? PopTypeBuffer() : PrimitiveName(None);
-    const auto annotation_type  = node.HasTypeAnnotation() ? node.GetTypeName() : initializer_type;
+    const auto annotation      = tree->Name(node, 1);
+    auto initializer_type      = has_init ? PopTypeBuffer() : PrimitiveID(None);
+    const auto annotation_type = annotation != NO_NAME ? annotation : initializer_type;
+
+    // 'data xs: [u8] = [1, 2]' stores its elements as u8
+    if (has_init && annotation != NO_NAME && tree->Kind(tree->Child(node, 0)) == NodeKind::List) {
+        initializer_type = AnnotateList(tree->Child(node, 0), annotation, initializer_type);
+    }
+
+    if (has_init && tree->Kind(tree->Child(node, 0)) == NodeKind::Map) {
+        initializer_type = AnnotateMap(tree->Child(node, 0), annotation);
+    }
 
     if (not types.contains(annotation_type)) {
-        Log->error("Unknown type '{}'", annotation_type);
+        Log->error("Unknown type '{}'", Names().Name(annotation_type));
         ++issue_counter;
     }
 
     if (has_init && not TypesMatch(initializer_type, annotation_type)) {
-        Log->error("Initializer: Type mismatch: expected '{}', got '{}'", annotation_type, initializer_type);
+        Log->error("Initializer: Type mismatch: expected '{}', got '{}'",
+                   Names().Name(annotation_type),
+                   Names().Name(initializer_type)
+        );
         ++issue_counter;
     }
 
     PreventAssignmentWithNone(initializer_type);
 
-    AddSymbol(node.GetName(), annotation_type, is_mutable, current_scope);
+    AddSymbol(tree->Name(node), annotation_type, is_mutable);
 }
 
 // temporary, until we can elide every binding containing 'none'
-void SemanticAnalyzer::PreventAssignmentWithNone(const std::string_view type) {
-    if (type == PrimitiveName(None)) {
+void SemanticAnalyzer::PreventAssignmentWithNone(const NameID type) {
+    if (type == PrimitiveID(None)) {
         Log->error("Cannot initialize binding of type '{}'. "
                    "This feature is planned for future versions of Mana.",
-                   type
+                   Names().Name(type)
         );
         ++issue_counter;
     }
 }
 
-void SemanticAnalyzer::HandleRangedLoop(const LoopRange& node, const bool is_mutable) {
+void SemanticAnalyzer::HandleRangedLoop(const NodeId node, const bool is_mutable) {
     ++loop_depth;
 
-    // counter is mandatory in ranged loop
-    AddSymbol(node.GetCounterName(), PrimitiveName(I64), is_mutable, current_scope + 1);
-
-    const bool has_origin = node.GetOrigin() != nullptr;
+    const auto parts      = tree->Children(node);
+    const bool has_origin = parts.size() == 3;
     if (has_origin) {
-        node.GetOrigin()->Accept(*this);
+        Analyze(parts[0]);
     }
 
-    const auto start_type = has_origin ? PopTypeBuffer() : PrimitiveName(I64);
+    const auto start_type = has_origin ? PopTypeBuffer() : PrimitiveID(I64);
 
-    node.GetDestination()->Accept(*this);
+    Analyze(parts[parts.size() - 2]);
     const auto end_type = PopTypeBuffer();
 
     if (not IsIntegral(start_type) || not IsIntegral(end_type)) {
@@ -633,8 +1468,34 @@ void SemanticAnalyzer::HandleRangedLoop(const LoopRange& node, const bool is_mut
         Log->warn("Using unsigned integers in ranges is bug-prone. Prefer signed integers instead");
     }
 
-    node.GetBody()->Accept(*this);
+    // the counter is mandatory, and lives in the body's scope
+    symbols.EnterScope();
+
+    const auto enclosing_floor = parallel_floor;
+    if (tree->Kind(node) == NodeKind::LoopRangeParallel) {
+        if (InParallelLoop()) {
+            Log->error("Parallel loops cannot be nested");
+            ++issue_counter;
+        }
+
+        parallel_floor      = static_cast<u32>(symbols.Bindings().size());
+        parallel_loop_depth = loop_depth;
+    }
+
+    AddSymbol(tree->Name(node), PrimitiveID(I64), is_mutable);
+    AnalyzeStatements(parts.back());
+    symbols.ExitScope();
+
+    parallel_floor = enclosing_floor;
 
     --loop_depth;
 }
+
+bool SemanticAnalyzer::InParallelLoop() const {
+    return parallel_floor != NOT_PARALLEL;
+}
+
+bool SemanticAnalyzer::IsSharedByIterations(const NameID name) const {
+    return InParallelLoop() && symbols.Position(name) < parallel_floor;
+}
 } // namespace sigil
@@ -16,19 +16,28 @@ bool GlobalSourceFile::Load(const std::filesystem::path& file_path) {
     }
 
     size = std::filesystem::file_size(file_path);
-    contents.resize(size);
+    contents.resize(size + SCAN_PADDING);
     source_file.read(contents.data(), static_cast<ml::i64>(size));
     source_file.close();
 
     name = file_path.filename().replace_extension("").string();
 
-    view = contents;
+    view = std::string_view(contents).substr(0, size);
 
     return true;
 }
 
+void GlobalSourceFile::Assign(std::string&& source, const std::string_view source_name) {
+    contents = std::move(source);
+    size     = contents.size();
+    name     = source_name;
+
+    contents.resize(size + SCAN_PADDING);
+    view = std::string_view(contents).substr(0, size);
+}
+
 void GlobalSourceFile::Reset() {
-    contents.clear();
+    contents.assign(SCAN_PADDING, '\0');
     name.clear();
     view = {};
     size = 0;
@@ -39,7 +48,7 @@ std::string_view GlobalSourceFile::Name() const {
 }
 
 std::string_view GlobalSourceFile::Content() const {
-    return contents;
+    return view;
 }
 
 std::string_view GlobalSourceFile::Slice(const std::size_t start, const std::size_t length) const {
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <ranges>
 #include <sigil/ast/keywords.hpp>
 #include <sigil/ast/parse-tree.hpp>
@@ -80,11 +81,11 @@ LiteralData MakeLiteral(const Token& token) {
 }
 
 /// Artifact
-Artifact::Artifact(const std::string_view name, const ParseNode& node)
-    : name(name) {
-    for (auto& decl : node.branches) {
-        declarations.emplace_back(CreateDeclaration(*decl));
-    }
+Artifact::Artifact(const std::string_view name)
+    : name(name) {}
+
+void Artifact::AddDeclaration(NodePtr declaration) {
+    declarations.emplace_back(std::move(declaration));
 }
 
 auto Artifact::GetName() const -> std::string_view {
@@ -101,30 +102,42 @@ void Artifact::Accept(Visitor& visitor) const {
 
 /// FunctionDeclaration
 FunctionDeclaration::FunctionDeclaration(const ParseNode& node) {
-    name = FetchTokenText(node.tokens[0]);
+    name        = node.TokenAt(0).name;
+    return_type = ReturnTypeOf(node);
 
-    std::string_view param_type;
-    for (const auto& param : std::views::reverse(node.branches[0]->branches)) {
-        if (param->tokens.size() == 2) {
-            param_type = FetchTokenText(param->tokens[1]);
-        }
+    ReadParameters(node, parameters);
 
-        parameters.emplace_back(FetchTokenText(param->tokens[0]), param_type);
-    }
+    body = std::make_shared<Scope>(node.Branch(1));
+}
 
-    // fix the order after handling type propagation
-    std::ranges::reverse(parameters);
+void ReadParameters(const ParseNode& function, std::vector<Parameter>& parameters) {
+    const auto first = parameters.size();
 
-    if (node.tokens.size() == 2) {
-        return_type = FetchTokenText(node.tokens[1]);
-    } else {
-        return_type = PrimitiveName(PrimitiveType::None);
+    // parameters are visited front to back, so the types are propagated afterwards
+    for (const auto& param : function.Branch(0).Branches()) {
+        parameters.emplace_back(param.TokenAt(0).name,
+                                param.TokenCount() == 2 ? param.TokenAt(1).name : NO_NAME
+        );
+    }
+
+    NameID param_type = NO_NAME;
+    for (auto& param : std::views::reverse(std::span(parameters).subspan(first))) {
+        if (param.type == NO_NAME) {
+            param.type = param_type;
+        } else {
+            param_type = param.type;
+        }
     }
+}
 
-    body = std::make_shared<Scope>(*node.branches[1]);
+NameID ReturnTypeOf(const ParseNode& function) {
+    if (function.TokenCount() == 2) {
+        return function.TokenAt(1).name;
+    }
+    return PrimitiveID(PrimitiveType::None);
 }
 
-std::string_view FunctionDeclaration::GetName() const {
+NameID FunctionDeclaration::GetName() const {
     return name;
 }
 
@@ -136,7 +149,7 @@ const NodePtr& FunctionDeclaration::GetBody() const {
     return body;
 }
 
-std::string_view FunctionDeclaration::GetReturnType() const {
+NameID FunctionDeclaration::GetReturnType() const {
     return return_type;
 }
 
@@ -145,14 +158,14 @@ void FunctionDeclaration::Accept(Visitor& visitor) const {
 }
 
 Invocation::Invocation(const ParseNode& node) {
-    identifier = FetchTokenText(node.tokens[0]);
+    identifier = node.TokenAt(0).name;
 
-    for (const auto& arg : node.branches) {
-        arguments.emplace_back(CreateExpression(*arg));
+    for (const auto& arg : node.Branches()) {
+        arguments.emplace_back(CreateExpression(arg));
     }
 }
 
-std::string_view Invocation::GetIdentifier() const {
+NameID Invocation::GetIdentifier() const {
     return identifier;
 }
 
@@ -166,35 +179,58 @@ void Invocation::Accept(Visitor& visitor) const {
 
 /// Binding
 Initializer::Initializer(const ParseNode& node)
-    : initializer {nullptr} {
-    const auto& tokens = node.tokens;
+    : name {InitializerName(node)},
+      type {InitializerType(node)},
+      initializer {nullptr} {
+    if (not node.IsLeaf()) {
+        initializer = CreateExpression(node.Branch(0));
+    }
+}
 
+NameID InitializerName(const ParseNode& node) {
     // data keyword is irrelevant to AST
-    for (const auto& token : tokens) {
+    for (const auto& token : node.Tokens()) {
         if (token.type == TokenType::Identifier) {
-            name = FetchTokenText(token);
-            break;
+            return token.name;
         }
     }
+    return NO_NAME;
+}
 
-    for (int i = 0; i < tokens.size(); ++i) {
-        if (tokens[i].type == TokenType::Op_Colon) {
-            // AST input is assumed to be correct, so we don't need to bounds check
-            type = FetchTokenText(tokens[i + 1]);
-            break;
+NameID InitializerType(const ParseNode& node) {
+    const auto tokens = node.Tokens();
+
+    for (auto it = tokens.begin(); it != tokens.end(); ++it) {
+        if (it->type != TokenType::Op_Colon) {
+            continue;
+        }
+
+        // AST input is assumed to be correct, so we don't need to bounds check
+        if ((++it)->type != TokenType::Op_BracketLeft) {
+            return it->name;
         }
-    }
 
-    if (not node.branches.empty()) {
-        initializer = CreateExpression(*node.branches[0]);
+        // list types are interned as '[T]', like the analyzer does for list literals
+        // and map types as '[K: V]'
+        std::string list_type {"["};
+        list_type.append(Names().Name((++it)->name));
+
+        if ((++it)->type == TokenType::Op_Colon) {
+            list_type.append(": ");
+            list_type.append(Names().Name((++it)->name));
+        }
+        list_type.append("]");
+
+        return Names().Intern(list_type);
     }
+    return NO_NAME;
 }
 
-std::string_view Initializer::GetName() const {
+NameID Initializer::GetName() const {
     return name;
 }
 
-std::string_view Initializer::GetTypeName() const {
+NameID Initializer::GetTypeName() const {
     return type;
 }
 
@@ -203,7 +239,7 @@ const NodePtr& Initializer::GetInitializer() const {
 }
 
 bool Initializer::HasTypeAnnotation() const {
-    return not type.empty();
+    return type != NO_NAME;
 }
 
 void Initializer::Accept(Visitor& visitor) const {
@@ -227,13 +263,18 @@ void MutableDataDeclaration::Accept(Visitor& visitor) const {
 }
 
 /// Statement
-Statement::Statement(NodePtr&& node)
-    : child(std::move(node)) {}
+Statement::Statement(NodePtr&& node, const SourceLocation location)
+    : child(std::move(node)),
+      location(location) {}
 
 const NodePtr& Statement::GetChild() const {
     return child;
 }
 
+SourceLocation Statement::GetLocation() const {
+    return location;
+}
+
 void Statement::Accept(Visitor& visitor) const {
     child->Accept(visitor); // forward the visitor, statements don't do anything on their own
 }
@@ -241,12 +282,12 @@ void Statement::Accept(Visitor& visitor) const {
 
 /// If
 If::If(const ParseNode& node) {
-    condition = CreateExpression(*node.branches[0]);
+    condition = CreateExpression(node.Branch(0));
 
-    then_block = std::make_shared<Scope>(*node.branches[1]);
+    then_block = std::make_shared<Scope>(node.Branch(1));
 
-    if (node.branches.size() > 2) {
-        auto& tail = *node.branches[2]->branches[0];
+    if (node.BranchCount() > 2) {
+        auto& tail = node.Branch(2).Branch(0);
         if (tail.rule == Rule::Scope) {
             else_branch = std::make_shared<Scope>(tail);
         } else if (tail.rule == Rule::If) {
@@ -277,7 +318,7 @@ void If::Accept(Visitor& visitor) const {
 
 /// Loop
 Loop::Loop(const ParseNode& node) {
-    body = std::make_shared<Scope>(*node.branches[0]);
+    body = std::make_shared<Scope>(node.Branch(0));
 }
 
 const NodePtr& Loop::GetBody() const {
@@ -290,8 +331,8 @@ void Loop::Accept(Visitor& visitor) const {
 
 /// LoopIf
 LoopIf::LoopIf(const ParseNode& node)
-    : condition {CreateExpression(*node.branches[0])},
-      body {std::make_shared<Scope>(*node.branches[1])} {}
+    : condition {CreateExpression(node.Branch(0))},
+      body {std::make_shared<Scope>(node.Branch(1))} {}
 
 const NodePtr& LoopIf::GetCondition() const {
     return condition;
@@ -307,8 +348,8 @@ void LoopIf::Accept(Visitor& visitor) const {
 
 /// LoopIfPost
 LoopIfPost::LoopIfPost(const ParseNode& node)
-    : condition {CreateExpression(*node.branches[1])},
-      body {std::make_shared<Scope>(*node.branches[0])} {}
+    : condition {CreateExpression(node.Branch(1))},
+      body {std::make_shared<Scope>(node.Branch(0))} {}
 
 const NodePtr& LoopIfPost::GetCondition() const {
     return condition;
@@ -324,19 +365,24 @@ void LoopIfPost::Accept(Visitor& visitor) const {
 
 /// LoopRange
 LoopRange::LoopRange(const ParseNode& node) {
-    counter = FetchTokenText(node.tokens[0]);
+    counter = RangeCounterOf(node);
 
-    if (node.branches.size() == 2) {
+    if (node.BranchCount() == 2) {
         origin      = nullptr;
-        destination = CreateExpression(*node.branches[0]);
-        body        = std::make_shared<Scope>(*node.branches[1]);
+        destination = CreateExpression(node.Branch(0));
+        body        = std::make_shared<Scope>(node.Branch(1));
         return;
     }
 
     // it's either a partial or full range
-    origin      = CreateExpression(*node.branches[0]);
-    destination = CreateExpression(*node.branches[1]);
-    body        = std::make_shared<Scope>(*node.branches[2]);
+    origin      = CreateExpression(node.Branch(0));
+    destination = CreateExpression(node.Branch(1));
+    body        = std::make_shared<Scope>(node.Branch(2));
+}
+
+NameID RangeCounterOf(const ParseNode& range) {
+    // mut token is useless past this point
+    return range.TokenAt(range.TokenAt(0).type == TokenType::KW_mut ? 1 : 0).name;
 }
 
 const NodePtr& LoopRange::GetOrigin() const {
@@ -351,7 +397,7 @@ const NodePtr& LoopRange::GetBody() const {
     return body;
 }
 
-std::string_view LoopRange::GetCounterName() const {
+NameID LoopRange::GetCounterName() const {
     return counter;
 }
 
@@ -367,10 +413,18 @@ void LoopRangeMutable::Accept(Visitor& visitor) const {
     visitor.Visit(*this);
 }
 
+/// LoopRangeParallel
+LoopRangeParallel::LoopRangeParallel(const ParseNode& node)
+    : LoopRange {node} {}
+
+void LoopRangeParallel::Accept(Visitor& visitor) const {
+    visitor.Visit(*this);
+}
+
 /// ListAccess
 ListAccess::ListAccess(const ParseNode& node) {
-    item  = CreateExpression(*node.branches[0]);
-    index = CreateExpression(*node.branches[1]);
+    item  = CreateExpression(node.Branch(0));
+    index = CreateExpression(node.Branch(1));
 }
 
 const NodePtr& ListAccess::GetItem() const {
@@ -387,8 +441,8 @@ void ListAccess::Accept(Visitor& visitor) const {
 
 /// LoopFixed
 LoopFixed::LoopFixed(const ParseNode& node) {
-    count = CreateExpression(*node.branches[0]);
-    body  = std::make_shared<Scope>(*node.branches[1]);
+    count = CreateExpression(node.Branch(0));
+    body  = std::make_shared<Scope>(node.Branch(1));
 }
 
 const NodePtr& LoopFixed::GetCountTarget() const {
@@ -405,29 +459,33 @@ void LoopFixed::Accept(Visitor& visitor) const {
 
 /// LoopControl
 LoopControl::LoopControl(const ParseNode& node)
-    : condition {nullptr} {
-    if (node.tokens.size() > 2 && node.tokens[2].type == TokenType::Identifier) {
-        label = FetchTokenText(node.tokens[2]);
-    }
-
-    if (node.branches.empty()) {
+    : condition {nullptr},
+      label {LoopLabelOf(node)} {
+    if (node.IsLeaf()) {
         return;
     }
 
     // LoopControl can only have up to 1 branch
-    condition = CreateExpression(*node.branches[0]);
+    condition = CreateExpression(node.Branch(0));
+}
+
+NameID LoopLabelOf(const ParseNode& control) {
+    if (control.TokenCount() > 2 && control.TokenAt(2).type == TokenType::Identifier) {
+        return control.TokenAt(2).name;
+    }
+    return NO_NAME;
 }
 
 const NodePtr& LoopControl::GetCondition() const {
     return condition;
 }
 
-std::string_view LoopControl::GetLabel() const {
+NameID LoopControl::GetLabel() const {
     return label;
 }
 
 bool LoopControl::HasLabel() const {
-    return not label.empty();
+    return label != NO_NAME;
 }
 
 void LoopControl::Accept(Visitor& visitor) const {
@@ -452,17 +510,18 @@ void Skip::Accept(Visitor& visitor) const {
 
 /// Return
 Return::Return(const ParseNode& node) {
-    // TODO: verify this
-    if (node.branches.empty()
-        || (node.branches[0]->rule == Rule::Identifier && FetchTokenText(node.branches[0]->tokens[0]) == std::string(
-                PrimitiveName(
-                    PrimitiveType::None
-                )
-            ))) {
-        // it's either 'return' or 'return none' which are identical
+    if (ReturnsNothing(node)) {
         return;
     }
-    expr = CreateExpression(*node.branches[0]);
+    expr = CreateExpression(node.Branch(0));
+}
+
+bool ReturnsNothing(const ParseNode& node) {
+    // TODO: verify this
+    // it's either 'return' or 'return none' which are identical
+    return node.IsLeaf()
+           || (node.Branch(0).rule == Rule::Identifier
+               && FetchTokenText(node.Branch(0).TokenAt(0)) == PrimitiveName(PrimitiveType::None));
 }
 
 const NodePtr& Return::GetExpression() const {
@@ -473,14 +532,19 @@ void Return::Accept(Visitor& visitor) const {
     visitor.Visit(*this);
 }
 
+/// Yield
+void Yield::Accept(Visitor& visitor) const {
+    visitor.Visit(*this);
+}
+
 /// Assignment
 Assignment::Assignment(const ParseNode& node) {
-    identifier = FetchTokenText(node.tokens[0]);
-    op         = FetchTokenText(node.tokens[1]);
-    value      = CreateExpression(*node.branches[0]);
+    identifier = node.TokenAt(0).name;
+    op         = node.TokenAt(1).type;
+    value      = CreateExpression(node.Branch(0));
 }
 
-std::string_view Assignment::GetIdentifier() const {
+NameID Assignment::GetIdentifier() const {
     return identifier;
 }
 
@@ -488,7 +552,7 @@ const NodePtr& Assignment::GetValue() const {
     return value;
 }
 
-std::string_view Assignment::GetOp() const {
+TokenType Assignment::GetOp() const {
     return op;
 }
 
@@ -496,61 +560,119 @@ void Assignment::Accept(Visitor& visitor) const {
     visitor.Visit(*this);
 }
 
+/// ElementAssignment
+ElementAssignment::ElementAssignment(const ParseNode& node) {
+    identifier = node.TokenAt(0).name;
+    op         = node.TokenAt(1).type;
+    index      = CreateExpression(node.Branch(0));
+    value      = CreateExpression(node.Branch(1));
+}
+
+NameID ElementAssignment::GetIdentifier() const {
+    return identifier;
+}
+
+const NodePtr& ElementAssignment::GetIndex() const {
+    return index;
+}
+
+const NodePtr& ElementAssignment::GetValue() const {
+    return value;
+}
+
+TokenType ElementAssignment::GetOp() const {
+    return op;
+}
+
+void ElementAssignment::Accept(Visitor& visitor) const {
+    visitor.Visit(*this);
+}
+
 /// Scope
+namespace {
+// a node's own tokens may be operators (e.g. '+' in 'a + b'),
+// so the leftmost branch has to be considered as well
+const Token* FirstTokenOf(const ParseNode& node) {
+    const Token* first = node.TokenCount() == 0 ? nullptr : &node.TokenAt(0);
+
+    if (not node.IsLeaf()) {
+        if (const auto* nested = FirstTokenOf(node.Branch(0));
+            nested != nullptr && (first == nullptr || nested->offset < first->offset)) {
+            first = nested;
+        }
+    }
+
+    return first;
+}
+
+} // namespace
+
+SourceLocation LocationOf(const ParseNode& statement) {
+    if (const auto* token = FirstTokenOf(statement)) {
+        return {token->line, token->column};
+    }
+    return {};
+}
+
 Scope::Scope(const ParseNode& node) {
-    for (const auto& stmt : node.branches) {
+    for (const auto& stmt : node.Branches()) {
         using enum Rule;
 
-        switch (stmt->rule) {
+        const auto location = LocationOf(stmt);
+
+        switch (stmt.rule) {
         case Return:
-            AddStatement<class Return>(*stmt);
+            AddStatement<class Return>(location, stmt);
+            break;
+        case Yield:
+            AddStatement<class Yield>(location);
             break;
         case Invocation:
-            AddStatement<class Invocation>(*stmt);
+            AddStatement<class Invocation>(location, stmt);
             break;
         case If:
-            AddStatement<class If>(*stmt);
+            AddStatement<class If>(location, stmt);
             break;
         case Loop:
-            AddStatement<class Loop>(*stmt);
+            AddStatement<class Loop>(location, stmt);
             break;
         case LoopIf:
-            AddStatement<class LoopIf>(*stmt);
+            AddStatement<class LoopIf>(location, stmt);
             break;
         case LoopIfPost:
-            AddStatement<class LoopIfPost>(*stmt);
+            AddStatement<class LoopIfPost>(location, stmt);
             break;
         case LoopRange:
-            if (stmt->tokens[0].type == TokenType::KW_mut) {
-                // mut token is useless past this point
-                stmt->tokens[0] = stmt->tokens[1];
-                stmt->tokens.pop_back();
-                AddStatement<LoopRangeMutable>(*stmt);
+            if (stmt.TokenAt(0).type == TokenType::KW_mut) {
+                AddStatement<LoopRangeMutable>(location, stmt);
                 break;
             }
-            AddStatement<class LoopRange>(*stmt);
+            AddStatement<class LoopRange>(location, stmt);
+            break;
+        case LoopRangeParallel:
+            AddStatement<class LoopRangeParallel>(location, stmt);
             break;
         case LoopFixed:
-            AddStatement<class LoopFixed>(*stmt);
+            AddStatement<class LoopFixed>(location, stmt);
             break;
         case LoopControl:
-            if (stmt->tokens[0].type == TokenType::KW_break) {
-                AddStatement<Break>(*stmt);
+            if (stmt.TokenAt(0).type == TokenType::KW_break) {
+                AddStatement<Break>(location, stmt);
                 break;
             }
-            if (stmt->tokens[0].type == TokenType::KW_skip) {
-                AddStatement<Skip>(*stmt);
+            if (stmt.TokenAt(0).type == TokenType::KW_skip) {
+                AddStatement<Skip>(location, stmt);
                 break;
             }
             Log->error("Unexpected loop control statement. Token was '{}'",
-                       magic_enum::enum_name(stmt->tokens[0].type)
+                       magic_enum::enum_name(stmt.TokenAt(0).type)
             );
             break;
         default:
-            if (auto decl = CreateDeclaration(*stmt)) {
-                AddStatement(std::move(decl));
-            } else if (auto expr = CreateExpression(*stmt)) {
-                AddStatement(std::move(expr));
+            if (auto decl = CreateDeclaration(stmt)) {
+                AddStatement(std::move(decl), location);
+            } else if (auto expr = CreateExpression(stmt)) {
+                AddStatement(std::move(expr), location);
             } else {
                 Log->error("Expected statement");
             }
@@ -570,9 +692,9 @@ const std::vector<NodePtr>& Scope::GetStatements() const {
 
 /// Identifier
 Identifier::Identifier(const ParseNode& node)
-    : name(FetchTokenText(node.tokens[0])) {}
+    : name(node.TokenAt(0).name) {}
 
-std::string_view Identifier::GetName() const {
+NameID Identifier::GetName() const {
     return name;
 }
 
@@ -580,15 +702,34 @@ void Identifier::Accept(Visitor& visitor) const {
     visitor.Visit(*this);
 }
 
+// p-tree nodes only offer sequential access, so the operands and operators are gathered up front
+std::vector<const ParseNode*> OperandsOf(const ParseNode& node) {
+    std::vector<const ParseNode*> operands;
+    operands.reserve(node.BranchCount());
+    for (const auto& branch : node.Branches()) {
+        operands.push_back(&branch);
+    }
+    return operands;
+}
+
+std::vector<const Token*> OperatorsOf(const ParseNode& node) {
+    std::vector<const Token*> operators;
+    operators.reserve(node.TokenCount());
+    for (const auto& token : node.Tokens()) {
+        operators.push_back(&token);
+    }
+    return operators;
+}
+
 BinaryExpr::BinaryExpr(const ParseNode& node)
-    : BinaryExpr(node, 1) {}
+    : BinaryExpr(OperandsOf(node), OperatorsOf(node)) {}
 
-BinaryExpr::BinaryExpr(const std::string_view op, const ParseNode& left, const ParseNode& right)
+BinaryExpr::BinaryExpr(const TokenType op, const ParseNode& left, const ParseNode& right)
     : op(op),
       left(CreateExpression(left)),
       right(CreateExpression(right)) {}
 
-std::string_view BinaryExpr::GetOp() const {
+TokenType BinaryExpr::GetOp() const {
     return op;
 }
 
@@ -605,38 +746,43 @@ void BinaryExpr::Accept(Visitor& visitor) const {
 }
 
 /// BinaryExpr
-BinaryExpr::BinaryExpr(const ParseNode& binary_node, const i64 depth) {
-    const auto& tokens   = binary_node.tokens;
-    const auto& branches = binary_node.branches;
-
-    if (tokens.size() <= depth) {
+BinaryExpr::BinaryExpr(const std::span<const ParseNode* const> operands,
+                       const std::span<const Token* const> operators) {
+    if (operators.size() == 1) {
         // we're in the leaf node
-        left  = CreateExpression(*branches[0]);
-        right = CreateExpression(*branches[1]);
-        op    = FetchTokenText(tokens[0]);
+        left  = CreateExpression(*operands[0]);
+        right = CreateExpression(*operands[1]);
+        op    = operators[0]->type;
         return;
     }
     // we're in a parent node
 
     //                                  can't call make_shared cause private
-    left  = std::shared_ptr<BinaryExpr>(new BinaryExpr(binary_node, depth + 1));
-    right = CreateExpression(*branches[branches.size() - depth]);
-    op    = FetchTokenText(tokens[tokens.size() - depth]);
+    left  = std::shared_ptr<BinaryExpr>(new BinaryExpr(operands.first(operands.size() - 1),
+                                                       operators.first(operators.size() - 1)
+    ));
+    right = CreateExpression(*operands.back());
+    op    = operators.back()->type;
 }
 
 /// StringLiteral
-StringLiteral::StringLiteral(const std::string_view sv) {
+StringLiteral::StringLiteral(const std::string_view sv)
+    : string {Unescape(sv)} {}
+
+std::string Unescape(const std::string_view literal) {
     // unescape newlines
-    string.reserve(sv.size());
+    std::string string;
+    string.reserve(literal.size());
     i64 last_append {};
-    for (i64 i = 0; i < sv.size() - 1; ++i) {
-        if (sv[i] == '\\' && sv[i + 1] == 'n') {
-            string.append(sv.substr(last_append, i - last_append));
+    for (i64 i = 0; i < literal.size() - 1; ++i) {
+        if (literal[i] == '\\' && literal[i + 1] == 'n') {
+            string.append(literal.substr(last_append, i - last_append));
             string.push_back('\n');
             last_append = i++ + 2;
         }
     }
-    string.append(sv.substr(last_append, sv.size() - last_append));
+    string.append(literal.substr(last_append, literal.size() - last_append));
+    return string;
 }
 
 std::string_view StringLiteral::Get() const {
@@ -648,22 +794,29 @@ void StringLiteral::Accept(Visitor& visitor) const {
 }
 
 /// ArrayLiteral
-ListExpression::ListExpression(const ParseNode& node) {
-    // []
-    if (node.branches.empty()) {
+ListExpression::ListExpression(const ParseNode& node)
+    : is_map {IsEmptyMap(node)} {
+    // [] or [:]
+    if (node.IsLeaf()) {
         return;
     }
 
-    if (node.branches.size() > 1) {
+    if (node.BranchCount() > 1) {
         Log->error("ArrayLiteral may only contain one elem list");
     }
 
-    for (const auto& elem_list = *node.branches[0];
-         const auto& elem : elem_list.branches) {
-        values.emplace_back(std::move(ProcessValue(*elem)));
+    for (const auto& elem_list = node.Branch(0);
+         const auto& elem : elem_list.Branches()) {
+        values.emplace_back(std::move(ProcessValue(elem)));
     }
 }
 
+bool IsEmptyMap(const ParseNode& list) {
+    return list.IsLeaf() && std::ranges::any_of(list.Tokens(), [](const Token& token) {
+        return token.type == TokenType::Op_Colon;
+    });
+}
+
 std::span<const NodePtr> ListExpression::GetValues() const {
     return values;
 }
@@ -672,6 +825,10 @@ hexe::Value::Data::Type ListExpression::GetType() const {
     return type;
 }
 
+bool ListExpression::IsMap() const {
+    return is_map;
+}
+
 void ListExpression::SetType(const hexe::Value::Data::Type new_type) {
     type = new_type;
 }
@@ -686,13 +843,13 @@ NodePtr ListExpression::ProcessValue(const ParseNode& elem) {
 
     case Grouping:
         // [()]
-        if (elem.branches.empty()) {
+        if (elem.IsLeaf()) {
             Log->warn("Empty grouping inside array literal");
             return nullptr;
         }
 
         // [(foo)]
-        return ProcessValue(*elem.branches[0]);
+        return ProcessValue(elem.Branch(0));
 
     case ListExpression:
         // [[1, 2, 3,], [4, 3, 2],]
@@ -703,7 +860,7 @@ NodePtr ListExpression::ProcessValue(const ParseNode& elem) {
 
     case Literal:
         // [12.4, 95.3]
-        return MakeLiteral(elem.tokens[0]).value;
+        return MakeLiteral(elem.TokenAt(0)).value;
 
     case Equality:
     case Comparison:
@@ -734,14 +891,14 @@ SIGIL_NODISCARD bool IsBooleanLiteral(const TokenType token) {
 
 /// UnaryExpr
 UnaryExpr::UnaryExpr(const ParseNode& node)
-    : op(FetchTokenText(node.tokens[0])),
-      val(CreateExpression(*node.branches[0])) {}
+    : op(node.TokenAt(0).type),
+      val(CreateExpression(node.Branch(0))) {}
 
 void UnaryExpr::Accept(Visitor& visitor) const {
     visitor.Visit(*this);
 }
 
-std::string_view UnaryExpr::GetOp() const {
+TokenType UnaryExpr::GetOp() const {
     return op;
 }
 
@@ -752,15 +909,17 @@ const Node& UnaryExpr::GetVal() const {
 NodePtr CreateExpression(const ParseNode& node) {
     using enum Rule;
 
-    const auto& token = node.tokens.empty() ? Token {} : node.tokens[0];
+    const auto token = node.TokenCount() == 0 ? Token {} : node.TokenAt(0);
 
     switch (node.rule) {
     case Invocation:
         return std::make_shared<class Invocation>(node);
     case Assignment:
         return std::make_shared<class Assignment>(node);
+    case ElementAssignment:
+        return std::make_shared<class ElementAssignment>(node);
     case Grouping:
-        return CreateExpression(*node.branches[0]);
+        return CreateExpression(node.Branch(0));
     case Literal:
         return MakeLiteral(token).value;
     case Identifier:
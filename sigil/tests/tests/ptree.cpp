@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "headers/common.hpp"
+#include <sigil/ast/document.hpp>
+#include <sigil/ast/keywords.hpp>
 #include <sigil/ast/lexer.hpp>
 #include <sigil/ast/parser.hpp>
 
@@ -32,7 +34,7 @@ TEST_CASE("P-Trees", "[parse][ast]") {
         SECTION("Root is properly formed") {
             REQUIRE_FALSE(tokens.empty());
             REQUIRE(ptree.rule == Rule::Artifact);
-            REQUIRE_FALSE(ptree.branches.empty());
+            REQUIRE_FALSE(ptree.IsLeaf());
         }
 
         SECTION("P-Tree output matches control") {
@@ -74,4 +76,207 @@ TEST_CASE("P-Trees", "[parse][ast]") {
     SECTION("Conditionals") {
         compare_ptree("if");
     }
+
+    // a 'mut' range counter keeps its 'mut' token in the tree
+    SECTION("Loops") {
+        compare_ptree("loops");
+    }
+}
+
+TEST_CASE("Discarded P-Trees", "[parse][ast]") {
+    const auto path = Concatenate(PARSER_SAMPLE_PATH, "declarations.mn");
+
+    Lexer lexer;
+    REQUIRE(lexer.Tokenize(path));
+
+    Parser retained(lexer.Tokens());
+    REQUIRE(retained.Parse());
+
+    Parser discarded(lexer.Tokens());
+    discarded.RetainParseTree(false);
+    REQUIRE(discarded.Parse());
+
+    SECTION("Builds the same AST") {
+        REQUIRE(retained.IssueCount() == 0);
+        REQUIRE(discarded.IssueCount() == 0);
+
+        const auto& retained_ast  = retained.FlatAST();
+        const auto& discarded_ast = discarded.FlatAST();
+        REQUIRE(discarded_ast.Declarations().size() == retained_ast.Declarations().size());
+        REQUIRE(discarded_ast.NodeCount() == retained_ast.NodeCount());
+    }
+
+    SECTION("Keeps no declarations around") {
+        REQUIRE_FALSE(retained.ViewParseTree().IsLeaf());
+        REQUIRE(discarded.ViewParseTree().IsLeaf());
+
+        REQUIRE_FALSE(dynamic_cast<Artifact*>(retained.AST())->GetChildren().empty());
+        REQUIRE(dynamic_cast<Artifact*>(discarded.AST())->GetChildren().empty());
+    }
+}
+
+TEST_CASE("Flat AST", "[parse][ast]") {
+    Lexer lexer;
+    REQUIRE(lexer.Tokenize(Concatenate(PARSER_SAMPLE_PATH, "declarations.mn")));
+
+    Parser parser(lexer.Tokens());
+    parser.RetainParseTree(false);
+    REQUIRE(parser.Parse());
+
+    const auto& ast   = parser.FlatAST();
+    const auto& decls = ast.Declarations();
+    REQUIRE(decls.size() == 3);
+
+    SECTION("Declarations") {
+        REQUIRE(ast.Kind(decls[0]) == NodeKind::DataDeclaration);
+        REQUIRE(ast.Name(decls[0]) == Names().Find("limit"));
+        REQUIRE(ast.ChildCount(decls[0]) == 1);
+        REQUIRE(ast.Int(ast.Child(decls[0], 0)) == 10);
+
+        REQUIRE(ast.Kind(decls[1]) == NodeKind::FunctionDeclaration);
+        REQUIRE(ast.Function(decls[1]).name == Names().Find("Sum"));
+        REQUIRE(ast.Function(decls[1]).return_type == PrimitiveID(PrimitiveType::I64));
+        REQUIRE(ast.Parameters(decls[1]).size() == 2);
+    }
+
+    SECTION("Expressions") {
+        // return a + b * 2
+        const auto body = ast.Child(decls[1], 0);
+        REQUIRE(ast.Kind(body) == NodeKind::Scope);
+
+        const auto ret = ast.Child(body, 0);
+        REQUIRE(ast.Kind(ret) == NodeKind::Return);
+        REQUIRE(ast.Location(ret).line == 4);
+
+        const auto sum = ast.Child(ret, 0);
+        REQUIRE(ast.Kind(sum) == NodeKind::Binary);
+        REQUIRE(ast.Operator(sum) == TokenType::Op_Plus);
+        REQUIRE(ast.Kind(ast.Child(sum, 1)) == NodeKind::Binary);
+        REQUIRE(ast.Operator(ast.Child(sum, 1)) == TokenType::Op_Asterisk);
+    }
+}
+
+TEST_CASE("Binary Expressions", "[parse][ast]") {
+    Lexer lexer;
+    REQUIRE(lexer.Tokenize(Concatenate(PARSER_SAMPLE_PATH, "precedence.mn")));
+
+    Parser parser(lexer.Tokens());
+    REQUIRE(parser.Parse());
+    REQUIRE(parser.IssueCount() == 0);
+
+    const auto& scope     = parser.ViewParseTree().Branch(0).Branch(1);
+    const auto expression = [&scope](const i64 decl) -> const ParseNode& {
+        return scope.Branch(decl).Branch(0);
+    };
+
+    SECTION("Operators of equal precedence share a node") {
+        const auto& chain = expression(0);
+        REQUIRE(chain.rule == Rule::Term);
+        REQUIRE(chain.BranchCount() == 3);
+        REQUIRE(chain.TokenCount() == 2);
+    }
+
+    SECTION("Tighter operators nest deeper") {
+        const auto& logical = expression(1);
+        REQUIRE(logical.rule == Rule::Logical);
+
+        const auto& comparison = logical.Branch(0);
+        REQUIRE(comparison.rule == Rule::Comparison);
+
+        const auto& term = comparison.Branch(0);
+        REQUIRE(term.rule == Rule::Term);
+        REQUIRE(term.Branch(0).rule == Rule::Literal);
+        REQUIRE(term.Branch(1).rule == Rule::Factor);
+        REQUIRE(comparison.Branch(1).rule == Rule::Literal);
+    }
+
+    SECTION("Groupings reset precedence") {
+        const auto& factor = expression(2);
+        REQUIRE(factor.rule == Rule::Factor);
+        REQUIRE(factor.Branch(0).rule == Rule::Grouping);
+        REQUIRE(factor.Branch(0).Branch(0).rule == Rule::Term);
+    }
+}
+
+TEST_CASE("Yield", "[parse][ast]") {
+    Lexer lexer;
+    REQUIRE(lexer.TokenizeSource("fn Patrol() {\n    loop {\n        yield\n    }\n}\n", "yield"));
+
+    Parser parser(lexer.Tokens());
+    parser.RetainParseTree(false);
+    REQUIRE(parser.Parse());
+
+    const auto& ast = parser.FlatAST();
+    const auto loop = ast.Child(ast.Child(ast.Declarations()[0], 0), 0);
+    REQUIRE(ast.Kind(loop) == NodeKind::Loop);
+
+    const auto yield = ast.Child(ast.Child(loop, 0), 0);
+    REQUIRE(ast.Kind(yield) == NodeKind::Yield);
+    REQUIRE(ast.Location(yield).line == 3);
+    REQUIRE(ast.ChildCount(yield) == 0);
+}
+
+TEST_CASE("Incremental Documents", "[parse][ast]") {
+    std::ifstream file(Concatenate(PARSER_SAMPLE_PATH, "declarations.mn"));
+    REQUIRE((file && file.is_open()));
+
+    Document document("declarations");
+    document.Open(std::string(std::istreambuf_iterator {file}, {}));
+
+    // whatever the edits, lowering the document should give what parsing its text from scratch does
+    const auto matches_full_parse = [&document] {
+        Lexer lexer;
+        REQUIRE(lexer.TokenizeSource(document.Text(), "declarations"));
+
+        Parser parser(lexer.Tokens());
+        parser.RetainParseTree(false);
+        REQUIRE(parser.Parse());
+
+        FlatTree incremental;
+        document.Lower(incremental);
+
+        const auto& full = parser.FlatAST();
+        REQUIRE(incremental.Declarations().size() == full.Declarations().size());
+        REQUIRE(incremental.NodeCount() == full.NodeCount());
+
+        for (NodeId node = 0; node < full.NodeCount(); ++node) {
+            REQUIRE(incremental.Kind(node) == full.Kind(node));
+            REQUIRE(incremental.Location(node).line == full.Location(node).line);
+        }
+    };
+
+    SECTION("Opening parses every declaration") {
+        REQUIRE(document.ReparsedCount() == 3);
+        REQUIRE(document.IssueCount() == 0);
+        matches_full_parse();
+    }
+
+    SECTION("Edits only reparse the declaration they touch") {
+        // return a + b * 2 -> return a + b * 3
+        document.Edit({4, 20}, {4, 21}, "3");
+
+        REQUIRE(document.ReparsedCount() == 1);
+        REQUIRE(document.LineTokens(4).back().type == TokenType::Terminator);
+        matches_full_parse();
+    }
+
+    SECTION("Inserted lines move the declarations below") {
+        document.Edit({1, 1}, {1, 1}, "data step = 2\n");
+
+        // the new line and the one it was inserted before
+        REQUIRE(document.ReparsedCount() == 2);
+        REQUIRE(document.LineCount() == 20);
+        matches_full_parse();
+    }
+
+    SECTION("Syntax errors stay within their declaration") {
+        document.Edit({3, 31}, {3, 32}, "");
+        REQUIRE(document.ReparsedCount() == 1);
+        REQUIRE(document.IssueCount() > 0);
+
+        document.Edit({3, 31}, {3, 31}, "{");
+        REQUIRE(document.ReparsedCount() == 1);
+        REQUIRE(document.IssueCount() == 0);
+        matches_full_parse();
+    }
 }
@@ -0,0 +1,312 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "headers/common.hpp"
+#include <sigil/ast/lexer.hpp>
+#include <sigil/ast/parser.hpp>
+#include <sigil/ast/semantic-analyzer.hpp>
+
+#include <fstream>
+#include <string>
+
+constexpr auto SEMANTIC_SAMPLE_PATH = "assets/samples/parsing/";
+
+using namespace sigil;
+using namespace sigil::ast;
+using namespace mana::literals;
+
+namespace {
+std::string InMain(const std::string_view body) {
+    return "fn Main() {\n" + std::string(body) + "}\n";
+}
+
+std::string ReadSample(const std::string_view name) {
+    std::ifstream file(Concatenate(SEMANTIC_SAMPLE_PATH, name));
+    REQUIRE((file && file.is_open()));
+    return {std::istreambuf_iterator {file}, {}};
+}
+
+// lexes, parses and analyzes 'source' the way circe does, leaving the AST in 'parser'
+// returns how many issues the analyzer reported
+i32 Analyze(Parser& parser, const std::string_view source, const std::string_view natives = "") {
+    // the manifest has to be lexed before the source, which replaces it
+    SemanticAnalyzer analyzer;
+    if (not natives.empty()) {
+        REQUIRE(analyzer.RegisterNatives(natives, "semantic"));
+    }
+
+    Lexer lexer;
+    REQUIRE(lexer.TokenizeSource(std::string(source), "semantic"));
+
+    parser.AcquireTokens(lexer.Tokens());
+    parser.RetainParseTree(false);
+    REQUIRE(parser.Parse());
+
+    analyzer.Analyze(parser.FlatAST());
+    return analyzer.IssueCount();
+}
+
+i32 Analyze(const std::string_view source, const std::string_view natives = "") {
+    Parser parser;
+    return Analyze(parser, source, natives);
+}
+} // namespace
+
+TEST_CASE("Scoped Symbols", "[semantic][ast]") {
+    SECTION("Names can be reused once their scope is left") {
+        REQUIRE(Analyze(ReadSample("scopes.mn")) == 0);
+    }
+
+    SECTION("Names are not visible past their scope") {
+        REQUIRE(Analyze(ReadSample("scopes-escape.mn")) == 2);
+    }
+}
+
+TEST_CASE("Native Functions", "[semantic][ast]") {
+    constexpr std::string_view manifest = "fn Sqrt(x: f64) -> f64\n"
+                                          "fn Log(message: string)\n";
+
+    const auto analyze = [manifest](const std::string_view source) {
+        return Analyze(source, manifest);
+    };
+
+    SECTION("Calls are checked against the manifest") {
+        REQUIRE(analyze(InMain("    data r = Sqrt(2.0)\n    Log(\"done\")\n")) == 0);
+        REQUIRE(analyze(InMain("    data r = Sqrt(true)\n")) == 1);
+        REQUIRE(analyze(InMain("    Log()\n")) == 1);
+    }
+
+    SECTION("Natives can't be declared again") {
+        REQUIRE(analyze("fn Sqrt(x: f64) -> f64 {\n    return x\n}\n" + InMain("")) == 1);
+    }
+
+    SECTION("Malformed manifests are rejected") {
+        SemanticAnalyzer analyzer;
+        REQUIRE_FALSE(analyzer.RegisterNatives("fn Sqrt(x) -> f64\n", "natives"));
+        REQUIRE_FALSE(analyzer.RegisterNatives("fn Print(message: string)\n", "natives"));
+        REQUIRE(analyzer.IssueCount() == 2);
+    }
+}
+
+TEST_CASE("Parallel Loops", "[semantic][ast]") {
+    const auto with_lists = [](const std::string_view body) {
+        return InMain("    mut data xs = [1, 2, 3, 4]\n    mut data total = 0\n" + std::string(body));
+    };
+
+    const auto analyze = [&with_lists](const std::string_view body) {
+        return Analyze(with_lists(body));
+    };
+
+    SECTION("Iterations may write their own element of a shared list") {
+        REQUIRE(analyze("    @parallel loop 0..3 => i {\n        mut data x = xs[i] * 2\n        x += i\n"
+                        "        xs[i] = x\n    }\n") == 0);
+
+        Parser parser;
+        REQUIRE(Analyze(parser, with_lists("    @parallel loop 4 => i {\n        xs[i] += 1\n    }\n")) == 0);
+
+        const auto& ast = parser.FlatAST();
+        const auto loop = ast.Child(ast.Child(ast.Declarations()[0], 0), 2);
+        REQUIRE(ast.Kind(loop) == NodeKind::LoopRangeParallel);
+        const auto body = ast.Child(loop, ast.ChildCount(loop) - 1);
+        REQUIRE(ast.Kind(ast.Child(body, 0)) == NodeKind::ElementAssignment);
+    }
+
+    SECTION("Anything else iterations share is read-only") {
+        REQUIRE(analyze("    @parallel loop 0..3 => i {\n        total += xs[i]\n    }\n") == 1);
+        REQUIRE(analyze("    @parallel loop 0..2 => i {\n        xs[i + 1] = 0\n    }\n") == 1);
+    }
+
+    SECTION("Iterations can't leave the loop early") {
+        REQUIRE(analyze("    @parallel loop 0..3 => i {\n        break\n    }\n") == 1);
+        REQUIRE(analyze("    @parallel loop 0..3 => i {\n        return\n    }\n") == 1);
+        REQUIRE(analyze("    @parallel loop 0..3 => i {\n        @parallel loop 0..3 => j {\n        }\n    }\n") == 1);
+    }
+
+    SECTION("Only ranged loops can be parallel") {
+        const auto parses = [&with_lists](const std::string_view body) {
+            Lexer lexer;
+            REQUIRE(lexer.TokenizeSource(with_lists(body), "semantic"));
+
+            Parser parser(lexer.Tokens());
+            parser.RetainParseTree(false);
+            return parser.Parse() && parser.IssueCount() == 0;
+        };
+
+        REQUIRE_FALSE(parses("    @parallel loop {\n        break\n    }\n"));
+        REQUIRE_FALSE(parses("    @parallel loop 0..3 => mut i {\n    }\n"));
+        REQUIRE_FALSE(parses("    @unrolled loop 0..3 => i {\n    }\n"));
+    }
+}
+
+TEST_CASE("Vector Types", "[semantic][ast]") {
+    const auto analyze = [](const std::string_view body) {
+        return Analyze(InMain("    mut data v = Vec3(1.0, 2.0, 3.0)\n    mut data c = Vec2i(1, 2)\n" + std::string(body)));
+    };
+
+    SECTION("Vectors add up with vectors of their own type, and scale by their lane type") {
+        REQUIRE(analyze("    data w: vec3 = v + v * 2.0 - -v\n    v += w\n    v *= 0.5\n    c *= 3\n") == 0);
+        REQUIRE(analyze("    data d: f32 = Dot(v, v) + Length(v) + v[1]\n    data n: vec3 = Normalize(Cross(v, v))\n") == 0);
+
+        REQUIRE(analyze("    data w = v + Vec2(1.0, 2.0)\n") == 1);
+        REQUIRE(analyze("    data w = v * v\n") == 1);
+        REQUIRE(analyze("    data w = v * 2\n") == 1);
+        REQUIRE(analyze("    data w = c * 2.0\n") == 1);
+        REQUIRE(analyze("    v /= 2.0\n") == 1);
+    }
+
+    SECTION("Vector builtins only take the vectors they're defined for") {
+        REQUIRE(analyze("    data w = Cross(c, c)\n") == 1);
+        REQUIRE(analyze("    data w = Length(c)\n") == 1);
+        REQUIRE(analyze("    data w = Dot(v, c)\n") == 1);
+        REQUIRE(analyze("    data w = Normalize(1.0)\n") == 1);
+    }
+
+    SECTION("Constant lane indices have to be within the vector") {
+        REQUIRE(analyze("    data x = v[2] + v[0]\n    data y = c[1]\n") == 0);
+
+        REQUIRE(analyze("    data x = v[3]\n") == 1);
+        REQUIRE(analyze("    data x = v[-1]\n") == 1);
+        REQUIRE(analyze("    data y = c[2]\n") == 1);
+        REQUIRE(analyze("    data w = Vec4(1.0, 2.0, 3.0, 4.0)\n    data x = w[3]\n    data y = w[4]\n") == 1);
+    }
+
+    SECTION("Operators on vectors record their operands for codegen") {
+        Parser parser;
+        REQUIRE(Analyze(parser, InMain("    data v = Vec3(1.0, 2.0, 3.0)\n    data w = 2.0 * v\n")) == 0);
+
+        const auto& ast  = parser.FlatAST();
+        const auto scale = ast.Child(ast.Child(ast.Child(ast.Declarations()[0], 0), 1), 0);
+        REQUIRE(ast.Kind(scale) == NodeKind::Binary);
+        REQUIRE(ast.Operator(scale) == TokenType::Op_Asterisk);
+        REQUIRE(ast.OperandType(scale, 0) == hexe::Value::Data::Type::Float64);
+        REQUIRE(ast.OperandType(scale, 1) == hexe::Value::Data::Type::Vec3);
+    }
+}
+
+TEST_CASE("Packed Lists", "[semantic][ast]") {
+    const auto analyze = [](const std::string_view body) {
+        return Analyze(InMain(body));
+    };
+
+    SECTION("List literals take on the element type they're annotated with") {
+        REQUIRE(analyze("    data a: [f32] = [1.0, 2.5]\n    data b: [u8] = [1, 200]\n    data c: [i16] = [-3, 4]\n") == 0);
+        REQUIRE(analyze("    mut data a: [i32] = [1, 2]\n    a[0] += 3\n    data x: i32 = a[1]\n") == 0);
+
+        REQUIRE(analyze("    data a: [u8] = [1.5]\n") == 1);
+        REQUIRE(analyze("    data a: [f32] = [true]\n") == 1);
+        REQUIRE(analyze("    data a: [foo] = [1]\n") == 2);
+        REQUIRE(analyze("    mut data a: [f32] = [1.0]\n    a[0] = 1\n") == 1);
+    }
+
+    SECTION("Bool lists can't be written to by parallel loops, as their elements share bytes") {
+        REQUIRE(analyze("    mut data a = [true, false]\n    @parallel loop 0..2 => i {\n        a[i] = false\n    }\n") == 1);
+        REQUIRE(analyze("    mut data a = [1, 2]\n    @parallel loop 0..2 => i {\n        a[i] = 3\n    }\n") == 0);
+    }
+
+    SECTION("Operators only apply to elements, never to whole lists") {
+        REQUIRE(analyze("    data a: [u8] = [1, 2]\n    data x = a[0] + a[1]\n") == 0);
+
+        REQUIRE(analyze("    data a: [u8] = [1, 2]\n    data b = a + 1\n") == 1);
+        REQUIRE(analyze("    data a = [1, 2]\n    data b = 2 * a\n") == 1);
+        REQUIRE(analyze("    data a: [f32] = [1.0]\n    data b = a == a\n") == 1);
+        REQUIRE(analyze("    data a = [1, 2]\n    data b = a < 3\n") == 1);
+        REQUIRE(analyze("    data a: [i16] = [1, 2]\n    data b = -a\n") == 1);
+        REQUIRE(analyze("    data a = [true]\n    data b = not a\n") == 1);
+        REQUIRE(analyze("    mut data a = [1, 2]\n    a += 1\n") == 1);
+    }
+
+    SECTION("Lists and their accesses record how the elements are stored") {
+        Parser parser;
+        REQUIRE(Analyze(parser, InMain("    data a: [u16] = [1, 2]\n    data b = [true]\n    data x = a[1]\n")) == 0);
+
+        const auto& ast = parser.FlatAST();
+        const auto body = ast.Child(ast.Declarations()[0], 0);
+        REQUIRE(ast.ListType(ast.Child(ast.Child(body, 0), 0)) == hexe::Value::Data::Type::Uint16);
+        REQUIRE(ast.ListType(ast.Child(ast.Child(body, 1), 0)) == hexe::Value::Data::Type::Bits);
+
+        const auto access = ast.Child(ast.Child(body, 2), 0);
+        REQUIRE(ast.Kind(access) == NodeKind::ListAccess);
+        REQUIRE(ast.OperandType(access, 0) == hexe::Value::Data::Type::Uint16);
+    }
+}
+
+TEST_CASE("List Builtins", "[semantic][ast]") {
+    const auto analyze = [](const std::string_view body) {
+        return Analyze(InMain(body));
+    };
+
+    SECTION("Results take on the list's types") {
+        REQUIRE(analyze("    data a: [u8] = [1, 2]\n    data s: u64 = ListSum(a)\n    data m: u8 = ListMax(a)\n") == 0);
+        REQUIRE(analyze("    data a = [1.0, 2.0]\n    data b: [f64] = ListAdd(a, ListSlice(a, 0, 1))\n") == 0);
+        REQUIRE(analyze("    data a: [u16] = [4, 5]\n    data i: i64 = ListFind(a, 5)\n") == 0);
+
+        REQUIRE(analyze("    data a = [1, 2]\n    data b: [u8] = [1, 2]\n    data c = ListMul(a, b)\n") == 1);
+        REQUIRE(analyze("    data a = [1, 2]\n    data b = ListSlice(a, 0, 1.0)\n") == 1);
+    }
+
+    SECTION("Only lists of numbers have arithmetic, and strings have none of it") {
+        REQUIRE(analyze("    mut data a = [true, false]\n    ListFill(a, true)\n    data i = ListFind(a, false)\n") == 0);
+
+        REQUIRE(analyze("    data a = [true, false]\n    data s = ListSum(a)\n") == 1);
+        REQUIRE(analyze("    mut data a = [\"x\", \"y\"]\n    ListFill(a, \"z\")\n") == 1);
+        REQUIRE(analyze("    data s = ListSum(5)\n") == 1);
+    }
+
+    SECTION("Lists are only modified through mutable bindings nothing else shares") {
+        REQUIRE(analyze("    mut data a = [3, 1, 2]\n    ListSort(a)\n    ListCopy(a, [4, 5])\n") == 0);
+
+        REQUIRE(analyze("    data a = [3, 1, 2]\n    ListSort(a)\n") == 1);
+        REQUIRE(analyze("    mut data a = [3, 1, 2]\n    ListSort(ListSlice(a, 0, 2))\n") == 1);
+        REQUIRE(analyze("    mut data a = [3, 1, 2]\n    @parallel loop 0..3 => i {\n        ListFill(a, 0)\n    }\n") == 1);
+    }
+}
+
+TEST_CASE("Map Types", "[semantic][ast]") {
+    const auto analyze = [](const std::string_view body) {
+        return Analyze(InMain(body));
+    };
+
+    SECTION("'[:]' takes on the map type it's annotated with") {
+        REQUIRE(analyze("    mut data m: [i64: f64] = [:]\n    m = [:]\n") == 0);
+        REQUIRE(analyze("    data m: [string: i32] = [:]\n    data n = MapCount(m)\n") == 0);
+
+        REQUIRE(analyze("    data m = [:]\n") == 1);
+        REQUIRE(analyze("    data m: [u64: f64] = [:]\n") == 1);
+        REQUIRE(analyze("    data m: [f64: f64] = [:]\n") == 1);
+    }
+
+    SECTION("Keys and values take on the map's types") {
+        REQUIRE(analyze("    mut data m: [i32: f64] = [:]\n    MapSet(m, 7, 1.5)\n    data v: f64 = MapGet(m, 7, 0.0)\n") == 0);
+        REQUIRE(analyze("    data m: [string: i64] = [:]\n    data k: string = MapKeyAt(m, 0)\n    data b: bool = MapHas(m, \"x\")\n") == 0);
+
+        REQUIRE(analyze("    mut data m: [i64: f64] = [:]\n    MapSet(m, \"x\", 1.5)\n") == 1);
+        REQUIRE(analyze("    data m: [i64: f64] = [:]\n    data v = MapGet(m, 1, true)\n") == 1);
+        REQUIRE(analyze("    data m: [i64: f64] = [:]\n    data v = MapValueAt(m, 1.0)\n") == 1);
+        REQUIRE(analyze("    data xs = [1, 2]\n    data n = MapCount(xs)\n") == 1);
+    }
+
+    SECTION("Maps are only modified through mutable bindings nothing else shares") {
+        REQUIRE(analyze("    mut data m: [i64: i64] = [:]\n    MapSet(m, 1, 2)\n    data gone = MapRemove(m, 1)\n") == 0);
+
+        REQUIRE(analyze("    data m: [i64: i64] = [:]\n    MapSet(m, 1, 2)\n") == 1);
+        REQUIRE(analyze("    mut data m: [i64: i64] = [:]\n    @parallel loop 0..3 => i {\n        MapSet(m, i, i)\n    }\n") == 1);
+    }
+
+    SECTION("Operators don't apply to maps") {
+        const auto with_maps = [&analyze](const std::string_view body) {
+            return analyze("    mut data m: [i64: i64] = [:]\n    data n: [string: f64] = [:]\n" + std::string(body));
+        };
+
+        REQUIRE(with_maps("    data x = MapGet(m, 1, 0) + MapCount(n)\n") == 0);
+
+        REQUIRE(with_maps("    data x = m + 1\n") == 1);
+        REQUIRE(with_maps("    data x = 2 * n\n") == 1);
+        REQUIRE(with_maps("    data x = m == n\n") == 1);
+        REQUIRE(with_maps("    data x = m != m\n") == 1);
+        REQUIRE(with_maps("    data x = m < 3\n") == 1);
+        REQUIRE(with_maps("    data x = n >= n\n") == 1);
+        REQUIRE(with_maps("    data x = m and true\n") == 1);
+        REQUIRE(with_maps("    data x = -m\n") == 1);
+        REQUIRE(with_maps("    data x = not n\n") == 1);
+        REQUIRE(with_maps("    m += 1\n") == 1);
+    }
+}
@@ -1,7 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <sigil/ast/keywords.hpp>
 #include <sigil/ast/lexer.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 using namespace sigil;
@@ -23,3 +25,124 @@ TEST_CASE("Lexer", "[lex][token][operator][keyword]") {
 
     REQUIRE(output == control);
 }
+
+TEST_CASE("Lexer from memory", "[lex][token]") {
+    using enum TokenType;
+
+    SECTION("Matches tokenizing the same file") {
+        const std::string path = "assets/samples/lex-tests.mn";
+
+        Lexer file_lexer;
+        REQUIRE(file_lexer.Tokenize(path));
+        const auto file_tokens = file_lexer.Tokens();
+
+        std::ifstream source_file(path);
+        REQUIRE(source_file.good());
+        std::string source(std::istreambuf_iterator {source_file}, {});
+
+        Lexer lexer;
+        REQUIRE(lexer.TokenizeSource(std::move(source), "lex-tests"));
+        REQUIRE(lexer.Tokens() == file_tokens);
+    }
+
+    SECTION("Keywords and identifiers past 64KiB") {
+        // a long comment pushes the tokens past what a 16-bit offset can hold
+        std::string source = "//" + std::string(70'000, '-') + "\n";
+        const auto offset  = static_cast<mana::literals::i32>(source.size());
+        source.append("return identifier\n");
+
+        Lexer lexer;
+        REQUIRE(lexer.TokenizeSource(std::move(source), "large"));
+
+        const auto& tokens = lexer.Tokens();
+        const auto keyword = std::ranges::find(tokens, KW_return, &Token::type);
+        REQUIRE(keyword != tokens.end());
+        REQUIRE(keyword->offset == offset);
+
+        const auto identifier = std::ranges::find(tokens, Identifier, &Token::type);
+        REQUIRE(identifier != tokens.end());
+        REQUIRE(FetchTokenText(*identifier) == "identifier");
+    }
+
+    SECTION("Comment on the last line without a newline") {
+        Lexer lexer;
+        REQUIRE(lexer.TokenizeSource("data x = 1\n// no newline follows", "comment"));
+
+        const auto& tokens = lexer.Tokens();
+        REQUIRE(tokens.back().type == Eof);
+        REQUIRE(std::ranges::count(tokens, Terminator, &Token::type) == 2);
+    }
+
+    SECTION("Keywords") {
+        for (const auto& [text, type] : KEYWORDS) {
+            Lexer lexer;
+            REQUIRE(lexer.TokenizeSource(std::string(text), "keyword"));
+            REQUIRE(lexer.Tokens().front().type == type);
+        }
+
+        Lexer lexer;
+        REQUIRE(lexer.TokenizeSource("datum mutable Main", "identifiers"));
+        REQUIRE(std::ranges::count(lexer.Tokens(), Identifier, &Token::type) == 3);
+    }
+}
+
+TEST_CASE("Interned names", "[lex][token]") {
+    using enum TokenType;
+
+    Lexer lexer;
+    REQUIRE(lexer.TokenizeSource("data count: i64 = count + other\nfn Main() {}", "names"));
+
+    const auto& tokens = lexer.Tokens();
+
+    SECTION("Identifiers with the same text share a name") {
+        std::vector<NameID> names;
+        for (const auto& token : tokens) {
+            if (token.type == Identifier) {
+                REQUIRE(Names().Name(token.name) == FetchTokenText(token));
+                names.push_back(token.name);
+            }
+        }
+
+        REQUIRE(names.size() == 4);
+        REQUIRE(names[0] == names[1]);
+        REQUIRE(names[0] != names[2]);
+        REQUIRE(names[3] == ENTRY_POINT_ID);
+    }
+
+    SECTION("Primitive types are named by their PrimitiveType") {
+        const auto type = std::ranges::find(tokens, KW_i64, &Token::type);
+        REQUIRE(type != tokens.end());
+        REQUIRE(type->name == PrimitiveID(PrimitiveType::I64));
+
+        const auto keyword = std::ranges::find(tokens, KW_data, &Token::type);
+        REQUIRE(keyword != tokens.end());
+        REQUIRE(keyword->name == NO_NAME);
+    }
+}
+
+TEST_CASE("Truncating interned names", "[lex][token]") {
+    const auto before = Names().Count();
+
+    Lexer lexer;
+    REQUIRE(lexer.TokenizeSource("data only_in_this_file = 1", "truncate"));
+    REQUIRE(Names().Find("only_in_this_file") != NO_NAME);
+
+    SECTION("Names past the count are forgotten, and their IDs handed out again") {
+        const auto id = Names().Find("only_in_this_file");
+        Names().Truncate(before);
+
+        REQUIRE(Names().Count() == before);
+        REQUIRE(Names().Find("only_in_this_file") == NO_NAME);
+        REQUIRE(Names().Intern("another_file") == id);
+
+        Names().Truncate(before);
+    }
+
+    SECTION("The primitives and the entry point are never forgotten") {
+        Names().Truncate(0);
+
+        REQUIRE(Names().Count() == ENTRY_POINT_ID + 1);
+        REQUIRE(Names().Find(ENTRY_POINT) == ENTRY_POINT_ID);
+        REQUIRE(Names().Find(PrimitiveName(PrimitiveType::I64)) == PrimitiveID(PrimitiveType::I64));
+    }
+}